@@ -58,6 +58,7 @@ static gboolean scan_modems_flag;
 static gchar *set_logging_str;
 static gchar *inhibit_device_str;
 static gchar *report_kernel_event_str;
+static gboolean report_memory_flag;
 
 #if defined WITH_UDEV
 static gboolean report_kernel_event_auto_scan;
@@ -92,6 +93,10 @@ static GOptionEntry entries[] = {
       "Report kernel event",
       "[\"key=value,...\"]"
     },
+    { "report-memory", 0, 0, G_OPTION_ARG_NONE, &report_memory_flag,
+      "Report memory usage per modem (requires the daemon Test interface)",
+      NULL
+    },
 #if defined WITH_UDEV
     { "report-kernel-event-auto-scan", 0, 0, G_OPTION_ARG_NONE, &report_kernel_event_auto_scan,
       "Automatically report kernel events based on udev notifications",
@@ -132,7 +137,8 @@ mmcli_manager_options_enabled (void)
                  scan_modems_flag +
                  !!set_logging_str +
                  !!inhibit_device_str +
-                 !!report_kernel_event_str);
+                 !!report_kernel_event_str +
+                 report_memory_flag);
 
 #if defined WITH_UDEV
     n_actions += report_kernel_event_auto_scan;
@@ -143,7 +149,7 @@ mmcli_manager_options_enabled (void)
         exit (EXIT_FAILURE);
     }
 
-    if (get_daemon_version_flag)
+    if (get_daemon_version_flag || report_memory_flag)
         mmcli_force_sync_operation ();
     else if (monitor_modems_flag) {
         if (mmcli_output_get () != MMC_OUTPUT_TYPE_HUMAN) {
@@ -321,6 +327,48 @@ scan_devices_ready (MMManager    *manager,
     mmcli_async_operation_done ();
 }
 
+static void
+report_memory (GDBusConnection *connection)
+{
+    GError       *error = NULL;
+    GVariant     *result;
+    GVariantIter *modems;
+    const gchar  *path;
+    GVariantIter *entries;
+
+    /* The memory report is only available in the Test interface, which has
+     * no libmm-glib counterpart, so just call it directly */
+    result = g_dbus_connection_call_sync (connection,
+                                          MM_DBUS_SERVICE,
+                                          MM_DBUS_PATH,
+                                          "org.freedesktop.ModemManager1.Test",
+                                          "GetMemoryReport",
+                                          NULL,
+                                          G_VARIANT_TYPE ("(a{sa{st}})"),
+                                          G_DBUS_CALL_FLAGS_NONE,
+                                          -1,
+                                          NULL,
+                                          &error);
+    if (!result) {
+        g_printerr ("error: couldn't get memory report: '%s'\n",
+                    error ? error->message : "unknown error");
+        exit (EXIT_FAILURE);
+    }
+
+    g_variant_get (result, "(a{sa{st}})", &modems);
+    while (g_variant_iter_next (modems, "{&sa{st}}", &path, &entries)) {
+        const gchar *key;
+        guint64      value;
+
+        g_print ("%s\n", path);
+        while (g_variant_iter_next (entries, "{&st}", &key, &value))
+            g_print ("  %-20s: %" G_GUINT64_FORMAT "\n", key, value);
+        g_variant_iter_free (entries);
+    }
+    g_variant_iter_free (modems);
+    g_variant_unref (result);
+}
+
 #define FOUND_ACTION_PREFIX   "    "
 #define ADDED_ACTION_PREFIX   "(+) "
 #define REMOVED_ACTION_PREFIX "(-) "
@@ -555,6 +603,12 @@ mmcli_manager_run_synchronous (GDBusConnection *connection)
     ctx = g_new0 (Context, 1);
     ctx->manager = mmcli_get_manager_sync (connection);
 
+    /* Report memory usage? */
+    if (report_memory_flag) {
+        report_memory (connection);
+        return;
+    }
+
     /* Get daemon version? */
     if (get_daemon_version_flag) {
         g_print ("ModemManager daemon %s running\n", mm_manager_get_version (ctx->manager));
@@ -22,6 +22,10 @@
 
 QcdmResult *qcdm_result_new (void);
 
+/* Keys are stored by reference and must outlive the result; in practice
+ * they are the ITEM_* string constants from commands.h.
+ */
+
 void qcdm_result_add_string (QcdmResult *result,
                              const char *key,
                              const char *str);
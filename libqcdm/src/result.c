@@ -21,11 +21,10 @@
 #include "result.h"
 #include "result-private.h"
 #include "errors.h"
+#include "utils.h"
 
 /*********************************************************/
 
-typedef struct Val Val;
-
 typedef enum {
     VAL_TYPE_NONE = 0,
     VAL_TYPE_STRING = 1,
@@ -35,8 +34,16 @@ typedef enum {
     VAL_TYPE_U16_ARRAY = 5,
 } ValType;
 
-struct Val {
-    char *key;
+/* Strings up to this length (including the terminator) are stored in the
+ * value slot itself; all the version, ESN, MDN, IMSI and IMEI strings
+ * returned by the modem fit.
+ */
+#define VAL_INLINE_STRING_SIZE 32
+
+typedef struct {
+    /* Keys are the ITEM_* constants from commands.h, and are not copied */
+    const char *key;
+    uint32_t hash;
     uint8_t type;
     union {
         char *s;
@@ -46,140 +53,53 @@ struct Val {
         uint16_t *u16_array;
     } u;
     uint32_t array_len;
-    Val *next;
-};
+    char s_inline[VAL_INLINE_STRING_SIZE];
+} Val;
 
 static void
-val_free (Val *v)
+val_clear (Val *v)
 {
     if (v->type == VAL_TYPE_STRING) {
-        free (v->u.s);
+        if (v->u.s != v->s_inline)
+            free (v->u.s);
     } else if (v->type == VAL_TYPE_U8_ARRAY) {
         free (v->u.u8_array);
     } else if (v->type == VAL_TYPE_U16_ARRAY) {
         free (v->u.u16_array);
     }
-    free (v->key);
-    memset (v, 0, sizeof (*v));
-    free (v);
+    v->type = VAL_TYPE_NONE;
+    memset (&v->u, 0, sizeof (v->u));
+    v->array_len = 0;
 }
 
-static Val *
-val_new_string (const char *key, const char *value)
+/* FNV-1a */
+static uint32_t
+key_hash (const char *key)
 {
-    Val *v;
-
-    qcdm_return_val_if_fail (key != NULL, NULL);
-    qcdm_return_val_if_fail (key[0] != '\0', NULL);
-    qcdm_return_val_if_fail (value != NULL, NULL);
+    uint32_t h = 2166136261u;
 
-    v = calloc (sizeof (Val), 1);
-    if (v == NULL)
-        return NULL;
-
-    v->key = strdup (key);
-    v->type = VAL_TYPE_STRING;
-    v->u.s = strdup (value);
-    return v;
-}
-
-static Val *
-val_new_u8 (const char *key, uint8_t u)
-{
-    Val *v;
-
-    qcdm_return_val_if_fail (key != NULL, NULL);
-    qcdm_return_val_if_fail (key[0] != '\0', NULL);
-
-    v = calloc (sizeof (Val), 1);
-    if (v == NULL)
-        return NULL;
-
-    v->key = strdup (key);
-    v->type = VAL_TYPE_U8;
-    v->u.u8 = u;
-    return v;
-}
-
-static Val *
-val_new_u8_array (const char *key, const uint8_t *array, size_t array_len)
-{
-    Val *v;
-
-    qcdm_return_val_if_fail (key != NULL, NULL);
-    qcdm_return_val_if_fail (key[0] != '\0', NULL);
-    qcdm_return_val_if_fail (array != NULL, NULL);
-    qcdm_return_val_if_fail (array_len > 0, NULL);
-
-    v = calloc (sizeof (Val), 1);
-    if (v == NULL)
-        return NULL;
-
-    v->key = strdup (key);
-    v->type = VAL_TYPE_U8_ARRAY;
-    v->u.u8_array = malloc (array_len);
-    if (v->u.u8_array == NULL) {
-        val_free (v);
-        return NULL;
+    while (*key) {
+        h ^= (uint8_t) *key++;
+        h *= 16777619u;
     }
-    memcpy (v->u.u8_array, array, array_len);
-    v->array_len = array_len;
-
-    return v;
-}
-
-static Val *
-val_new_u32 (const char *key, uint32_t u)
-{
-    Val *v;
-
-    qcdm_return_val_if_fail (key != NULL, NULL);
-    qcdm_return_val_if_fail (key[0] != '\0', NULL);
-
-    v = calloc (sizeof (Val), 1);
-    if (v == NULL)
-        return NULL;
-
-    v->key = strdup (key);
-    v->type = VAL_TYPE_U32;
-    v->u.u32 = u;
-    return v;
-}
-
-static Val *
-val_new_u16_array (const char *key, const uint16_t *array, size_t array_len)
-{
-    Val *v;
-    size_t sz;
-
-    qcdm_return_val_if_fail (key != NULL, NULL);
-    qcdm_return_val_if_fail (key[0] != '\0', NULL);
-    qcdm_return_val_if_fail (array != NULL, NULL);
-    qcdm_return_val_if_fail (array_len > 0, NULL);
-
-    v = calloc (sizeof (Val), 1);
-    if (v == NULL)
-        return NULL;
-
-    v->key = strdup (key);
-    v->type = VAL_TYPE_U16_ARRAY;
-    sz = sizeof (uint16_t) * array_len;
-    v->u.u16_array = malloc (sz);
-    if (v->u.u16_array == NULL) {
-        val_free (v);
-        return NULL;
-    }
-    memcpy (v->u.u16_array, array, sz);
-    v->array_len = array_len;
-
-    return v;
+    return h;
 }
 
 /*********************************************************/
 
+/* Values live in an open-addressed table (linear probing) that starts out
+ * embedded in the result, so parsers adding a handful of values perform a
+ * single allocation for the whole result.  Values are never removed; adding
+ * a key again replaces the previous value.
+ */
+#define RESULT_EMBEDDED_SLOTS 16
+
 struct QcdmResult {
     uint32_t refcount;
-    Val *first;
+    uint32_t n_vals;
+    uint32_t n_slots;
+    Val *slots;
+    Val embedded[RESULT_EMBEDDED_SLOTS];
 };
 
 QcdmResult *
@@ -188,8 +108,11 @@ qcdm_result_new (void)
     QcdmResult *r;
 
     r = calloc (sizeof (QcdmResult), 1);
-    if (r)
+    if (r) {
         r->refcount = 1;
+        r->slots = r->embedded;
+        r->n_slots = RESULT_EMBEDDED_SLOTS;
+    }
     return r;
 }
 
@@ -206,14 +129,14 @@ qcdm_result_ref (QcdmResult *r)
 static void
 qcdm_result_free (QcdmResult *r)
 {
-    Val *v, *n;
+    uint32_t i;
 
-    v = r->first;
-    while (v) {
-        n = v->next;
-        val_free (v);
-        v = n;
+    for (i = 0; i < r->n_slots; i++) {
+        if (r->slots[i].key)
+            val_clear (&r->slots[i]);
     }
+    if (r->slots != r->embedded)
+        free (r->slots);
     memset (r, 0, sizeof (*r));
     free (r);
 }
@@ -229,22 +152,99 @@ qcdm_result_unref (QcdmResult *r)
         qcdm_result_free (r);
 }
 
+/* Returns the slot holding 'key', or the empty slot where it would go */
 static Val *
-find_val (QcdmResult *r, const char *key, ValType expected_type)
+lookup_slot (Val *slots, uint32_t n_slots, const char *key, uint32_t hash)
 {
-    Val *v, *n;
-
-    v = r->first;
-    while (v) {
-        n = v->next;
-        if (strcmp (v->key, key) == 0) {
-            /* Check type */
-            qcdm_return_val_if_fail (v->type == expected_type, NULL);
+    uint32_t mask = n_slots - 1;
+    uint32_t i;
+
+    for (i = hash & mask; ; i = (i + 1) & mask) {
+        Val *v = &slots[i];
+
+        if (v->key == NULL)
             return v;
-        }
-        v = n;
+        /* Callers nearly always pass the same constant used when adding */
+        if (v->key == key || (v->hash == hash && strcmp (v->key, key) == 0))
+            return v;
+    }
+}
+
+static qcdmbool
+grow_slots (QcdmResult *r)
+{
+    Val *slots;
+    uint32_t n_slots, i;
+
+    n_slots = r->n_slots * 2;
+    slots = calloc (sizeof (Val), n_slots);
+    if (slots == NULL)
+        return FALSE;
+
+    for (i = 0; i < r->n_slots; i++) {
+        Val *old = &r->slots[i];
+        Val *v;
+
+        if (old->key == NULL)
+            continue;
+
+        v = lookup_slot (slots, n_slots, old->key, old->hash);
+        memcpy (v, old, sizeof (*v));
+        /* Inline strings must point at their new home */
+        if (old->type == VAL_TYPE_STRING && old->u.s == old->s_inline)
+            v->u.s = v->s_inline;
+    }
+
+    if (r->slots != r->embedded)
+        free (r->slots);
+    r->slots = slots;
+    r->n_slots = n_slots;
+    return TRUE;
+}
+
+/* Returns an empty slot for 'key', clearing any value previously added
+ * with the same key.
+ */
+static Val *
+add_val (QcdmResult *r, const char *key)
+{
+    uint32_t hash;
+    Val *v;
+
+    qcdm_return_val_if_fail (key[0] != '\0', NULL);
+
+    hash = key_hash (key);
+    v = lookup_slot (r->slots, r->n_slots, key, hash);
+    if (v->key) {
+        val_clear (v);
+        return v;
     }
-    return NULL;
+
+    /* Keep the load factor at or below 3/4 */
+    if ((r->n_vals + 1) * 4 > r->n_slots * 3) {
+        if (!grow_slots (r))
+            return NULL;
+        v = lookup_slot (r->slots, r->n_slots, key, hash);
+    }
+
+    v->key = key;
+    v->hash = hash;
+    r->n_vals++;
+    return v;
+}
+
+static Val *
+find_val (QcdmResult *r, const char *key, ValType expected_type)
+{
+    Val *v;
+
+    v = lookup_slot (r->slots, r->n_slots, key, key_hash (key));
+    if (v->key == NULL)
+        return NULL;
+
+    /* Check type */
+    qcdm_return_val_if_fail (v->type == expected_type, NULL);
+    return v;
 }
 
 void
@@ -253,16 +253,28 @@ qcdm_result_add_string (QcdmResult *r,
                        const char *str)
 {
     Val *v;
+    size_t len;
 
     qcdm_return_if_fail (r != NULL);
     qcdm_return_if_fail (r->refcount > 0);
     qcdm_return_if_fail (key != NULL);
     qcdm_return_if_fail (str != NULL);
 
-    v = val_new_string (key, str);
+    v = add_val (r, key);
     qcdm_return_if_fail (v != NULL);
-    v->next = r->first;
-    r->first = v;
+
+    v->type = VAL_TYPE_STRING;
+    len = strlen (str) + 1;
+    if (len <= sizeof (v->s_inline))
+        v->u.s = v->s_inline;
+    else {
+        v->u.s = malloc (len);
+        if (v->u.s == NULL) {
+            v->type = VAL_TYPE_NONE;
+            return;
+        }
+    }
+    memcpy (v->u.s, str, len);
 }
 
 int
@@ -297,10 +309,11 @@ qcdm_result_add_u8 (QcdmResult *r,
     qcdm_return_if_fail (r->refcount > 0);
     qcdm_return_if_fail (key != NULL);
 
-    v = val_new_u8 (key, num);
+    v = add_val (r, key);
     qcdm_return_if_fail (v != NULL);
-    v->next = r->first;
-    r->first = v;
+
+    v->type = VAL_TYPE_U8;
+    v->u.u8 = num;
 }
 
 int
@@ -336,10 +349,16 @@ qcdm_result_add_u8_array (QcdmResult *r,
     qcdm_return_if_fail (key != NULL);
     qcdm_return_if_fail (array != NULL);
 
-    v = val_new_u8_array (key, array, array_len);
+    qcdm_return_if_fail (array_len > 0);
+
+    v = add_val (r, key);
     qcdm_return_if_fail (v != NULL);
-    v->next = r->first;
-    r->first = v;
+
+    v->u.u8_array = malloc (array_len);
+    qcdm_return_if_fail (v->u.u8_array != NULL);
+    memcpy (v->u.u8_array, array, array_len);
+    v->array_len = array_len;
+    v->type = VAL_TYPE_U8_ARRAY;
 }
 
 int
@@ -376,10 +395,11 @@ qcdm_result_add_u32 (QcdmResult *r,
     qcdm_return_if_fail (r->refcount > 0);
     qcdm_return_if_fail (key != NULL);
 
-    v = val_new_u32 (key, num);
+    v = add_val (r, key);
     qcdm_return_if_fail (v != NULL);
-    v->next = r->first;
-    r->first = v;
+
+    v->type = VAL_TYPE_U32;
+    v->u.u32 = num;
 }
 
 int
@@ -415,10 +435,16 @@ qcdm_result_add_u16_array (QcdmResult *r,
     qcdm_return_if_fail (key != NULL);
     qcdm_return_if_fail (array != NULL);
 
-    v = val_new_u16_array (key, array, array_len);
+    qcdm_return_if_fail (array_len > 0);
+
+    v = add_val (r, key);
     qcdm_return_if_fail (v != NULL);
-    v->next = r->first;
-    r->first = v;
+
+    v->u.u16_array = malloc (sizeof (uint16_t) * array_len);
+    qcdm_return_if_fail (v->u.u16_array != NULL);
+    memcpy (v->u.u16_array, array, sizeof (uint16_t) * array_len);
+    v->array_len = array_len;
+    v->type = VAL_TYPE_U16_ARRAY;
 }
 
 int
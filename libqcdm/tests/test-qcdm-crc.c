@@ -63,3 +63,67 @@ test_crc16_1 (void *f, void *data)
     g_assert (crc == expected);
 }
 
+
+/* Bitwise CRC-16 (polynomial 0x8408, seed 0xffff), independent of the lookup
+ * tables used by dm_crc16().
+ */
+static guint16
+reference_crc16 (const char *buffer, gsize len)
+{
+    guint16 crc = 0xffff;
+    guint i;
+
+    while (len--) {
+        crc ^= (guint8) *buffer++;
+        for (i = 0; i < 8; i++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0x8408 : (crc >> 1);
+    }
+    return ~crc;
+}
+
+void
+test_crc16_random (void *f, void *data)
+{
+    char buf[1030];
+    gsize i, offset, len;
+
+    for (i = 0; i < sizeof (buf); i++)
+        buf[i] = (char) g_random_int_range (0, 256);
+
+    /* All lengths and alignments, to exercise the tail handling */
+    for (offset = 0; offset < 4; offset++) {
+        for (len = 0; len <= sizeof (buf) - offset; len++)
+            g_assert_cmpuint (dm_crc16 (buf + offset, len), ==, reference_crc16 (buf + offset, len));
+    }
+}
+
+#define BENCHMARK_BUFFER_SIZE (1024 * 1024)
+#define BENCHMARK_ROUNDS      50
+
+void
+test_crc16_benchmark (void *f, void *data)
+{
+    char *buf;
+    GTimer *timer;
+    gdouble secs;
+    guint16 crc = 0;
+    gsize i;
+
+    if (!g_test_perf ())
+        return;
+
+    buf = g_malloc (BENCHMARK_BUFFER_SIZE);
+    for (i = 0; i < BENCHMARK_BUFFER_SIZE; i++)
+        buf[i] = (char) g_random_int_range (0, 256);
+
+    timer = g_timer_new ();
+    for (i = 0; i < BENCHMARK_ROUNDS; i++)
+        crc = dm_crc16 (buf, BENCHMARK_BUFFER_SIZE);
+    secs = g_timer_elapsed (timer, NULL);
+
+    g_test_message ("crc16: %.1f MB/s (checksum 0x%04x)", BENCHMARK_ROUNDS / secs, crc);
+    g_test_maximized_result (BENCHMARK_ROUNDS / secs, "crc16 MB/s");
+
+    g_timer_destroy (timer);
+    g_free (buf);
+}
@@ -122,3 +122,150 @@ test_escape_unescape (void *f, void *data)
     g_assert (memcmp (unescaped, data1, unlen) == 0);
 }
 
+
+/* Straightforward byte-at-a-time escaping, used as the reference the fast
+ * path in dm_escape() is checked against.
+ */
+static gsize
+reference_escape (const char *inbuf, gsize inbuf_len, char *outbuf)
+{
+    gsize i, len = 0;
+
+    for (i = 0; i < inbuf_len; i++) {
+        if (inbuf[i] == 0x7E || inbuf[i] == 0x7D) {
+            outbuf[len++] = 0x7D;
+            outbuf[len++] = inbuf[i] ^ 0x20;
+        } else
+            outbuf[len++] = inbuf[i];
+    }
+    return len;
+}
+
+static void
+fill_random (char *buf, gsize len, guint special_percent)
+{
+    gsize i;
+
+    for (i = 0; i < len; i++) {
+        if (g_random_int_range (0, 100) < (gint) special_percent)
+            buf[i] = g_random_boolean () ? 0x7E : 0x7D;
+        else
+            buf[i] = (char) g_random_int_range (0, 256);
+    }
+}
+
+void
+test_escape_random (void *f, void *data)
+{
+    char inbuf[300];
+    char expected[600];
+    char escaped[601];
+    char unescaped[601];
+    guint i;
+
+    /* Cover all run lengths around the word size and a range of densities
+     * of characters needing escaping, including none and all.
+     */
+    for (i = 0; i < 5000; i++) {
+        gsize len, explen, esclen, unlen;
+        qcdmbool escaping = FALSE;
+
+        len = g_random_int_range (1, sizeof (inbuf) + 1);
+        fill_random (inbuf, len, (i % 5) * 25);
+
+        explen = reference_escape (inbuf, len, expected);
+        esclen = dm_escape (inbuf, len, escaped, sizeof (escaped));
+        g_assert_cmpuint (esclen, ==, explen);
+        g_assert (memcmp (escaped, expected, esclen) == 0);
+
+        /* Output buffer one byte short of escaped data + control char */
+        if (explen > len)
+            g_assert_cmpuint (dm_escape (inbuf, len, escaped, explen), ==, 0);
+        g_assert_cmpuint (dm_escape (inbuf, len, escaped, explen + 1), ==, explen);
+
+        unlen = dm_unescape (escaped, esclen, unescaped, sizeof (unescaped), &escaping);
+        g_assert_cmpuint (unlen, ==, len);
+        g_assert (escaping == FALSE);
+        g_assert (memcmp (unescaped, inbuf, len) == 0);
+    }
+}
+
+void
+test_unescape_split (void *f, void *data)
+{
+    char inbuf[200];
+    char escaped[401];
+    char unescaped[401];
+    gsize len, esclen, split;
+
+    /* Unescaping must carry a trailing escape character over to the next
+     * chunk regardless of where the data is split.
+     */
+    fill_random (inbuf, sizeof (inbuf), 30);
+    esclen = dm_escape (inbuf, sizeof (inbuf), escaped, sizeof (escaped));
+    g_assert_cmpuint (esclen, >, sizeof (inbuf));
+
+    for (split = 1; split < esclen; split++) {
+        qcdmbool escaping = FALSE;
+
+        len = dm_unescape (escaped, split, unescaped, sizeof (unescaped), &escaping);
+        len += dm_unescape (escaped + split, esclen - split, unescaped + len, sizeof (unescaped) - len, &escaping);
+        g_assert_cmpuint (len, ==, sizeof (inbuf));
+        g_assert (escaping == FALSE);
+        g_assert (memcmp (unescaped, inbuf, len) == 0);
+    }
+}
+
+#define BENCHMARK_BUFFER_SIZE (1024 * 1024)
+#define BENCHMARK_ROUNDS      50
+
+void
+test_escape_benchmark (void *f, void *data)
+{
+    char *inbuf, *escaped, *unescaped;
+    gsize esclen = 0, unlen = 0, explen = 0;
+    GTimer *timer;
+    gdouble escape_secs, unescape_secs, reference_secs;
+    guint i;
+
+    if (!g_test_perf ())
+        return;
+
+    /* Log payloads mostly carry a small share of bytes needing escaping */
+    inbuf = g_malloc (BENCHMARK_BUFFER_SIZE);
+    escaped = g_malloc (BENCHMARK_BUFFER_SIZE * 2 + 1);
+    unescaped = g_malloc (BENCHMARK_BUFFER_SIZE * 2 + 1);
+    fill_random (inbuf, BENCHMARK_BUFFER_SIZE, 1);
+
+    timer = g_timer_new ();
+    for (i = 0; i < BENCHMARK_ROUNDS; i++)
+        explen = reference_escape (inbuf, BENCHMARK_BUFFER_SIZE, unescaped);
+    reference_secs = g_timer_elapsed (timer, NULL);
+
+    g_timer_start (timer);
+    for (i = 0; i < BENCHMARK_ROUNDS; i++)
+        esclen = dm_escape (inbuf, BENCHMARK_BUFFER_SIZE, escaped, BENCHMARK_BUFFER_SIZE * 2 + 1);
+    escape_secs = g_timer_elapsed (timer, NULL);
+    g_assert_cmpuint (esclen, ==, explen);
+
+    g_timer_start (timer);
+    for (i = 0; i < BENCHMARK_ROUNDS; i++) {
+        qcdmbool escaping = FALSE;
+
+        unlen = dm_unescape (escaped, esclen, unescaped, BENCHMARK_BUFFER_SIZE * 2 + 1, &escaping);
+    }
+    unescape_secs = g_timer_elapsed (timer, NULL);
+    g_assert_cmpuint (unlen, ==, BENCHMARK_BUFFER_SIZE);
+    g_assert (memcmp (unescaped, inbuf, unlen) == 0);
+
+    g_test_message ("escape: %.1f MB/s (byte-at-a-time reference: %.1f MB/s)",
+                    BENCHMARK_ROUNDS / escape_secs,
+                    BENCHMARK_ROUNDS / reference_secs);
+    g_test_message ("unescape: %.1f MB/s", BENCHMARK_ROUNDS / unescape_secs);
+    g_test_maximized_result (BENCHMARK_ROUNDS / escape_secs, "escape MB/s");
+
+    g_timer_destroy (timer);
+    g_free (inbuf);
+    g_free (escaped);
+    g_free (unescaped);
+}
@@ -21,6 +21,7 @@
 #include "test-qcdm-result.h"
 #include "result.h"
 #include "result-private.h"
+#include "errors.h"
 
 #define TEST_TAG "test"
 
@@ -90,3 +91,105 @@ test_result_uint8_array (void *f, void *data)
 
     qcdm_result_unref (result);
 }
+
+#define NUM_KEYS 64
+
+static char keys[NUM_KEYS][16];
+
+static void
+setup_keys (void)
+{
+    guint i;
+
+    for (i = 0; i < NUM_KEYS; i++)
+        g_snprintf (keys[i], sizeof (keys[i]), "key-%u", i);
+}
+
+void
+test_result_many_keys (void *f, void *data)
+{
+    const char *long_str = "a string too long to be stored inline with the value";
+    QcdmResult *result;
+    char lookup[16];
+    guint32 missing = 0;
+    guint i;
+
+    setup_keys ();
+
+    /* Enough keys to outgrow the initial value table */
+    result = qcdm_result_new ();
+    for (i = 0; i < NUM_KEYS; i++) {
+        if (i % 2)
+            qcdm_result_add_u32 (result, keys[i], i);
+        else
+            qcdm_result_add_string (result, keys[i], (i % 4) ? keys[i] : long_str);
+    }
+
+    /* Adding a key again replaces its value */
+    qcdm_result_add_u32 (result, keys[1], 0xDEADBEEF);
+
+    for (i = 0; i < NUM_KEYS; i++) {
+        /* Look up using a different pointer than the one the key was added with */
+        g_snprintf (lookup, sizeof (lookup), "key-%u", i);
+
+        if (i % 2) {
+            guint32 tmp = 0;
+
+            g_assert_cmpint (qcdm_result_get_u32 (result, lookup, &tmp), ==, 0);
+            g_assert_cmpuint (tmp, ==, i == 1 ? 0xDEADBEEF : i);
+        } else {
+            const char *tmp = NULL;
+
+            g_assert_cmpint (qcdm_result_get_string (result, lookup, &tmp), ==, 0);
+            g_assert_cmpstr (tmp, ==, (i % 4) ? keys[i] : long_str);
+        }
+    }
+
+    g_assert_cmpint (qcdm_result_get_u32 (result, "missing", &missing), ==, -QCDM_ERROR_VALUE_NOT_FOUND);
+
+    qcdm_result_unref (result);
+}
+
+#define BENCHMARK_ROUNDS 100000
+
+void
+test_result_benchmark (void *f, void *data)
+{
+    GTimer *timer;
+    guint n_keys, i, j;
+
+    if (!g_test_perf ())
+        return;
+
+    setup_keys ();
+    timer = g_timer_new ();
+
+    /* Build a result and read back every value, as consumers of the
+     * command results do.
+     */
+    for (n_keys = 4; n_keys <= NUM_KEYS; n_keys *= 2) {
+        gdouble secs;
+
+        g_timer_start (timer);
+        for (i = 0; i < BENCHMARK_ROUNDS; i++) {
+            QcdmResult *result;
+
+            result = qcdm_result_new ();
+            for (j = 0; j < n_keys; j++)
+                qcdm_result_add_u32 (result, keys[j], j);
+            for (j = 0; j < n_keys; j++) {
+                guint32 tmp = 0;
+
+                qcdm_result_get_u32 (result, keys[j], &tmp);
+                g_assert (tmp == j);
+            }
+            qcdm_result_unref (result);
+        }
+        secs = g_timer_elapsed (timer, NULL);
+
+        g_test_message ("%u keys: %.1f ns per add+get",
+                        n_keys, secs * 1e9 / (BENCHMARK_ROUNDS * n_keys));
+    }
+
+    g_timer_destroy (timer);
+}
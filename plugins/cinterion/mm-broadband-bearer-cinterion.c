@@ -31,6 +31,19 @@
 
 G_DEFINE_TYPE (MMBroadbandBearerCinterion, mm_broadband_bearer_cinterion, MM_TYPE_BROADBAND_BEARER)
 
+struct _MMBroadbandBearerCinterionPrivate {
+    /* URCs reporting connection progress for the CID being dialed, only
+     * listened to while dialing */
+    GRegex         *swwan_regex;
+    GRegex         *cgev_act_regex;
+    MMPortSerialAt *urc_ports[2];
+    /* Dial operation waiting for the reports, if any (not a full reference) */
+    GTask *dial_task;
+    guint  dial_cid;
+    /* Time taken by the successful dial attempts */
+    MMCinterionConnectStats connect_stats;
+};
+
 /*****************************************************************************/
 /* WWAN interface mapping */
 
@@ -75,6 +88,111 @@ get_usb_interface_config_index (MMPort  *data,
     return -1;
 }
 
+/*****************************************************************************/
+/* ^SWWAN reports shared by all bearers in the modem
+ *
+ * The ^SWWAN URC and the lines in a ^SWWAN? reply have the same format, and
+ * the AT ports are shared by all bearers; so while any ^SWWAN? query is in
+ * flight, the dial URC handlers are disabled so that they don't consume the
+ * query reply. Instead, the reply is also given to the ongoing dials.
+ */
+
+#define SWWAN_SHARED_TAG "cinterion-swwan-shared-tag"
+static GQuark swwan_shared_quark;
+
+typedef struct {
+    guint   n_status_queries;
+    /* Bearers listening to dial reports, not full references */
+    GSList *dialing;
+} SwwanShared;
+
+static void
+swwan_shared_free (SwwanShared *shared)
+{
+    g_assert (!shared->dialing);
+    g_slice_free (SwwanShared, shared);
+}
+
+static SwwanShared *
+get_swwan_shared (MMBaseModem *modem)
+{
+    SwwanShared *shared;
+
+    if (G_UNLIKELY (!swwan_shared_quark))
+        swwan_shared_quark = g_quark_from_static_string (SWWAN_SHARED_TAG);
+
+    shared = g_object_get_qdata (G_OBJECT (modem), swwan_shared_quark);
+    if (!shared) {
+        shared = g_slice_new0 (SwwanShared);
+        g_object_set_qdata_full (G_OBJECT (modem), swwan_shared_quark, shared, (GDestroyNotify)swwan_shared_free);
+    }
+    return shared;
+}
+
+static void
+dial_urc_handlers_enable (MMBroadbandBearerCinterion *self,
+                          gboolean                    enable)
+{
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS (self->priv->urc_ports); i++) {
+        if (!self->priv->urc_ports[i])
+            continue;
+        mm_port_serial_at_enable_unsolicited_msg_handler (self->priv->urc_ports[i], self->priv->swwan_regex, enable);
+        mm_port_serial_at_enable_unsolicited_msg_handler (self->priv->urc_ports[i], self->priv->cgev_act_regex, enable);
+    }
+}
+
+static void
+swwan_shared_enable_dial_urc_handlers (SwwanShared *shared,
+                                       gboolean     enable)
+{
+    GSList *l;
+
+    for (l = shared->dialing; l; l = g_slist_next (l))
+        dial_urc_handlers_enable (MM_BROADBAND_BEARER_CINTERION (l->data), enable);
+}
+
+static void dial_report_connected (MMBroadbandBearerCinterion *self,
+                                   const gchar                *source);
+
+static void
+swwan_status_query_started (MMBaseModem *modem)
+{
+    SwwanShared *shared;
+
+    shared = get_swwan_shared (modem);
+    if (shared->n_status_queries++ == 0)
+        swwan_shared_enable_dial_urc_handlers (shared, FALSE);
+}
+
+static void
+swwan_status_query_finished (MMBaseModem *modem,
+                             const gchar *response)
+{
+    SwwanShared *shared;
+    GSList      *dialing;
+    GSList      *l;
+
+    shared = get_swwan_shared (modem);
+    g_assert (shared->n_status_queries > 0);
+    shared->n_status_queries--;
+
+    /* Reports for the ongoing dials may have been received as part of the
+     * reply; completing a dial removes it from the shared list */
+    dialing = g_slist_copy (shared->dialing);
+    for (l = dialing; response && l; l = g_slist_next (l)) {
+        MMBroadbandBearerCinterion *self = l->data;
+
+        if (mm_cinterion_parse_swwan_response (response, self->priv->dial_cid, NULL) == MM_BEARER_CONNECTION_STATUS_CONNECTED)
+            dial_report_connected (self, "^SWWAN?");
+    }
+    g_slist_free (dialing);
+
+    if (shared->n_status_queries == 0)
+        swwan_shared_enable_dial_urc_handlers (shared, TRUE);
+}
+
 /*****************************************************************************/
 /* Connection status loading
  * NOTE: only CONNECTED or DISCONNECTED should be reported here.
@@ -109,6 +227,7 @@ swwan_check_status_ready (MMBaseModem  *modem,
     cid = GPOINTER_TO_UINT (g_task_get_task_data (task));
 
     response = mm_base_modem_at_command_finish (modem, res, &error);
+    swwan_status_query_finished (modem, response);
     if (!response) {
         g_task_return_error (task, error);
         goto out;
@@ -144,6 +263,7 @@ load_connection_status_by_cid (MMBroadbandBearerCinterion *bearer,
                   MM_BASE_BEARER_MODEM, &modem,
                   NULL);
 
+    swwan_status_query_started (modem);
     mm_base_modem_at_command (modem,
                               "^SWWAN?",
                               5,
@@ -252,11 +372,17 @@ typedef struct {
     MMPort                     *data;
     gint                        usb_interface_config_index;
     Dial3gppContextStep         step;
+    GTimer                     *timer;
+    gboolean                    pdn_activated;
 } Dial3gppContext;
 
+static void dial_urc_handlers_remove (MMBroadbandBearerCinterion *self);
+
 static void
 dial_3gpp_context_free (Dial3gppContext *ctx)
 {
+    dial_urc_handlers_remove (ctx->self);
+    g_timer_destroy (ctx->timer);
     g_object_unref (ctx->modem);
     g_object_unref (ctx->self);
     g_object_unref (ctx->primary);
@@ -327,6 +453,193 @@ common_dial_operation_ready (MMBaseModem  *modem,
     dial_3gpp_context_step (task);
 }
 
+static void dial_urc_handlers_stop (MMBroadbandBearerCinterion *self);
+
+static void
+swwan_dial_ready (MMBaseModem  *modem,
+                  GAsyncResult *res,
+                  GTask        *task)
+{
+    Dial3gppContext *ctx;
+    GError          *error = NULL;
+
+    ctx = (Dial3gppContext *) g_task_get_task_data (task);
+
+    mm_base_modem_at_command_full_finish (modem, res, &error);
+
+    /* Connection already reported via URC? Then the dial operation has already
+     * completed and we just drop the reference we got */
+    if (ctx->step != DIAL_3GPP_CONTEXT_STEP_START_SWWAN) {
+        if (error) {
+            mm_dbg ("^SWWAN=1 failed after connection was already reported: %s", error->message);
+            g_error_free (error);
+        }
+        g_object_unref (task);
+        return;
+    }
+
+    /* Stop listening, the ^SWWAN? validation takes over */
+    dial_urc_handlers_stop (ctx->self);
+    g_object_unref (task);
+
+    if (error) {
+        g_task_return_error (task, error);
+        g_object_unref (task);
+        return;
+    }
+
+    /* If the PDN activation was already reported for our CID, the OK is enough
+     * and we can skip the explicit status check */
+    ctx->step++;
+    if (ctx->pdn_activated) {
+        mm_dbg ("PDN activation already reported for CID %u, skipping ^SWWAN validation", ctx->cid);
+        ctx->step++;
+    }
+    dial_3gpp_context_step (task);
+}
+
+static void
+dial_report_connected (MMBroadbandBearerCinterion *self,
+                       const gchar                *source)
+{
+    GTask           *task;
+    Dial3gppContext *ctx;
+
+    task = self->priv->dial_task;
+    g_assert (task);
+    ctx = (Dial3gppContext *) g_task_get_task_data (task);
+
+    mm_dbg ("SWWAN connection for CID %u reported via %s", ctx->cid, source);
+    dial_urc_handlers_stop (self);
+
+    /* The ^SWWAN=1 reply callback holds its own reference and will just drop it */
+    ctx->step = DIAL_3GPP_CONTEXT_STEP_LAST;
+    dial_3gpp_context_step (task);
+}
+
+static void
+swwan_received (MMPortSerialAt             *port,
+                GMatchInfo                 *match_info,
+                MMBroadbandBearerCinterion *self)
+{
+    /* Only CONNECTED reports for the CID being dialed are matched;
+     * disconnections while dialing are left to the ^SWWAN=1 reply */
+    if (self->priv->dial_task)
+        dial_report_connected (self, "^SWWAN");
+}
+
+static void
+cgev_act_received (MMPortSerialAt             *port,
+                   GMatchInfo                 *match_info,
+                   MMBroadbandBearerCinterion *self)
+{
+    Dial3gppContext *ctx;
+
+    if (!self->priv->dial_task)
+        return;
+
+    ctx = (Dial3gppContext *) g_task_get_task_data (self->priv->dial_task);
+    mm_dbg ("PDN context activated for CID %u", ctx->cid);
+    ctx->pdn_activated = TRUE;
+}
+
+static void
+dial_urc_handlers_start (Dial3gppContext *ctx,
+                         GTask           *task)
+{
+    MMBroadbandBearerCinterion *self = ctx->self;
+    SwwanShared                *shared;
+    guint                       i;
+
+    g_assert (!self->priv->dial_task);
+    g_assert (!self->priv->swwan_regex && !self->priv->cgev_act_regex);
+
+    self->priv->swwan_regex    = mm_cinterion_get_swwan_connected_regex (ctx->cid);
+    self->priv->cgev_act_regex = mm_cinterion_get_cgev_pdn_act_regex (ctx->cid);
+    self->priv->urc_ports[0]   = g_object_ref (ctx->primary);
+    self->priv->urc_ports[1]   = mm_base_modem_get_port_secondary (ctx->modem);
+
+    for (i = 0; i < G_N_ELEMENTS (self->priv->urc_ports); i++) {
+        if (!self->priv->urc_ports[i])
+            continue;
+        mm_port_serial_at_add_unsolicited_msg_handler (
+            self->priv->urc_ports[i],
+            self->priv->swwan_regex,
+            (MMPortSerialAtUnsolicitedMsgFn) swwan_received,
+            self,
+            NULL);
+        mm_port_serial_at_add_unsolicited_msg_handler (
+            self->priv->urc_ports[i],
+            self->priv->cgev_act_regex,
+            (MMPortSerialAtUnsolicitedMsgFn) cgev_act_received,
+            self,
+            NULL);
+    }
+
+    self->priv->dial_task = task;
+    self->priv->dial_cid  = ctx->cid;
+
+    /* Not while another bearer is querying the status */
+    shared = get_swwan_shared (ctx->modem);
+    shared->dialing = g_slist_prepend (shared->dialing, self);
+    if (shared->n_status_queries > 0)
+        dial_urc_handlers_enable (self, FALSE);
+}
+
+/* Stop processing reports; this may run from within the URC handlers, so the
+ * handlers are just disabled here, and removed afterwards */
+static void
+dial_urc_handlers_stop (MMBroadbandBearerCinterion *self)
+{
+    MMBaseModem *modem = NULL;
+
+    if (!self->priv->dial_task)
+        return;
+
+    dial_urc_handlers_enable (self, FALSE);
+    self->priv->dial_task = NULL;
+
+    g_object_get (self,
+                  MM_BASE_BEARER_MODEM, &modem,
+                  NULL);
+    if (modem) {
+        SwwanShared *shared;
+
+        shared = get_swwan_shared (modem);
+        shared->dialing = g_slist_remove (shared->dialing, self);
+        g_object_unref (modem);
+    }
+}
+
+static void
+dial_urc_handlers_remove (MMBroadbandBearerCinterion *self)
+{
+    guint i;
+
+    dial_urc_handlers_stop (self);
+
+    for (i = 0; i < G_N_ELEMENTS (self->priv->urc_ports); i++) {
+        if (!self->priv->urc_ports[i])
+            continue;
+        /* Clear the callbacks, and keep the handlers disabled so that the
+         * reports are not consumed any more */
+        mm_port_serial_at_add_unsolicited_msg_handler (self->priv->urc_ports[i], self->priv->swwan_regex, NULL, NULL, NULL);
+        mm_port_serial_at_add_unsolicited_msg_handler (self->priv->urc_ports[i], self->priv->cgev_act_regex, NULL, NULL, NULL);
+        mm_port_serial_at_enable_unsolicited_msg_handler (self->priv->urc_ports[i], self->priv->swwan_regex, FALSE);
+        mm_port_serial_at_enable_unsolicited_msg_handler (self->priv->urc_ports[i], self->priv->cgev_act_regex, FALSE);
+        g_clear_object (&self->priv->urc_ports[i]);
+    }
+
+    if (self->priv->swwan_regex) {
+        g_regex_unref (self->priv->swwan_regex);
+        self->priv->swwan_regex = NULL;
+    }
+    if (self->priv->cgev_act_regex) {
+        g_regex_unref (self->priv->cgev_act_regex);
+        self->priv->cgev_act_regex = NULL;
+    }
+}
+
 static void
 handle_cancel_dial (GTask *task)
 {
@@ -424,6 +737,11 @@ dial_3gpp_context_step (GTask *task)
         command = g_strdup_printf ("^SWWAN=1,%u,%u",
                                    ctx->cid,
                                    usb_interface_configs[ctx->usb_interface_config_index].swwan_index);
+
+        /* The connection may be reported via URC before the command reply
+         * arrives; listen to those while the command is in flight. */
+        dial_urc_handlers_start (ctx, task);
+
         mm_base_modem_at_command_full (ctx->modem,
                                        ctx->primary,
                                        command,
@@ -431,8 +749,8 @@ dial_3gpp_context_step (GTask *task)
                                        FALSE,
                                        FALSE,
                                        NULL,
-                                       (GAsyncReadyCallback) common_dial_operation_ready,
-                                       task);
+                                       (GAsyncReadyCallback) swwan_dial_ready,
+                                       g_object_ref (task));
         g_free (command);
         return;
     }
@@ -446,12 +764,19 @@ dial_3gpp_context_step (GTask *task)
                                        task);
         return;
 
-    case DIAL_3GPP_CONTEXT_STEP_LAST:
-        mm_dbg ("cinterion dial step %u/%u: finished", ctx->step, DIAL_3GPP_CONTEXT_STEP_LAST);
+    case DIAL_3GPP_CONTEXT_STEP_LAST: {
+        MMCinterionConnectStats *stats;
+
+        stats = &ctx->self->priv->connect_stats;
+        mm_cinterion_connect_stats_add (stats, g_timer_elapsed (ctx->timer, NULL));
+        mm_dbg ("cinterion dial step %u/%u: finished in %.3lfs (avg %.3lfs, min %.3lfs, max %.3lfs, %u connections)",
+                ctx->step, DIAL_3GPP_CONTEXT_STEP_LAST,
+                stats->last, mm_cinterion_connect_stats_get_avg (stats), stats->min, stats->max, stats->n_connects);
         g_task_return_pointer (task, g_object_ref (ctx->data), g_object_unref);
         g_object_unref (task);
         return;
     }
+    }
 }
 
 static void
@@ -480,6 +805,7 @@ dial_3gpp (MMBroadbandBearer   *self,
     ctx->primary = g_object_ref (primary);
     ctx->cid     = cid;
     ctx->step    = DIAL_3GPP_CONTEXT_STEP_FIRST;
+    ctx->timer   = g_timer_new ();
 
     /* Get a net port to setup the connection on */
     ctx->data = mm_base_modem_peek_best_data_port (MM_BASE_MODEM (modem), MM_PORT_TYPE_NET);
@@ -732,14 +1058,33 @@ mm_broadband_bearer_cinterion_new (MMBroadbandModemCinterion *modem,
 static void
 mm_broadband_bearer_cinterion_init (MMBroadbandBearerCinterion *self)
 {
+    /* Initialize private data */
+    self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self,
+                                              MM_TYPE_BROADBAND_BEARER_CINTERION,
+                                              MMBroadbandBearerCinterionPrivate);
+}
+
+static void
+dispose (GObject *object)
+{
+    MMBroadbandBearerCinterion *self = MM_BROADBAND_BEARER_CINTERION (object);
+
+    dial_urc_handlers_remove (self);
+
+    G_OBJECT_CLASS (mm_broadband_bearer_cinterion_parent_class)->dispose (object);
 }
 
 static void
 mm_broadband_bearer_cinterion_class_init (MMBroadbandBearerCinterionClass *klass)
 {
+    GObjectClass           *object_class           = G_OBJECT_CLASS            (klass);
     MMBaseBearerClass      *base_bearer_class      = MM_BASE_BEARER_CLASS      (klass);
     MMBroadbandBearerClass *broadband_bearer_class = MM_BROADBAND_BEARER_CLASS (klass);
 
+    g_type_class_add_private (object_class, sizeof (MMBroadbandBearerCinterionPrivate));
+
+    object_class->dispose = dispose;
+
     base_bearer_class->load_connection_status        = load_connection_status;
     base_bearer_class->load_connection_status_finish = load_connection_status_finish;
 
@@ -558,6 +558,65 @@ mm_cinterion_parse_swwan_response (const gchar  *response,
     return status;
 }
 
+/*****************************************************************************/
+/* Dial progress URCs
+ *
+ * Only the reports for the given CID are matched, as the AT ports and
+ * the URC handlers in them are shared by all bearers of the modem. Note that
+ * the lines in a ^SWWAN? reply have the same format as the ^SWWAN URC, so the
+ * ^SWWAN regex must not be enabled while a ^SWWAN? query is in flight.
+ */
+
+GRegex *
+mm_cinterion_get_swwan_connected_regex (guint cid)
+{
+    gchar  *pattern;
+    GRegex *r;
+
+    pattern = g_strdup_printf ("\\r\\n\\^SWWAN:\\s*%u\\s*,\\s*%u(?:\\s*,\\s*\\d+)?\\r\\n",
+                               cid, MM_SWWAN_STATE_CONNECTED);
+    r = g_regex_new (pattern, G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    g_assert (r != NULL);
+    g_free (pattern);
+    return r;
+}
+
+GRegex *
+mm_cinterion_get_cgev_pdn_act_regex (guint cid)
+{
+    gchar  *pattern;
+    GRegex *r;
+
+    pattern = g_strdup_printf ("\\r\\n\\+CGEV:\\s*(?:NW|ME) PDN ACT\\s*%u(?:\\s*,[^\\r\\n]*)?\\r\\n",
+                               cid);
+    r = g_regex_new (pattern, G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    g_assert (r != NULL);
+    g_free (pattern);
+    return r;
+}
+
+/*****************************************************************************/
+/* Connection time statistics */
+
+void
+mm_cinterion_connect_stats_add (MMCinterionConnectStats *stats,
+                                gdouble                  elapsed)
+{
+    if (stats->n_connects == 0 || elapsed < stats->min)
+        stats->min = elapsed;
+    if (stats->n_connects == 0 || elapsed > stats->max)
+        stats->max = elapsed;
+    stats->last = elapsed;
+    stats->total += elapsed;
+    stats->n_connects++;
+}
+
+gdouble
+mm_cinterion_connect_stats_get_avg (const MMCinterionConnectStats *stats)
+{
+    return (stats->n_connects ? stats->total / stats->n_connects : 0.0);
+}
+
 /*****************************************************************************/
 /* ^SMONG response parser */
 
@@ -75,6 +75,27 @@ MMBearerConnectionStatus mm_cinterion_parse_swwan_response (const gchar  *respon
                                                             guint         swwan_index,
                                                             GError      **error);
 
+/*****************************************************************************/
+/* Dial progress URCs, for a single CID */
+
+GRegex *mm_cinterion_get_swwan_connected_regex (guint cid);
+GRegex *mm_cinterion_get_cgev_pdn_act_regex    (guint cid);
+
+/*****************************************************************************/
+/* Connection time statistics */
+
+typedef struct {
+    guint   n_connects;
+    gdouble last;
+    gdouble min;
+    gdouble max;
+    gdouble total;
+} MMCinterionConnectStats;
+
+void    mm_cinterion_connect_stats_add     (MMCinterionConnectStats       *stats,
+                                            gdouble                        elapsed);
+gdouble mm_cinterion_connect_stats_get_avg (const MMCinterionConnectStats *stats);
+
 /*****************************************************************************/
 /* ^SMONG response parser */
 
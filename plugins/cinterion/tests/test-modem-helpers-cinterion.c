@@ -667,6 +667,149 @@ test_smong_response_other (void)
     common_test_smong_response (response, MM_MODEM_ACCESS_TECHNOLOGY_GPRS);
 }
 
+/*****************************************************************************/
+/* Test dial progress URCs */
+
+/* Process the URCs in the buffer the same way the AT port does: run the
+ * handler for every match, then remove all matches from the buffer */
+static guint
+process_urcs (GRegex  *r,
+              GString *buffer)
+{
+    GMatchInfo *match_info;
+    guint       n_matches = 0;
+    gchar      *str;
+
+    g_regex_match (r, buffer->str, 0, &match_info);
+    while (g_match_info_matches (match_info)) {
+        n_matches++;
+        g_match_info_next (match_info, NULL);
+    }
+    g_match_info_free (match_info);
+
+    str = g_regex_replace_literal (r, buffer->str, -1, 0, "", 0, NULL);
+    g_string_assign (buffer, str);
+    g_free (str);
+
+    return n_matches;
+}
+
+typedef struct {
+    const gchar *str;
+    guint        n_matches;
+    const gchar *remaining;
+} UrcTest;
+
+static void
+common_test_urcs (GRegex        *r,
+                  const UrcTest *tests,
+                  guint          n_tests)
+{
+    guint i;
+
+    for (i = 0; i < n_tests; i++) {
+        GString *buffer;
+
+        buffer = g_string_new (tests[i].str);
+        g_assert_cmpuint (process_urcs (r, buffer), ==, tests[i].n_matches);
+        g_assert_cmpstr (buffer->str, ==, tests[i].remaining);
+        g_string_free (buffer, TRUE);
+    }
+}
+
+static void
+test_swwan_urc (void)
+{
+    static const UrcTest tests[] = {
+        { "\r\n^SWWAN: 3,1,1\r\n",  1, "" },
+        { "\r\n^SWWAN: 3,1\r\n",    1, "" },
+        { "\r\n^SWWAN: 3, 1, 1\r\n", 1, "" },
+        /* Disconnections are not processed */
+        { "\r\n^SWWAN: 3,0,1\r\n",  0, "\r\n^SWWAN: 3,0,1\r\n" },
+        /* Reports for other CIDs must be left alone */
+        { "\r\n^SWWAN: 2,1,2\r\n",  0, "\r\n^SWWAN: 2,1,2\r\n" },
+        { "\r\n^SWWAN: 31,1,1\r\n", 0, "\r\n^SWWAN: 31,1,1\r\n" },
+        { "\r\n^SWWAN: 2,1,2\r\n\r\n^SWWAN: 3,1,1\r\n", 1, "\r\n^SWWAN: 2,1,2\r\n" },
+    };
+    GRegex *r;
+
+    r = mm_cinterion_get_swwan_connected_regex (3);
+    common_test_urcs (r, tests, G_N_ELEMENTS (tests));
+    g_regex_unref (r);
+}
+
+static void
+test_cgev_pdn_act_urc (void)
+{
+    static const UrcTest tests[] = {
+        { "\r\n+CGEV: NW PDN ACT 3\r\n",    1, "" },
+        { "\r\n+CGEV: ME PDN ACT 3\r\n",    1, "" },
+        { "\r\n+CGEV: ME PDN ACT 3,0\r\n",  1, "" },
+        { "\r\n+CGEV: NW PDN ACT 31\r\n",   0, "\r\n+CGEV: NW PDN ACT 31\r\n" },
+        { "\r\n+CGEV: NW PDN ACT 2\r\n",    0, "\r\n+CGEV: NW PDN ACT 2\r\n" },
+        { "\r\n+CGEV: NW PDN DEACT 3\r\n",  0, "\r\n+CGEV: NW PDN DEACT 3\r\n" },
+    };
+    GRegex *r;
+
+    r = mm_cinterion_get_cgev_pdn_act_regex (3);
+    common_test_urcs (r, tests, G_N_ELEMENTS (tests));
+    g_regex_unref (r);
+}
+
+static void
+test_swwan_urc_status_query (void)
+{
+    /* Reply to a ^SWWAN? status query sent for the bearer in CID 2, while
+     * the bearer in CID 3 is dialing */
+    static const gchar *reply = "\r\n^SWWAN: 2,1,2\r\n^SWWAN: 3,1,1\r\n\r\nOK\r\n";
+    static const gchar *response = "^SWWAN: 2,1,2\r\n^SWWAN: 3,1,1";
+    GRegex  *r;
+    GString *buffer;
+
+    r = mm_cinterion_get_swwan_connected_regex (3);
+
+    /* If the dial URC handler processed the reply, the line for CID 3 would
+     * be lost, but never the one for CID 2 */
+    buffer = g_string_new (reply);
+    g_assert_cmpuint (process_urcs (r, buffer), ==, 1);
+    g_assert_cmpstr (buffer->str, ==, "\r\n^SWWAN: 2,1,2\r\nOK\r\n");
+    g_assert_cmpint (mm_cinterion_parse_swwan_response ("^SWWAN: 2,1,2", 2, NULL), ==, MM_BEARER_CONNECTION_STATUS_CONNECTED);
+    g_string_free (buffer, TRUE);
+
+    /* So the handler is disabled while the query is in flight, and the full
+     * response is given to both the querying bearer and the dialing one */
+    g_assert_cmpint (mm_cinterion_parse_swwan_response (response, 2, NULL), ==, MM_BEARER_CONNECTION_STATUS_CONNECTED);
+    g_assert_cmpint (mm_cinterion_parse_swwan_response (response, 3, NULL), ==, MM_BEARER_CONNECTION_STATUS_CONNECTED);
+
+    g_regex_unref (r);
+}
+
+/*****************************************************************************/
+/* Test connection time statistics */
+
+static void
+test_connect_stats (void)
+{
+    MMCinterionConnectStats stats = { 0 };
+    /* Time to connect in seconds, the first one from ^SWWAN=1 reply and
+     * validation, the others completed by the ^SWWAN URC */
+    static const gdouble elapsed[] = { 2.5, 0.75, 0.5, 1.25 };
+    guint i;
+
+    g_assert_cmpfloat (mm_cinterion_connect_stats_get_avg (&stats), ==, 0.0);
+
+    for (i = 0; i < G_N_ELEMENTS (elapsed); i++) {
+        mm_cinterion_connect_stats_add (&stats, elapsed[i]);
+        g_assert_cmpuint (stats.n_connects, ==, i + 1);
+        g_assert_cmpfloat (stats.last, ==, elapsed[i]);
+    }
+
+    g_assert_cmpfloat (stats.min, ==, 0.5);
+    g_assert_cmpfloat (stats.max, ==, 2.5);
+    g_assert_cmpfloat (stats.total, ==, 5.0);
+    g_assert_cmpfloat (mm_cinterion_connect_stats_get_avg (&stats), ==, 1.25);
+}
+
 /*****************************************************************************/
 
 void
@@ -703,6 +846,10 @@ int main (int argc, char **argv)
     g_test_add_func ("/MM/cinterion/cnmi/phs8",               test_cnmi_phs8);
     g_test_add_func ("/MM/cinterion/cnmi/other",              test_cnmi_other);
     g_test_add_func ("/MM/cinterion/swwan/pls8",              test_swwan_pls8);
+    g_test_add_func ("/MM/cinterion/swwan/urc",               test_swwan_urc);
+    g_test_add_func ("/MM/cinterion/swwan/urc/status-query",  test_swwan_urc_status_query);
+    g_test_add_func ("/MM/cinterion/cgev/pdn-act/urc",        test_cgev_pdn_act_urc);
+    g_test_add_func ("/MM/cinterion/connect-stats",           test_connect_stats);
     g_test_add_func ("/MM/cinterion/sind/response/simstatus", test_sind_response_simstatus);
     g_test_add_func ("/MM/cinterion/smong/response/tc63i",    test_smong_response_tc63i);
     g_test_add_func ("/MM/cinterion/smong/response/other",    test_smong_response_other);
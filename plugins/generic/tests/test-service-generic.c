@@ -79,12 +79,425 @@ test_enable_disable (TestFixture *fixture)
 
 /*****************************************************************************/
 
+static gchar *
+csq_handler (TestPortContext *port,
+             const gchar     *command,
+             guint           *quality)
+{
+    /* Report a different signal quality every time */
+    *quality = (*quality + 1) % 32;
+    return g_strdup_printf ("\r\n+CSQ: %u,99\r\n\r\nOK\r\n", *quality);
+}
+
+static void
+test_enable_disable_simulated (TestFixture *fixture)
+{
+    GError *error = NULL;
+    MMObject *obj;
+    MMModem *modem;
+    TestPortContext *port0;
+    gchar *ports [] = { NULL, NULL };
+    guint quality = 0;
+    const gchar *creg_flaps[] = { "\r\n+CREG: 2\r\n", "\r\n+CREG: 1,\"1234\",\"001122BB\"\r\n", NULL };
+
+    ports[0] = g_strdup_printf ("abstract:port0:%ld", (glong) getpid ());
+    g_debug ("test service generic: using abstract port at '%s'", ports[0]);
+
+    /* Setup new port context, replying with random latencies, in small
+     * chunks and with registration status changes reported every now and
+     * then */
+    port0 = test_port_context_new (ports[0]);
+    test_port_context_load_commands (port0, COMMON_GSM_PORT_CONF);
+    test_port_context_set_latency (port0, NULL, 1, 20);
+    test_port_context_set_chunking (port0, 5, 1);
+    test_port_context_add_urc_stream (port0, creg_flaps, 50, 0);
+    test_port_context_set_command (port0, "AT+CSQ", NULL);
+    test_port_context_set_command_handler (port0, "AT+CSQ", (TestPortContextCommandFn)csq_handler, &quality, NULL);
+    test_port_context_start (port0);
+
+    test_fixture_no_modem (fixture);
+    test_fixture_set_profile (fixture,
+                              "test-enable-disable-simulated",
+                              "Generic",
+                              (const gchar *const *)ports);
+    obj = test_fixture_get_modem (fixture);
+
+    modem = mm_object_get_modem (obj);
+    g_assert (modem != NULL);
+    mm_modem_enable_sync (modem, NULL, &error);
+    g_assert_no_error (error);
+
+    mm_modem_disable_sync (modem, NULL, &error);
+    g_assert_no_error (error);
+
+    g_object_unref (modem);
+    g_object_unref (obj);
+
+    test_port_context_stop (port0);
+    test_port_context_free (port0);
+
+    g_free (ports[0]);
+}
+
+/*****************************************************************************/
+
+/* One request holding the session, plus all the ones that can be queued, plus
+ * a few more that won't fit in the queue */
+#define USSD_QUEUED_MAX   16
+#define USSD_N_REQUESTS   (1 + USSD_QUEUED_MAX + 3)
+
+typedef struct {
+    GMainLoop *loop;
+    guint      n_completed;
+    guint      n_cancelled;
+    guint      n_rejected;
+    guint      n_replies;
+} UssdContext;
+
+typedef struct {
+    UssdContext *ctx;
+    guint        index;
+} UssdRequest;
+
+static gchar *
+cusd_handler (TestPortContext *port,
+              const gchar     *command,
+              guint           *n_requests)
+{
+    /* The first request never gets a reply, so that the session stays
+     * active and all others get queued */
+    if ((*n_requests)++ == 0)
+        return g_strdup ("\r\nOK\r\n");
+    return g_strdup_printf ("\r\n+CUSD: 0,\"Reply %u\",15\r\n\r\nOK\r\n", *n_requests - 1);
+}
+
+static void
+ussd_initiate_ready (MMModem3gppUssd *ussd,
+                     GAsyncResult    *res,
+                     UssdRequest     *request)
+{
+    UssdContext *ctx = request->ctx;
+    GError      *error = NULL;
+    gchar       *reply;
+
+    reply = mm_modem_3gpp_ussd_initiate_finish (ussd, res, &error);
+    if (request->index == 0) {
+        g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_CANCELLED);
+        ctx->n_cancelled++;
+    } else if (request->index <= USSD_QUEUED_MAX) {
+        gchar *expected;
+
+        /* Queued requests are run in order */
+        g_assert_no_error (error);
+        expected = g_strdup_printf ("Reply %u", request->index);
+        g_assert_cmpstr (reply, ==, expected);
+        g_free (expected);
+        ctx->n_replies++;
+    } else {
+        g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_RETRY);
+        ctx->n_rejected++;
+    }
+
+    g_clear_error (&error);
+    g_free (reply);
+    g_slice_free (UssdRequest, request);
+
+    ctx->n_completed++;
+    if (ctx->n_completed == USSD_N_REQUESTS ||
+        (ctx->n_completed == USSD_N_REQUESTS - USSD_QUEUED_MAX - 1 && ctx->n_rejected == ctx->n_completed))
+        g_main_loop_quit (ctx->loop);
+}
+
+static void
+test_ussd_queue (TestFixture *fixture)
+{
+    GError *error = NULL;
+    MMObject *obj;
+    MMModem *modem;
+    MMModem3gppUssd *ussd;
+    TestPortContext *port0;
+    gchar *ports [] = { NULL, NULL };
+    guint n_requests = 0;
+    UssdContext ctx = { 0 };
+    guint i;
+
+    ports[0] = g_strdup_printf ("abstract:port0:%ld", (glong) getpid ());
+    g_debug ("test service generic: using abstract port at '%s'", ports[0]);
+
+    port0 = test_port_context_new (ports[0]);
+    test_port_context_load_commands (port0, COMMON_GSM_PORT_CONF);
+    test_port_context_set_command (port0, "AT+CUSD=?", "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CUSD=0", "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CUSD=1", "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CUSD=2", "\r\nOK\r\n");
+    test_port_context_set_command_handler (port0, "AT+CUSD=1,", (TestPortContextCommandFn)cusd_handler, &n_requests, NULL);
+    test_port_context_start (port0);
+
+    test_fixture_no_modem (fixture);
+    test_fixture_set_profile (fixture,
+                              "test-ussd-queue",
+                              "Generic",
+                              (const gchar *const *)ports);
+    obj = test_fixture_get_modem (fixture);
+
+    modem = mm_object_get_modem (obj);
+    g_assert (modem != NULL);
+    mm_modem_enable_sync (modem, NULL, &error);
+    g_assert_no_error (error);
+
+    ussd = mm_object_get_modem_3gpp_ussd (obj);
+    g_assert (ussd != NULL);
+
+    /* Launch all requests at once; wait until the ones that don't fit in the
+     * queue are rejected */
+    ctx.loop = g_main_loop_new (NULL, FALSE);
+    for (i = 0; i < USSD_N_REQUESTS; i++) {
+        UssdRequest *request;
+
+        request = g_slice_new (UssdRequest);
+        request->ctx = &ctx;
+        request->index = i;
+        mm_modem_3gpp_ussd_initiate (ussd, "*100#", NULL, (GAsyncReadyCallback)ussd_initiate_ready, request);
+    }
+    g_main_loop_run (ctx.loop);
+    g_assert_cmpuint (ctx.n_rejected, ==, USSD_N_REQUESTS - USSD_QUEUED_MAX - 1);
+
+    /* Cancelling the session that never got a reply lets the queued ones go */
+    mm_modem_3gpp_ussd_cancel_sync (ussd, NULL, &error);
+    g_assert_no_error (error);
+    g_main_loop_run (ctx.loop);
+    g_assert_cmpuint (ctx.n_cancelled, ==, 1);
+    g_assert_cmpuint (ctx.n_replies, ==, USSD_QUEUED_MAX);
+    g_main_loop_unref (ctx.loop);
+
+    mm_modem_disable_sync (modem, NULL, &error);
+    g_assert_no_error (error);
+
+    g_object_unref (ussd);
+    g_object_unref (modem);
+    g_object_unref (obj);
+
+    test_port_context_stop (port0);
+    test_port_context_free (port0);
+
+    g_free (ports[0]);
+}
+
+/*****************************************************************************/
+
+#define CALL_NUMBER          "+34600000000"
+#define CALL_WAIT_TIMEOUT_US (15 * G_USEC_PER_SEC)
+
+/* State of the single call in the simulated modem, changed by the test and
+ * by the command handlers running in the port thread */
+typedef struct {
+    GMutex      mutex;
+    MMCallState state;
+} CallScript;
+
+static void
+call_script_set_state (CallScript  *script,
+                       MMCallState  state)
+{
+    g_mutex_lock (&script->mutex);
+    script->state = state;
+    g_mutex_unlock (&script->mutex);
+}
+
+static gchar *
+clcc_handler (TestPortContext *port,
+              const gchar     *command,
+              CallScript      *script)
+{
+    gchar *response;
+
+    g_mutex_lock (&script->mutex);
+    switch (script->state) {
+    case MM_CALL_STATE_RINGING_IN:
+        response = g_strdup ("\r\n+CLCC: 1,1,4,0,0,\"" CALL_NUMBER "\",145\r\n\r\nOK\r\n");
+        break;
+    case MM_CALL_STATE_ACTIVE:
+        response = g_strdup ("\r\n+CLCC: 1,1,0,0,0,\"" CALL_NUMBER "\",145\r\n\r\nOK\r\n");
+        break;
+    default:
+        response = g_strdup ("\r\nOK\r\n");
+        break;
+    }
+    g_mutex_unlock (&script->mutex);
+    return response;
+}
+
+static gchar *
+ata_handler (TestPortContext *port,
+             const gchar     *command,
+             CallScript      *script)
+{
+    call_script_set_state (script, MM_CALL_STATE_ACTIVE);
+    return g_strdup ("\r\nOK\r\n");
+}
+
+static gchar *
+chup_handler (TestPortContext *port,
+              const gchar     *command,
+              CallScript      *script)
+{
+    call_script_set_state (script, MM_CALL_STATE_UNKNOWN);
+    return g_strdup ("\r\nOK\r\n");
+}
+
+/* Waits until the call at the given path, or any call not at skip_path, is
+ * in the given state */
+static MMCall *
+wait_for_call (MMModemVoice *voice,
+               const gchar  *path,
+               const gchar  *skip_path,
+               MMCallState   state)
+{
+    gint64 deadline;
+
+    deadline = g_get_monotonic_time () + CALL_WAIT_TIMEOUT_US;
+    while (g_get_monotonic_time () < deadline) {
+        GError *error = NULL;
+        GList  *calls;
+        GList  *l;
+        MMCall *found = NULL;
+
+        /* Calls listed are new proxies, with their properties up to date */
+        calls = mm_modem_voice_list_calls_sync (voice, NULL, &error);
+        g_assert_no_error (error);
+        for (l = calls; l && !found; l = g_list_next (l)) {
+            MMCall *call = l->data;
+
+            if ((path && g_strcmp0 (mm_call_get_path (call), path) != 0) ||
+                (skip_path && g_strcmp0 (mm_call_get_path (call), skip_path) == 0))
+                continue;
+            if (mm_call_get_state (call) == state)
+                found = g_object_ref (call);
+        }
+        g_list_free_full (calls, g_object_unref);
+
+        if (found)
+            return found;
+        g_usleep (100 * 1000);
+    }
+
+    g_assert_not_reached ();
+    return NULL;
+}
+
+static void
+test_voice_clcc (TestFixture *fixture)
+{
+    GError *error = NULL;
+    MMObject *obj;
+    MMModem *modem;
+    MMModemVoice *voice;
+    MMCall *call;
+    MMCall *other;
+    TestPortContext *port0;
+    gchar *ports [] = { NULL, NULL };
+    gchar *path;
+    CallScript script;
+
+    g_mutex_init (&script.mutex);
+    script.state = MM_CALL_STATE_UNKNOWN;
+
+    ports[0] = g_strdup_printf ("abstract:port0:%ld", (glong) getpid ());
+    g_debug ("test service generic: using abstract port at '%s'", ports[0]);
+
+    /* Setup new port context, listing the calls in +CLCC as per the script */
+    port0 = test_port_context_new (ports[0]);
+    test_port_context_load_commands (port0, COMMON_GSM_PORT_CONF);
+    test_port_context_set_command (port0, "ATH", "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CLIP=1", "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CRC=1", "\r\nOK\r\n");
+    test_port_context_set_command_handler (port0, "AT+CLCC", (TestPortContextCommandFn)clcc_handler, &script, NULL);
+    test_port_context_set_command_handler (port0, "ATA", (TestPortContextCommandFn)ata_handler, &script, NULL);
+    test_port_context_set_command_handler (port0, "AT+CHUP", (TestPortContextCommandFn)chup_handler, &script, NULL);
+    test_port_context_start (port0);
+
+    test_fixture_no_modem (fixture);
+    test_fixture_set_profile (fixture,
+                              "test-voice-clcc",
+                              "Generic",
+                              (const gchar *const *)ports);
+    obj = test_fixture_get_modem (fixture);
+
+    modem = mm_object_get_modem (obj);
+    g_assert (modem != NULL);
+    mm_modem_enable_sync (modem, NULL, &error);
+    g_assert_no_error (error);
+
+    voice = mm_object_get_modem_voice (obj);
+    g_assert (voice != NULL);
+
+    /* An incoming call is created on RING, and its number is taken from the
+     * call list */
+    call_script_set_state (&script, MM_CALL_STATE_RINGING_IN);
+    test_port_context_send_urc (port0, "\r\nRING\r\n");
+    call = wait_for_call (voice, NULL, NULL, MM_CALL_STATE_RINGING_IN);
+    g_assert_cmpuint (mm_call_get_direction (call), ==, MM_CALL_DIRECTION_INCOMING);
+    path = g_strdup (mm_call_get_path (call));
+
+    /* Accept and hangup */
+    mm_call_accept_sync (call, NULL, &error);
+    g_assert_no_error (error);
+    g_object_unref (call);
+    call = wait_for_call (voice, path, NULL, MM_CALL_STATE_ACTIVE);
+    g_assert_cmpstr (mm_call_get_number (call), ==, CALL_NUMBER);
+
+    mm_call_hangup_sync (call, NULL, &error);
+    g_assert_no_error (error);
+    g_object_unref (call);
+    call = wait_for_call (voice, path, NULL, MM_CALL_STATE_TERMINATED);
+    g_object_unref (call);
+
+    /* A new call reusing the same index is not mistaken for the old one */
+    call_script_set_state (&script, MM_CALL_STATE_RINGING_IN);
+    test_port_context_send_urc (port0, "\r\nRING\r\n");
+    other = wait_for_call (voice, NULL, path, MM_CALL_STATE_RINGING_IN);
+    g_free (path);
+    path = g_strdup (mm_call_get_path (other));
+
+    mm_call_accept_sync (other, NULL, &error);
+    g_assert_no_error (error);
+    g_object_unref (other);
+    other = wait_for_call (voice, path, NULL, MM_CALL_STATE_ACTIVE);
+    g_object_unref (other);
+
+    /* The remote party hangs up; no URC is sent, so the call is only known to
+     * be gone once the call list is polled */
+    call_script_set_state (&script, MM_CALL_STATE_UNKNOWN);
+    other = wait_for_call (voice, path, NULL, MM_CALL_STATE_TERMINATED);
+    g_assert_cmpuint (mm_call_get_state_reason (other), ==, MM_CALL_STATE_REASON_TERMINATED);
+    g_object_unref (other);
+    g_free (path);
+
+    mm_modem_disable_sync (modem, NULL, &error);
+    g_assert_no_error (error);
+
+    g_object_unref (voice);
+    g_object_unref (modem);
+    g_object_unref (obj);
+
+    test_port_context_stop (port0);
+    test_port_context_free (port0);
+    g_mutex_clear (&script.mutex);
+
+    g_free (ports[0]);
+}
+
+/*****************************************************************************/
+
 int main (int   argc,
           char *argv[])
 {
     g_test_init (&argc, &argv, NULL);
 
     TEST_ADD ("/MM/Service/Generic/enable-disable", test_enable_disable);
+    TEST_ADD ("/MM/Service/Generic/enable-disable/simulated", test_enable_disable_simulated);
+    TEST_ADD ("/MM/Service/Generic/ussd/queue", test_ussd_queue);
+    TEST_ADD ("/MM/Service/Generic/voice/clcc", test_voice_clcc);
 
     return g_test_run ();
 }
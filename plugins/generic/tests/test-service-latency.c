@@ -0,0 +1,465 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <sys/types.h>
+#include <unistd.h>
+#include <stdlib.h>
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include <libmm-glib.h>
+
+#include "test-port-context.h"
+#include "test-fixture.h"
+
+/* End-to-end latency of common DBus operations, as seen by a libmm-glib
+ * client, against a simulated modem handled by the Generic plugin.
+ *
+ * The latency of each operation is split in:
+ *  - DBus: round trip of a property read in the modem object, which is the
+ *    cost of marshalling and routing a message through the bus and of
+ *    dispatching it in the daemon main loop. Peer.Ping isn't used, as it's
+ *    answered from the GDBus worker thread and skips the main loop.
+ *  - auth: cost of the daemon authorization step, estimated as the extra
+ *    latency of Location.GetLocation (which only authorizes and replies
+ *    with data already available) over the property read.
+ *  - serial: time the modem spent replying the commands received while
+ *    the operation ran, as accounted by the fake port.
+ *  - queueing and processing: whatever is left, i.e. time waiting in the
+ *    serial command queue and handling the request and replies.
+ * Background polling done by the daemon during the operation is accounted
+ * as serial time as well, so the split is an estimation.
+ */
+
+#define DEFAULT_ITERATIONS      2
+#define DEFAULT_PERF_ITERATIONS 100
+
+typedef struct {
+    TestPortContext  *port;
+    MMObject         *obj;
+    MMModem          *modem;
+    MMModemSimple    *simple;
+    MMModemMessaging *messaging;
+    MMModemLocation  *location;
+    GDBusConnection  *connection;
+    gchar            *sms_path;
+    guint             message_reference;
+} BenchContext;
+
+/*****************************************************************************/
+/* Fake modem setup */
+
+static gchar *
+cmgs_handler (TestPortContext *port,
+              const gchar     *command,
+              BenchContext    *ctx)
+{
+    /* Prompt for the SMS PDU */
+    return g_strdup ("\r\n> ");
+}
+
+static gchar *
+fallback_handler (TestPortContext *port,
+                  const gchar     *command,
+                  BenchContext    *ctx)
+{
+    /* Whatever doesn't start with AT is SMS data after the prompt */
+    if (!g_str_has_prefix (command, "AT"))
+        return g_strdup_printf ("\r\n+CMGS: %u\r\n\r\nOK\r\n", ctx->message_reference++ % 256);
+
+    /* Accept any other command, e.g. storage or context setup */
+    return g_strdup ("\r\nOK\r\n");
+}
+
+static void
+setup_port_context (BenchContext *ctx)
+{
+    TestPortContext *port = ctx->port;
+
+    test_port_context_load_commands (port, COMMON_GSM_PORT_CONF);
+
+    /* Messaging support */
+    test_port_context_set_command (port, "AT+CNMI=?", "\r\n+CNMI: (0-2),(0-3),(0,2),(0-2),(0,1)\r\n\r\nOK\r\n");
+    test_port_context_set_command (port, "AT+CPMS=?", "\r\n+CPMS: (\"ME\",\"SM\"),(\"ME\",\"SM\"),(\"ME\",\"SM\")\r\n\r\nOK\r\n");
+    test_port_context_set_command (port, "AT+CPMS?",  "\r\n+CPMS: \"ME\",0,23,\"ME\",0,23,\"ME\",0,23\r\n\r\nOK\r\n");
+    test_port_context_set_command (port, "AT+CMGL=4", "\r\nOK\r\n");
+
+    /* Extended signal quality support */
+    test_port_context_set_command (port, "AT+CESQ=?", "\r\n+CESQ: (0-63,99),(0-7,99),(0-96,255),(0-49,255),(0-34,255),(0-97,255)\r\n\r\nOK\r\n");
+    test_port_context_set_command (port, "AT+CESQ",   "\r\n+CESQ: 99,99,255,255,20,80\r\n\r\nOK\r\n");
+
+    /* PPP dial on the single AT port, with a context already defined */
+    test_port_context_set_command (port, "AT+CGDCONT?", "\r\n+CGDCONT: 1,\"IP\",\"internet\",\"0.0.0.0\",0,0\r\n\r\nOK\r\n");
+    test_port_context_set_command (port, "ATD*99***1#", "\r\nCONNECT\r\n");
+
+    /* Replies built at runtime; the fallback must go last */
+    test_port_context_set_command_handler (port, "AT+CMGS=", (TestPortContextCommandFn)cmgs_handler, ctx, NULL);
+    test_port_context_set_command_handler (port, "", (TestPortContextCommandFn)fallback_handler, ctx, NULL);
+
+    /* Some modem response time */
+    test_port_context_set_latency (port, NULL, 1, 5);
+}
+
+/*****************************************************************************/
+/* Operations */
+
+typedef struct {
+    const gchar *name;
+    /* Whether the daemon authorizes the request */
+    gboolean     auth;
+    gboolean   (* prepare) (BenchContext *ctx, GError **error);
+    gboolean   (* run)     (BenchContext *ctx, GError **error);
+    void       (* cleanup) (BenchContext *ctx);
+} Operation;
+
+static gboolean
+property_get_run (BenchContext  *ctx,
+                  GError       **error)
+{
+    GVariant *result;
+
+    result = g_dbus_connection_call_sync (ctx->connection,
+                                          "org.freedesktop.ModemManager1",
+                                          mm_object_get_path (ctx->obj),
+                                          "org.freedesktop.DBus.Properties",
+                                          "Get",
+                                          g_variant_new ("(ss)", "org.freedesktop.ModemManager1.Modem", "State"),
+                                          G_VARIANT_TYPE ("(v)"),
+                                          G_DBUS_CALL_FLAGS_NONE,
+                                          -1,
+                                          NULL,
+                                          error);
+    if (!result)
+        return FALSE;
+    g_variant_unref (result);
+    return TRUE;
+}
+
+static gboolean
+enable_prepare (BenchContext  *ctx,
+                GError       **error)
+{
+    return mm_modem_disable_sync (ctx->modem, NULL, error);
+}
+
+static gboolean
+enable_run (BenchContext  *ctx,
+            GError       **error)
+{
+    return mm_modem_enable_sync (ctx->modem, NULL, error);
+}
+
+static gboolean
+signal_read_run (BenchContext  *ctx,
+                 GError       **error)
+{
+    GVariant *result;
+
+    /* What clients polling signal information do */
+    result = g_dbus_connection_call_sync (ctx->connection,
+                                          "org.freedesktop.ModemManager1",
+                                          mm_object_get_path (ctx->obj),
+                                          "org.freedesktop.DBus.Properties",
+                                          "GetAll",
+                                          g_variant_new ("(s)", "org.freedesktop.ModemManager1.Modem.Signal"),
+                                          G_VARIANT_TYPE ("(a{sv})"),
+                                          G_DBUS_CALL_FLAGS_NONE,
+                                          -1,
+                                          NULL,
+                                          error);
+    if (!result)
+        return FALSE;
+    g_variant_unref (result);
+    return TRUE;
+}
+
+static gboolean
+location_get_run (BenchContext  *ctx,
+                  GError       **error)
+{
+    MMLocation3gpp *location_3gpp = NULL;
+
+    if (!mm_modem_location_get_full_sync (ctx->location, &location_3gpp, NULL, NULL, NULL, NULL, error))
+        return FALSE;
+    g_clear_object (&location_3gpp);
+    return TRUE;
+}
+
+static gboolean
+messaging_create_send_run (BenchContext  *ctx,
+                           GError       **error)
+{
+    MMSmsProperties *properties;
+    MMSms           *sms;
+    gboolean         sent;
+
+    properties = mm_sms_properties_new ();
+    mm_sms_properties_set_text (properties, "Hello world");
+    mm_sms_properties_set_number (properties, "+34600000000");
+    sms = mm_modem_messaging_create_sync (ctx->messaging, properties, NULL, error);
+    g_object_unref (properties);
+    if (!sms)
+        return FALSE;
+
+    ctx->sms_path = g_strdup (mm_sms_get_path (sms));
+    sent = mm_sms_send_sync (sms, NULL, error);
+    g_object_unref (sms);
+    return sent;
+}
+
+static void
+messaging_create_send_cleanup (BenchContext *ctx)
+{
+    if (ctx->sms_path) {
+        mm_modem_messaging_delete_sync (ctx->messaging, ctx->sms_path, NULL, NULL);
+        g_clear_pointer (&ctx->sms_path, g_free);
+    }
+}
+
+static gboolean
+simple_connect_run (BenchContext  *ctx,
+                    GError       **error)
+{
+    MMSimpleConnectProperties *properties;
+    MMBearer                  *bearer;
+
+    properties = mm_simple_connect_properties_new ();
+    mm_simple_connect_properties_set_apn (properties, "internet");
+    bearer = mm_modem_simple_connect_sync (ctx->simple, properties, NULL, error);
+    g_object_unref (properties);
+    if (!bearer)
+        return FALSE;
+    g_object_unref (bearer);
+    return TRUE;
+}
+
+static void
+simple_connect_cleanup (BenchContext *ctx)
+{
+    mm_modem_simple_disconnect_sync (ctx->simple, NULL, NULL, NULL);
+}
+
+/* Property read and location must go first, as they're used to split the others */
+static const Operation operations[] = {
+    { "property-get",          FALSE, NULL,           property_get_run,          NULL },
+    { "location-get",          TRUE,  NULL,           location_get_run,          NULL },
+    { "enable",                TRUE,  enable_prepare, enable_run,                NULL },
+    { "signal-read",           FALSE, NULL,           signal_read_run,           NULL },
+    { "messaging-create-send", TRUE,  NULL,           messaging_create_send_run, messaging_create_send_cleanup },
+    { "simple-connect",        TRUE,  NULL,           simple_connect_run,        simple_connect_cleanup },
+};
+
+/*****************************************************************************/
+
+typedef struct {
+    GArray  *latencies;  /* ms */
+    gdouble  serial_ms;  /* accumulated */
+    guint    n_commands; /* accumulated */
+    guint    n_errors;
+} OperationStats;
+
+static gdouble
+latency_mean (GArray *latencies)
+{
+    gdouble total = 0.0;
+    guint   i;
+
+    if (!latencies->len)
+        return 0.0;
+    for (i = 0; i < latencies->len; i++)
+        total += g_array_index (latencies, gdouble, i);
+    return total / latencies->len;
+}
+
+static void
+run_operation (BenchContext    *ctx,
+               const Operation *operation,
+               guint            iterations,
+               OperationStats  *stats)
+{
+    guint i;
+
+    stats->latencies = g_array_new (FALSE, FALSE, sizeof (gdouble));
+
+    for (i = 0; i < iterations; i++) {
+        GError   *error = NULL;
+        gint64    start;
+        gdouble   latency;
+        guint     n_replies_start, n_replies_end;
+        guint64   reply_time_start, reply_time_end;
+        gboolean  success;
+
+        if (operation->prepare && !operation->prepare (ctx, &error)) {
+            g_test_message ("%s: couldn't prepare: %s", operation->name, error->message);
+            g_clear_error (&error);
+            stats->n_errors++;
+            continue;
+        }
+
+        test_port_context_get_stats (ctx->port, &n_replies_start, &reply_time_start);
+        start = g_get_monotonic_time ();
+        success = operation->run (ctx, &error);
+        latency = (g_get_monotonic_time () - start) / 1000.0;
+        test_port_context_get_stats (ctx->port, &n_replies_end, &reply_time_end);
+
+        if (operation->cleanup)
+            operation->cleanup (ctx);
+
+        if (!success) {
+            g_test_message ("%s: failed: %s", operation->name, error->message);
+            g_clear_error (&error);
+            stats->n_errors++;
+            continue;
+        }
+
+        g_array_append_val (stats->latencies, latency);
+        stats->serial_ms += (reply_time_end - reply_time_start) / 1000.0;
+        stats->n_commands += n_replies_end - n_replies_start;
+    }
+
+    g_array_sort (stats->latencies, (GCompareFunc)test_fixture_latency_cmp);
+}
+
+static void
+report_operation (const Operation *operation,
+                  OperationStats  *stats,
+                  gdouble          dbus_ms,
+                  gdouble          auth_ms)
+{
+    gdouble mean;
+    gdouble serial_ms = 0.0;
+    gdouble commands = 0.0;
+    gdouble remaining;
+
+    mean = latency_mean (stats->latencies);
+    if (stats->latencies->len) {
+        serial_ms = stats->serial_ms / stats->latencies->len;
+        commands = (gdouble) stats->n_commands / stats->latencies->len;
+    }
+    if (!operation->auth)
+        auth_ms = 0.0;
+    remaining = MAX (0.0, mean - dbus_ms - auth_ms - serial_ms);
+
+    g_test_message ("%-22s: %u samples, %u errors; latency (ms): p50 %.3f, p90 %.3f, p99 %.3f, max %.3f",
+                    operation->name,
+                    stats->latencies->len,
+                    stats->n_errors,
+                    test_fixture_latency_percentile (stats->latencies, 50),
+                    test_fixture_latency_percentile (stats->latencies, 90),
+                    test_fixture_latency_percentile (stats->latencies, 99),
+                    test_fixture_latency_percentile (stats->latencies, 100));
+    g_test_message ("%-22s  mean %.3f ms: DBus %.3f, auth %.3f, serial %.3f (%.1f commands), queueing and processing %.3f",
+                    "",
+                    mean, dbus_ms, auth_ms, serial_ms, commands, remaining);
+    if (stats->latencies->len)
+        g_test_minimized_result (test_fixture_latency_percentile (stats->latencies, 50) / 1000.0,
+                                 "%s p50 latency: %.3f ms",
+                                 operation->name,
+                                 test_fixture_latency_percentile (stats->latencies, 50));
+}
+
+static void
+test_latency (TestFixture *fixture)
+{
+    GError         *error = NULL;
+    BenchContext    ctx = { 0 };
+    gchar          *ports [] = { NULL, NULL };
+    const gchar    *env;
+    guint           iterations;
+    OperationStats  stats[G_N_ELEMENTS (operations)] = { { 0 } };
+    gdouble         dbus_ms = 0.0;
+    gdouble         auth_ms = 0.0;
+    guint           i;
+
+    env = g_getenv ("MM_TEST_LATENCY_ITERATIONS");
+    iterations = env ? atoi (env) : 0;
+    if (!iterations)
+        iterations = g_test_perf () ? DEFAULT_PERF_ITERATIONS : DEFAULT_ITERATIONS;
+
+    ports[0] = g_strdup_printf ("abstract:port0:%ld", (glong) getpid ());
+    ctx.port = test_port_context_new (ports[0]);
+    setup_port_context (&ctx);
+    test_port_context_start (ctx.port);
+
+    test_fixture_no_modem (fixture);
+    test_fixture_set_profile (fixture,
+                              "test-latency",
+                              "Generic",
+                              (const gchar *const *)ports);
+    ctx.obj = test_fixture_get_modem (fixture);
+    ctx.connection = fixture->connection;
+
+    ctx.modem = mm_object_get_modem (ctx.obj);
+    g_assert (ctx.modem != NULL);
+    mm_modem_enable_sync (ctx.modem, NULL, &error);
+    g_assert_no_error (error);
+
+    /* Optional interfaces are only available once enabled */
+    g_object_unref (ctx.obj);
+    ctx.obj = test_fixture_get_modem (fixture);
+    ctx.simple = mm_object_get_modem_simple (ctx.obj);
+    g_assert (ctx.simple != NULL);
+    ctx.messaging = mm_object_get_modem_messaging (ctx.obj);
+    g_assert (ctx.messaging != NULL);
+    ctx.location = mm_object_get_modem_location (ctx.obj);
+    g_assert (ctx.location != NULL);
+    mm_modem_location_setup_sync (ctx.location, MM_MODEM_LOCATION_SOURCE_3GPP_LAC_CI, FALSE, NULL, &error);
+    g_assert_no_error (error);
+
+    for (i = 0; i < G_N_ELEMENTS (operations); i++) {
+        run_operation (&ctx, &operations[i], iterations, &stats[i]);
+
+        /* Reference values to split the latency of all the others */
+        if (g_str_equal (operations[i].name, "property-get"))
+            dbus_ms = test_fixture_latency_percentile (stats[i].latencies, 50);
+        else if (g_str_equal (operations[i].name, "location-get") && stats[i].latencies->len)
+            auth_ms = MAX (0.0, test_fixture_latency_percentile (stats[i].latencies, 50) - dbus_ms);
+
+        report_operation (&operations[i], &stats[i], dbus_ms, auth_ms);
+    }
+
+    /* The fake modem accepts everything, so no operation may fail */
+    for (i = 0; i < G_N_ELEMENTS (operations); i++) {
+        g_assert_cmpuint (stats[i].n_errors, ==, 0);
+        g_array_unref (stats[i].latencies);
+    }
+
+    mm_modem_disable_sync (ctx.modem, NULL, &error);
+    g_assert_no_error (error);
+
+    g_clear_object (&ctx.location);
+    g_clear_object (&ctx.messaging);
+    g_clear_object (&ctx.simple);
+    g_object_unref (ctx.modem);
+    g_object_unref (ctx.obj);
+
+    test_port_context_stop (ctx.port);
+    test_port_context_free (ctx.port);
+
+    g_free (ports[0]);
+}
+
+/*****************************************************************************/
+
+int main (int   argc,
+          char *argv[])
+{
+    g_test_init (&argc, &argv, NULL);
+
+    TEST_ADD ("/MM/Service/Latency", test_latency);
+
+    return g_test_run ();
+}
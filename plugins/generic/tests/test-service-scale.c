@@ -0,0 +1,544 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <sys/types.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include <libmm-glib.h>
+
+#include "test-port-context.h"
+#include "test-fixture.h"
+
+/* Multi-modem scale benchmark: N simulated modems handled by the Generic
+ * plugin, each one on its own fake AT port. Only a small sanity run is
+ * done by default, the real benchmark sizes run in perf mode (-m perf). */
+
+#define STEADY_STATE_WINDOW_SECS 10
+#define PROBE_INTERVAL_MS        50
+#define ENABLE_TIMEOUT_MS        120000
+
+/*****************************************************************************/
+/* Daemon process statistics */
+
+static guint
+get_daemon_pid (TestFixture *fixture)
+{
+    GError   *error = NULL;
+    GVariant *result;
+    guint     pid;
+
+    result = g_dbus_connection_call_sync (fixture->connection,
+                                          "org.freedesktop.DBus",
+                                          "/org/freedesktop/DBus",
+                                          "org.freedesktop.DBus",
+                                          "GetConnectionUnixProcessID",
+                                          g_variant_new ("(s)", "org.freedesktop.ModemManager1"),
+                                          G_VARIANT_TYPE ("(u)"),
+                                          G_DBUS_CALL_FLAGS_NONE,
+                                          -1,
+                                          NULL,
+                                          &error);
+    g_assert_no_error (error);
+    g_variant_get (result, "(u)", &pid);
+    g_variant_unref (result);
+    return pid;
+}
+
+/* CPU time (user + system) in seconds */
+static gdouble
+get_process_cpu_time (guint pid)
+{
+    gchar   *path;
+    gchar   *contents = NULL;
+    gchar   *p;
+    gchar  **fields;
+    gdouble  cpu_time;
+
+    path = g_strdup_printf ("/proc/%u/stat", pid);
+    if (!g_file_get_contents (path, &contents, NULL, NULL))
+        g_error ("Couldn't read '%s'", path);
+    g_free (path);
+
+    /* Skip pid and command name, which may have spaces */
+    p = strrchr (contents, ')');
+    g_assert (p);
+    fields = g_strsplit (p + 2, " ", -1);
+    /* utime and stime are fields 14 and 15, i.e. 11 and 12 after the state */
+    g_assert_cmpuint (g_strv_length (fields), >, 12);
+    cpu_time = ((gdouble) (g_ascii_strtoull (fields[11], NULL, 10) + g_ascii_strtoull (fields[12], NULL, 10))) /
+               sysconf (_SC_CLK_TCK);
+    g_strfreev (fields);
+    g_free (contents);
+    return cpu_time;
+}
+
+/* Resident set size in kB */
+static guint64
+get_process_rss (guint pid)
+{
+    gchar   *path;
+    gchar   *contents = NULL;
+    gchar   *p;
+    guint64  rss;
+
+    path = g_strdup_printf ("/proc/%u/status", pid);
+    if (!g_file_get_contents (path, &contents, NULL, NULL))
+        g_error ("Couldn't read '%s'", path);
+    g_free (path);
+
+    p = strstr (contents, "VmRSS:");
+    g_assert (p);
+    rss = g_ascii_strtoull (p + strlen ("VmRSS:"), NULL, 10);
+    g_free (contents);
+    return rss;
+}
+
+/*****************************************************************************/
+/* Steady state monitoring: main loop latency measured as the round trip of
+ * property reads on a modem object (served by the daemon main loop), and
+ * DBus messages sent and received by the daemon, seen from a bus monitor */
+
+typedef struct {
+    gint n_signals;
+    gint n_method_calls;
+    gint n_replies;
+} MessageCounters;
+
+typedef struct {
+    GDBusConnection *connection;
+    const gchar     *modem_path;
+    GMainLoop       *loop;
+    GArray          *probe_latencies;
+    guint            probes_pending;
+} MonitorContext;
+
+typedef struct {
+    MonitorContext *ctx;
+    gint64          start;
+} ProbeContext;
+
+static void
+probe_ready (GDBusConnection *connection,
+             GAsyncResult    *res,
+             ProbeContext    *probe_ctx)
+{
+    GVariant *result;
+    GError   *error = NULL;
+    gdouble   latency;
+
+    result = g_dbus_connection_call_finish (connection, res, &error);
+    g_assert_no_error (error);
+    g_variant_unref (result);
+
+    latency = (g_get_monotonic_time () - probe_ctx->start) / 1000.0;
+    g_array_append_val (probe_ctx->ctx->probe_latencies, latency);
+    probe_ctx->ctx->probes_pending--;
+    g_slice_free (ProbeContext, probe_ctx);
+}
+
+static gboolean
+probe_cb (MonitorContext *ctx)
+{
+    ProbeContext *probe_ctx;
+
+    /* Don't pile up probes if the daemon is stuck */
+    if (ctx->probes_pending)
+        return G_SOURCE_CONTINUE;
+
+    /* Peer.Ping is answered by the GDBus worker thread, so it wouldn't see
+     * the daemon main loop; property reads of exported objects are instead
+     * dispatched in the main loop */
+    probe_ctx = g_slice_new0 (ProbeContext);
+    probe_ctx->ctx = ctx;
+    probe_ctx->start = g_get_monotonic_time ();
+    ctx->probes_pending++;
+    g_dbus_connection_call (ctx->connection,
+                            "org.freedesktop.ModemManager1",
+                            ctx->modem_path,
+                            "org.freedesktop.DBus.Properties",
+                            "Get",
+                            g_variant_new ("(ss)", "org.freedesktop.ModemManager1.Modem", "State"),
+                            G_VARIANT_TYPE ("(v)"),
+                            G_DBUS_CALL_FLAGS_NONE,
+                            -1,
+                            NULL,
+                            (GAsyncReadyCallback)probe_ready,
+                            probe_ctx);
+    return G_SOURCE_CONTINUE;
+}
+
+/* Run in the GDBus worker thread of the monitor connection */
+static GDBusMessage *
+monitor_filter_cb (GDBusConnection *connection,
+                   GDBusMessage    *message,
+                   gboolean         incoming,
+                   MessageCounters *counters)
+{
+    /* Messages addressed to the monitor itself, e.g. the BecomeMonitor()
+     * reply, are processed as usual */
+    if (!incoming ||
+        !g_strcmp0 (g_dbus_message_get_destination (message), g_dbus_connection_get_unique_name (connection)))
+        return message;
+
+    switch (g_dbus_message_get_message_type (message)) {
+    case G_DBUS_MESSAGE_TYPE_SIGNAL:
+        g_atomic_int_inc (&counters->n_signals);
+        break;
+    case G_DBUS_MESSAGE_TYPE_METHOD_CALL:
+        g_atomic_int_inc (&counters->n_method_calls);
+        break;
+    case G_DBUS_MESSAGE_TYPE_METHOD_RETURN:
+    case G_DBUS_MESSAGE_TYPE_ERROR:
+        g_atomic_int_inc (&counters->n_replies);
+        break;
+    case G_DBUS_MESSAGE_TYPE_INVALID:
+    default:
+        break;
+    }
+
+    /* Monitors must never reply, so don't let GDBus process anything */
+    g_object_unref (message);
+    return NULL;
+}
+
+/* Opens a new connection to the test bus which becomes a monitor of all the
+ * messages sent or received by the daemon */
+static GDBusConnection *
+monitor_connection_new (TestFixture     *fixture,
+                        MessageCounters *counters)
+{
+    GError          *error = NULL;
+    GDBusConnection *connection;
+    GVariant        *result;
+    gchar           *owner = NULL;
+    gchar           *rules[3] = { NULL };
+    guint            filter_id;
+
+    result = g_dbus_connection_call_sync (fixture->connection,
+                                          "org.freedesktop.DBus",
+                                          "/org/freedesktop/DBus",
+                                          "org.freedesktop.DBus",
+                                          "GetNameOwner",
+                                          g_variant_new ("(s)", "org.freedesktop.ModemManager1"),
+                                          G_VARIANT_TYPE ("(s)"),
+                                          G_DBUS_CALL_FLAGS_NONE,
+                                          -1,
+                                          NULL,
+                                          &error);
+    g_assert_no_error (error);
+    g_variant_get (result, "(s)", &owner);
+    g_variant_unref (result);
+
+    connection = g_dbus_connection_new_for_address_sync (g_test_dbus_get_bus_address (fixture->dbus),
+                                                         G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+                                                         G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION,
+                                                         NULL,
+                                                         NULL,
+                                                         &error);
+    g_assert_no_error (error);
+
+    /* The filter is in place before becoming a monitor, so that monitored
+     * method calls are never replied by GDBus */
+    filter_id = g_dbus_connection_add_filter (connection, (GDBusMessageFilterFunction)monitor_filter_cb, counters, NULL);
+
+    rules[0] = g_strdup_printf ("sender='%s'", owner);
+    rules[1] = g_strdup_printf ("destination='%s'", owner);
+    result = g_dbus_connection_call_sync (connection,
+                                          "org.freedesktop.DBus",
+                                          "/org/freedesktop/DBus",
+                                          "org.freedesktop.DBus.Monitoring",
+                                          "BecomeMonitor",
+                                          g_variant_new ("(^asu)", rules, 0),
+                                          NULL,
+                                          G_DBUS_CALL_FLAGS_NONE,
+                                          -1,
+                                          NULL,
+                                          &error);
+    g_free (rules[0]);
+    g_free (rules[1]);
+    g_free (owner);
+
+    if (!result) {
+        /* Old bus daemons don't support monitors */
+        g_test_message ("Couldn't monitor DBus messages: %s", error->message);
+        g_error_free (error);
+        g_dbus_connection_remove_filter (connection, filter_id);
+        g_object_unref (connection);
+        return NULL;
+    }
+    g_variant_unref (result);
+
+    return connection;
+}
+
+static void
+message_counters_get (MessageCounters *counters,
+                      MessageCounters *snapshot)
+{
+    snapshot->n_signals = g_atomic_int_get (&counters->n_signals);
+    snapshot->n_method_calls = g_atomic_int_get (&counters->n_method_calls);
+    snapshot->n_replies = g_atomic_int_get (&counters->n_replies);
+}
+
+static gboolean
+monitor_window_done_cb (MonitorContext *ctx)
+{
+    g_main_loop_quit (ctx->loop);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+monitor_steady_state (TestFixture *fixture,
+                      guint        pid,
+                      const gchar *modem_path,
+                      guint        n_modems,
+                      guint        window_secs)
+{
+    MonitorContext    ctx = { 0 };
+    MessageCounters   counters = { 0 };
+    MessageCounters   counters_start;
+    MessageCounters   counters_end;
+    GDBusConnection  *monitor;
+    guint             probe_id;
+    gdouble           cpu_start;
+    gdouble           cpu_end;
+    gint64            start;
+    gdouble           elapsed;
+
+    ctx.connection = fixture->connection;
+    ctx.modem_path = modem_path;
+    ctx.loop = g_main_loop_new (NULL, FALSE);
+    ctx.probe_latencies = g_array_new (FALSE, FALSE, sizeof (gdouble));
+
+    monitor = monitor_connection_new (fixture, &counters);
+    probe_id = g_timeout_add (PROBE_INTERVAL_MS, (GSourceFunc)probe_cb, &ctx);
+    g_timeout_add_seconds (window_secs, (GSourceFunc)monitor_window_done_cb, &ctx);
+
+    start = g_get_monotonic_time ();
+    cpu_start = get_process_cpu_time (pid);
+    message_counters_get (&counters, &counters_start);
+    g_main_loop_run (ctx.loop);
+    message_counters_get (&counters, &counters_end);
+    cpu_end = get_process_cpu_time (pid);
+    elapsed = (g_get_monotonic_time () - start) / (gdouble) G_USEC_PER_SEC;
+
+    g_source_remove (probe_id);
+
+    /* Let pending probes finish, they reference the context */
+    while (ctx.probes_pending)
+        g_main_context_iteration (NULL, TRUE);
+
+    if (monitor) {
+        g_dbus_connection_close_sync (monitor, NULL, NULL);
+        g_object_unref (monitor);
+    }
+
+    g_array_sort (ctx.probe_latencies, (GCompareFunc)test_fixture_latency_cmp);
+
+    g_test_message ("[%u modems] steady state CPU: %.2f%%", n_modems, 100.0 * (cpu_end - cpu_start) / elapsed);
+    g_test_message ("[%u modems] main loop latency (ms): p50 %.3f, p90 %.3f, p99 %.3f, max %.3f (%u samples)",
+                    n_modems,
+                    test_fixture_latency_percentile (ctx.probe_latencies, 50),
+                    test_fixture_latency_percentile (ctx.probe_latencies, 90),
+                    test_fixture_latency_percentile (ctx.probe_latencies, 99),
+                    test_fixture_latency_percentile (ctx.probe_latencies, 100),
+                    ctx.probe_latencies->len);
+    /* Includes the latency probes, one method call and one reply each */
+    if (monitor)
+        g_test_message ("[%u modems] DBus messages: %.2f/s (signals %.2f/s, method calls %.2f/s, replies %.2f/s)",
+                        n_modems,
+                        ((counters_end.n_signals + counters_end.n_method_calls + counters_end.n_replies) -
+                         (counters_start.n_signals + counters_start.n_method_calls + counters_start.n_replies)) / elapsed,
+                        (counters_end.n_signals - counters_start.n_signals) / elapsed,
+                        (counters_end.n_method_calls - counters_start.n_method_calls) / elapsed,
+                        (counters_end.n_replies - counters_start.n_replies) / elapsed);
+
+    g_array_unref (ctx.probe_latencies);
+    g_main_loop_unref (ctx.loop);
+}
+
+/*****************************************************************************/
+
+typedef struct {
+    GMainLoop *loop;
+    guint      n_pending;
+} EnableContext;
+
+static void
+enable_ready (MMModem       *modem,
+              GAsyncResult  *res,
+              EnableContext *ctx)
+{
+    GError *error = NULL;
+
+    mm_modem_enable_finish (modem, res, &error);
+    g_assert_no_error (error);
+
+    if (--ctx->n_pending == 0)
+        g_main_loop_quit (ctx->loop);
+}
+
+static void
+test_scale (TestFixture   *fixture,
+            gconstpointer  data)
+{
+    guint             n_modems;
+    guint             pid;
+    guint             i;
+    guint64           rss_start;
+    guint64           rss_end;
+    gint64            start;
+    gdouble           exported_time;
+    gdouble           enabled_time;
+    TestPortContext **port_contexts;
+    gchar           **ports;
+    GList            *modems;
+    GList            *l;
+    EnableContext     enable_ctx = { 0 };
+
+    n_modems = GPOINTER_TO_UINT (data);
+
+    test_fixture_no_modem (fixture);
+    pid = get_daemon_pid (fixture);
+    rss_start = get_process_rss (pid);
+
+    /* Setup all port contexts, replying with some latency as real modems
+     * would do */
+    port_contexts = g_new0 (TestPortContext *, n_modems);
+    ports = g_new0 (gchar *, n_modems + 1);
+    for (i = 0; i < n_modems; i++) {
+        ports[i] = g_strdup_printf ("abstract:scale%u:%ld", i, (glong) getpid ());
+        port_contexts[i] = test_port_context_new (ports[i]);
+        test_port_context_load_commands (port_contexts[i], COMMON_GSM_PORT_CONF);
+        test_port_context_set_latency (port_contexts[i], NULL, 1, 10);
+        test_port_context_set_seed (port_contexts[i], i);
+        test_port_context_start (port_contexts[i]);
+    }
+
+    /* Create all modems */
+    start = g_get_monotonic_time ();
+    for (i = 0; i < n_modems; i++) {
+        const gchar *modem_ports[] = { ports[i], NULL };
+        gchar       *profile;
+
+        profile = g_strdup_printf ("test-scale-%u", i);
+        test_fixture_set_profile (fixture, profile, "Generic", modem_ports);
+        g_free (profile);
+    }
+
+    modems = test_fixture_get_modems (fixture, n_modems);
+    exported_time = (g_get_monotonic_time () - start) / (gdouble) G_USEC_PER_SEC;
+
+    /* Enable all of them at the same time */
+    enable_ctx.loop = g_main_loop_new (NULL, FALSE);
+    enable_ctx.n_pending = n_modems;
+    for (l = modems; l; l = g_list_next (l)) {
+        MMModem *modem;
+
+        modem = mm_object_get_modem (MM_OBJECT (l->data));
+        g_assert (modem != NULL);
+        g_dbus_proxy_set_default_timeout (G_DBUS_PROXY (modem), ENABLE_TIMEOUT_MS);
+        mm_modem_enable (modem, NULL, (GAsyncReadyCallback)enable_ready, &enable_ctx);
+        g_object_unref (modem);
+    }
+    g_main_loop_run (enable_ctx.loop);
+    g_main_loop_unref (enable_ctx.loop);
+    enabled_time = (g_get_monotonic_time () - start) / (gdouble) G_USEC_PER_SEC;
+
+    rss_end = get_process_rss (pid);
+
+    g_test_message ("[%u modems] time to all modems exported: %.3fs", n_modems, exported_time);
+    g_test_message ("[%u modems] time to all modems enabled: %.3fs", n_modems, enabled_time);
+    g_test_message ("[%u modems] RSS: %" G_GUINT64_FORMAT " kB -> %" G_GUINT64_FORMAT " kB (%.1f kB per modem)",
+                    n_modems, rss_start, rss_end,
+                    rss_end > rss_start ? (gdouble)(rss_end - rss_start) / n_modems : 0.0);
+    g_test_minimized_result (enabled_time, "time to %u modems enabled: %.3fs", n_modems, enabled_time);
+
+    /* Measure how the daemon behaves with all modems enabled and idle */
+    monitor_steady_state (fixture,
+                          pid,
+                          mm_object_get_path (MM_OBJECT (modems->data)),
+                          n_modems,
+                          g_test_perf () ? STEADY_STATE_WINDOW_SECS : 1);
+
+    /* Disable all modems before leaving */
+    for (l = modems; l; l = g_list_next (l)) {
+        GError  *error = NULL;
+        MMModem *modem;
+
+        modem = mm_object_get_modem (MM_OBJECT (l->data));
+        g_dbus_proxy_set_default_timeout (G_DBUS_PROXY (modem), ENABLE_TIMEOUT_MS);
+        mm_modem_disable_sync (modem, NULL, &error);
+        g_assert_no_error (error);
+        g_object_unref (modem);
+    }
+    g_list_free_full (modems, g_object_unref);
+
+    for (i = 0; i < n_modems; i++) {
+        test_port_context_stop (port_contexts[i]);
+        test_port_context_free (port_contexts[i]);
+    }
+    g_free (port_contexts);
+    g_strfreev (ports);
+}
+
+/*****************************************************************************/
+
+static void
+add_scale_test (guint n_modems)
+{
+    gchar *path;
+
+    path = g_strdup_printf ("/MM/Service/Scale/%u", n_modems);
+    g_test_add (path,
+                TestFixture,
+                GUINT_TO_POINTER (n_modems),
+                (TCFunc)test_fixture_setup,
+                (TCFunc)test_scale,
+                (TCFunc)test_fixture_teardown);
+    g_free (path);
+}
+
+int main (int   argc,
+          char *argv[])
+{
+    g_test_init (&argc, &argv, NULL);
+
+    if (g_test_perf ()) {
+        const gchar *env;
+        guint        n_modems;
+
+        /* A specific number of modems may be requested */
+        env = g_getenv ("MM_TEST_SCALE_MODEMS");
+        n_modems = env ? atoi (env) : 0;
+        if (n_modems > 0) {
+            g_assert_cmpuint (n_modems, <=, 128);
+            add_scale_test (n_modems);
+        } else {
+            add_scale_test (1);
+            add_scale_test (8);
+            add_scale_test (32);
+            add_scale_test (128);
+        }
+    } else
+        add_scale_test (2);
+
+    return g_test_run ();
+}
@@ -39,8 +39,18 @@ struct _MMBroadbandBearerHuaweiPrivate {
     gpointer disconnect_pending;
     /* Tag for the post task for network-initiated disconnect */
     guint network_disconnect_pending_id;
+    /* Latest ^DSFLOWRPT counters */
+    guint64 tx_bytes;
+    guint64 rx_bytes;
 };
 
+/* Connection and disconnection completion is driven by the ^NDISSTAT
+ * unsolicited messages; ^NDISSTATQRY? polling is only used as a fallback when
+ * the modem stays quiet for a while after ^NDISDUP. */
+#define NDISSTAT_QUIET_PERIOD_SEC  5
+#define NDISSTAT_POLL_INTERVAL_SEC 1
+#define NDISSTAT_TIMEOUT_SEC       60
+
 /*****************************************************************************/
 
 static MMPortSerialAt *
@@ -76,7 +86,10 @@ typedef struct {
     MMPortSerialAt *primary;
     MMPort *data;
     Connect3gppContextStep step;
-    guint check_count;
+    gint64 ndisstat_started;
+    guint ndisstat_wait_id;
+    gboolean ndisstatqry_running;
+    gboolean ndisstat_connected;
     guint failed_ndisstatqry_count;
     MMBearerIpConfig *ipv4_config;
 } Connect3gppContext;
@@ -84,6 +97,9 @@ typedef struct {
 static void
 connect_3gpp_context_free (Connect3gppContext *ctx)
 {
+    if (ctx->ndisstat_wait_id)
+        g_source_remove (ctx->ndisstat_wait_id);
+
     g_object_unref (ctx->modem);
 
     g_clear_object (&ctx->ipv4_config);
@@ -185,23 +201,69 @@ connect_dhcp_check_ready (MMBaseModem *modem,
 }
 
 static gboolean
-connect_retry_ndisstatqry_check_cb (MMBroadbandBearerHuawei *self)
+connect_ndisstat_wait_cb (MMBroadbandBearerHuawei *self)
 {
     GTask *task;
+    Connect3gppContext *ctx;
 
     /* Recover context */
     task = self->priv->connect_pending;
     g_assert (task != NULL);
 
-    /* Balance refcount */
-    g_object_unref (self);
+    ctx = g_task_get_task_data (task);
+    ctx->ndisstat_wait_id = 0;
 
-    /* Retry same step */
+    /* No ^NDISSTAT received yet, (re)run the same step to poll */
     connect_3gpp_context_step (task);
 
     return G_SOURCE_REMOVE;
 }
 
+static void
+connect_ndisstat_wait (MMBroadbandBearerHuawei *self,
+                       Connect3gppContext *ctx,
+                       guint seconds)
+{
+    g_assert (ctx->ndisstat_wait_id == 0);
+    ctx->ndisstat_wait_id = g_timeout_add_seconds (seconds,
+                                                   (GSourceFunc)connect_ndisstat_wait_cb,
+                                                   self);
+}
+
+static void
+connect_report_ndisstat (MMBroadbandBearerHuawei *self,
+                         MMBearerConnectionStatus status)
+{
+    GTask *task;
+    Connect3gppContext *ctx;
+
+    task = self->priv->connect_pending;
+    ctx = g_task_get_task_data (task);
+
+    /* Only a 'connected' report after ^NDISDUP was sent is meaningful here;
+     * a 'disconnected' one is just the state we're moving away from. */
+    if (status != MM_BEARER_CONNECTION_STATUS_CONNECTED ||
+        ctx->step < CONNECT_3GPP_CONTEXT_STEP_NDISDUP ||
+        ctx->step > CONNECT_3GPP_CONTEXT_STEP_NDISSTATQRY)
+        return;
+
+    mm_dbg ("Received ^NDISSTAT (connected) while connecting");
+    ctx->ndisstat_connected = TRUE;
+
+    /* If ^NDISDUP hasn't been replied yet, or a ^NDISSTATQRY? is in flight,
+     * the flag will be processed once those finish. */
+    if (ctx->step != CONNECT_3GPP_CONTEXT_STEP_NDISSTATQRY || ctx->ndisstatqry_running)
+        return;
+
+    if (ctx->ndisstat_wait_id) {
+        g_source_remove (ctx->ndisstat_wait_id);
+        ctx->ndisstat_wait_id = 0;
+    }
+
+    ctx->step++;
+    connect_3gpp_context_step (task);
+}
+
 static void
 connect_ndisstatqry_check_ready (MMBaseModem *modem,
                                  GAsyncResult *res,
@@ -220,6 +282,7 @@ connect_ndisstatqry_check_ready (MMBaseModem *modem,
     g_assert (task != NULL);
 
     ctx = g_task_get_task_data (task);
+    ctx->ndisstatqry_running = FALSE;
 
     /* Balance refcount */
     g_object_unref (self);
@@ -238,8 +301,9 @@ connect_ndisstatqry_check_ready (MMBaseModem *modem,
         g_error_free (error);
     }
 
-    /* Connected in IPv4? */
-    if (ipv4_available && ipv4_connected) {
+    /* Connected in IPv4? Either the query or a ^NDISSTAT received while the
+     * query was running tells us so. */
+    if ((ipv4_available && ipv4_connected) || ctx->ndisstat_connected) {
         /* Success! */
         ctx->step++;
         connect_3gpp_context_step (task);
@@ -247,9 +311,7 @@ connect_ndisstatqry_check_ready (MMBaseModem *modem,
     }
 
     /* Setup timeout to retry the same step */
-    g_timeout_add_seconds (1,
-                           (GSourceFunc)connect_retry_ndisstatqry_check_cb,
-                           g_object_ref (self));
+    connect_ndisstat_wait (self, ctx, NDISSTAT_POLL_INTERVAL_SEC);
 }
 
 static void
@@ -425,11 +487,23 @@ connect_3gpp_context_step (GTask *task)
     }
 
     case CONNECT_3GPP_CONTEXT_STEP_NDISSTATQRY:
-        /* Wait for dial up timeout, retries for 60 times
-         * (1s between the retries, so it means 1 minute).
-         * If too many retries, failed
-         */
-        if (ctx->check_count > 60) {
+        /* Already reported connected via ^NDISSTAT? */
+        if (ctx->ndisstat_connected) {
+            ctx->step++;
+            connect_3gpp_context_step (task);
+            return;
+        }
+
+        /* On the first run, just wait for the ^NDISSTAT unsolicited message;
+         * only fall back to polling if the modem stays quiet. */
+        if (!ctx->ndisstat_started) {
+            ctx->ndisstat_started = g_get_monotonic_time ();
+            connect_ndisstat_wait (self, ctx, NDISSTAT_QUIET_PERIOD_SEC);
+            return;
+        }
+
+        /* Wait for dial up timeout (1 minute). If too long, failed */
+        if (g_get_monotonic_time () - ctx->ndisstat_started > NDISSTAT_TIMEOUT_SEC * G_USEC_PER_SEC) {
             /* Clear context */
             self->priv->connect_pending = NULL;
             g_task_return_new_error (task,
@@ -453,7 +527,7 @@ connect_3gpp_context_step (GTask *task)
         }
 
         /* Check if connected */
-        ctx->check_count++;
+        ctx->ndisstatqry_running = TRUE;
         mm_base_modem_at_command_full (ctx->modem,
                                        ctx->primary,
                                        "^NDISSTATQRY?",
@@ -538,6 +612,10 @@ connect_3gpp (MMBroadbandBearer *_self,
     ctx->ipv4_config = mm_bearer_ip_config_new ();
     mm_bearer_ip_config_set_method (ctx->ipv4_config, MM_BEARER_IP_METHOD_DHCP);
 
+    /* Flow counters start over on each connection */
+    self->priv->tx_bytes = 0;
+    self->priv->rx_bytes = 0;
+
     task = g_task_new (self, NULL, callback, user_data);
     g_task_set_task_data (task, ctx, (GDestroyNotify)connect_3gpp_context_free);
     g_task_set_check_cancellable (task, FALSE);
@@ -560,13 +638,19 @@ typedef struct {
     MMBaseModem *modem;
     MMPortSerialAt *primary;
     Disconnect3gppContextStep step;
-    guint check_count;
+    gint64 ndisstat_started;
+    guint ndisstat_wait_id;
+    gboolean ndisstatqry_running;
+    gboolean ndisstat_disconnected;
     guint failed_ndisstatqry_count;
 } Disconnect3gppContext;
 
 static void
 disconnect_3gpp_context_free (Disconnect3gppContext *ctx)
 {
+    if (ctx->ndisstat_wait_id)
+        g_source_remove (ctx->ndisstat_wait_id);
+
     g_object_unref (ctx->primary);
     g_object_unref (ctx->modem);
     g_slice_free (Disconnect3gppContext, ctx);
@@ -583,22 +667,67 @@ disconnect_3gpp_finish (MMBroadbandBearer *self,
 static void disconnect_3gpp_context_step (GTask *task);
 
 static gboolean
-disconnect_retry_ndisstatqry_check_cb (MMBroadbandBearerHuawei *self)
+disconnect_ndisstat_wait_cb (MMBroadbandBearerHuawei *self)
 {
     GTask *task;
+    Disconnect3gppContext *ctx;
 
     /* Recover context */
     task = self->priv->disconnect_pending;
     g_assert (task != NULL);
 
-    /* Balance refcount */
-    g_object_unref (self);
+    ctx = g_task_get_task_data (task);
+    ctx->ndisstat_wait_id = 0;
 
-    /* Retry same step */
+    /* No ^NDISSTAT received yet, (re)run the same step to poll */
     disconnect_3gpp_context_step (task);
     return G_SOURCE_REMOVE;
 }
 
+static void
+disconnect_ndisstat_wait (MMBroadbandBearerHuawei *self,
+                          Disconnect3gppContext *ctx,
+                          guint seconds)
+{
+    g_assert (ctx->ndisstat_wait_id == 0);
+    ctx->ndisstat_wait_id = g_timeout_add_seconds (seconds,
+                                                   (GSourceFunc)disconnect_ndisstat_wait_cb,
+                                                   self);
+}
+
+static void
+disconnect_report_ndisstat (MMBroadbandBearerHuawei *self,
+                            MMBearerConnectionStatus status)
+{
+    GTask *task;
+    Disconnect3gppContext *ctx;
+
+    task = self->priv->disconnect_pending;
+    ctx = g_task_get_task_data (task);
+
+    /* Only a 'disconnected' report after ^NDISDUP was sent is meaningful */
+    if (status == MM_BEARER_CONNECTION_STATUS_CONNECTED ||
+        ctx->step < DISCONNECT_3GPP_CONTEXT_STEP_NDISDUP ||
+        ctx->step > DISCONNECT_3GPP_CONTEXT_STEP_NDISSTATQRY)
+        return;
+
+    mm_dbg ("Received ^NDISSTAT (disconnected) while disconnecting");
+    ctx->ndisstat_disconnected = TRUE;
+
+    /* If ^NDISDUP hasn't been replied yet, or a ^NDISSTATQRY? is in flight,
+     * the flag will be processed once those finish. */
+    if (ctx->step != DISCONNECT_3GPP_CONTEXT_STEP_NDISSTATQRY || ctx->ndisstatqry_running)
+        return;
+
+    if (ctx->ndisstat_wait_id) {
+        g_source_remove (ctx->ndisstat_wait_id);
+        ctx->ndisstat_wait_id = 0;
+    }
+
+    ctx->step++;
+    disconnect_3gpp_context_step (task);
+}
+
 static void
 disconnect_ndisstatqry_check_ready (MMBaseModem *modem,
                                     GAsyncResult *res,
@@ -617,6 +746,7 @@ disconnect_ndisstatqry_check_ready (MMBaseModem *modem,
     g_assert (task != NULL);
 
     ctx = g_task_get_task_data (task);
+    ctx->ndisstatqry_running = FALSE;
 
     /* Balance refcount */
     g_object_unref (self);
@@ -635,8 +765,9 @@ disconnect_ndisstatqry_check_ready (MMBaseModem *modem,
         g_error_free (error);
     }
 
-    /* Disconnected IPv4? */
-    if (ipv4_available && !ipv4_connected) {
+    /* Disconnected IPv4? Either the query or a ^NDISSTAT received while the
+     * query was running tells us so. */
+    if ((ipv4_available && !ipv4_connected) || ctx->ndisstat_disconnected) {
         /* Success! */
         ctx->step++;
         disconnect_3gpp_context_step (task);
@@ -644,9 +775,7 @@ disconnect_ndisstatqry_check_ready (MMBaseModem *modem,
     }
 
     /* Setup timeout to retry the same step */
-    g_timeout_add_seconds (1,
-                           (GSourceFunc)disconnect_retry_ndisstatqry_check_cb,
-                           g_object_ref (self));
+    disconnect_ndisstat_wait (self, ctx, NDISSTAT_POLL_INTERVAL_SEC);
 }
 
 static void
@@ -717,8 +846,23 @@ disconnect_3gpp_context_step (GTask *task)
         return;
 
     case DISCONNECT_3GPP_CONTEXT_STEP_NDISSTATQRY:
-        /* If too many retries (1s of wait between the retries), failed */
-        if (ctx->check_count > 60) {
+        /* Already reported disconnected via ^NDISSTAT? */
+        if (ctx->ndisstat_disconnected) {
+            ctx->step++;
+            disconnect_3gpp_context_step (task);
+            return;
+        }
+
+        /* On the first run, just wait for the ^NDISSTAT unsolicited message;
+         * only fall back to polling if the modem stays quiet. */
+        if (!ctx->ndisstat_started) {
+            ctx->ndisstat_started = g_get_monotonic_time ();
+            disconnect_ndisstat_wait (self, ctx, NDISSTAT_QUIET_PERIOD_SEC);
+            return;
+        }
+
+        /* If too long, failed */
+        if (g_get_monotonic_time () - ctx->ndisstat_started > NDISSTAT_TIMEOUT_SEC * G_USEC_PER_SEC) {
             /* Clear task */
             self->priv->disconnect_pending = NULL;
             g_task_return_new_error (task,
@@ -742,7 +886,7 @@ disconnect_3gpp_context_step (GTask *task)
         }
 
         /* Check if disconnected */
-        ctx->check_count++;
+        ctx->ndisstatqry_running = TRUE;
         mm_base_modem_at_command_full (ctx->modem,
                                        ctx->primary,
                                        "^NDISSTATQRY?",
@@ -821,11 +965,16 @@ report_connection_status (MMBaseBearer *bearer,
               status == MM_BEARER_CONNECTION_STATUS_DISCONNECTING ||
               status == MM_BEARER_CONNECTION_STATUS_DISCONNECTED);
 
-    /* When a pending connection / disconnection attempt is in progress, we use
-     * ^NDISSTATQRY? to check the connection status and thus temporarily ignore
-     * ^NDISSTAT unsolicited messages */
-    if (self->priv->connect_pending || self->priv->disconnect_pending)
+    /* When a pending connection / disconnection attempt is in progress, the
+     * ^NDISSTAT unsolicited messages drive its completion */
+    if (self->priv->connect_pending) {
+        connect_report_ndisstat (self, status);
+        return;
+    }
+    if (self->priv->disconnect_pending) {
+        disconnect_report_ndisstat (self, status);
         return;
+    }
 
     mm_dbg ("Received spontaneous ^NDISSTAT (%s)",
             mm_bearer_connection_status_get_string (status));
@@ -834,8 +983,8 @@ report_connection_status (MMBaseBearer *bearer,
     if (status == MM_BEARER_CONNECTION_STATUS_CONNECTED)
         return;
 
-    /* We already use ^NDISSTATQRY? to poll the connection status, so only
-     * handle network-initiated disconnection here. */
+    /* Outside of connection / disconnection attempts, only handle
+     * network-initiated disconnection here. */
     if (status == MM_BEARER_CONNECTION_STATUS_DISCONNECTING) {
         /* MM_BEARER_CONNECTION_STATUS_DISCONNECTING is used to indicate that the
          * reporting of disconnection should be delayed. See MMBroadbandModemHuawei's
@@ -858,6 +1007,52 @@ report_connection_status (MMBaseBearer *bearer,
         MM_BEARER_CONNECTION_STATUS_DISCONNECTED);
 }
 
+/*****************************************************************************/
+/* Reload statistics */
+
+void
+mm_broadband_bearer_huawei_report_flow_stats (MMBroadbandBearerHuawei *self,
+                                              guint64 tx_bytes,
+                                              guint64 rx_bytes)
+{
+    if (mm_base_bearer_get_status (MM_BASE_BEARER (self)) != MM_BEARER_STATUS_CONNECTED)
+        return;
+
+    self->priv->tx_bytes = tx_bytes;
+    self->priv->rx_bytes = rx_bytes;
+}
+
+static gboolean
+reload_stats_finish (MMBaseBearer *self,
+                     guint64 *bytes_rx,
+                     guint64 *bytes_tx,
+                     GAsyncResult *res,
+                     GError **error)
+{
+    if (!g_task_propagate_boolean (G_TASK (res), error))
+        return FALSE;
+
+    if (bytes_rx)
+        *bytes_rx = MM_BROADBAND_BEARER_HUAWEI (self)->priv->rx_bytes;
+    if (bytes_tx)
+        *bytes_tx = MM_BROADBAND_BEARER_HUAWEI (self)->priv->tx_bytes;
+    return TRUE;
+}
+
+static void
+reload_stats (MMBaseBearer *self,
+              GAsyncReadyCallback callback,
+              gpointer user_data)
+{
+    GTask *task;
+
+    /* The modem keeps us up to date through ^DSFLOWRPT unsolicited messages,
+     * so there's nothing to query here. */
+    task = g_task_new (self, NULL, callback, user_data);
+    g_task_return_boolean (task, TRUE);
+    g_object_unref (task);
+}
+
 /*****************************************************************************/
 
 MMBaseBearer *
@@ -934,6 +1129,8 @@ mm_broadband_bearer_huawei_class_init (MMBroadbandBearerHuaweiClass *klass)
     base_bearer_class->report_connection_status = report_connection_status;
     base_bearer_class->load_connection_status = NULL;
     base_bearer_class->load_connection_status_finish = NULL;
+    base_bearer_class->reload_stats = reload_stats;
+    base_bearer_class->reload_stats_finish = reload_stats_finish;
 
     broadband_bearer_class->connect_3gpp = connect_3gpp;
     broadband_bearer_class->connect_3gpp_finish = connect_3gpp_finish;
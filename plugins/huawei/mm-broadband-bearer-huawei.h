@@ -56,4 +56,8 @@ void          mm_broadband_bearer_huawei_new        (MMBroadbandModemHuawei *mod
 MMBaseBearer *mm_broadband_bearer_huawei_new_finish (GAsyncResult *res,
                                                      GError **error);
 
+void          mm_broadband_bearer_huawei_report_flow_stats (MMBroadbandBearerHuawei *self,
+                                                            guint64 tx_bytes,
+                                                            guint64 rx_bytes);
+
 #endif /* MM_BROADBAND_BEARER_HUAWEI_H */
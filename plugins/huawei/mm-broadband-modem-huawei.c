@@ -91,39 +91,14 @@ typedef struct {
 } DetailedSignal;
 
 struct _MMBroadbandModemHuaweiPrivate {
-    /* Regex for signal quality related notifications */
-    GRegex *rssi_regex;
-    GRegex *rssilvl_regex;
-    GRegex *hrssilvl_regex;
-
-    /* Regex for access-technology related notifications */
-    GRegex *mode_regex;
-
-    /* Regex for connection status related notifications */
-    GRegex *dsflowrpt_regex;
-    GRegex *ndisstat_regex;
-
-    /* Regex to ignore */
-    GRegex *boot_regex;
-    GRegex *connect_regex;
-    GRegex *csnr_regex;
-    GRegex *cusatp_regex;
-    GRegex *cusatend_regex;
-    GRegex *dsdormant_regex;
-    GRegex *simst_regex;
-    GRegex *srvst_regex;
-    GRegex *stin_regex;
-    GRegex *hcsq_regex;
-    GRegex *pdpdeact_regex;
-    GRegex *ndisend_regex;
+    /* Single regex matching all the unsolicited messages we either process
+     * or ignore; see unsolicited_msgs[] */
+    GRegex *unsolicited_regex;
+    /* Which groups of unsolicited messages are currently processed */
+    guint unsolicited_groups;
+
+    /* ^RFSWITCH is ignored, except while explicitly querying it */
     GRegex *rfswitch_regex;
-    GRegex *position_regex;
-    GRegex *posend_regex;
-    GRegex *ecclist_regex;
-    GRegex *ltersrp_regex;
-    GRegex *cschannelinfo_regex;
-    GRegex *eons_regex;
-    GRegex *orig_regex;
 
     FeatureSupport ndisdup_support;
     FeatureSupport rfswitch_support;
@@ -1517,14 +1492,38 @@ set_current_modes (MMIfaceModem *_self,
 /*****************************************************************************/
 /* Setup/Cleanup unsolicited events (3GPP interface) */
 
+typedef enum {
+    UNSOLICITED_GROUP_3GPP = 1 << 0,
+    UNSOLICITED_GROUP_CDMA = 1 << 1,
+} UnsolicitedGroup;
+
+/* Unsolicited message arguments are given in place in the port buffer, so
+ * they're not NUL-terminated; numbers just end at the first non-digit. */
+static gboolean
+unsolicited_arg_to_uint (const gchar *str,
+                         guint *out)
+{
+    guint64 num;
+
+    if (!g_ascii_isdigit (*str))
+        return FALSE;
+
+    num = g_ascii_strtoull (str, NULL, 10);
+    if (num > G_MAXUINT)
+        return FALSE;
+
+    *out = (guint)num;
+    return TRUE;
+}
+
 static void
-huawei_signal_changed (MMPortSerialAt *port,
-                       GMatchInfo *match_info,
-                       MMBroadbandModemHuawei *self)
+huawei_signal_changed (MMBroadbandModemHuawei *self,
+                       const gchar *args,
+                       gsize args_len)
 {
     guint quality = 0;
 
-    if (!mm_get_uint_from_match_info (match_info, 1, &quality))
+    if (!unsolicited_arg_to_uint (args, &quality))
         return;
 
     if (quality == 99) {
@@ -1540,24 +1539,26 @@ huawei_signal_changed (MMPortSerialAt *port,
 }
 
 static void
-huawei_mode_changed (MMPortSerialAt *port,
-                     GMatchInfo *match_info,
-                     MMBroadbandModemHuawei *self)
+huawei_mode_changed (MMBroadbandModemHuawei *self,
+                     const gchar *args,
+                     gsize args_len)
 {
     MMModemAccessTechnology act = MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN;
     gchar *str;
-    gint a;
+    guint a = 0;
+    guint submode;
+    const gchar *comma;
     guint32 mask = MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN;
 
-    str = g_match_info_fetch (match_info, 1);
-    a = atoi (str);
-    g_free (str);
+    /* 3GPP: ^MODE:5,4
+     * CDMA: ^MODE: 2
+     */
+    unsolicited_arg_to_uint (args, &a);
 
     /* CDMA/EVDO devices may not send this */
-    str = g_match_info_fetch (match_info, 2);
-    if (str[0])
-        act = huawei_sysinfo_submode_to_act (atoi (str));
-    g_free (str);
+    comma = memchr (args, ',', args_len);
+    if (comma && unsolicited_arg_to_uint (comma + 1, &submode))
+        act = huawei_sysinfo_submode_to_act (submode);
 
     switch (a) {
     case 3:
@@ -1620,7 +1621,7 @@ huawei_mode_changed (MMPortSerialAt *port,
         break;
 
     default:
-        mm_warn ("Unexpected mode change value reported: '%d'", a);
+        mm_warn ("Unexpected mode change value reported: '%u'", a);
         return;
     }
 
@@ -1631,20 +1632,63 @@ huawei_mode_changed (MMPortSerialAt *port,
     mm_iface_modem_update_access_technologies (MM_IFACE_MODEM (self), act, mask);
 }
 
+typedef struct {
+    guint64 tx_bytes;
+    guint64 rx_bytes;
+} DsflowrptResult;
+
 static void
-huawei_status_changed (MMPortSerialAt *port,
-                       GMatchInfo *match_info,
-                       MMBroadbandModemHuawei *self)
+bearer_report_flow_stats (MMBaseBearer *bearer,
+                          DsflowrptResult *dsflowrpt_result)
 {
-    gchar *str;
-    gint n1, n2, n3, n4, n5, n6, n7;
+    /* Only our own bearers know how to use these */
+    if (MM_IS_BROADBAND_BEARER_HUAWEI (bearer))
+        mm_broadband_bearer_huawei_report_flow_stats (MM_BROADBAND_BEARER_HUAWEI (bearer),
+                                                      dsflowrpt_result->tx_bytes,
+                                                      dsflowrpt_result->rx_bytes);
+}
+
+static void
+huawei_dsflowrpt_received (MMBroadbandModemHuawei *self,
+                           const gchar *args,
+                           gsize args_len)
+{
+    DsflowrptResult dsflowrpt_result;
+    guint duration;
+    guint tx_rate;
+    guint rx_rate;
+    GError *error = NULL;
+    MMBearerList *list = NULL;
 
-    str = g_match_info_fetch (match_info, 1);
-    if (sscanf (str, "%x,%x,%x,%x,%x,%x,%x", &n1, &n2, &n3, &n4, &n5, &n6, &n7)) {
-        mm_dbg ("Duration: %d Up: %d Kbps Down: %d Kbps Total: %d Total: %d\n",
-                n1, n2 * 8 / 1000, n3  * 8 / 1000, n4 / 1024, n5 / 1024);
+    if (!mm_huawei_parse_dsflowrpt (args,
+                                    &duration,
+                                    &tx_rate,
+                                    &rx_rate,
+                                    &dsflowrpt_result.tx_bytes,
+                                    &dsflowrpt_result.rx_bytes,
+                                    &error)) {
+        mm_dbg ("Ignored invalid ^DSFLOWRPT message: '%.*s' (error %s)",
+                (gint)args_len, args, error->message);
+        g_error_free (error);
+        return;
     }
-    g_free (str);
+
+    mm_dbg ("Duration: %u Up: %u Kbps Down: %u Kbps Total: %" G_GUINT64_FORMAT " KiB Total: %" G_GUINT64_FORMAT " KiB",
+            duration, tx_rate * 8 / 1000, rx_rate * 8 / 1000,
+            dsflowrpt_result.tx_bytes / 1024, dsflowrpt_result.rx_bytes / 1024);
+
+    /* The flow counters are the bearer statistics */
+    g_object_get (self,
+                  MM_IFACE_MODEM_BEARER_LIST, &list,
+                  NULL);
+    if (!list)
+        return;
+
+    mm_bearer_list_foreach (list,
+                            (MMBearerListForeachFunc)bearer_report_flow_stats,
+                            &dsflowrpt_result);
+
+    g_object_unref (list);
 }
 
 typedef struct {
@@ -1672,16 +1716,17 @@ bearer_report_connection_status (MMBaseBearer *bearer,
 }
 
 static void
-huawei_ndisstat_changed (MMPortSerialAt *port,
-                         GMatchInfo *match_info,
-                         MMBroadbandModemHuawei *self)
+huawei_ndisstat_changed (MMBroadbandModemHuawei *self,
+                         const gchar *args,
+                         gsize args_len)
 {
     gchar *str;
     NdisstatResult ndisstat_result;
     GError *error = NULL;
     MMBearerList *list = NULL;
 
-    str = g_match_info_fetch (match_info, 1);
+    /* Rare enough to just rebuild the full reply for the shared parser */
+    str = g_strdup_printf ("^NDISSTAT:%.*s", (gint)args_len, args);
     if (!mm_huawei_parse_ndisstatqry_response (str,
                                                &ndisstat_result.ipv4_available,
                                                &ndisstat_result.ipv4_connected,
@@ -1777,11 +1822,10 @@ get_rsrq_db (guint rsrq, gdouble *out_val)
 }
 
 static void
-huawei_hcsq_changed (MMPortSerialAt *port,
-                     GMatchInfo *match_info,
-                     MMBroadbandModemHuawei *self)
+huawei_hcsq_changed (MMBroadbandModemHuawei *self,
+                     const gchar *args,
+                     gsize args_len)
 {
-    gchar *str;
     MMModemAccessTechnology act = MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN;
     guint value1 = 0;
     guint value2 = 0;
@@ -1791,8 +1835,7 @@ huawei_hcsq_changed (MMPortSerialAt *port,
     gdouble v;
     GError *error = NULL;
 
-    str = g_match_info_fetch (match_info, 1);
-    if (!mm_huawei_parse_hcsq_response (str,
+    if (!mm_huawei_parse_hcsq_response (args,
                                         &act,
                                         &value1,
                                         &value2,
@@ -1800,9 +1843,9 @@ huawei_hcsq_changed (MMPortSerialAt *port,
                                         &value4,
                                         &value5,
                                         &error)) {
-        mm_dbg ("Ignored invalid ^HCSQ message: %s (error %s)", str, error->message);
+        mm_dbg ("Ignored invalid ^HCSQ message: %.*s (error %s)",
+                (gint)args_len, args, error->message);
         g_error_free (error);
-        g_free (str);
         return;
     }
 
@@ -1850,54 +1893,12 @@ static void
 set_3gpp_unsolicited_events_handlers (MMBroadbandModemHuawei *self,
                                       gboolean enable)
 {
-    GList *ports, *l;
-
-    ports = mm_broadband_modem_huawei_get_at_port_list (self);
-
-    /* Enable/disable unsolicited events in given port */
-    for (l = ports; l; l = g_list_next (l)) {
-        MMPortSerialAt *port = MM_PORT_SERIAL_AT (l->data);
-
-        /* Signal quality related */
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->rssi_regex,
-            enable ? (MMPortSerialAtUnsolicitedMsgFn)huawei_signal_changed : NULL,
-            enable ? self : NULL,
-            NULL);
-
-        /* Access technology related */
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->mode_regex,
-            enable ? (MMPortSerialAtUnsolicitedMsgFn)huawei_mode_changed : NULL,
-            enable ? self : NULL,
-            NULL);
-
-        /* Connection status related */
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->dsflowrpt_regex,
-            enable ? (MMPortSerialAtUnsolicitedMsgFn)huawei_status_changed : NULL,
-            enable ? self : NULL,
-            NULL);
-
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->ndisstat_regex,
-            enable ? (MMPortSerialAtUnsolicitedMsgFn)huawei_ndisstat_changed : NULL,
-            enable ? self : NULL,
-            NULL);
-
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->hcsq_regex,
-            enable ? (MMPortSerialAtUnsolicitedMsgFn)huawei_hcsq_changed : NULL,
-            enable ? self : NULL,
-            NULL);
-    }
-
-    g_list_free_full (ports, g_object_unref);
+    /* The messages are always matched (and ignored when not enabled) by the
+     * unsolicited messages dispatcher, we only need to flag them here */
+    if (enable)
+        self->priv->unsolicited_groups |= UNSOLICITED_GROUP_3GPP;
+    else
+        self->priv->unsolicited_groups &= ~UNSOLICITED_GROUP_3GPP;
 }
 
 static gboolean
@@ -2359,13 +2360,13 @@ decode (MMIfaceModem3gppUssd *self,
 /*****************************************************************************/
 
 static void
-huawei_1x_signal_changed (MMPortSerialAt *port,
-                          GMatchInfo *match_info,
-                          MMBroadbandModemHuawei *self)
+huawei_1x_signal_changed (MMBroadbandModemHuawei *self,
+                          const gchar *args,
+                          gsize args_len)
 {
     guint quality = 0;
 
-    if (!mm_get_uint_from_match_info (match_info, 1, &quality))
+    if (!unsolicited_arg_to_uint (args, &quality))
         return;
 
     quality = CLAMP (quality, 0, 100);
@@ -2374,13 +2375,13 @@ huawei_1x_signal_changed (MMPortSerialAt *port,
 }
 
 static void
-huawei_evdo_signal_changed (MMPortSerialAt *port,
-                            GMatchInfo *match_info,
-                            MMBroadbandModemHuawei *self)
+huawei_evdo_signal_changed (MMBroadbandModemHuawei *self,
+                            const gchar *args,
+                            gsize args_len)
 {
     guint quality = 0;
 
-    if (!mm_get_uint_from_match_info (match_info, 1, &quality))
+    if (!unsolicited_arg_to_uint (args, &quality))
         return;
 
     quality = CLAMP (quality, 0, 100);
@@ -2514,37 +2515,11 @@ static void
 set_cdma_unsolicited_events_handlers (MMBroadbandModemHuawei *self,
                                       gboolean enable)
 {
-    GList *ports, *l;
-
-    ports = mm_broadband_modem_huawei_get_at_port_list (self);
-
-    /* Enable/disable unsolicited events in given port */
-    for (l = ports; l; l = g_list_next (l)) {
-        MMPortSerialAt *port = MM_PORT_SERIAL_AT (l->data);
-
-        /* Signal quality related */
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->rssilvl_regex,
-            enable ? (MMPortSerialAtUnsolicitedMsgFn)huawei_1x_signal_changed : NULL,
-            enable ? self : NULL,
-            NULL);
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->hrssilvl_regex,
-            enable ? (MMPortSerialAtUnsolicitedMsgFn)huawei_evdo_signal_changed : NULL,
-            enable ? self : NULL,
-            NULL);
-        /* Access technology related */
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->mode_regex,
-            enable ? (MMPortSerialAtUnsolicitedMsgFn)huawei_mode_changed : NULL,
-            enable ? self : NULL,
-            NULL);
-    }
-
-    g_list_free_full (ports, g_object_unref);
+    /* See set_3gpp_unsolicited_events_handlers() */
+    if (enable)
+        self->priv->unsolicited_groups |= UNSOLICITED_GROUP_CDMA;
+    else
+        self->priv->unsolicited_groups &= ~UNSOLICITED_GROUP_CDMA;
 }
 
 static gboolean
@@ -3936,93 +3911,139 @@ signal_load_values (MMIfaceModemSignal *_self,
 /*****************************************************************************/
 /* Setup ports (Broadband modem class) */
 
+typedef void (* UnsolicitedMsgFn) (MMBroadbandModemHuawei *self,
+                                   const gchar *args,
+                                   gsize args_len);
+
+typedef struct {
+    const gchar *name;
+    guint groups;
+    UnsolicitedMsgFn handler;
+} UnsolicitedMsg;
+
+/* All unsolicited messages matched by the dispatcher, sorted by name so that
+ * they can be looked up with bsearch(). Messages without handler, or whose
+ * groups aren't currently enabled, are matched and ignored. */
+static const UnsolicitedMsg unsolicited_msgs[] = {
+    { "+CUSATEND",      0, NULL },
+    { "+CUSATP",        0, NULL },
+    { "^BOOT",          0, NULL },
+    { "^CONNECT",       0, NULL },
+    { "^CSCHANNELINFO", 0, NULL },
+    { "^CSNR",          0, NULL },
+    { "^DSDORMANT",     0, NULL },
+    { "^DSFLOWRPT",     UNSOLICITED_GROUP_3GPP | UNSOLICITED_GROUP_CDMA, huawei_dsflowrpt_received },
+    { "^ECCLIST",       0, NULL },
+    { "^EONS",          0, NULL },
+    { "^HCSQ",          UNSOLICITED_GROUP_3GPP, huawei_hcsq_changed },
+    { "^HRSSILVL",      UNSOLICITED_GROUP_CDMA, huawei_evdo_signal_changed },
+    { "^LTERSRP",       0, NULL },
+    { "^MODE",          UNSOLICITED_GROUP_3GPP | UNSOLICITED_GROUP_CDMA, huawei_mode_changed },
+    { "^NDISEND",       0, NULL },
+    { "^NDISSTAT",      UNSOLICITED_GROUP_3GPP, huawei_ndisstat_changed },
+    { "^ORIG",          0, NULL },
+    { "^PDPDEACT",      0, NULL },
+    { "^POSEND",        0, NULL },
+    { "^POSITION",      0, NULL },
+    { "^RSSI",          UNSOLICITED_GROUP_3GPP, huawei_signal_changed },
+    { "^RSSILVL",       UNSOLICITED_GROUP_CDMA, huawei_1x_signal_changed },
+    { "^SIMST",         0, NULL },
+    { "^SRVST",         0, NULL },
+    { "^STIN",          0, NULL },
+};
+
+typedef struct {
+    const gchar *name;
+    gsize name_len;
+} UnsolicitedMsgKey;
+
+static gint
+unsolicited_msg_cmp (const UnsolicitedMsgKey *key,
+                     const UnsolicitedMsg *msg)
+{
+    gint ret;
+
+    ret = strncmp (key->name, msg->name, key->name_len);
+    if (ret == 0 && msg->name[key->name_len] != '\0')
+        ret = -1;
+    return ret;
+}
+
+static GRegex *
+unsolicited_msgs_regex_new (void)
+{
+    GString *pattern;
+    GRegex *regex;
+    guint i;
+
+    /* <cr><lf>NAME[:][ ]ARGS<cr>[<cr>]<lf>
+     *
+     * The name must be followed by a colon, a space or the end of line, so
+     * that e.g. ^RSSI doesn't match ^RSSILVL. */
+    pattern = g_string_new ("\\r\\n(");
+    for (i = 0; i < G_N_ELEMENTS (unsolicited_msgs); i++) {
+        g_assert (i == 0 || strcmp (unsolicited_msgs[i - 1].name, unsolicited_msgs[i].name) < 0);
+        g_string_append_printf (pattern, "%s\\%s", i > 0 ? "|" : "", unsolicited_msgs[i].name);
+    }
+    g_string_append (pattern, ")(?::[ ]*|[ ]+|(?=\\r))([^\\r\\n]*)\\r+\\n");
+
+    regex = g_regex_new (pattern->str, G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    g_assert (regex != NULL);
+    g_string_free (pattern, TRUE);
+    return regex;
+}
+
+static void
+huawei_unsolicited_msg_received (MMPortSerialAt *port,
+                                 GMatchInfo *match_info,
+                                 MMBroadbandModemHuawei *self)
+{
+    const gchar *str;
+    gint name_start, name_end;
+    gint args_start, args_end;
+    UnsolicitedMsgKey key;
+    const UnsolicitedMsg *msg;
+
+    if (!g_match_info_fetch_pos (match_info, 1, &name_start, &name_end) ||
+        !g_match_info_fetch_pos (match_info, 2, &args_start, &args_end))
+        return;
+
+    str = g_match_info_get_string (match_info);
+    key.name = &str[name_start];
+    key.name_len = name_end - name_start;
+    msg = bsearch (&key,
+                   unsolicited_msgs,
+                   G_N_ELEMENTS (unsolicited_msgs),
+                   sizeof (UnsolicitedMsg),
+                   (GCompareFunc)unsolicited_msg_cmp);
+    g_assert (msg != NULL);
+
+    if (!msg->handler || !(msg->groups & self->priv->unsolicited_groups))
+        return;
+
+    msg->handler (self, &str[args_start], args_end - args_start);
+}
+
 static void
-set_ignored_unsolicited_events_handlers (MMBroadbandModemHuawei *self)
+set_unsolicited_events_dispatcher (MMBroadbandModemHuawei *self)
 {
     GList *ports, *l;
 
     ports = mm_broadband_modem_huawei_get_at_port_list (self);
 
-    /* Enable/disable unsolicited events in given port */
     for (l = ports; l; l = g_list_next (l)) {
         MMPortSerialAt *port = MM_PORT_SERIAL_AT (l->data);
 
         mm_port_serial_at_add_unsolicited_msg_handler (
             port,
-            self->priv->boot_regex,
-            NULL, NULL, NULL);
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->connect_regex,
-            NULL, NULL, NULL);
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->csnr_regex,
-            NULL, NULL, NULL);
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->cusatp_regex,
-            NULL, NULL, NULL);
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->cusatend_regex,
-            NULL, NULL, NULL);
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->dsdormant_regex,
-            NULL, NULL, NULL);
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->simst_regex,
-            NULL, NULL, NULL);
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->srvst_regex,
-            NULL, NULL, NULL);
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->stin_regex,
-            NULL, NULL, NULL);
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->pdpdeact_regex,
-            NULL, NULL, NULL);
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->ndisend_regex,
-            NULL, NULL, NULL);
+            self->priv->unsolicited_regex,
+            (MMPortSerialAtUnsolicitedMsgFn)huawei_unsolicited_msg_received,
+            self,
+            NULL);
         mm_port_serial_at_add_unsolicited_msg_handler (
             port,
             self->priv->rfswitch_regex,
             NULL, NULL, NULL);
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->position_regex,
-            NULL, NULL, NULL);
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->posend_regex,
-            NULL, NULL, NULL);
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->ecclist_regex,
-            NULL, NULL, NULL);
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->ltersrp_regex,
-            NULL, NULL, NULL);
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->cschannelinfo_regex,
-            NULL, NULL, NULL);
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->eons_regex,
-            NULL, NULL, NULL);
-        mm_port_serial_at_add_unsolicited_msg_handler (
-            port,
-            self->priv->orig_regex,
-            NULL, NULL, NULL);
     }
 
     g_list_free_full (ports, g_object_unref);
@@ -4044,8 +4065,8 @@ setup_ports (MMBroadbandModem *self)
     /* Call parent's setup ports first always */
     MM_BROADBAND_MODEM_CLASS (mm_broadband_modem_huawei_parent_class)->setup_ports (self);
 
-    /* Unsolicited messages to always ignore */
-    set_ignored_unsolicited_events_handlers (MM_BROADBAND_MODEM_HUAWEI (self));
+    /* Unsolicited messages to process when enabled, or ignore otherwise */
+    set_unsolicited_events_dispatcher (MM_BROADBAND_MODEM_HUAWEI (self));
 
     /* Now reset the unsolicited messages we'll handle when enabled */
     set_3gpp_unsolicited_events_handlers (MM_BROADBAND_MODEM_HUAWEI (self), FALSE);
@@ -4092,62 +4113,9 @@ mm_broadband_modem_huawei_init (MMBroadbandModemHuawei *self)
                                               MM_TYPE_BROADBAND_MODEM_HUAWEI,
                                               MMBroadbandModemHuaweiPrivate);
     /* Prepare regular expressions to setup */
-    self->priv->rssi_regex = g_regex_new ("\\r\\n\\^RSSI:\\s*(\\d+)\\r\\n",
-                                           G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->rssilvl_regex = g_regex_new ("\\r\\n\\^RSSILVL:\\s*(\\d+)\\r+\\n",
-                                             G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->hrssilvl_regex = g_regex_new ("\\r\\n\\^HRSSILVL:\\s*(\\d+)\\r+\\n",
-                                              G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-
-    /* 3GPP: <cr><lf>^MODE:5<cr><lf>
-     * CDMA: <cr><lf>^MODE: 2<cr><cr><lf>
-     */
-    self->priv->mode_regex = g_regex_new ("\\r\\n\\^MODE:\\s*(\\d*),?(\\d*)\\r+\\n",
-                                          G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->dsflowrpt_regex = g_regex_new ("\\r\\n\\^DSFLOWRPT:(.+)\\r\\n",
-                                               G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->ndisstat_regex = g_regex_new ("\\r\\n(\\^NDISSTAT:.+)\\r+\\n",
-                                              G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->boot_regex = g_regex_new ("\\r\\n\\^BOOT:.+\\r\\n",
-                                          G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->connect_regex = g_regex_new ("\\r\\n\\^CONNECT .+\\r\\n",
-                                          G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->csnr_regex = g_regex_new ("\\r\\n\\^CSNR:.+\\r\\n",
-                                          G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->cusatp_regex = g_regex_new ("\\r\\n\\+CUSATP:.+\\r\\n",
-                                            G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->cusatend_regex = g_regex_new ("\\r\\n\\+CUSATEND\\r\\n",
-                                              G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->dsdormant_regex = g_regex_new ("\\r\\n\\^DSDORMANT:.+\\r\\n",
-                                               G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->simst_regex = g_regex_new ("\\r\\n\\^SIMST:.+\\r\\n",
-                                           G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->srvst_regex = g_regex_new ("\\r\\n\\^SRVST:.+\\r\\n",
-                                           G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->stin_regex = g_regex_new ("\\r\\n\\^STIN:.+\\r\\n",
-                                          G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->hcsq_regex = g_regex_new ("\\r\\n(\\^HCSQ:.+)\\r+\\n",
-                                          G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->pdpdeact_regex = g_regex_new ("\\r\\n\\^PDPDEACT:.+\\r+\\n",
-                                              G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->ndisend_regex = g_regex_new ("\\r\\n\\^NDISEND:.+\\r+\\n",
-                                             G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    self->priv->unsolicited_regex = unsolicited_msgs_regex_new ();
     self->priv->rfswitch_regex = g_regex_new ("\\r\\n\\^RFSWITCH:.+\\r\\n",
                                               G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->position_regex = g_regex_new ("\\r\\n\\^POSITION:.+\\r\\n",
-                                              G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->posend_regex = g_regex_new ("\\r\\n\\^POSEND:.+\\r\\n",
-                                            G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->ecclist_regex = g_regex_new ("\\r\\n\\^ECCLIST:.+\\r\\n",
-                                             G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->ltersrp_regex = g_regex_new ("\\r\\n\\^LTERSRP:.+\\r\\n",
-                                             G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->cschannelinfo_regex = g_regex_new ("\\r\\n\\^CSCHANNELINFO:.+\\r\\n",
-                                                    G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->eons_regex = g_regex_new ("\\r\\n\\^EONS:.+\\r\\n",
-                                          G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->orig_regex = g_regex_new ("\\r\\n\\^ORIG:.+\\r\\n",
-                                              G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
 
     self->priv->ndisdup_support = FEATURE_SUPPORT_UNKNOWN;
     self->priv->rfswitch_support = FEATURE_SUPPORT_UNKNOWN;
@@ -4175,32 +4143,8 @@ finalize (GObject *object)
 {
     MMBroadbandModemHuawei *self = MM_BROADBAND_MODEM_HUAWEI (object);
 
-    g_regex_unref (self->priv->rssi_regex);
-    g_regex_unref (self->priv->rssilvl_regex);
-    g_regex_unref (self->priv->hrssilvl_regex);
-    g_regex_unref (self->priv->mode_regex);
-    g_regex_unref (self->priv->dsflowrpt_regex);
-    g_regex_unref (self->priv->ndisstat_regex);
-    g_regex_unref (self->priv->boot_regex);
-    g_regex_unref (self->priv->connect_regex);
-    g_regex_unref (self->priv->csnr_regex);
-    g_regex_unref (self->priv->cusatp_regex);
-    g_regex_unref (self->priv->cusatend_regex);
-    g_regex_unref (self->priv->dsdormant_regex);
-    g_regex_unref (self->priv->simst_regex);
-    g_regex_unref (self->priv->srvst_regex);
-    g_regex_unref (self->priv->stin_regex);
-    g_regex_unref (self->priv->hcsq_regex);
-    g_regex_unref (self->priv->pdpdeact_regex);
-    g_regex_unref (self->priv->ndisend_regex);
+    g_regex_unref (self->priv->unsolicited_regex);
     g_regex_unref (self->priv->rfswitch_regex);
-    g_regex_unref (self->priv->position_regex);
-    g_regex_unref (self->priv->posend_regex);
-    g_regex_unref (self->priv->ecclist_regex);
-    g_regex_unref (self->priv->ltersrp_regex);
-    g_regex_unref (self->priv->cschannelinfo_regex);
-    g_regex_unref (self->priv->eons_regex);
-    g_regex_unref (self->priv->orig_regex);
 
     if (self->priv->syscfg_supported_modes)
         g_array_unref (self->priv->syscfg_supported_modes);
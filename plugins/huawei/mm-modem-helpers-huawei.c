@@ -1334,6 +1334,38 @@ gboolean mm_huawei_parse_time_response (const gchar *response,
 /*****************************************************************************/
 /* ^HCSQ response parser */
 
+/* The ^HCSQ and ^DSFLOWRPT parsers work in place, without any intermediate
+ * allocation, so that they can also be run directly on the unsolicited
+ * messages found in the port buffer. The first CR or LF ends the input. */
+
+static inline gboolean
+is_end_of_line (gchar c)
+{
+    return (c == '\0' || c == '\r' || c == '\n');
+}
+
+static gboolean
+read_uint_field (const gchar **str,
+                 guint         base,
+                 guint64       max,
+                 guint64      *out)
+{
+    gchar   *end = NULL;
+    guint64  num;
+
+    /* g_ascii_strtoull() would otherwise skip whitespace and accept signs */
+    if (!g_ascii_isxdigit (**str) || (base == 10 && !g_ascii_isdigit (**str)))
+        return FALSE;
+
+    num = g_ascii_strtoull (*str, &end, base);
+    if (num > max)
+        return FALSE;
+
+    *out = num;
+    *str = end;
+    return TRUE;
+}
+
 gboolean
 mm_huawei_parse_hcsq_response (const gchar *response,
                                MMModemAccessTechnology *out_act,
@@ -1344,61 +1376,141 @@ mm_huawei_parse_hcsq_response (const gchar *response,
                                guint *out_value5,
                                GError **error)
 {
-    GRegex *r;
-    GMatchInfo *match_info = NULL;
-    GError *match_error = NULL;
-    gboolean ret = FALSE;
-    char *s;
+    const gchar *p;
+    const gchar *sysmode;
+    gsize        sysmode_len;
+    guint64      values[5];
+    guint        n_values = 0;
+
+    p = response;
+    if (g_ascii_strncasecmp (p, "^HCSQ:", 6) == 0)
+        p += 6;
+    while (*p == ' ')
+        p++;
 
-    r = g_regex_new ("\\^HCSQ:\\s*\"([a-zA-Z]*)\",(\\d+),?(\\d+)?,?(\\d+)?,?(\\d+)?,?(\\d+)?$", 0, 0, NULL);
-    g_assert (r != NULL);
+    /* "<sysmode>" */
+    if (*p != '"')
+        goto out_nomatch;
+    sysmode = ++p;
+    while (g_ascii_isalpha (*p))
+        p++;
+    if (*p != '"')
+        goto out_nomatch;
+    sysmode_len = p - sysmode;
+    p++;
 
-    if (!g_regex_match_full (r, response, -1, 0, 0, &match_info, &match_error)) {
-        if (match_error) {
-            g_propagate_error (error, match_error);
-            g_prefix_error (error, "Could not parse ^HCSQ results: ");
-        } else {
-            g_set_error_literal (error,
-                                 MM_CORE_ERROR,
-                                 MM_CORE_ERROR_FAILED,
-                                 "Couldn't match ^HCSQ reply");
-        }
-        goto done;
+    /* Up to 5 values, at least one required */
+    while (n_values < G_N_ELEMENTS (values) && *p == ',') {
+        p++;
+        if (!read_uint_field (&p, 10, G_MAXUINT, &values[n_values]))
+            goto out_nomatch;
+        n_values++;
     }
 
-    /* Remember that g_match_info_get_match_count() includes match #0 */
-    if (g_match_info_get_match_count (match_info) < 3) {
+    while (*p == ' ')
+        p++;
+    if (!is_end_of_line (*p))
+        goto out_nomatch;
+
+    if (n_values == 0) {
         g_set_error_literal (error,
                              MM_CORE_ERROR,
                              MM_CORE_ERROR_FAILED,
                              "Not enough elements in ^HCSQ reply");
-        goto done;
+        return FALSE;
     }
 
     if (out_act) {
-        s = g_match_info_fetch (match_info, 1);
-        *out_act = mm_string_to_access_tech (s);
-        g_free (s);
+        gchar buffer[16];
+
+        /* Known sysmodes are all short; longer ones are truncated and
+         * therefore likely reported as unknown */
+        sysmode_len = MIN (sysmode_len, sizeof (buffer) - 1);
+        memcpy (buffer, sysmode, sysmode_len);
+        buffer[sysmode_len] = '\0';
+        *out_act = mm_string_to_access_tech (buffer);
     }
 
-    if (out_value1)
-        mm_get_uint_from_match_info (match_info, 2, out_value1);
-    if (out_value2)
-        mm_get_uint_from_match_info (match_info, 3, out_value2);
-    if (out_value3)
-        mm_get_uint_from_match_info (match_info, 4, out_value3);
-    if (out_value4)
-        mm_get_uint_from_match_info (match_info, 5, out_value4);
-    if (out_value5)
-        mm_get_uint_from_match_info (match_info, 6, out_value5);
+    if (out_value1 && n_values > 0)
+        *out_value1 = (guint) values[0];
+    if (out_value2 && n_values > 1)
+        *out_value2 = (guint) values[1];
+    if (out_value3 && n_values > 2)
+        *out_value3 = (guint) values[2];
+    if (out_value4 && n_values > 3)
+        *out_value4 = (guint) values[3];
+    if (out_value5 && n_values > 4)
+        *out_value5 = (guint) values[4];
 
-    ret = TRUE;
+    return TRUE;
 
-done:
-    g_match_info_free (match_info);
-    g_regex_unref (r);
+out_nomatch:
+    g_set_error_literal (error,
+                         MM_CORE_ERROR,
+                         MM_CORE_ERROR_FAILED,
+                         "Couldn't match ^HCSQ reply");
+    return FALSE;
+}
 
-    return ret;
+/*****************************************************************************/
+/* ^DSFLOWRPT unsolicited message parser */
+
+gboolean
+mm_huawei_parse_dsflowrpt (const gchar *response,
+                           guint *out_duration,
+                           guint *out_tx_rate,
+                           guint *out_rx_rate,
+                           guint64 *out_tx_bytes,
+                           guint64 *out_rx_bytes,
+                           GError **error)
+{
+    const gchar *p;
+    guint64      values[5];
+    guint        i;
+
+    /* ^DSFLOWRPT: <curr_ds_time>,<tx_rate>,<rx_rate>,<curr_tx_flow>,<curr_rx_flow>,
+     *             <qos_tx_rate>,<qos_rx_rate>
+     *
+     * All fields in hex; flows are 64-bit byte counters for the current
+     * connection, time is given in seconds and rates in bytes/s. The QoS
+     * fields are optional and ignored.
+     */
+    p = response;
+    if (g_ascii_strncasecmp (p, "^DSFLOWRPT:", 11) == 0)
+        p += 11;
+    while (*p == ' ')
+        p++;
+
+    for (i = 0; i < G_N_ELEMENTS (values); i++) {
+        if ((i > 0 && *(p++) != ',') ||
+            !read_uint_field (&p, 16, (i < 3 ? G_MAXUINT32 : G_MAXUINT64), &values[i])) {
+            g_set_error (error,
+                         MM_CORE_ERROR,
+                         MM_CORE_ERROR_FAILED,
+                         "Couldn't parse ^DSFLOWRPT field #%u", i + 1);
+            return FALSE;
+        }
+    }
+
+    if (*p != ',' && !is_end_of_line (*p)) {
+        g_set_error_literal (error,
+                             MM_CORE_ERROR,
+                             MM_CORE_ERROR_FAILED,
+                             "Unexpected trailing data in ^DSFLOWRPT");
+        return FALSE;
+    }
+
+    if (out_duration)
+        *out_duration = (guint) values[0];
+    if (out_tx_rate)
+        *out_tx_rate = (guint) values[1];
+    if (out_rx_rate)
+        *out_rx_rate = (guint) values[2];
+    if (out_tx_bytes)
+        *out_tx_bytes = values[3];
+    if (out_rx_bytes)
+        *out_rx_bytes = values[4];
+    return TRUE;
 }
 
 /*****************************************************************************/
@@ -151,6 +151,17 @@ gboolean mm_huawei_parse_hcsq_response (const gchar *response,
                                         guint *out_value5,
                                         GError **error);
 
+/*****************************************************************************/
+/* ^DSFLOWRPT unsolicited message parser */
+
+gboolean mm_huawei_parse_dsflowrpt (const gchar *response,
+                                    guint *out_duration,
+                                    guint *out_tx_rate,
+                                    guint *out_rx_rate,
+                                    guint64 *out_tx_bytes,
+                                    guint64 *out_rx_bytes,
+                                    GError **error);
+
 /*****************************************************************************/
 /* ^CVOICE response parser */
 
@@ -1230,6 +1230,9 @@ static const HcsqTest hcsq_tests[] = {
     { "^HCSQ: \"WCDMA\",30,30,58\r\n", TRUE,  MM_MODEM_ACCESS_TECHNOLOGY_UMTS,    30, 30,  58, 0, 0 },
     { "^HCSQ: \"GSM\",36,255\r\n",     TRUE,  MM_MODEM_ACCESS_TECHNOLOGY_GSM,     36, 255,  0, 0, 0 },
     { "^HCSQ: \"NOSERVICE\"\r\n",      FALSE, MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN,  0,   0,  0, 0, 0 },
+    { "^HCSQ: \"LTE\",30,x\r\n",       FALSE, MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN,  0,   0,  0, 0, 0 },
+    /* Unsolicited message arguments, parsed in place in the port buffer */
+    { "\"LTE\",30,19,66,0,1\r\n\r\nOK",  TRUE,  MM_MODEM_ACCESS_TECHNOLOGY_LTE,     30, 19,  66, 0, 1 },
     { NULL,                            FALSE, MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN,  0,   0,  0, 0, 0 }
 };
 
@@ -1271,6 +1274,69 @@ test_hcsq (void)
     }
 }
 
+/*****************************************************************************/
+/* Test ^DSFLOWRPT unsolicited messages */
+
+typedef struct {
+    const gchar *str;
+    gboolean ret;
+    guint duration;
+    guint tx_rate;
+    guint rx_rate;
+    guint64 tx_bytes;
+    guint64 rx_bytes;
+} DsflowrptTest;
+
+static const DsflowrptTest dsflowrpt_tests[] = {
+    { "^DSFLOWRPT:0000240E,00000000,000003E8,00000000000258D9,0000000100000000,0003E800,0003E800\r\n",
+      TRUE, 0x240E, 0, 1000, 0x258D9, G_GUINT64_CONSTANT (0x100000000) },
+    { "^DSFLOWRPT: 00000010,00000001,00000002,0000000000000003,0000000000000004\r\n",
+      TRUE, 0x10, 1, 2, 3, 4 },
+    /* Unsolicited message arguments, parsed in place in the port buffer */
+    { "0000003C,00000020,00000040,00000000000A0000,0000000000140000\r\n\r\n^RSSI:20\r\n",
+      TRUE, 60, 32, 64, 0xA0000, 0x140000 },
+    { "^DSFLOWRPT:0000240E,00000000,000003E8,00000000000258D9\r\n",
+      FALSE, 0, 0, 0, 0, 0 },
+    { "^DSFLOWRPT:0000240E,00000000,000003E8,00000000000258D9,0000000000000001Z\r\n",
+      FALSE, 0, 0, 0, 0, 0 },
+    { NULL, FALSE, 0, 0, 0, 0, 0 }
+};
+
+static void
+test_dsflowrpt (void)
+{
+    guint i;
+
+    for (i = 0; dsflowrpt_tests[i].str; i++) {
+        GError *error = NULL;
+        guint duration = 0;
+        guint tx_rate = 0;
+        guint rx_rate = 0;
+        guint64 tx_bytes = 0;
+        guint64 rx_bytes = 0;
+        gboolean ret;
+
+        ret = mm_huawei_parse_dsflowrpt (dsflowrpt_tests[i].str,
+                                         &duration,
+                                         &tx_rate,
+                                         &rx_rate,
+                                         &tx_bytes,
+                                         &rx_bytes,
+                                         &error);
+        g_assert (ret == dsflowrpt_tests[i].ret);
+        if (ret) {
+            g_assert_no_error (error);
+            g_assert_cmpuint (dsflowrpt_tests[i].duration, ==, duration);
+            g_assert_cmpuint (dsflowrpt_tests[i].tx_rate, ==, tx_rate);
+            g_assert_cmpuint (dsflowrpt_tests[i].rx_rate, ==, rx_rate);
+            g_assert_cmpuint (dsflowrpt_tests[i].tx_bytes, ==, tx_bytes);
+            g_assert_cmpuint (dsflowrpt_tests[i].rx_bytes, ==, rx_bytes);
+        } else
+            g_assert (error);
+        g_clear_error (&error);
+    }
+}
+
 /*****************************************************************************/
 
 void
@@ -1312,6 +1378,7 @@ int main (int argc, char **argv)
     g_test_add_func ("/MM/huawei/nwtime", test_nwtime);
     g_test_add_func ("/MM/huawei/time", test_time);
     g_test_add_func ("/MM/huawei/hcsq", test_hcsq);
+    g_test_add_func ("/MM/huawei/dsflowrpt", test_dsflowrpt);
 
     return g_test_run ();
 }
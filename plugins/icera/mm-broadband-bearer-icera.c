@@ -381,12 +381,19 @@ typedef struct {
     MMPort         *data;
     guint           authentication_retries;
     GError         *saved_error;
+    /* Per-phase timings, in seconds since the dial started */
+    GTimer         *timer;
+    gboolean        authenticated;
+    gdouble         authenticated_time;
+    gdouble         activated_time;
+    gdouble         connected_time;
 } Dial3gppContext;
 
 static void
 dial_3gpp_context_free (Dial3gppContext *ctx)
 {
     g_assert (!ctx->saved_error);
+    g_timer_destroy (ctx->timer);
     g_clear_object (&ctx->data);
     g_clear_object (&ctx->primary);
     g_clear_object (&ctx->modem);
@@ -512,6 +519,28 @@ ier_query_ready (MMBaseModem  *modem,
     g_object_unref (task);
 }
 
+static void
+dial_3gpp_complete (GTask *task)
+{
+    Dial3gppContext *ctx;
+    gchar           *authenticated = NULL;
+
+    ctx = g_task_get_task_data (task);
+
+    /* The authentication phase is only reported if credentials were used */
+    if (ctx->authenticated)
+        authenticated = g_strdup_printf ("authenticated: %.3fs, ", ctx->authenticated_time);
+    mm_dbg ("Connection established in %.3fs (%sactivated: %.3fs, connected: %.3fs)",
+            g_timer_elapsed (ctx->timer, NULL),
+            authenticated ? authenticated : "",
+            ctx->activated_time,
+            ctx->connected_time);
+    g_free (authenticated);
+
+    g_task_return_pointer (task, g_object_ref (ctx->data), g_object_unref);
+    g_object_unref (task);
+}
+
 static void
 process_pending_connect_attempt (MMBroadbandBearerIcera   *self,
                                  MMBearerConnectionStatus status)
@@ -544,8 +573,8 @@ process_pending_connect_attempt (MMBroadbandBearerIcera   *self,
             return;
         }
 
-        g_task_return_pointer (task, g_object_ref (ctx->data), g_object_unref);
-        g_object_unref (task);
+        ctx->connected_time = g_timer_elapsed (ctx->timer, NULL);
+        dial_3gpp_complete (task);
         return;
     }
 
@@ -617,6 +646,9 @@ activate_ready (MMBaseModem            *modem,
     /* Track again */
     self->priv->connect_pending = task;
 
+    ctx = g_task_get_task_data (task);
+    ctx->activated_time = g_timer_elapsed (ctx->timer, NULL);
+
     /* We will now setup a timeout and keep the context in the bearer's private.
      * Reports of modem being connected will arrive via unsolicited messages.
      * This timeout should be long enough. Actually... ideally should never get
@@ -626,7 +658,6 @@ activate_ready (MMBaseModem            *modem,
                                                             self);
 
     /* If we get the port closed, we treat as a connect error */
-    ctx = g_task_get_task_data (task);
     self->priv->connect_port_closed_id = g_signal_connect_swapped (ctx->primary,
                                                                    "forced-close",
                                                                    G_CALLBACK (forced_close_cb),
@@ -682,6 +713,8 @@ authenticate_ready (MMBaseModem  *modem,
         return;
     }
 
+    ctx->authenticated_time = g_timer_elapsed (ctx->timer, NULL);
+
     /* The unsolicited response to %IPDPACT may come before the OK does.
      * We will keep the connection context in the bearer private data so
      * that it is accessible from the unsolicited message handler. Note
@@ -762,6 +795,7 @@ authenticate (GTask *task)
                                    quoted_password);
         g_free (quoted_user);
         g_free (quoted_password);
+        ctx->authenticated = TRUE;
     }
 
     mm_base_modem_at_command_full (ctx->modem,
@@ -778,8 +812,7 @@ authenticate (GTask *task)
 
 static void
 deactivate_ready (MMBaseModem  *modem,
-                  GAsyncResult *res,
-                  GTask        *task)
+                  GAsyncResult *res)
 {
     /*
      * Ignore any error here; %IPDPACT=ctx,0 will produce an error 767
@@ -787,8 +820,6 @@ deactivate_ready (MMBaseModem  *modem,
      * harmless.
      */
     mm_base_modem_at_command_full_finish (modem, res, NULL);
-
-    authenticate (task);
 }
 
 static void
@@ -803,6 +834,10 @@ connect_deactivate (GTask *task)
      * it. This handles the case where ModemManager crashed while
      * connected and is now trying to reconnect. (Should some part of
      * the core or modem driver have made sure of this already?)
+     *
+     * The result of the deactivation is ignored, so there is no need to
+     * wait for it before configuring the context: the authentication
+     * command is queued right after it in the same port.
      */
     command = g_strdup_printf ("%%IPDPACT=%d,0", ctx->cid);
     mm_base_modem_at_command_full (
@@ -814,8 +849,10 @@ connect_deactivate (GTask *task)
         FALSE, /* raw */
         NULL, /* cancellable */
         (GAsyncReadyCallback)deactivate_ready,
-        task);
+        NULL);
     g_free (command);
+
+    authenticate (task);
 }
 
 static void
@@ -839,6 +876,7 @@ dial_3gpp (MMBroadbandBearer   *_self,
     ctx->modem   = g_object_ref (modem);
     ctx->primary = g_object_ref (primary);
     ctx->cid     = cid;
+    ctx->timer   = g_timer_new ();
     g_task_set_task_data (task, ctx, (GDestroyNotify)dial_3gpp_context_free);
 
     /* We need a net data port */
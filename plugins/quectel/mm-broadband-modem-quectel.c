@@ -18,12 +18,17 @@
 #include "mm-broadband-modem-quectel.h"
 #include "mm-shared-quectel.h"
 #include "mm-iface-modem-firmware.h"
+#include "mm-iface-modem-location.h"
 
 static void shared_quectel_init       (MMSharedQuectel      *iface);
 static void iface_modem_firmware_init (MMIfaceModemFirmware *iface);
+static void iface_modem_location_init (MMIfaceModemLocation *iface);
+
+static MMIfaceModemLocation *iface_modem_location_parent;
 
 G_DEFINE_TYPE_EXTENDED (MMBroadbandModemQuectel, mm_broadband_modem_quectel, MM_TYPE_BROADBAND_MODEM, 0,
                         G_IMPLEMENT_INTERFACE (MM_TYPE_IFACE_MODEM_FIRMWARE, iface_modem_firmware_init)
+                        G_IMPLEMENT_INTERFACE (MM_TYPE_IFACE_MODEM_LOCATION, iface_modem_location_init)
                         G_IMPLEMENT_INTERFACE (MM_TYPE_SHARED_QUECTEL, shared_quectel_init))
 
 /*****************************************************************************/
@@ -51,6 +56,25 @@ iface_modem_firmware_init (MMIfaceModemFirmware *iface)
     iface->load_update_settings_finish = mm_shared_quectel_firmware_load_update_settings_finish;
 }
 
+static void
+iface_modem_location_init (MMIfaceModemLocation *iface)
+{
+    iface_modem_location_parent = g_type_interface_peek_parent (iface);
+
+    iface->load_capabilities                 = mm_shared_quectel_location_load_capabilities;
+    iface->load_capabilities_finish          = mm_shared_quectel_location_load_capabilities_finish;
+    iface->enable_location_gathering         = mm_shared_quectel_enable_location_gathering;
+    iface->enable_location_gathering_finish  = mm_shared_quectel_enable_location_gathering_finish;
+    iface->disable_location_gathering        = mm_shared_quectel_disable_location_gathering;
+    iface->disable_location_gathering_finish = mm_shared_quectel_disable_location_gathering_finish;
+}
+
+static MMIfaceModemLocation *
+peek_parent_location_interface (MMSharedQuectel *self)
+{
+    return iface_modem_location_parent;
+}
+
 static void
 mm_broadband_modem_quectel_init (MMBroadbandModemQuectel *self)
 {
@@ -59,6 +83,7 @@ mm_broadband_modem_quectel_init (MMBroadbandModemQuectel *self)
 static void
 shared_quectel_init (MMSharedQuectel *iface)
 {
+    iface->peek_parent_location_interface = peek_parent_location_interface;
 }
 
 static void
@@ -21,11 +21,64 @@
 #define _LIBMM_INSIDE_MM
 #include <libmm-glib.h>
 
+#include "mm-log.h"
 #include "mm-iface-modem-firmware.h"
+#include "mm-iface-modem-location.h"
 #include "mm-base-modem.h"
 #include "mm-base-modem-at.h"
 #include "mm-shared-quectel.h"
 
+/*****************************************************************************/
+/* Private data context */
+
+#define PRIVATE_TAG "shared-quectel-private-tag"
+static GQuark private_quark;
+
+typedef enum {
+    FEATURE_SUPPORT_UNKNOWN,
+    FEATURE_NOT_SUPPORTED,
+    FEATURE_SUPPORTED,
+} FeatureSupport;
+
+typedef struct {
+    MMIfaceModemLocation  *iface_modem_location_parent;
+    MMModemLocationSource  supported_sources;
+    MMModemLocationSource  enabled_sources;
+    FeatureSupport         qgps_support;
+} Private;
+
+static void
+private_free (Private *ctx)
+{
+    g_slice_free (Private, ctx);
+}
+
+static Private *
+get_private (MMSharedQuectel *self)
+{
+    Private *priv;
+
+    if (G_UNLIKELY (!private_quark))
+        private_quark = g_quark_from_static_string (PRIVATE_TAG);
+
+    priv = g_object_get_qdata (G_OBJECT (self), private_quark);
+    if (!priv) {
+        priv = g_slice_new (Private);
+
+        priv->supported_sources = MM_MODEM_LOCATION_SOURCE_NONE;
+        priv->enabled_sources = MM_MODEM_LOCATION_SOURCE_NONE;
+        priv->qgps_support = FEATURE_SUPPORT_UNKNOWN;
+
+        /* Setup parent class' MMIfaceModemLocation */
+        g_assert (MM_SHARED_QUECTEL_GET_INTERFACE (self)->peek_parent_location_interface);
+        priv->iface_modem_location_parent = MM_SHARED_QUECTEL_GET_INTERFACE (self)->peek_parent_location_interface (self);
+
+        g_object_set_qdata_full (G_OBJECT (self), private_quark, priv, (GDestroyNotify)private_free);
+    }
+
+    return priv;
+}
+
 /*****************************************************************************/
 /* Firmware update settings loading (Firmware interface) */
 
@@ -71,6 +124,486 @@ mm_shared_quectel_firmware_load_update_settings (MMIfaceModemFirmware *self,
                               task);
 }
 
+/*****************************************************************************/
+/* GPS trace received */
+
+static void
+trace_received (MMPortSerialGps      *port,
+                const gchar          *trace,
+                MMIfaceModemLocation *self)
+{
+    mm_iface_modem_location_gps_update (self, trace);
+}
+
+/*****************************************************************************/
+/* Location capabilities loading (Location interface) */
+
+MMModemLocationSource
+mm_shared_quectel_location_load_capabilities_finish (MMIfaceModemLocation  *self,
+                                                     GAsyncResult          *res,
+                                                     GError               **error)
+{
+    GError *inner_error = NULL;
+    gssize  aux;
+
+    aux = g_task_propagate_int (G_TASK (res), &inner_error);
+    if (inner_error) {
+        g_propagate_error (error, inner_error);
+        return MM_MODEM_LOCATION_SOURCE_NONE;
+    }
+    return (MMModemLocationSource) aux;
+}
+
+static void
+qgps_test_ready (MMBaseModem  *self,
+                 GAsyncResult *res,
+                 GTask        *task)
+{
+    MMModemLocationSource  sources;
+    MMPortSerialGps       *gps_port;
+    Private               *priv;
+
+    priv = get_private (MM_SHARED_QUECTEL (self));
+
+    /* Recover parent sources */
+    sources = GPOINTER_TO_UINT (g_task_get_task_data (task));
+
+    if (!mm_base_modem_at_command_finish (self, res, NULL)) {
+        mm_dbg ("GPS engine control not supported: no GPS capabilities");
+        priv->qgps_support = FEATURE_NOT_SUPPORTED;
+        g_task_return_int (task, (gssize) sources);
+        g_object_unref (task);
+        return;
+    }
+
+    priv->qgps_support = FEATURE_SUPPORTED;
+
+    /* It may happen that the modem was started with GPS already enabled, or
+     * maybe ModemManager got rebooted and it was left enabled before. We'll
+     * make sure that it is disabled when we initialize the modem. */
+    mm_base_modem_at_command (self, "AT+QGPSEND", 3, FALSE, NULL, NULL);
+
+    /* The engine can always be started in unmanaged mode, as the NMEA traces
+     * are sent to the dedicated NMEA port, even if we don't use it ourselves.
+     * We only flag as supported by this implementation those sources not
+     * already supported by the parent implementation */
+    if (!(sources & MM_MODEM_LOCATION_SOURCE_GPS_UNMANAGED))
+        priv->supported_sources |= MM_MODEM_LOCATION_SOURCE_GPS_UNMANAGED;
+
+    /* The NMEA and RAW sources require the GPS data port */
+    gps_port = mm_base_modem_peek_port_gps (self);
+    if (gps_port) {
+        mm_dbg ("GPS data port found: NMEA and RAW GPS capabilities enabled");
+        if (!(sources & MM_MODEM_LOCATION_SOURCE_GPS_NMEA))
+            priv->supported_sources |= MM_MODEM_LOCATION_SOURCE_GPS_NMEA;
+        if (!(sources & MM_MODEM_LOCATION_SOURCE_GPS_RAW))
+            priv->supported_sources |= MM_MODEM_LOCATION_SOURCE_GPS_RAW;
+
+        /* Add handler for the NMEA traces in the GPS data port */
+        mm_port_serial_gps_add_trace_handler (gps_port,
+                                              (MMPortSerialGpsTraceFn)trace_received,
+                                              self,
+                                              NULL);
+    } else
+        mm_dbg ("No GPS data port found: only unmanaged GPS capabilities enabled");
+
+    sources |= priv->supported_sources;
+
+    g_task_return_int (task, (gssize) sources);
+    g_object_unref (task);
+}
+
+static void
+parent_load_capabilities_ready (MMIfaceModemLocation *self,
+                                GAsyncResult         *res,
+                                GTask                *task)
+{
+    MMModemLocationSource  sources;
+    GError                *error = NULL;
+    Private               *priv;
+
+    priv = get_private (MM_SHARED_QUECTEL (self));
+
+    sources = priv->iface_modem_location_parent->load_capabilities_finish (self, res, &error);
+    if (error) {
+        g_task_return_error (task, error);
+        g_object_unref (task);
+        return;
+    }
+
+    /* Cache sources supported by the parent */
+    g_task_set_task_data (task, GUINT_TO_POINTER (sources), NULL);
+
+    /* Check whether the GPS engine can be controlled */
+    mm_base_modem_at_command (MM_BASE_MODEM (self),
+                              "AT+QGPS=?",
+                              3,
+                              TRUE,
+                              (GAsyncReadyCallback)qgps_test_ready,
+                              task);
+}
+
+void
+mm_shared_quectel_location_load_capabilities (MMIfaceModemLocation *self,
+                                              GAsyncReadyCallback   callback,
+                                              gpointer              user_data)
+{
+    Private *priv;
+    GTask   *task;
+
+    priv = get_private (MM_SHARED_QUECTEL (self));
+    task = g_task_new (self, NULL, callback, user_data);
+
+    g_assert (priv->iface_modem_location_parent);
+    g_assert (priv->iface_modem_location_parent->load_capabilities);
+    g_assert (priv->iface_modem_location_parent->load_capabilities_finish);
+
+    priv->iface_modem_location_parent->load_capabilities (self,
+                                                          (GAsyncReadyCallback)parent_load_capabilities_ready,
+                                                          task);
+}
+
+/*****************************************************************************/
+/* Disable location gathering (Location interface) */
+
+gboolean
+mm_shared_quectel_disable_location_gathering_finish (MMIfaceModemLocation  *self,
+                                                     GAsyncResult          *res,
+                                                     GError               **error)
+{
+    return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+static void
+qgpsend_ready (MMBaseModem  *self,
+               GAsyncResult *res,
+               GTask        *task)
+{
+    MMModemLocationSource  source;
+    Private               *priv;
+    GError                *error = NULL;
+
+    priv = get_private (MM_SHARED_QUECTEL (self));
+    source = GPOINTER_TO_UINT (g_task_get_task_data (task));
+
+    /* Even if we get an error here, we try to close the GPS port */
+    if (source & (MM_MODEM_LOCATION_SOURCE_GPS_NMEA | MM_MODEM_LOCATION_SOURCE_GPS_RAW)) {
+        MMPortSerialGps *gps_port;
+
+        gps_port = mm_base_modem_peek_port_gps (self);
+        if (gps_port)
+            mm_port_serial_close (MM_PORT_SERIAL (gps_port));
+    }
+
+    if (!mm_base_modem_at_command_finish (self, res, &error))
+        g_task_return_error (task, error);
+    else {
+        priv->enabled_sources &= ~source;
+        g_task_return_boolean (task, TRUE);
+    }
+    g_object_unref (task);
+}
+
+static void
+parent_disable_location_gathering_ready (MMIfaceModemLocation *self,
+                                         GAsyncResult         *res,
+                                         GTask                *task)
+{
+    GError  *error = NULL;
+    Private *priv;
+
+    priv = get_private (MM_SHARED_QUECTEL (self));
+
+    g_assert (priv->iface_modem_location_parent);
+    if (!priv->iface_modem_location_parent->disable_location_gathering_finish (self, res, &error))
+        g_task_return_error (task, error);
+    else
+        g_task_return_boolean (task, TRUE);
+    g_object_unref (task);
+}
+
+void
+mm_shared_quectel_disable_location_gathering (MMIfaceModemLocation  *self,
+                                              MMModemLocationSource  source,
+                                              GAsyncReadyCallback    callback,
+                                              gpointer               user_data)
+{
+    MMModemLocationSource  enabled_sources;
+    Private               *priv;
+    GTask                 *task;
+
+    task = g_task_new (self, NULL, callback, user_data);
+
+    priv = get_private (MM_SHARED_QUECTEL (self));
+    g_assert (priv->iface_modem_location_parent);
+
+    /* Only consider request if it applies to one of the sources we are
+     * supporting, otherwise run parent disable */
+    if (!(priv->supported_sources & source)) {
+        /* If disabling implemented by the parent, run it. */
+        if (priv->iface_modem_location_parent->disable_location_gathering &&
+            priv->iface_modem_location_parent->disable_location_gathering_finish) {
+            priv->iface_modem_location_parent->disable_location_gathering (self,
+                                                                           source,
+                                                                           (GAsyncReadyCallback)parent_disable_location_gathering_ready,
+                                                                           task);
+            return;
+        }
+        /* Otherwise, we're done */
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    /* We only expect GPS sources here */
+    g_assert (source & (MM_MODEM_LOCATION_SOURCE_GPS_NMEA |
+                        MM_MODEM_LOCATION_SOURCE_GPS_RAW |
+                        MM_MODEM_LOCATION_SOURCE_GPS_UNMANAGED));
+
+    /* Flag as disabled to see how many others we would have left enabled */
+    enabled_sources = priv->enabled_sources;
+    enabled_sources &= ~source;
+
+    /* If there are still GPS-related sources enabled, do nothing else */
+    if (enabled_sources & (MM_MODEM_LOCATION_SOURCE_GPS_NMEA |
+                           MM_MODEM_LOCATION_SOURCE_GPS_RAW |
+                           MM_MODEM_LOCATION_SOURCE_GPS_UNMANAGED)) {
+        priv->enabled_sources &= ~source;
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    /* Stop GPS engine if all GPS-related sources are disabled */
+    g_task_set_task_data (task, GUINT_TO_POINTER (source), NULL);
+    mm_base_modem_at_command (MM_BASE_MODEM (self),
+                              "AT+QGPSEND",
+                              3,
+                              FALSE,
+                              (GAsyncReadyCallback)qgpsend_ready,
+                              task);
+}
+
+/*****************************************************************************/
+/* Enable location gathering (Location interface) */
+
+/* Interval between fixes reported by the GPS engine, in seconds. May be
+ * overridden with the ID_MM_QUECTEL_GPS_FIX_RATE udev property. */
+#define GPS_FIX_RATE_DEFAULT_SECS 1
+#define GPS_FIX_RATE_MAX_SECS     65535
+
+typedef enum {
+    ENABLE_LOCATION_GATHERING_GPS_STEP_FIRST,
+    ENABLE_LOCATION_GATHERING_GPS_STEP_QGPSCFG_OUTPORT,
+    ENABLE_LOCATION_GATHERING_GPS_STEP_QGPS,
+    ENABLE_LOCATION_GATHERING_GPS_STEP_LAST,
+} EnableLocationGatheringGpsStep;
+
+typedef struct {
+    MMModemLocationSource          source;
+    EnableLocationGatheringGpsStep gps_step;
+} EnableLocationGatheringContext;
+
+static void
+enable_location_gathering_context_free (EnableLocationGatheringContext *ctx)
+{
+    g_slice_free (EnableLocationGatheringContext, ctx);
+}
+
+gboolean
+mm_shared_quectel_enable_location_gathering_finish (MMIfaceModemLocation  *self,
+                                                    GAsyncResult          *res,
+                                                    GError               **error)
+{
+    return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+static guint
+load_gps_fix_rate (MMBaseModem *self)
+{
+    MMPort *port;
+    gint    fix_rate = 0;
+
+    /* The setting may be given either in the GPS data port or in the
+     * primary AT port */
+    port = MM_PORT (mm_base_modem_peek_port_gps (self));
+    if (port && mm_port_peek_kernel_device (port))
+        fix_rate = mm_kernel_device_get_property_as_int (mm_port_peek_kernel_device (port), "ID_MM_QUECTEL_GPS_FIX_RATE");
+    if (fix_rate <= 0) {
+        port = MM_PORT (mm_base_modem_peek_port_primary (self));
+        if (port && mm_port_peek_kernel_device (port))
+            fix_rate = mm_kernel_device_get_property_as_int (mm_port_peek_kernel_device (port), "ID_MM_QUECTEL_GPS_FIX_RATE");
+    }
+
+    if (fix_rate <= 0)
+        return GPS_FIX_RATE_DEFAULT_SECS;
+    if (fix_rate > GPS_FIX_RATE_MAX_SECS) {
+        mm_warn ("Invalid GPS fix rate requested (%d), using maximum (%u)", fix_rate, GPS_FIX_RATE_MAX_SECS);
+        return GPS_FIX_RATE_MAX_SECS;
+    }
+    return (guint) fix_rate;
+}
+
+static void enable_location_gathering_context_gps_step (GTask *task);
+
+static void
+enable_qgps_or_qgpscfg_ready (MMBaseModem  *self,
+                              GAsyncResult *res,
+                              GTask        *task)
+{
+    EnableLocationGatheringContext *ctx;
+    GError                         *error = NULL;
+
+    ctx = (EnableLocationGatheringContext *) g_task_get_task_data (task);
+
+    if (!mm_base_modem_at_command_finish (self, res, &error)) {
+        g_task_return_error (task, error);
+        g_object_unref (task);
+        return;
+    }
+
+    /* Go on to next step */
+    ctx->gps_step++;
+    enable_location_gathering_context_gps_step (task);
+}
+
+static void
+enable_location_gathering_context_gps_step (GTask *task)
+{
+    EnableLocationGatheringContext *ctx;
+    MMSharedQuectel                *self;
+    Private                        *priv;
+
+    self = MM_SHARED_QUECTEL (g_task_get_source_object (task));
+    priv = get_private (self);
+    ctx = (EnableLocationGatheringContext *) g_task_get_task_data (task);
+
+    g_assert (priv->qgps_support == FEATURE_SUPPORTED);
+
+    switch (ctx->gps_step) {
+    case ENABLE_LOCATION_GATHERING_GPS_STEP_FIRST:
+        ctx->gps_step++;
+        /* Fall down to next step */
+
+    case ENABLE_LOCATION_GATHERING_GPS_STEP_QGPSCFG_OUTPORT:
+        /* Send the NMEA traces to the dedicated NMEA port, instead of
+         * polling them with AT+QGPSLOC or AT+QGPSGNMEA */
+        mm_base_modem_at_command (MM_BASE_MODEM (self),
+                                  "AT+QGPSCFG=\"outport\",\"usbnmea\"",
+                                  3, FALSE, (GAsyncReadyCallback) enable_qgps_or_qgpscfg_ready, task);
+        return;
+
+    case ENABLE_LOCATION_GATHERING_GPS_STEP_QGPS: {
+        gchar *command;
+        guint  fix_rate;
+
+        /* Standalone mode, 30s max positioning time, 50m accuracy threshold,
+         * continuous positioning, and the configured interval between fixes */
+        fix_rate = load_gps_fix_rate (MM_BASE_MODEM (self));
+        mm_dbg ("Starting GPS engine with a fix rate of %us", fix_rate);
+        command = g_strdup_printf ("AT+QGPS=1,30,50,0,%u", fix_rate);
+        mm_base_modem_at_command (MM_BASE_MODEM (self),
+                                  command,
+                                  3, FALSE, (GAsyncReadyCallback) enable_qgps_or_qgpscfg_ready, task);
+        g_free (command);
+        return;
+    }
+
+    case ENABLE_LOCATION_GATHERING_GPS_STEP_LAST:
+        /* Only use the GPS port in NMEA/RAW setups */
+        if (ctx->source & (MM_MODEM_LOCATION_SOURCE_GPS_NMEA |
+                           MM_MODEM_LOCATION_SOURCE_GPS_RAW)) {
+            MMPortSerialGps *gps_port;
+            GError          *error = NULL;
+
+            gps_port = mm_base_modem_peek_port_gps (MM_BASE_MODEM (self));
+            if (!gps_port || !mm_port_serial_open (MM_PORT_SERIAL (gps_port), &error)) {
+                if (error)
+                    g_task_return_error (task, error);
+                else
+                    g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                                             "Couldn't open raw GPS serial port");
+                g_object_unref (task);
+                return;
+            }
+        }
+
+        /* Success */
+        priv->enabled_sources |= ctx->source;
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+}
+
+static void
+parent_enable_location_gathering_ready (MMIfaceModemLocation *self,
+                                        GAsyncResult         *res,
+                                        GTask                *task)
+{
+    GError  *error = NULL;
+    Private *priv;
+
+    priv = get_private (MM_SHARED_QUECTEL (self));
+
+    g_assert (priv->iface_modem_location_parent);
+    if (!priv->iface_modem_location_parent->enable_location_gathering_finish (self, res, &error))
+        g_task_return_error (task, error);
+    else
+        g_task_return_boolean (task, TRUE);
+    g_object_unref (task);
+}
+
+void
+mm_shared_quectel_enable_location_gathering (MMIfaceModemLocation  *self,
+                                             MMModemLocationSource  source,
+                                             GAsyncReadyCallback    callback,
+                                             gpointer               user_data)
+{
+    Private                        *priv;
+    GTask                          *task;
+    EnableLocationGatheringContext *ctx;
+
+    task = g_task_new (self, NULL, callback, user_data);
+
+    priv = get_private (MM_SHARED_QUECTEL (self));
+    g_assert (priv->iface_modem_location_parent);
+    g_assert (priv->iface_modem_location_parent->enable_location_gathering);
+    g_assert (priv->iface_modem_location_parent->enable_location_gathering_finish);
+
+    /* Only consider request if it applies to one of the sources we are
+     * supporting, otherwise run parent enable */
+    if (!(priv->supported_sources & source)) {
+        priv->iface_modem_location_parent->enable_location_gathering (self,
+                                                                      source,
+                                                                      (GAsyncReadyCallback)parent_enable_location_gathering_ready,
+                                                                      task);
+        return;
+    }
+
+    /* We only expect GPS sources here */
+    g_assert (source & (MM_MODEM_LOCATION_SOURCE_GPS_NMEA |
+                        MM_MODEM_LOCATION_SOURCE_GPS_RAW |
+                        MM_MODEM_LOCATION_SOURCE_GPS_UNMANAGED));
+
+    /* If GPS already started, store new flag and we're done */
+    if (priv->enabled_sources & (MM_MODEM_LOCATION_SOURCE_GPS_NMEA |
+                                 MM_MODEM_LOCATION_SOURCE_GPS_RAW |
+                                 MM_MODEM_LOCATION_SOURCE_GPS_UNMANAGED)) {
+        priv->enabled_sources |= source;
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    ctx = g_slice_new0 (EnableLocationGatheringContext);
+    ctx->source   = source;
+    ctx->gps_step = ENABLE_LOCATION_GATHERING_GPS_STEP_FIRST;
+    g_task_set_task_data (task, ctx, (GDestroyNotify) enable_location_gathering_context_free);
+
+    enable_location_gathering_context_gps_step (task);
+}
+
 /*****************************************************************************/
 
 static void
@@ -0,0 +1,111 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include <libmm-glib.h>
+
+#include "test-port-context.h"
+#include "test-fixture.h"
+
+/*****************************************************************************/
+
+static void
+test_location_gps_unmanaged (TestFixture *fixture)
+{
+    GError *error = NULL;
+    MMObject *obj;
+    MMModem *modem;
+    MMModemLocation *location;
+    MMModemLocationSource sources;
+    TestPortContext *port0;
+    gchar *ports [] = { NULL, NULL };
+
+    /* Create port name, and add process ID so that multiple runs of this test
+     * in the same system don't clash with each other */
+    ports[0] = g_strdup_printf ("abstract:port0:%ld", (glong) getpid ());
+    g_debug ("test service quectel: using abstract port at '%s'", ports[0]);
+
+    /* Setup new port context, with the GPS engine control commands */
+    port0 = test_port_context_new (ports[0]);
+    test_port_context_load_commands (port0, COMMON_GSM_PORT_CONF);
+    test_port_context_set_command (port0, "AT+QGPS=?", "\r\n+QGPS: (1-4),(1-255),(1-1000),(0-1000),(1-65535)\r\n\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+QGPSEND", "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+QGPSCFG=\"outport\",\"usbnmea\"", "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+QGPS=1,30,50,0,1", "\r\nOK\r\n");
+    test_port_context_start (port0);
+
+    /* Ensure no modem is modem exported */
+    test_fixture_no_modem (fixture);
+
+    /* Set the test profile */
+    test_fixture_set_profile (fixture,
+                              "test-location-gps-unmanaged",
+                              "Quectel",
+                              (const gchar *const *)ports);
+
+    /* Wait and get the modem object */
+    obj = test_fixture_get_modem (fixture);
+
+    /* Get Modem interface, and enable */
+    modem = mm_object_get_modem (obj);
+    g_assert (modem != NULL);
+    mm_modem_enable_sync (modem, NULL, &error);
+    g_assert_no_error (error);
+
+    /* Without a GPS data port, only the unmanaged GPS source is exposed */
+    location = mm_object_get_modem_location (obj);
+    g_assert (location != NULL);
+    sources = mm_modem_location_get_capabilities (location);
+    g_assert (sources & MM_MODEM_LOCATION_SOURCE_GPS_UNMANAGED);
+    g_assert (!(sources & MM_MODEM_LOCATION_SOURCE_GPS_NMEA));
+    g_assert (!(sources & MM_MODEM_LOCATION_SOURCE_GPS_RAW));
+
+    /* Start and stop the GPS engine */
+    mm_modem_location_setup_sync (location, MM_MODEM_LOCATION_SOURCE_GPS_UNMANAGED, FALSE, NULL, &error);
+    g_assert_no_error (error);
+    mm_modem_location_setup_sync (location, MM_MODEM_LOCATION_SOURCE_NONE, FALSE, NULL, &error);
+    g_assert_no_error (error);
+
+    /* And disable */
+    mm_modem_disable_sync (modem, NULL, &error);
+    g_assert_no_error (error);
+
+    g_object_unref (location);
+    g_object_unref (modem);
+    g_object_unref (obj);
+
+    /* Stop port context */
+    test_port_context_stop (port0);
+    test_port_context_free (port0);
+
+    g_free (ports[0]);
+}
+
+/*****************************************************************************/
+
+int main (int   argc,
+          char *argv[])
+{
+    g_test_init (&argc, &argv, NULL);
+
+    TEST_ADD ("/MM/Service/Quectel/location/gps-unmanaged", test_location_gps_unmanaged);
+
+    return g_test_run ();
+}
@@ -64,32 +64,73 @@ load_connection_status_finish (MMBaseBearer  *bearer,
     return (MMBearerConnectionStatus)value;
 }
 
+/* All bearers of the same modem share the !SCACT? query, as it reports the
+ * state of every context at once */
+#define SCACT_QUERY_TAG "sierra-scact-query"
+
+/* Replies younger than this are reused instead of querying again */
+#define SCACT_QUERY_MAX_AGE_SECS 2
+
+/* If +CGEV events are enabled, context deactivations are already reported
+ * by the modem and the query is just a fallback, so it is reused longer */
+#define SCACT_QUERY_MAX_AGE_CGEV_SECS 30
+
+typedef struct {
+    GList  *pending;
+    GList  *pdp_active_list;
+    gint64  time;
+} ScactQuery;
+
 static void
-scact_periodic_query_ready (MMBaseModem  *modem,
-                            GAsyncResult *res,
-                            GTask        *task)
+scact_query_free (ScactQuery *query)
+{
+    g_assert (!query->pending);
+    mm_3gpp_pdp_context_active_list_free (query->pdp_active_list);
+    g_slice_free (ScactQuery, query);
+}
+
+static ScactQuery *
+scact_query_peek (MMBaseModem *modem)
+{
+    ScactQuery *query;
+
+    query = g_object_get_data (G_OBJECT (modem), SCACT_QUERY_TAG);
+    if (!query) {
+        query = g_slice_new0 (ScactQuery);
+        g_object_set_data_full (G_OBJECT (modem), SCACT_QUERY_TAG, query, (GDestroyNotify) scact_query_free);
+    }
+    return query;
+}
+
+static void
+scact_query_invalidate (MMBaseModem *modem)
+{
+    ScactQuery *query;
+
+    query = g_object_get_data (G_OBJECT (modem), SCACT_QUERY_TAG);
+    if (query)
+        query->time = 0;
+}
+
+static void
+scact_query_complete (GTask        *task,
+                      GList        *pdp_active_list,
+                      const GError *error)
 {
-    const gchar              *response;
-    GError                   *error = NULL;
-    GList                    *pdp_active_list = NULL;
     GList                    *l;
     MMBearerConnectionStatus  status = MM_BEARER_CONNECTION_STATUS_UNKNOWN;
     guint                     cid;
 
-    cid = GPOINTER_TO_UINT (g_task_get_task_data (task));
-
-    response = mm_base_modem_at_command_finish (modem, res, &error);
-    if (response)
-        pdp_active_list = mm_sierra_parse_scact_read_response (response, &error);
-
     if (error) {
-        g_assert (!pdp_active_list);
-        g_prefix_error (&error, "Couldn't check current list of active PDP contexts: ");
-        g_task_return_error (task, error);
+        g_task_return_new_error (task, error->domain, error->code,
+                                 "Couldn't check current list of active PDP contexts: %s",
+                                 error->message);
         g_object_unref (task);
         return;
     }
 
+    cid = GPOINTER_TO_UINT (g_task_get_task_data (task));
+
     for (l = pdp_active_list; l; l = g_list_next (l)) {
         MM3gppPdpContextActive *pdp_active;
 
@@ -100,7 +141,6 @@ scact_periodic_query_ready (MMBaseModem  *modem,
             break;
         }
     }
-    mm_3gpp_pdp_context_active_list_free (pdp_active_list);
 
     /* PDP context not found? This shouldn't happen, error out */
     if (status == MM_BEARER_CONNECTION_STATUS_UNKNOWN)
@@ -111,6 +151,40 @@ scact_periodic_query_ready (MMBaseModem  *modem,
     g_object_unref (task);
 }
 
+static void
+scact_periodic_query_ready (MMBaseModem  *modem,
+                            GAsyncResult *res)
+{
+    ScactQuery  *query;
+    const gchar *response;
+    GError      *error = NULL;
+    GList       *pdp_active_list = NULL;
+    GList       *pending;
+    GList       *l;
+
+    query = scact_query_peek (modem);
+
+    response = mm_base_modem_at_command_finish (modem, res, &error);
+    if (response)
+        pdp_active_list = mm_sierra_parse_scact_read_response (response, &error);
+
+    if (!error) {
+        mm_3gpp_pdp_context_active_list_free (query->pdp_active_list);
+        query->pdp_active_list = pdp_active_list;
+        query->time = g_get_monotonic_time ();
+    }
+    g_assert (!error || !pdp_active_list);
+
+    /* Complete every bearer waiting for this reply */
+    pending = query->pending;
+    query->pending = NULL;
+    for (l = pending; l; l = g_list_next (l))
+        scact_query_complete (G_TASK (l->data), query->pdp_active_list, error);
+    g_list_free (pending);
+
+    g_clear_error (&error);
+}
+
 static void
 load_connection_status (MMBaseBearer        *self,
                         GAsyncReadyCallback  callback,
@@ -119,6 +193,9 @@ load_connection_status (MMBaseBearer        *self,
     GTask          *task;
     MMBaseModem    *modem = NULL;
     MMPortSerialAt *port;
+    ScactQuery     *query;
+    guint           max_age;
+    gboolean        running;
     guint           cid;
 
     task = g_task_new (self, NULL, callback, user_data);
@@ -146,6 +223,21 @@ load_connection_status (MMBaseBearer        *self,
         goto out;
     }
 
+    /* Reuse a recent reply if there is one */
+    query = scact_query_peek (modem);
+    max_age = (mm_broadband_modem_get_packet_domain_events_enabled (MM_BROADBAND_MODEM (modem)) ?
+               SCACT_QUERY_MAX_AGE_CGEV_SECS : SCACT_QUERY_MAX_AGE_SECS);
+    if (query->time && (g_get_monotonic_time () - query->time) < (gint64) max_age * G_USEC_PER_SEC) {
+        scact_query_complete (task, query->pdp_active_list, NULL);
+        goto out;
+    }
+
+    /* If a query is already running, just wait for its reply */
+    running = !!query->pending;
+    query->pending = g_list_append (query->pending, task);
+    if (running)
+        goto out;
+
     mm_base_modem_at_command_full (MM_BASE_MODEM (modem),
                                    port,
                                    "!SCACT?",
@@ -154,7 +246,7 @@ load_connection_status (MMBaseBearer        *self,
                                    FALSE, /* raw */
                                    NULL, /* cancellable */
                                    (GAsyncReadyCallback) scact_periodic_query_ready,
-                                   task);
+                                   NULL);
 
 out:
     g_clear_object (&modem);
@@ -429,6 +521,8 @@ dial_3gpp_context_step (GTask *task)
         return;
 
     case DIAL_3GPP_STEP_LAST:
+        /* Context states changed, don't reuse the last !SCACT? reply */
+        scact_query_invalidate (ctx->modem);
         g_task_return_pointer (task,
                                g_object_ref (ctx->data),
                                g_object_unref);
@@ -524,6 +618,9 @@ disconnect_3gpp (MMBroadbandBearer *self,
 
     task = g_task_new (self, NULL, callback, user_data);
 
+    /* Context states change, don't reuse the last !SCACT? reply */
+    scact_query_invalidate (MM_BASE_MODEM (modem));
+
     if (!MM_IS_PORT_SERIAL_AT (data)) {
         gchar *command;
 
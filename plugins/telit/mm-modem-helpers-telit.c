@@ -29,112 +29,164 @@
 
 
 /*****************************************************************************/
-/* Set current bands helpers */
+/* #BND band flag tables
+ *
+ * Each Telit band flag maps to a fixed set of MM bands, so the sets are kept
+ * as bitmasks indexed by the flag number:
+ *   2G: bit N is band (MM_MODEM_BAND_EGSM + N)
+ *   3G: bit N is UTRAN band N
+ *   4G: bit N is EUTRAN band N+1 (the 4G flag is already a bitmask)
+ */
 
-void
-mm_telit_get_band_flag (GArray *bands_array,
-                        gint *flag2g,
-                        gint *flag3g,
-                        gint *flag4g)
+#define BAND_2G_BIT(band) (1 << ((band) - MM_MODEM_BAND_EGSM))
+#define UTRAN_BIT(n)      (1 << (n))
+
+static const guint32 telit_2g_band_masks[] = {
+    [BND_FLAG_GSM900_DCS1800] = BAND_2G_BIT (MM_MODEM_BAND_EGSM) | BAND_2G_BIT (MM_MODEM_BAND_DCS),
+    [BND_FLAG_GSM900_PCS1900] = BAND_2G_BIT (MM_MODEM_BAND_EGSM) | BAND_2G_BIT (MM_MODEM_BAND_PCS),
+    [BND_FLAG_GSM850_DCS1800] = BAND_2G_BIT (MM_MODEM_BAND_DCS)  | BAND_2G_BIT (MM_MODEM_BAND_G850),
+    [BND_FLAG_GSM850_PCS1900] = BAND_2G_BIT (MM_MODEM_BAND_PCS)  | BAND_2G_BIT (MM_MODEM_BAND_G850),
+};
+
+/* Flag 11 is not defined; an empty mask flags it as unknown */
+static const guint32 telit_3g_band_masks[] = {
+    [BND_FLAG_0]  = UTRAN_BIT (1),
+    [BND_FLAG_1]  = UTRAN_BIT (2),
+    [BND_FLAG_2]  = UTRAN_BIT (5),
+    [BND_FLAG_3]  = UTRAN_BIT (1) | UTRAN_BIT (2) | UTRAN_BIT (5),
+    [BND_FLAG_4]  = UTRAN_BIT (2) | UTRAN_BIT (5),
+    [BND_FLAG_5]  = UTRAN_BIT (8),
+    [BND_FLAG_6]  = UTRAN_BIT (1) | UTRAN_BIT (8),
+    [BND_FLAG_7]  = UTRAN_BIT (4),
+    [BND_FLAG_8]  = UTRAN_BIT (1) | UTRAN_BIT (5),
+    [BND_FLAG_9]  = UTRAN_BIT (1) | UTRAN_BIT (5) | UTRAN_BIT (8),
+    [BND_FLAG_10] = UTRAN_BIT (2) | UTRAN_BIT (4) | UTRAN_BIT (5),
+    [BND_FLAG_12] = UTRAN_BIT (6),
+    [BND_FLAG_13] = UTRAN_BIT (3),
+    [BND_FLAG_14] = UTRAN_BIT (1) | UTRAN_BIT (2) | UTRAN_BIT (4) | UTRAN_BIT (5) | UTRAN_BIT (6),
+    [BND_FLAG_15] = UTRAN_BIT (1) | UTRAN_BIT (3) | UTRAN_BIT (8),
+    [BND_FLAG_16] = UTRAN_BIT (5) | UTRAN_BIT (8),
+    [BND_FLAG_17] = UTRAN_BIT (2) | UTRAN_BIT (4) | UTRAN_BIT (5) | UTRAN_BIT (6),
+    [BND_FLAG_18] = UTRAN_BIT (1) | UTRAN_BIT (2) | UTRAN_BIT (5) | UTRAN_BIT (6),
+    [BND_FLAG_19] = UTRAN_BIT (2) | UTRAN_BIT (6),
+    [BND_FLAG_20] = UTRAN_BIT (5) | UTRAN_BIT (6),
+    [BND_FLAG_21] = UTRAN_BIT (2) | UTRAN_BIT (5) | UTRAN_BIT (6),
+};
+
+/* UTRAN band number to MM band */
+static const MMModemBand utran_bands[] = {
+    [1] = MM_MODEM_BAND_UTRAN_1,
+    [2] = MM_MODEM_BAND_UTRAN_2,
+    [3] = MM_MODEM_BAND_UTRAN_3,
+    [4] = MM_MODEM_BAND_UTRAN_4,
+    [5] = MM_MODEM_BAND_UTRAN_5,
+    [6] = MM_MODEM_BAND_UTRAN_6,
+    [7] = MM_MODEM_BAND_UTRAN_7,
+    [8] = MM_MODEM_BAND_UTRAN_8,
+    [9] = MM_MODEM_BAND_UTRAN_9,
+};
+
+/* Set of bands, one bitmask per technology, as described above */
+typedef struct {
+    guint32 mask_2g;
+    guint32 mask_3g;
+    guint64 mask_4g;
+} TelitBandSet;
+
+static void
+band_set_add_mm_band (TelitBandSet *set,
+                      MMModemBand   band)
 {
-    guint mask2g = 0;
-    guint mask3g = 0;
-    guint mask4g = 0;
-    guint found4g = FALSE;
     guint i;
 
-    for (i = 0; i < bands_array->len; i++) {
-        MMModemBand band = g_array_index (bands_array, MMModemBand, i);
-
-        if (flag2g != NULL) {
-            switch (band) {
-                case MM_MODEM_BAND_EGSM:
-                case MM_MODEM_BAND_DCS:
-                case MM_MODEM_BAND_PCS:
-                case MM_MODEM_BAND_G850:
-                    mask2g += 1 << band;
-                    break;
-                default:
-                    break;
-            }
-        }
+    if (band >= MM_MODEM_BAND_EGSM && band <= MM_MODEM_BAND_G850) {
+        set->mask_2g |= BAND_2G_BIT (band);
+        return;
+    }
 
-        if (flag3g != NULL) {
-            switch (band) {
-                case MM_MODEM_BAND_UTRAN_1:
-                case MM_MODEM_BAND_UTRAN_2:
-                case MM_MODEM_BAND_UTRAN_3:
-                case MM_MODEM_BAND_UTRAN_4:
-                case MM_MODEM_BAND_UTRAN_5:
-                case MM_MODEM_BAND_UTRAN_6:
-                case MM_MODEM_BAND_UTRAN_7:
-                case MM_MODEM_BAND_UTRAN_8:
-                case MM_MODEM_BAND_UTRAN_9:
-                    mask3g += 1 << band;
-                    break;
-                default:
-                    break;
-            }
+    if (band >= MM_MODEM_BAND_EUTRAN_1 && band < MM_MODEM_BAND_EUTRAN_1 + 64) {
+        set->mask_4g |= ((guint64) 1) << (band - MM_MODEM_BAND_EUTRAN_1);
+        return;
+    }
+
+    for (i = 1; i < G_N_ELEMENTS (utran_bands); i++) {
+        if (utran_bands[i] == band) {
+            set->mask_3g |= UTRAN_BIT (i);
+            return;
         }
+    }
+}
+
+static void
+band_set_to_mm_bands (const TelitBandSet *set,
+                      GArray             *bands)
+{
+    MMModemBand band;
+    guint       i;
 
-         if (flag4g != NULL &&
-             band >= MM_MODEM_BAND_EUTRAN_1 && band <= MM_MODEM_BAND_EUTRAN_44) {
-             mask4g += 1 << (band - MM_MODEM_BAND_EUTRAN_1);
-             found4g = TRUE;
+    for (i = 0; set->mask_2g >> i; i++) {
+        if (set->mask_2g & (1 << i)) {
+            band = MM_MODEM_BAND_EGSM + i;
+            g_array_append_val (bands, band);
         }
     }
 
-    /* Get 2G flag */
-    if (flag2g != NULL) {
-        if (mask2g == ((1 << MM_MODEM_BAND_EGSM) + (1 << MM_MODEM_BAND_DCS)))
-            *flag2g = 0;
-        else if (mask2g == ((1 << MM_MODEM_BAND_EGSM) + (1 << MM_MODEM_BAND_PCS)))
-            *flag2g = 1;
-        else if (mask2g == ((1 << MM_MODEM_BAND_G850) + (1 << MM_MODEM_BAND_DCS)))
-            *flag2g = 2;
-        else if (mask2g == ((1 << MM_MODEM_BAND_G850) + (1 << MM_MODEM_BAND_PCS)))
-            *flag2g = 3;
-        else
-            *flag2g = -1;
+    for (i = 1; i < G_N_ELEMENTS (utran_bands); i++) {
+        if (set->mask_3g & UTRAN_BIT (i))
+            g_array_append_val (bands, utran_bands[i]);
     }
 
-    /* Get 3G flag */
-    if (flag3g != NULL) {
-        if (mask3g == (1 << MM_MODEM_BAND_UTRAN_1))
-            *flag3g = 0;
-        else if (mask3g == (1 << MM_MODEM_BAND_UTRAN_2))
-            *flag3g = 1;
-        else if (mask3g == (1 << MM_MODEM_BAND_UTRAN_5))
-            *flag3g = 2;
-        else if (mask3g == ((1 << MM_MODEM_BAND_UTRAN_1) +
-                            (1 << MM_MODEM_BAND_UTRAN_2) +
-                            (1 << MM_MODEM_BAND_UTRAN_5)))
-            *flag3g = 3;
-        else if (mask3g == ((1 << MM_MODEM_BAND_UTRAN_2) +
-                            (1 << MM_MODEM_BAND_UTRAN_5)))
-            *flag3g = 4;
-        else if (mask3g == (1 << MM_MODEM_BAND_UTRAN_8))
-            *flag3g = 5;
-        else if (mask3g == ((1 << MM_MODEM_BAND_UTRAN_1) +
-                            (1 << MM_MODEM_BAND_UTRAN_8)))
-            *flag3g = 6;
-        else if (mask3g == (1 << MM_MODEM_BAND_UTRAN_4))
-            *flag3g = 7;
-        else
-            *flag3g = -1;
+    for (i = 0; i < 64 && set->mask_4g >> i; i++) {
+        if (set->mask_4g & (((guint64) 1) << i)) {
+            band = MM_MODEM_BAND_EUTRAN_1 + i;
+            g_array_append_val (bands, band);
+        }
     }
+}
 
-    /* 4G flag correspond to the mask */
-    if (flag4g != NULL) {
-        if (found4g)
-            *flag4g = mask4g;
-        else
-            *flag4g = -1;
+/* Reverse lookup of the flag matching exactly the given mask */
+static gint
+band_mask_to_flag (const guint32 *masks,
+                   guint          n_masks,
+                   guint32        mask)
+{
+    guint i;
+
+    if (!mask)
+        return -1;
+
+    for (i = 0; i < n_masks; i++) {
+        if (masks[i] == mask)
+            return (gint) i;
     }
+    return -1;
 }
 
-#define SUPP_BAND_RESPONSE_REGEX          "#BND:\\s*\\((?P<Bands2G>[0-9\\-,]*)\\)(,\\s*\\((?P<Bands3G>[0-9\\-,]*)\\))?(,\\s*\\((?P<Bands4G>[0-9\\-,]*)\\))?"
-#define CURR_BAND_RESPONSE_REGEX          "#BND:\\s*(?P<Bands2G>\\d+)(,\\s*(?P<Bands3G>\\d+))?(,\\s*(?P<Bands4G>\\d+))?"
+/*****************************************************************************/
+/* Set current bands helpers */
+
+void
+mm_telit_get_band_flag (GArray *bands_array,
+                        gint *flag2g,
+                        gint *flag3g,
+                        guint64 *flag4g)
+{
+    TelitBandSet set = { 0 };
+    guint        i;
+
+    for (i = 0; i < bands_array->len; i++)
+        band_set_add_mm_band (&set, g_array_index (bands_array, MMModemBand, i));
+
+    if (flag2g != NULL)
+        *flag2g = band_mask_to_flag (telit_2g_band_masks, G_N_ELEMENTS (telit_2g_band_masks), set.mask_2g);
+
+    if (flag3g != NULL)
+        *flag3g = band_mask_to_flag (telit_3g_band_masks, G_N_ELEMENTS (telit_3g_band_masks), set.mask_3g);
+
+    /* 4G flag correspond to the full 64-bit mask; 0 if no 4G band given */
+    if (flag4g != NULL)
+        *flag4g = set.mask_4g;
+}
 
 /*****************************************************************************/
 /* #BND response parser
@@ -156,8 +208,8 @@ mm_telit_get_band_flag (GArray *bands_array,
  *        = 3G band flag 4 is U1900 + U850
  *
  * Modems that supports 4G bands, return a range value(X-Y) where
- * X: represent the lower supported band, such as X = 2^(B-1), being B = B1, B2,..., B32
- * Y: is a 32 bit number resulting from a mask of all the supported bands:
+ * X: represent the lower supported band, such as X = 2^(B-1), being B = B1, B2,..., B64
+ * Y: is a 64 bit number resulting from a mask of all the supported bands:
  *      1 - B1
  *      2 - B2
  *      4 - B3
@@ -166,6 +218,8 @@ mm_telit_get_band_flag (GArray *bands_array,
  *      i - B(2exp(i-1))
  *      ...
  *      2147483648 - B32
+ *      ...
+ *      4294967296 - B33
  *
  *   e.g.
  *      (2-4106)
@@ -187,284 +241,182 @@ mm_telit_get_band_flag (GArray *bands_array,
  *  4 = 3G band flag 4 is U1900 + U850
  *
  */
-gboolean
-mm_telit_parse_bnd_response (const gchar *response,
-                             gboolean modem_is_2g,
-                             gboolean modem_is_3g,
-                             gboolean modem_is_4g,
-                             MMTelitLoadBandsType band_type,
-                             GArray **supported_bands,
-                             GError **error)
-{
-    GArray *bands = NULL;
-    GMatchInfo *match_info = NULL;
-    GRegex *r = NULL;
-    gboolean ret = FALSE;
-
-    switch (band_type) {
-        case LOAD_SUPPORTED_BANDS:
-            /* Parse #BND=? response */
-            r = g_regex_new (SUPP_BAND_RESPONSE_REGEX, G_REGEX_RAW, 0, NULL);
-            break;
-        case LOAD_CURRENT_BANDS:
-            /* Parse #BND? response */
-            r = g_regex_new (CURR_BAND_RESPONSE_REGEX, G_REGEX_RAW, 0, NULL);
-        default:
-            break;
-    }
 
+#define SUPP_BAND_RESPONSE_REGEX          "#BND:\\s*\\((?P<Bands2G>[0-9\\-,]*)\\)(,\\s*\\((?P<Bands3G>[0-9\\-,]*)\\))?(,\\s*\\((?P<Bands4G>[0-9\\-,]*)\\))?"
+#define CURR_BAND_RESPONSE_REGEX          "#BND:\\s*(?P<Bands2G>\\d+)(,\\s*(?P<Bands3G>\\d+))?(,\\s*(?P<Bands4G>\\d+))?"
 
-    if (!g_regex_match (r, response, 0, &match_info)) {
-        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
-                     "Could not parse response '%s'", response);
-        goto end;
-    }
-
-    if (!g_match_info_matches (match_info)) {
-        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
-                     "Could not find matches in response '%s'", response);
-        goto end;
-    }
-
-    bands = g_array_new (TRUE, TRUE, sizeof (MMModemBand));
-
-    if (modem_is_2g && !mm_telit_get_2g_mm_bands (match_info, &bands, error))
-        goto end;
-
-    if (modem_is_3g && !mm_telit_get_3g_mm_bands (match_info, &bands, error))
-        goto end;
-
-    if (modem_is_4g && !mm_telit_get_4g_mm_bands (match_info, &bands, error))
-        goto end;
+static GRegex *
+bnd_response_regex_get (MMTelitLoadBandsType band_type)
+{
+    static gsize supp_regex = 0;
+    static gsize curr_regex = 0;
 
-    *supported_bands = bands;
-    ret = TRUE;
+    if (band_type == LOAD_SUPPORTED_BANDS) {
+        if (g_once_init_enter (&supp_regex)) {
+            GRegex *r;
 
-end:
-    if (!ret && bands != NULL)
-        g_array_free (bands, TRUE);
+            r = g_regex_new (SUPP_BAND_RESPONSE_REGEX, G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+            g_assert (r != NULL);
+            g_once_init_leave (&supp_regex, (gsize) r);
+        }
+        return (GRegex *) supp_regex;
+    }
 
-    g_match_info_free (match_info);
-    g_regex_unref (r);
+    if (g_once_init_enter (&curr_regex)) {
+        GRegex *r;
 
-    return ret;
+        r = g_regex_new (CURR_BAND_RESPONSE_REGEX, G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+        g_assert (r != NULL);
+        g_once_init_leave (&curr_regex, (gsize) r);
+    }
+    return (GRegex *) curr_regex;
 }
 
-gboolean
-mm_telit_get_2g_mm_bands (GMatchInfo *match_info,
-                          GArray **bands,
-                          GError **error)
+/* Parses a list of flags or flag ranges (e.g. "0,2-3,5"), merging the band
+ * masks of each flag into the given one */
+static gboolean
+parse_band_flags (const gchar    *str,
+                  const gchar    *tech,
+                  const guint32  *masks,
+                  guint           n_masks,
+                  guint32        *mask,
+                  GError        **error)
 {
-    GArray *flags = NULL;
-    gchar *match_str = NULL;
-    guint i;
-    gboolean ret = TRUE;
-
-    TelitToMMBandMap map [5] = {
-        { BND_FLAG_GSM900_DCS1800, {MM_MODEM_BAND_EGSM, MM_MODEM_BAND_DCS, MM_MODEM_BAND_UNKNOWN} }, /* 0 */
-        { BND_FLAG_GSM900_PCS1900, {MM_MODEM_BAND_EGSM, MM_MODEM_BAND_PCS, MM_MODEM_BAND_UNKNOWN} }, /* 1 */
-        { BND_FLAG_GSM850_DCS1800, {MM_MODEM_BAND_DCS, MM_MODEM_BAND_G850, MM_MODEM_BAND_UNKNOWN} }, /* 2 */
-        { BND_FLAG_GSM850_PCS1900, {MM_MODEM_BAND_PCS, MM_MODEM_BAND_G850, MM_MODEM_BAND_UNKNOWN} }, /* 3 */
-        { BND_FLAG_UNKNOWN, {}},
-    };
-
-    match_str = g_match_info_fetch_named (match_info, "Bands2G");
+    const gchar *p = str;
 
-    if (match_str == NULL || match_str[0] == '\0') {
+    if (!str || !str[0]) {
         g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
-                     "Could not find 2G band flags from response");
-        ret = FALSE;
-        goto end;
-    }
-
-    flags = g_array_new (FALSE, FALSE, sizeof (guint));
-
-    if (!mm_telit_get_band_flags_from_string (match_str, &flags, error)) {
-        ret = FALSE;
-        goto end;
+                     "Could not find %s band flags from response", tech);
+        return FALSE;
     }
 
-    for (i = 0; i < flags->len; i++) {
-        guint flag;
+    while (*p) {
+        gchar   *end = NULL;
+        guint64  first;
+        guint64  last;
+        guint64  flag;
 
-        flag = g_array_index (flags, guint, i);
-        if (!mm_telit_update_band_array (flag, map, bands, error)) {
-            ret = FALSE;
-            goto end;
+        first = g_ascii_strtoull (p, &end, 10);
+        if (end == p) {
+            g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                         "Could not parse %s band flags from string '%s'", tech, str);
+            return FALSE;
+        }
+        p = end;
+
+        last = first;
+        if (*p == '-') {
+            p++;
+            last = g_ascii_strtoull (p, &end, 10);
+            if (end == p || last < first) {
+                g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                             "Could not parse %s band flag range from string '%s'", tech, str);
+                return FALSE;
+            }
+            p = end;
         }
-    }
 
-end:
-    g_free (match_str);
+        for (flag = first; flag <= last; flag++) {
+            if (flag >= n_masks || !masks[flag]) {
+                g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                             "No MM band found for Telit #BND flag '%" G_GUINT64_FORMAT "'",
+                             flag);
+                return FALSE;
+            }
+            *mask |= masks[flag];
+        }
 
-    if (flags != NULL)
-        g_array_free (flags, TRUE);
+        if (*p == ',')
+            p++;
+    }
 
-    return ret;
+    return TRUE;
 }
 
-gboolean
-mm_telit_get_3g_mm_bands (GMatchInfo *match_info,
-                          GArray **bands,
-                          GError **error)
+/* The 4G flag is itself the mask of bands; in the =? response a range is
+ * given, where the upper limit is the mask of all supported bands */
+static gboolean
+parse_4g_band_flags (const gchar  *str,
+                     guint64      *mask,
+                     GError      **error)
 {
-    GArray *flags = NULL;
-    gchar *match_str = NULL;
-    guint i;
-    gboolean ret = TRUE;
-
-    TelitToMMBandMap map [] = {
-        { BND_FLAG_0, { MM_MODEM_BAND_UTRAN_1, MM_MODEM_BAND_UNKNOWN} },
-        { BND_FLAG_1, { MM_MODEM_BAND_UTRAN_2, MM_MODEM_BAND_UNKNOWN} },
-        { BND_FLAG_2, { MM_MODEM_BAND_UTRAN_5, MM_MODEM_BAND_UNKNOWN} },
-        { BND_FLAG_3, { MM_MODEM_BAND_UTRAN_1, MM_MODEM_BAND_UTRAN_2, MM_MODEM_BAND_UTRAN_5, MM_MODEM_BAND_UNKNOWN} },
-        { BND_FLAG_4, { MM_MODEM_BAND_UTRAN_2, MM_MODEM_BAND_UTRAN_5, MM_MODEM_BAND_UNKNOWN} },
-        { BND_FLAG_5, { MM_MODEM_BAND_UTRAN_8, MM_MODEM_BAND_UNKNOWN} },
-        { BND_FLAG_6, { MM_MODEM_BAND_UTRAN_1, MM_MODEM_BAND_UTRAN_8, MM_MODEM_BAND_UNKNOWN} },
-        { BND_FLAG_7, { MM_MODEM_BAND_UTRAN_4, MM_MODEM_BAND_UNKNOWN} },
-        { BND_FLAG_8, { MM_MODEM_BAND_UTRAN_1, MM_MODEM_BAND_UTRAN_5, MM_MODEM_BAND_UNKNOWN }},
-        { BND_FLAG_9, { MM_MODEM_BAND_UTRAN_1, MM_MODEM_BAND_UTRAN_8, MM_MODEM_BAND_UTRAN_5, MM_MODEM_BAND_UNKNOWN }},
-        { BND_FLAG_10, { MM_MODEM_BAND_UTRAN_2, MM_MODEM_BAND_UTRAN_4, MM_MODEM_BAND_UTRAN_5, MM_MODEM_BAND_UNKNOWN }},
-        { BND_FLAG_12, { MM_MODEM_BAND_UTRAN_6, MM_MODEM_BAND_UNKNOWN}},
-        { BND_FLAG_13, { MM_MODEM_BAND_UTRAN_3, MM_MODEM_BAND_UNKNOWN }},
-        { BND_FLAG_14, { MM_MODEM_BAND_UTRAN_1, MM_MODEM_BAND_UTRAN_8, MM_MODEM_BAND_UTRAN_4, MM_MODEM_BAND_UTRAN_5, MM_MODEM_BAND_UTRAN_6, MM_MODEM_BAND_UNKNOWN }},
-        { BND_FLAG_15, { MM_MODEM_BAND_UTRAN_1, MM_MODEM_BAND_UTRAN_8, MM_MODEM_BAND_UTRAN_3, MM_MODEM_BAND_UNKNOWN }},
-        { BND_FLAG_16, { MM_MODEM_BAND_UTRAN_8, MM_MODEM_BAND_UTRAN_5, MM_MODEM_BAND_UNKNOWN }},
-        { BND_FLAG_17, { MM_MODEM_BAND_UTRAN_2, MM_MODEM_BAND_UTRAN_4, MM_MODEM_BAND_UTRAN_5, MM_MODEM_BAND_UTRAN_6, MM_MODEM_BAND_UNKNOWN }},
-        { BND_FLAG_18, { MM_MODEM_BAND_UTRAN_1, MM_MODEM_BAND_UTRAN_2, MM_MODEM_BAND_UTRAN_5, MM_MODEM_BAND_UTRAN_6, MM_MODEM_BAND_UNKNOWN}},
-        { BND_FLAG_19, { MM_MODEM_BAND_UTRAN_2, MM_MODEM_BAND_UTRAN_6, MM_MODEM_BAND_UNKNOWN }},
-        { BND_FLAG_20, { MM_MODEM_BAND_UTRAN_5, MM_MODEM_BAND_UTRAN_6, MM_MODEM_BAND_UNKNOWN}},
-        { BND_FLAG_21, { MM_MODEM_BAND_UTRAN_2, MM_MODEM_BAND_UTRAN_5, MM_MODEM_BAND_UTRAN_6, MM_MODEM_BAND_UNKNOWN}},
-        { BND_FLAG_UNKNOWN, {}},
-    };
-
-    match_str = g_match_info_fetch_named (match_info, "Bands3G");
-
-    if (match_str == NULL || match_str[0] == '\0') {
-        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
-                     "Could not find 3G band flags from response");
-        ret = FALSE;
-        goto end;
-    }
-
-    flags = g_array_new (FALSE, FALSE, sizeof (guint));
+    const gchar *value_str;
+    gchar       *end = NULL;
+    guint64      value;
 
-    if (!mm_telit_get_band_flags_from_string (match_str, &flags, error)) {
-        ret = FALSE;
-        goto end;
+    if (!str || !str[0]) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                     "Could not find 4G band flags from response");
+        return FALSE;
     }
 
-    for (i = 0; i < flags->len; i++) {
-        guint flag;
+    value_str = strchr (str, '-');
+    value_str = value_str ? value_str + 1 : str;
 
-        flag = g_array_index (flags, guint, i);
-        if (!mm_telit_update_band_array (flag, map, bands, error)) {
-            ret = FALSE;
-            goto end;
-        }
+    value = g_ascii_strtoull (value_str, &end, 10);
+    if (end == value_str) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                     "Could not get 4G band ranges from string '%s'",
+                     str);
+        return FALSE;
     }
 
-end:
-    g_free (match_str);
-
-    if (flags != NULL)
-        g_array_free (flags, TRUE);
-
-    return ret;
+    *mask |= value;
+    return TRUE;
 }
 
 gboolean
-mm_telit_get_4g_mm_bands (GMatchInfo *match_info,
-                          GArray **bands,
-                          GError **error)
+mm_telit_parse_bnd_response (const gchar *response,
+                             gboolean modem_is_2g,
+                             gboolean modem_is_3g,
+                             gboolean modem_is_4g,
+                             MMTelitLoadBandsType band_type,
+                             GArray **supported_bands,
+                             GError **error)
 {
-    MMModemBand band;
-    gboolean ret = TRUE;
-    gchar *match_str = NULL;
-    guint i;
-    guint value;
-    gchar **tokens;
-
-    match_str = g_match_info_fetch_named (match_info, "Bands4G");
+    TelitBandSet  set = { 0 };
+    GMatchInfo   *match_info = NULL;
+    gchar        *match_str = NULL;
+    gboolean      ret = FALSE;
 
-    if (match_str == NULL || match_str[0] == '\0') {
+    if (!g_regex_match (bnd_response_regex_get (band_type), response, 0, &match_info)) {
         g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
-                     "Could not find 4G band flags from response");
-        ret = FALSE;
+                     "Could not parse response '%s'", response);
         goto end;
     }
 
-    if (strstr (match_str, "-")) {
-        tokens = g_strsplit (match_str, "-", -1);
-        if (tokens == NULL) {
-            g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
-                         "Could not get 4G band ranges from string '%s'",
-                         match_str);
-            ret = FALSE;
+    if (modem_is_2g) {
+        match_str = g_match_info_fetch_named (match_info, "Bands2G");
+        if (!parse_band_flags (match_str, "2G", telit_2g_band_masks, G_N_ELEMENTS (telit_2g_band_masks), &set.mask_2g, error))
             goto end;
-        }
-        sscanf (tokens[1], "%d", &value);
-        g_strfreev (tokens);
-    } else {
-        sscanf (match_str, "%d", &value);
+        g_clear_pointer (&match_str, g_free);
     }
 
-    for (i = 0; value > 0; i++) {
-        if (value % 2 != 0) {
-            band = MM_MODEM_BAND_EUTRAN_1 + i;
-            g_array_append_val (*bands, band);
-        }
-        value = value >> 1;
+    if (modem_is_3g) {
+        match_str = g_match_info_fetch_named (match_info, "Bands3G");
+        if (!parse_band_flags (match_str, "3G", telit_3g_band_masks, G_N_ELEMENTS (telit_3g_band_masks), &set.mask_3g, error))
+            goto end;
+        g_clear_pointer (&match_str, g_free);
     }
 
-end:
-    g_free (match_str);
-
-    return ret;
-}
-
-gboolean
-mm_telit_bands_contains (GArray *mm_bands, const MMModemBand mm_band)
-{
-    guint i;
-
-    for (i = 0; i < mm_bands->len; i++) {
-        if (mm_band == g_array_index (mm_bands, MMModemBand, i))
-            return TRUE;
+    if (modem_is_4g) {
+        match_str = g_match_info_fetch_named (match_info, "Bands4G");
+        if (!parse_4g_band_flags (match_str, &set.mask_4g, error))
+            goto end;
+        g_clear_pointer (&match_str, g_free);
     }
 
-    return FALSE;
-}
-
-gboolean
-mm_telit_update_band_array (const gint bands_flag,
-                            const TelitToMMBandMap *map,
-                            GArray **bands,
-                            GError **error)
-{
-    guint i;
-    guint j;
-
-    for (i = 0; map[i].flag != BND_FLAG_UNKNOWN; i++) {
-        if (bands_flag == map[i].flag) {
-            for (j = 0; map[i].mm_bands[j] != MM_MODEM_BAND_UNKNOWN; j++) {
-                if (!mm_telit_bands_contains (*bands, map[i].mm_bands[j])) {
-                    g_array_append_val (*bands, map[i].mm_bands[j]);
-                }
-            }
-
-            return TRUE;
-        }
-    }
+    *supported_bands = g_array_new (TRUE, TRUE, sizeof (MMModemBand));
+    band_set_to_mm_bands (&set, *supported_bands);
+    ret = TRUE;
 
-    g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
-                 "No MM band found for Telit #BND flag '%d'",
-                 bands_flag);
+end:
+    g_free (match_str);
+    g_match_info_free (match_info);
 
-    return FALSE;
+    return ret;
 }
 
-
 gboolean
 mm_telit_get_band_flags_from_string (const gchar *flag_str,
                                      GArray **band_flags,
@@ -21,8 +21,6 @@
 
 #define MAX_BANDS_LIST_LEN 20
 
-#define BND_FLAG_UNKNOWN -1
-
 /* AT#BND 2G flags */
 typedef enum {
     BND_FLAG_GSM900_DCS1800,
@@ -33,34 +31,29 @@ typedef enum {
 
 /* AT#BND 3G flags */
 typedef enum {
-    BND_FLAG_0,    /* B1 (2100 MHz) */
-    BND_FLAG_1,    /* B2 (1900 MHz) */
-    BND_FLAG_2,    /* B5 (850 MHz) */
-    BND_FLAG_3,    /* B1 (2100 MHz) + B2 (1900 MHz) + B5 (850 MHz) */
-    BND_FLAG_4,    /* B2 (1900 MHz) + B5 (850 MHz) */
-    BND_FLAG_5,    /* B8 (900 MHz) */
-    BND_FLAG_6,    /* B1 (2100 MHz) + B8 (900 MHz) */
-    BND_FLAG_7,    /* B4 (1700 MHz) */
-    BND_FLAG_8,    /* B1 (2100 MHz) + B5 (850 MHz) */
-    BND_FLAG_9,    /* B1 (2100 MHz) + B8 (900 MHz) + B5 (850 MHz) */
-    BND_FLAG_10,   /* B2 (1900 MHz) + B4 (1700 MHz) + B5 (850 MHz) */
-    BND_FLAG_12,   /* B6 (800 MHz) */
-    BND_FLAG_13,   /* B3 (1800 MHz) */
-    BND_FLAG_14,   /* B1 (2100 MHz) + B2 (1900 MHz) + B4 (1700 MHz) + B5 (850 MHz) + B6 (800MHz) */
-    BND_FLAG_15,   /* B1 (2100 MHz) + B8 (900 MHz) + B3 (1800 MHz) */
-    BND_FLAG_16,   /* B8 (900 MHz) + B5 (850 MHz) */
-    BND_FLAG_17,   /* B2 (1900 MHz) + B4 (1700 MHz) + B5 (850 MHz) + B6 (800 MHz) */
-    BND_FLAG_18,   /* B1 (2100 MHz) + B2 (1900 MHz) + B5 (850 MHz) + B6 (800 MHz) */
-    BND_FLAG_19,   /* B2 (1900 MHz) + B6 (800 MHz) */
-    BND_FLAG_20,   /* B5 (850 MHz) + B6 (800 MHz) */
-    BND_FLAG_21,   /* B2 (1900 MHz) + B5 (850 MHz) + B6 (800 MHz) */
+    BND_FLAG_0  = 0,   /* B1 (2100 MHz) */
+    BND_FLAG_1  = 1,   /* B2 (1900 MHz) */
+    BND_FLAG_2  = 2,   /* B5 (850 MHz) */
+    BND_FLAG_3  = 3,   /* B1 (2100 MHz) + B2 (1900 MHz) + B5 (850 MHz) */
+    BND_FLAG_4  = 4,   /* B2 (1900 MHz) + B5 (850 MHz) */
+    BND_FLAG_5  = 5,   /* B8 (900 MHz) */
+    BND_FLAG_6  = 6,   /* B1 (2100 MHz) + B8 (900 MHz) */
+    BND_FLAG_7  = 7,   /* B4 (1700 MHz) */
+    BND_FLAG_8  = 8,   /* B1 (2100 MHz) + B5 (850 MHz) */
+    BND_FLAG_9  = 9,   /* B1 (2100 MHz) + B8 (900 MHz) + B5 (850 MHz) */
+    BND_FLAG_10 = 10,  /* B2 (1900 MHz) + B4 (1700 MHz) + B5 (850 MHz) */
+    BND_FLAG_12 = 12,  /* B6 (800 MHz) */
+    BND_FLAG_13 = 13,  /* B3 (1800 MHz) */
+    BND_FLAG_14 = 14,  /* B1 (2100 MHz) + B2 (1900 MHz) + B4 (1700 MHz) + B5 (850 MHz) + B6 (800MHz) */
+    BND_FLAG_15 = 15,  /* B1 (2100 MHz) + B8 (900 MHz) + B3 (1800 MHz) */
+    BND_FLAG_16 = 16,  /* B8 (900 MHz) + B5 (850 MHz) */
+    BND_FLAG_17 = 17,  /* B2 (1900 MHz) + B4 (1700 MHz) + B5 (850 MHz) + B6 (800 MHz) */
+    BND_FLAG_18 = 18,  /* B1 (2100 MHz) + B2 (1900 MHz) + B5 (850 MHz) + B6 (800 MHz) */
+    BND_FLAG_19 = 19,  /* B2 (1900 MHz) + B6 (800 MHz) */
+    BND_FLAG_20 = 20,  /* B5 (850 MHz) + B6 (800 MHz) */
+    BND_FLAG_21 = 21,  /* B2 (1900 MHz) + B5 (850 MHz) + B6 (800 MHz) */
 } BndFlag3G;
 
-typedef struct {
-    gint flag;
-    MMModemBand mm_bands[MAX_BANDS_LIST_LEN];
-} TelitToMMBandMap;
-
 typedef enum {
     LOAD_SUPPORTED_BANDS,
     LOAD_CURRENT_BANDS
@@ -77,23 +70,9 @@ mm_telit_parse_bnd_response (const gchar *response,
                              GError **error);
 
 
-gboolean mm_telit_bands_contains (GArray *mm_bands, const MMModemBand mm_band);
-
-gboolean mm_telit_update_band_array (const gint bands_flag,
-                                     const TelitToMMBandMap *map,
-                                     GArray **bands,
-                                     GError **error);
-
 gboolean mm_telit_get_band_flags_from_string (const gchar *flag_str, GArray **band_flags, GError **error);
-gboolean mm_telit_get_2g_mm_bands(GMatchInfo *match_info, GArray **bands, GError **error);
-gboolean mm_telit_get_3g_mm_bands(GMatchInfo *match_info, GArray **bands, GError **error);
-gboolean mm_telit_get_4g_mm_bands(GMatchInfo *match_info, GArray **bands, GError **error);
-
-gboolean mm_telit_update_2g_bands(gchar *band_list, GMatchInfo **match_info, GArray **bands, GError **error);
-gboolean mm_telit_update_3g_bands(gchar *band_list, GMatchInfo **match_info, GArray **bands, GError **error);
-gboolean mm_telit_update_4g_bands(GArray** bands, GMatchInfo *match_info, GError **error);
 
-void mm_telit_get_band_flag (GArray *bands_array, gint *flag_2g, gint *flag_3g, gint *flag_4g);
+void mm_telit_get_band_flag (GArray *bands_array, gint *flag_2g, gint *flag_3g, guint64 *flag_4g);
 
 /* #QSS? response parser */
 typedef enum { /*< underscore_name=mm_telit_qss_status >*/
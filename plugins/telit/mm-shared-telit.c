@@ -255,7 +255,7 @@ mm_shared_telit_modem_set_current_bands (MMIfaceModem *self,
     gchar *cmd;
     gint flag2g;
     gint flag3g;
-    gint flag4g;
+    guint64 flag4g;
     gboolean is_2g;
     gboolean is_3g;
     gboolean is_4g;
@@ -289,7 +289,7 @@ mm_shared_telit_modem_set_current_bands (MMIfaceModem *self,
         return;
     }
 
-    if (is_4g && flag4g == -1) {
+    if (is_4g && flag4g == 0) {
         g_task_report_new_error (self,
                                  callback,
                                  user_data,
@@ -306,13 +306,13 @@ mm_shared_telit_modem_set_current_bands (MMIfaceModem *self,
     else if (is_2g && is_3g && !is_4g)
         cmd = g_strdup_printf ("AT#BND=%d,%d", flag2g, flag3g);
     else if (is_2g && is_3g && is_4g)
-        cmd = g_strdup_printf ("AT#BND=%d,%d,%d", flag2g, flag3g, flag4g);
+        cmd = g_strdup_printf ("AT#BND=%d,%d,%" G_GUINT64_FORMAT, flag2g, flag3g, flag4g);
     else if (!is_2g && !is_3g && is_4g)
-        cmd = g_strdup_printf ("AT#BND=0,0,%d", flag4g);
+        cmd = g_strdup_printf ("AT#BND=0,0,%" G_GUINT64_FORMAT, flag4g);
     else if (!is_2g && is_3g && is_4g)
-        cmd = g_strdup_printf ("AT#BND=0,%d,%d", flag3g, flag4g);
+        cmd = g_strdup_printf ("AT#BND=0,%d,%" G_GUINT64_FORMAT, flag3g, flag4g);
     else if (is_2g && !is_3g && is_4g)
-        cmd = g_strdup_printf ("AT#BND=%d,0,%d", flag2g, flag4g);
+        cmd = g_strdup_printf ("AT#BND=%d,0,%" G_GUINT64_FORMAT, flag2g, flag4g);
     else {
         g_task_report_new_error (self,
                                  callback,
@@ -25,23 +25,6 @@
 #include "mm-modem-helpers.h"
 #include "mm-modem-helpers-telit.h"
 
-static void
-test_mm_bands_contains (void) {
-    GArray* mm_bands;
-    guint i = 1;
-
-    mm_bands = g_array_sized_new (FALSE, TRUE, sizeof (MMModemBand), 3);
-
-    for (i = 0; i < 3; i++)
-        g_array_append_val (mm_bands, i);
-
-    g_assert (mm_telit_bands_contains (mm_bands, 2));
-    g_assert (mm_telit_bands_contains (mm_bands, 2));
-    g_assert (!mm_telit_bands_contains (mm_bands, 3));
-
-    g_array_free (mm_bands, TRUE);
-}
-
 typedef struct {
     gchar* band_flag_str;
     guint band_flags_len;
@@ -140,6 +123,11 @@ static BNDResponseTest supported_band_mapping_tests [] = {
                                                     MM_MODEM_BAND_EUTRAN_2} },
     { "#BND: (0),(0),(1-3)", FALSE, FALSE, TRUE, 2, { MM_MODEM_BAND_EUTRAN_1,
                                                       MM_MODEM_BAND_EUTRAN_2} },
+    { "#BND: (0),(12,13,21)", FALSE, TRUE, FALSE, 4, { MM_MODEM_BAND_UTRAN_2,
+                                                       MM_MODEM_BAND_UTRAN_3,
+                                                       MM_MODEM_BAND_UTRAN_5,
+                                                       MM_MODEM_BAND_UTRAN_6} },
+    { "#BND: (0),(0),(1-8589934592)", FALSE, FALSE, TRUE, 1, { MM_MODEM_BAND_EUTRAN_34 } },
     { NULL, FALSE, FALSE, FALSE, 0, {}},
 };
 
@@ -178,6 +166,21 @@ test_parse_supported_bands_response (void) {
     }
 }
 
+static void
+test_parse_supported_bands_response_unknown_flag (void) {
+    GError* error = NULL;
+    GArray* bands = NULL;
+
+    /* 3G flag 11 is not defined */
+    g_assert (!mm_telit_parse_bnd_response ("#BND: (0-3),(10-12)",
+                                            TRUE, TRUE, FALSE,
+                                            LOAD_SUPPORTED_BANDS,
+                                            &bands,
+                                            &error));
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED);
+    g_assert (bands == NULL);
+    g_error_free (error);
+}
 
 static BNDResponseTest current_band_mapping_tests [] = {
     { "#BND: 0", TRUE, FALSE, FALSE, 2, { MM_MODEM_BAND_EGSM,
@@ -322,6 +325,7 @@ test_telit_get_3g_bnd_flag (void)
     MMModemBand u900 = MM_MODEM_BAND_UTRAN_8;
     MMModemBand u17iv = MM_MODEM_BAND_UTRAN_4;
     MMModemBand u17ix = MM_MODEM_BAND_UTRAN_9;
+    MMModemBand u800 = MM_MODEM_BAND_UTRAN_6;
     gint flag;
 
     /* Test flag 0 */
@@ -400,6 +404,25 @@ test_telit_get_3g_bnd_flag (void)
     g_assert_cmpint (flag, ==, 7);
     g_array_free (bands_array, TRUE);
 
+    /* Test flag 8 */
+    flag = -1;
+    bands_array = g_array_sized_new (FALSE, FALSE, sizeof (MMModemBand), 2);
+    g_array_append_val (bands_array, u850);
+    g_array_append_val (bands_array, u2100);
+
+    mm_telit_get_band_flag (bands_array, NULL, &flag, NULL);
+    g_assert_cmpint (flag, ==, 8);
+    g_array_free (bands_array, TRUE);
+
+    /* Test flag 12 */
+    flag = -1;
+    bands_array = g_array_sized_new (FALSE, FALSE, sizeof (MMModemBand), 1);
+    g_array_append_val (bands_array, u800);
+
+    mm_telit_get_band_flag (bands_array, NULL, &flag, NULL);
+    g_assert_cmpint (flag, ==, 12);
+    g_array_free (bands_array, TRUE);
+
     /* Test invalid band array */
     flag = -1;
     bands_array = g_array_sized_new (FALSE, FALSE, sizeof (MMModemBand), 1);
@@ -416,15 +439,17 @@ test_telit_get_4g_bnd_flag (void)
     GArray *bands_array;
     MMModemBand eutran_i = MM_MODEM_BAND_EUTRAN_1;
     MMModemBand eutran_ii = MM_MODEM_BAND_EUTRAN_2;
+    MMModemBand eutran_xxxiii = MM_MODEM_BAND_EUTRAN_33;
+    MMModemBand eutran_xli = MM_MODEM_BAND_EUTRAN_41;
     MMModemBand egsm = MM_MODEM_BAND_EGSM;
-    gint flag = -1;
+    guint64 flag = 0;
 
     /* Test flag 1 */
     bands_array = g_array_sized_new (FALSE, FALSE, sizeof (MMModemBand), 1);
     g_array_append_val (bands_array, eutran_i);
 
     mm_telit_get_band_flag (bands_array, NULL, NULL, &flag);
-    g_assert_cmpint (flag, ==, 1);
+    g_assert_cmpuint (flag, ==, 1);
     g_array_free (bands_array, TRUE);
 
     /* Test flag 3 */
@@ -433,7 +458,17 @@ test_telit_get_4g_bnd_flag (void)
     g_array_append_val (bands_array, eutran_ii);
 
     mm_telit_get_band_flag (bands_array, NULL, NULL, &flag);
-    g_assert_cmpint (flag, ==, 3);
+    g_assert_cmpuint (flag, ==, 3);
+    g_array_free (bands_array, TRUE);
+
+    /* Test flag with bands above B32 */
+    bands_array = g_array_sized_new (FALSE, FALSE, sizeof (MMModemBand), 3);
+    g_array_append_val (bands_array, eutran_i);
+    g_array_append_val (bands_array, eutran_xxxiii);
+    g_array_append_val (bands_array, eutran_xli);
+
+    mm_telit_get_band_flag (bands_array, NULL, NULL, &flag);
+    g_assert_cmpuint (flag, ==, G_GUINT64_CONSTANT (0x10100000001));
     g_array_free (bands_array, TRUE);
 
     /* Test invalid bands array */
@@ -441,10 +476,126 @@ test_telit_get_4g_bnd_flag (void)
     g_array_append_val (bands_array, egsm);
 
     mm_telit_get_band_flag (bands_array, NULL, NULL, &flag);
-    g_assert_cmpint (flag, ==, -1);
+    g_assert_cmpuint (flag, ==, 0);
     g_array_free (bands_array, TRUE);
 }
 
+static void
+test_telit_set_current_bands_roundtrip (void)
+{
+    GArray  *bands_array;
+    GArray  *parsed = NULL;
+    GError  *error = NULL;
+    gchar   *response;
+    guint64  flag = 0;
+    gboolean res;
+    guint    i;
+
+    /* LM940 current bands, including B38, B39, B40 and B41 */
+    res = mm_telit_parse_bnd_response ("#BND: 0,0,141666087135",
+                                       FALSE, FALSE, TRUE,
+                                       LOAD_CURRENT_BANDS,
+                                       &bands_array,
+                                       &error);
+    g_assert_no_error (error);
+    g_assert (res);
+
+    /* Setting back the same bands must give the same 4G flag */
+    mm_telit_get_band_flag (bands_array, NULL, NULL, &flag);
+    g_assert_cmpuint (flag, ==, G_GUINT64_CONSTANT (141666087135));
+
+    response = g_strdup_printf ("#BND: 0,0,%" G_GUINT64_FORMAT, flag);
+    res = mm_telit_parse_bnd_response (response,
+                                       FALSE, FALSE, TRUE,
+                                       LOAD_CURRENT_BANDS,
+                                       &parsed,
+                                       &error);
+    g_assert_no_error (error);
+    g_assert (res);
+    g_assert_cmpuint (parsed->len, ==, bands_array->len);
+    for (i = 0; i < parsed->len; i++)
+        g_assert_cmpint (g_array_index (parsed, MMModemBand, i), ==, g_array_index (bands_array, MMModemBand, i));
+
+    g_free (response);
+    g_array_unref (parsed);
+    g_array_unref (bands_array);
+}
+
+/*****************************************************************************/
+/* #BND parsing benchmark
+ *
+ * Only run in perf mode, e.g.:
+ *   test-modem-helpers-telit -m perf -p /MM/telit/bands/benchmark
+ */
+
+typedef struct {
+    const gchar          *variant;
+    const gchar          *response;
+    gboolean              modem_is_2g;
+    gboolean              modem_is_3g;
+    gboolean              modem_is_4g;
+    MMTelitLoadBandsType  band_type;
+} BNDBenchmarkTest;
+
+static const BNDBenchmarkTest bnd_benchmark_tests[] = {
+    { "LE910-EU (supported)",     "#BND: (0-3),(0,5,6,13,15),(1-524485)",              TRUE,  TRUE,  TRUE, LOAD_SUPPORTED_BANDS },
+    { "LE910-EU (current)",       "#BND: 0,6,524485",                                  TRUE,  TRUE,  TRUE, LOAD_CURRENT_BANDS   },
+    { "LE910-NA (supported)",     "#BND: (0-3),(0-4,7,10,17,21),(2-4106)",             TRUE,  TRUE,  TRUE, LOAD_SUPPORTED_BANDS },
+    { "LE910-NA (current)",       "#BND: 3,10,4106",                                   TRUE,  TRUE,  TRUE, LOAD_CURRENT_BANDS   },
+    { "LE910-SV (supported)",     "#BND: (0),(0),(8-4104)",                            FALSE, FALSE, TRUE, LOAD_SUPPORTED_BANDS },
+    { "LE910-JN (supported)",     "#BND: (0),(0,5,6,12-15),(1-1048789)",               FALSE, TRUE,  TRUE, LOAD_SUPPORTED_BANDS },
+    { "LE910-AU (supported)",     "#BND: (0-3),(0,2,5,6,8,9,16),(1-134217861)",        TRUE,  TRUE,  TRUE, LOAD_SUPPORTED_BANDS },
+    { "LE910C1-EU (supported)",   "#BND: (0-3),(0,5,6,15),(1-134742229)",              TRUE,  TRUE,  TRUE, LOAD_SUPPORTED_BANDS },
+    { "LM940 (supported)",        "#BND: (0),(0),(1-141666087135)",                    FALSE, FALSE, TRUE, LOAD_SUPPORTED_BANDS },
+    { "LM940 (current)",          "#BND: 0,0,141666087135",                            FALSE, FALSE, TRUE, LOAD_CURRENT_BANDS   },
+};
+
+#define BND_BENCHMARK_ITERATIONS 10000
+
+static void
+test_parse_bnd_response_benchmark (void)
+{
+    guint i;
+
+    if (!g_test_perf ())
+        return;
+
+    for (i = 0; i < G_N_ELEMENTS (bnd_benchmark_tests); i++) {
+        GTimer  *timer;
+        gdouble  elapsed;
+        guint    n_bands = 0;
+        guint    j;
+
+        timer = g_timer_new ();
+        for (j = 0; j < BND_BENCHMARK_ITERATIONS; j++) {
+            GError *error = NULL;
+            GArray *bands = NULL;
+
+            g_assert (mm_telit_parse_bnd_response (bnd_benchmark_tests[i].response,
+                                                   bnd_benchmark_tests[i].modem_is_2g,
+                                                   bnd_benchmark_tests[i].modem_is_3g,
+                                                   bnd_benchmark_tests[i].modem_is_4g,
+                                                   bnd_benchmark_tests[i].band_type,
+                                                   &bands,
+                                                   &error));
+            g_assert_no_error (error);
+            n_bands = bands->len;
+            g_array_unref (bands);
+        }
+        elapsed = g_timer_elapsed (timer, NULL);
+        g_timer_destroy (timer);
+
+        g_test_message ("%s: %u bands, %.3f us per parse",
+                        bnd_benchmark_tests[i].variant,
+                        n_bands,
+                        (elapsed * G_USEC_PER_SEC) / BND_BENCHMARK_ITERATIONS);
+        g_test_minimized_result ((elapsed * G_USEC_PER_SEC) / BND_BENCHMARK_ITERATIONS,
+                                 "%s: %.3f us per parse",
+                                 bnd_benchmark_tests[i].variant,
+                                 (elapsed * G_USEC_PER_SEC) / BND_BENCHMARK_ITERATIONS);
+    }
+}
+
 typedef struct {
     const char* response;
     MMTelitQssStatus expected_qss;
@@ -489,13 +640,15 @@ int main (int argc, char **argv)
 
     g_test_init (&argc, &argv, NULL);
 
-    g_test_add_func ("/MM/telit/bands/supported/bands_contains", test_mm_bands_contains);
     g_test_add_func ("/MM/telit/bands/supported/parse_band_flag", test_parse_band_flag_str);
     g_test_add_func ("/MM/telit/bands/supported/parse_bands_response", test_parse_supported_bands_response);
+    g_test_add_func ("/MM/telit/bands/supported/parse_bands_response/unknown_flag", test_parse_supported_bands_response_unknown_flag);
     g_test_add_func ("/MM/telit/bands/current/parse_bands_response", test_parse_current_bands_response);
     g_test_add_func ("/MM/telit/bands/current/set_bands/2g", test_telit_get_2g_bnd_flag);
     g_test_add_func ("/MM/telit/bands/current/set_bands/3g", test_telit_get_3g_bnd_flag);
     g_test_add_func ("/MM/telit/bands/current/set_bands/4g", test_telit_get_4g_bnd_flag);
+    g_test_add_func ("/MM/telit/bands/current/set_bands/4g/roundtrip", test_telit_set_current_bands_roundtrip);
+    g_test_add_func ("/MM/telit/bands/benchmark", test_parse_bnd_response_benchmark);
     g_test_add_func ("/MM/telit/qss/query", test_telit_parse_qss_query);
     return g_test_run ();
 }
@@ -97,14 +97,18 @@ test_fixture_set_profile (TestFixture *fixture,
         g_error ("Error setting test profile: %s", error->message);
 }
 
-static MMObject *
-common_get_modem (TestFixture *fixture,
-                  gboolean     modem_expected)
+static GList *
+common_get_modems (TestFixture *fixture,
+                   guint        n_expected)
 {
-    MMObject *found = NULL;
-    guint     wait_time = 0;
+    GList *found = NULL;
+    guint  wait_time = 0;
+    guint  max_wait_time;
 
-    /* Find new modem object */
+    /* Allow more time when many modems are expected */
+    max_wait_time = 20 + n_expected / 2;
+
+    /* Find new modem objects */
     while (TRUE) {
         GError    *error = NULL;
         MMManager *manager;
@@ -125,13 +129,16 @@ common_get_modem (TestFixture *fixture,
 
         modems = g_dbus_object_manager_get_objects (G_DBUS_OBJECT_MANAGER (manager));
         n_modems = g_list_length (modems);
-        g_assert_cmpuint (n_modems, <=, 1);
+        g_assert_cmpuint (n_modems, <=, n_expected);
+
+        if (n_expected == n_modems) {
+            GList *l;
 
-        if (modem_expected == n_modems) {
-            if (modems) {
-                found = MM_OBJECT (g_object_ref (modems->data));
-                g_message ("Found modem at '%s'", mm_object_get_path (found));
+            for (l = modems; l; l = g_list_next (l)) {
+                found = g_list_prepend (found, g_object_ref (l->data));
+                g_message ("Found modem at '%s'", mm_object_get_path (MM_OBJECT (l->data)));
             }
+            found = g_list_reverse (found);
             ready = TRUE;
         }
 
@@ -142,7 +149,7 @@ common_get_modem (TestFixture *fixture,
             break;
 
         /* Blocking wait */
-        g_assert_cmpuint (wait_time, <=, 20);
+        g_assert_cmpuint (wait_time, <=, max_wait_time);
         wait_time++;
         sleep (1);
     }
@@ -150,14 +157,49 @@ common_get_modem (TestFixture *fixture,
     return found;
 }
 
+GList *
+test_fixture_get_modems (TestFixture *fixture,
+                         guint        n_modems)
+{
+    g_assert_cmpuint (n_modems, >, 0);
+    return common_get_modems (fixture, n_modems);
+}
+
 MMObject *
 test_fixture_get_modem (TestFixture *fixture)
 {
-    return common_get_modem (fixture, TRUE);
+    GList    *modems;
+    MMObject *found;
+
+    modems = common_get_modems (fixture, 1);
+    found = MM_OBJECT (modems->data);
+    g_list_free (modems);
+    return found;
 }
 
 void
 test_fixture_no_modem (TestFixture *fixture)
 {
-    common_get_modem (fixture, FALSE);
+    common_get_modems (fixture, 0);
+}
+
+/*****************************************************************************/
+
+gint
+test_fixture_latency_cmp (const gdouble *a,
+                          const gdouble *b)
+{
+    return (*a < *b) ? -1 : ((*a > *b) ? 1 : 0);
+}
+
+gdouble
+test_fixture_latency_percentile (GArray *latencies,
+                                 guint   percentile)
+{
+    guint idx;
+
+    if (!latencies->len)
+        return 0.0;
+    idx = MIN (latencies->len - 1, (latencies->len * percentile) / 100);
+    return g_array_index (latencies, gdouble, idx);
 }
@@ -49,6 +49,17 @@ void      test_fixture_set_profile (TestFixture *fixture,
                                     const gchar *plugin,
                                     const gchar *const *ports);
 MMObject *test_fixture_get_modem   (TestFixture *fixture);
+GList    *test_fixture_get_modems  (TestFixture *fixture,
+                                    guint        n_modems);
 void      test_fixture_no_modem    (TestFixture *fixture);
 
+/*****************************************************************************/
+/* Latency statistics, for benchmarks */
+
+/* Sort the array of gdouble latencies with this before getting percentiles */
+gint    test_fixture_latency_cmp        (const gdouble *a,
+                                         const gdouble *b);
+gdouble test_fixture_latency_percentile (GArray        *latencies,
+                                         guint          percentile);
+
 #endif /* TEST_FIXTURE_H */
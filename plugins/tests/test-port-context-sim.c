@@ -0,0 +1,330 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <sys/types.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <gio/gio.h>
+#include <gio/gunixsocketaddress.h>
+
+#include "test-port-context.h"
+
+/* Checks of the modem simulation features of the port context, talking to
+ * it directly through the socket, as a serial port would do. */
+
+#define REPLY_TIMEOUT_US (200 * 1000)
+
+/*****************************************************************************/
+/* Client side */
+
+static gchar *
+port_name_new (void)
+{
+    static guint n_ports = 0;
+
+    /* Add process ID so that multiple runs of this test in the same system
+     * don't clash with each other */
+    return g_strdup_printf ("abstract:test-port-context-sim:%ld:%u", (glong) getpid (), n_ports++);
+}
+
+static GSocket *
+client_connect (const gchar *name)
+{
+    GError         *error = NULL;
+    GSocket        *socket;
+    GSocketAddress *address;
+
+    socket = g_socket_new (G_SOCKET_FAMILY_UNIX, G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_DEFAULT, &error);
+    g_assert_no_error (error);
+    address = g_unix_socket_address_new_with_type (name, -1, G_UNIX_SOCKET_ADDRESS_ABSTRACT);
+    g_socket_connect (socket, address, NULL, &error);
+    g_assert_no_error (error);
+    g_object_unref (address);
+    return socket;
+}
+
+/* Reads until the given string is found in the buffer or the timeout
+ * expires; returns the number of reads done */
+static guint
+client_read_until (GSocket      *socket,
+                   GString      *buffer,
+                   const gchar  *end,
+                   gint64        timeout_us,
+                   GError      **error)
+{
+    gint64 deadline;
+    guint  n_reads = 0;
+
+    deadline = g_get_monotonic_time () + timeout_us;
+    while (!strstr (buffer->str, end)) {
+        gchar  data[256];
+        gssize n;
+        gint64 remaining;
+
+        remaining = deadline - g_get_monotonic_time ();
+        if (remaining <= 0 ||
+            !g_socket_condition_timed_wait (socket, G_IO_IN, remaining, NULL, error)) {
+            if (error && !*error)
+                g_set_error (error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT, "Socket I/O timed out");
+            break;
+        }
+
+        n = g_socket_receive (socket, data, sizeof (data), NULL, error);
+        if (n <= 0)
+            break;
+        g_string_append_len (buffer, data, n);
+        n_reads++;
+    }
+    return n_reads;
+}
+
+static gchar *
+client_command (GSocket      *socket,
+                const gchar  *command,
+                GError      **error)
+{
+    GString *buffer;
+    gchar   *cmd;
+
+    cmd = g_strdup_printf ("%s\r", command);
+    g_socket_send (socket, cmd, strlen (cmd), NULL, error);
+    g_free (cmd);
+    if (error && *error)
+        return NULL;
+
+    buffer = g_string_new (NULL);
+    client_read_until (socket, buffer, "\r\nOK\r\n", REPLY_TIMEOUT_US, error);
+    if (error && *error) {
+        g_string_free (buffer, TRUE);
+        return NULL;
+    }
+    return g_string_free (buffer, FALSE);
+}
+
+/*****************************************************************************/
+
+static void
+test_drop (void)
+{
+    TestPortContext *port;
+    GSocket         *socket;
+    GError          *error = NULL;
+    gchar           *name;
+    gchar           *response;
+    guint            n_replies = 0;
+
+    name = port_name_new ();
+    port = test_port_context_new (name);
+    test_port_context_set_command (port, "AT", "\r\nOK\r\n");
+    test_port_context_set_command (port, "AT+DROP", "\r\nOK\r\n");
+    test_port_context_set_drop_probability (port, "AT+DROP", 1.0);
+    test_port_context_start (port);
+
+    socket = client_connect (name);
+
+    /* The reply to a dropped command never arrives */
+    response = client_command (socket, "AT+DROP", &error);
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT);
+    g_assert (response == NULL);
+    g_clear_error (&error);
+
+    /* And other commands are still replied, without any late reply of the
+     * dropped one in between */
+    response = client_command (socket, "AT", &error);
+    g_assert_no_error (error);
+    g_assert_cmpstr (response, ==, "\r\nOK\r\n");
+    g_free (response);
+
+    test_port_context_get_stats (port, &n_replies, NULL);
+    g_assert_cmpuint (n_replies, ==, 1);
+
+    g_object_unref (socket);
+    test_port_context_stop (port);
+    test_port_context_free (port);
+    g_free (name);
+}
+
+static void
+test_chunking (void)
+{
+    TestPortContext *port;
+    GSocket         *socket;
+    GError          *error = NULL;
+    gchar           *name;
+    gchar           *response;
+    guint64          reply_time_us = 0;
+    static const gchar *reply = "\r\n+CHUNK: 0123456789abcdef\r\n\r\nOK\r\n";
+
+    name = port_name_new ();
+    port = test_port_context_new (name);
+    test_port_context_set_command (port, "AT+CHUNK", reply);
+    test_port_context_set_chunking (port, 4, 10);
+    test_port_context_start (port);
+
+    socket = client_connect (name);
+
+    response = client_command (socket, "AT+CHUNK", &error);
+    g_assert_no_error (error);
+    g_assert_cmpstr (response, ==, reply);
+    g_free (response);
+
+    /* The last chunk is written after all the inter-chunk delays */
+    test_port_context_get_stats (port, NULL, &reply_time_us);
+    g_assert_cmpuint (reply_time_us, >=, ((strlen (reply) + 3) / 4 - 1) * 10 * 1000);
+
+    g_object_unref (socket);
+    test_port_context_stop (port);
+    test_port_context_free (port);
+    g_free (name);
+}
+
+static void
+test_directives (void)
+{
+    TestPortContext *port;
+    GSocket         *socket;
+    GError          *error = NULL;
+    GString         *buffer;
+    gchar           *name;
+    gchar           *path = NULL;
+    gchar           *response;
+    gint             fd;
+    gint64           start;
+    const gchar     *p;
+    guint            n_urcs = 0;
+    static const gchar *commands =
+        "# Commands file with simulation directives\n"
+        "AT           \\r\\nOK\\r\\n\n"
+        "AT+SLOW      \\r\\nOK\\r\\n\n"
+        "AT+DROP      \\r\\nOK\\r\\n\n"
+        "@seed 1234\n"
+        "@latency 100 100 AT+SLOW\n"
+        "@drop 1.0 AT+DROP\n"
+        "@drop 1.0 AT+DROP=\"a b\"\n"
+        "@chunk 3 1\n"
+        "@urc 10 3 \\r\\n+URC: 1\\r\\n\n";
+
+    fd = g_file_open_tmp ("test-port-context-sim-XXXXXX.conf", &path, &error);
+    g_assert_no_error (error);
+    close (fd);
+    g_file_set_contents (path, commands, -1, &error);
+    g_assert_no_error (error);
+
+    name = port_name_new ();
+    port = test_port_context_new (name);
+    test_port_context_load_commands (port, path);
+    /* Commands with spaces can't be given in the file, only in directives */
+    test_port_context_set_command (port, "AT+DROP=\"a b\"", "\r\nOK\r\n");
+    test_port_context_start (port);
+
+    socket = client_connect (name);
+
+    /* Exactly 3 URCs are sent once the client is connected */
+    buffer = g_string_new (NULL);
+    while (n_urcs < 3) {
+        client_read_until (socket, buffer, "+URC: 1\r\n", G_USEC_PER_SEC, &error);
+        g_assert_no_error (error);
+        p = strstr (buffer->str, "\r\n+URC: 1\r\n");
+        g_assert (p != NULL);
+        g_string_erase (buffer, 0, (p - buffer->str) + strlen ("\r\n+URC: 1\r\n"));
+        n_urcs++;
+    }
+    client_read_until (socket, buffer, "+URC", REPLY_TIMEOUT_US, &error);
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT);
+    g_assert_cmpstr (buffer->str, ==, "");
+    g_clear_error (&error);
+    g_string_free (buffer, TRUE);
+
+    /* Escaped responses are loaded as real line breaks */
+    response = client_command (socket, "AT", &error);
+    g_assert_no_error (error);
+    g_assert_cmpstr (response, ==, "\r\nOK\r\n");
+    g_free (response);
+
+    /* Per-command latency */
+    start = g_get_monotonic_time ();
+    response = client_command (socket, "AT+SLOW", &error);
+    g_assert_no_error (error);
+    g_assert_cmpstr (response, ==, "\r\nOK\r\n");
+    g_assert_cmpint (g_get_monotonic_time () - start, >=, 100 * 1000);
+    g_free (response);
+
+    /* Per-command drop */
+    response = client_command (socket, "AT+DROP", &error);
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT);
+    g_assert (response == NULL);
+    g_clear_error (&error);
+
+    /* The command field of a directive spans until the end of the line */
+    response = client_command (socket, "AT+DROP=\"a b\"", &error);
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT);
+    g_assert (response == NULL);
+    g_clear_error (&error);
+
+    g_object_unref (socket);
+    test_port_context_stop (port);
+    test_port_context_free (port);
+    g_free (name);
+
+    g_unlink (path);
+    g_free (path);
+}
+
+static void
+test_directives_invalid (void)
+{
+    GError *error = NULL;
+    gchar  *path = NULL;
+    gint    fd;
+
+    fd = g_file_open_tmp ("test-port-context-sim-invalid-XXXXXX.conf", &path, &error);
+    g_assert_no_error (error);
+    close (fd);
+    g_file_set_contents (path, "@latency 100\n", -1, &error);
+    g_assert_no_error (error);
+
+    /* Directives with missing fields abort */
+    if (g_test_trap_fork (0, G_TEST_TRAP_SILENCE_STDERR)) {
+        TestPortContext *port;
+
+        port = test_port_context_new ("unused");
+        test_port_context_load_commands (port, path);
+        exit (0);
+    }
+    g_test_trap_assert_failed ();
+    g_test_trap_assert_stderr ("*Invalid directive in commands file: '@latency 100'*");
+
+    g_unlink (path);
+    g_free (path);
+}
+
+/*****************************************************************************/
+
+int main (int   argc,
+          char *argv[])
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/test-port-context/drop", test_drop);
+    g_test_add_func ("/MM/test-port-context/chunking", test_chunking);
+    g_test_add_func ("/MM/test-port-context/directives", test_directives);
+    g_test_add_func ("/MM/test-port-context/directives/invalid", test_directives_invalid);
+
+    return g_test_run ();
+}
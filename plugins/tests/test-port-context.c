@@ -16,11 +16,38 @@
 #include <gio/gio.h>
 #include <gio/gunixsocketaddress.h>
 #include <string.h>
+#include <stdlib.h>
 
 #include "test-port-context.h"
 
 #define BUFFER_SIZE 1024
 
+/* How a given command is replied */
+typedef struct {
+    guint   latency_min_ms;
+    guint   latency_max_ms;
+    gdouble drop_probability;
+} CommandBehavior;
+
+/* Stateful command handler */
+typedef struct {
+    gchar                    *prefix;
+    TestPortContextCommandFn  callback;
+    gpointer                  user_data;
+    GDestroyNotify            user_data_free;
+} CommandHandler;
+
+/* Periodic URC stream */
+typedef struct {
+    TestPortContext *ctx;
+    gchar          **urcs;
+    guint            n_urcs;
+    guint            interval_ms;
+    guint            count;
+    guint            sent;
+    GSource         *source;
+} UrcStream;
+
 struct _TestPortContext {
     gchar *name;
     GThread *thread;
@@ -33,6 +60,20 @@ struct _TestPortContext {
     GSocketService *socket_service;
     GList *clients;
     GHashTable *commands;
+
+    /* Simulation setup */
+    GRand *rand;
+    GHashTable *behaviors;
+    CommandBehavior default_behavior;
+    GList *handlers;
+    GList *urc_streams;
+    guint chunk_size;
+    guint chunk_delay_ms;
+
+    /* Reply statistics, read from other threads */
+    GMutex stats_mutex;
+    guint n_replies;
+    guint64 reply_time_us;
 };
 
 /*****************************************************************************/
@@ -44,7 +85,188 @@ test_port_context_set_command (TestPortContext *self,
 {
     if (G_UNLIKELY (!self->commands))
         self->commands = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
-    g_hash_table_replace (self->commands, g_strdup (command), g_strcompress (response));
+    /* A NULL response removes the fixed reply, e.g. to let a handler process it */
+    if (!response)
+        g_hash_table_remove (self->commands, command);
+    else
+        g_hash_table_replace (self->commands, g_strdup (command), g_strcompress (response));
+}
+
+void
+test_port_context_set_command_handler (TestPortContext          *self,
+                                       const gchar              *prefix,
+                                       TestPortContextCommandFn  callback,
+                                       gpointer                  user_data,
+                                       GDestroyNotify            user_data_free)
+{
+    CommandHandler *handler;
+
+    handler = g_slice_new0 (CommandHandler);
+    handler->prefix = g_strdup (prefix);
+    handler->callback = callback;
+    handler->user_data = user_data;
+    handler->user_data_free = user_data_free;
+    self->handlers = g_list_append (self->handlers, handler);
+}
+
+static void
+command_handler_free (CommandHandler *handler)
+{
+    if (handler->user_data_free)
+        handler->user_data_free (handler->user_data);
+    g_free (handler->prefix);
+    g_slice_free (CommandHandler, handler);
+}
+
+static CommandBehavior *
+command_behavior_get (TestPortContext *self,
+                      const gchar     *command)
+{
+    CommandBehavior *behavior;
+
+    if (!command)
+        return &self->default_behavior;
+
+    if (G_UNLIKELY (!self->behaviors))
+        self->behaviors = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+    behavior = g_hash_table_lookup (self->behaviors, command);
+    if (!behavior) {
+        behavior = g_memdup (&self->default_behavior, sizeof (CommandBehavior));
+        g_hash_table_insert (self->behaviors, g_strdup (command), behavior);
+    }
+    return behavior;
+}
+
+void
+test_port_context_set_latency (TestPortContext *self,
+                               const gchar     *command,
+                               guint            min_ms,
+                               guint            max_ms)
+{
+    CommandBehavior *behavior;
+
+    g_assert (min_ms <= max_ms);
+
+    behavior = command_behavior_get (self, command);
+    behavior->latency_min_ms = min_ms;
+    behavior->latency_max_ms = max_ms;
+}
+
+void
+test_port_context_set_drop_probability (TestPortContext *self,
+                                        const gchar     *command,
+                                        gdouble          probability)
+{
+    g_assert (probability >= 0.0 && probability <= 1.0);
+
+    command_behavior_get (self, command)->drop_probability = probability;
+}
+
+void
+test_port_context_set_chunking (TestPortContext *self,
+                                guint            chunk_size,
+                                guint            chunk_delay_ms)
+{
+    self->chunk_size = chunk_size;
+    self->chunk_delay_ms = chunk_delay_ms;
+}
+
+void
+test_port_context_set_seed (TestPortContext *self,
+                            guint32          seed)
+{
+    g_rand_set_seed (self->rand, seed);
+}
+
+void
+test_port_context_add_urc_stream (TestPortContext    *self,
+                                  const gchar *const *urcs,
+                                  guint               interval_ms,
+                                  guint               count)
+{
+    UrcStream *stream;
+    guint      i;
+
+    g_assert (urcs && urcs[0]);
+    g_assert (interval_ms > 0);
+
+    stream = g_slice_new0 (UrcStream);
+    stream->ctx = self;
+    stream->n_urcs = g_strv_length ((gchar **)urcs);
+    stream->urcs = g_new0 (gchar *, stream->n_urcs + 1);
+    for (i = 0; i < stream->n_urcs; i++)
+        stream->urcs[i] = g_strcompress (urcs[i]);
+    stream->interval_ms = interval_ms;
+    stream->count = count;
+    self->urc_streams = g_list_append (self->urc_streams, stream);
+}
+
+static void
+urc_stream_free (UrcStream *stream)
+{
+    if (stream->source) {
+        g_source_destroy (stream->source);
+        g_source_unref (stream->source);
+    }
+    g_strfreev (stream->urcs);
+    g_slice_free (UrcStream, stream);
+}
+
+/* Directives in the commands file:
+ *   @latency <min ms> <max ms> [command]
+ *   @drop <probability> <command>
+ *   @chunk <size> <delay ms>
+ *   @seed <seed>
+ *   @urc <interval ms> <count> <urc>
+ * The command and URC fields span until the end of the line, so they may
+ * contain spaces.
+ */
+static void
+load_directive (TestPortContext *self,
+                const gchar     *line)
+{
+    gchar *tokens[4] = { NULL };
+    gchar *str;
+    gchar *p;
+    guint  n_tokens = 0;
+    guint  max_tokens = G_N_ELEMENTS (tokens);
+
+    str = g_strdup (line);
+    p = str;
+    while (*p && n_tokens < max_tokens) {
+        while (*p == ' ' || *p == '\t')
+            p++;
+        if (!*p)
+            break;
+        tokens[n_tokens++] = p;
+        if (n_tokens == max_tokens)
+            break;
+        while (*p && *p != ' ' && *p != '\t')
+            p++;
+        if (*p)
+            *(p++) = '\0';
+        /* The command is the third field in @drop */
+        if (n_tokens == 1 && g_str_equal (tokens[0], "@drop"))
+            max_tokens = 3;
+    }
+
+    if (g_str_equal (tokens[0], "@latency") && n_tokens >= 3)
+        test_port_context_set_latency (self, tokens[3], atoi (tokens[1]), atoi (tokens[2]));
+    else if (g_str_equal (tokens[0], "@drop") && n_tokens == 3)
+        test_port_context_set_drop_probability (self, tokens[2], g_ascii_strtod (tokens[1], NULL));
+    else if (g_str_equal (tokens[0], "@chunk") && n_tokens == 3)
+        test_port_context_set_chunking (self, atoi (tokens[1]), atoi (tokens[2]));
+    else if (g_str_equal (tokens[0], "@seed") && n_tokens == 2)
+        test_port_context_set_seed (self, (guint32) g_ascii_strtoull (tokens[1], NULL, 10));
+    else if (g_str_equal (tokens[0], "@urc") && n_tokens == 4) {
+        const gchar *urcs[] = { tokens[3], NULL };
+
+        test_port_context_add_urc_stream (self, urcs, atoi (tokens[1]), atoi (tokens[2]));
+    } else
+        g_error ("Invalid directive in commands file: '%s'", line);
+
+    g_free (str);
 }
 
 void
@@ -71,7 +293,9 @@ test_port_context_load_commands (TestPortContext *self,
         }
 
         g_strstrip (current);
-        if (current[0] != '\0' && current[0] != '#') {
+        if (current[0] == '@')
+            load_directive (self, current);
+        else if (current[0] != '\0' && current[0] != '#') {
             gchar *response;
 
             response = current;
@@ -92,34 +316,54 @@ test_port_context_load_commands (TestPortContext *self,
     g_free (contents);
 }
 
-static const gchar *
-process_next_command (TestPortContext *ctx,
-                      GByteArray *buffer)
+static gchar *
+process_next_command (TestPortContext  *ctx,
+                      GByteArray       *buffer,
+                      CommandBehavior **behavior)
 {
     gsize i = 0;
     gchar *command;
-    const gchar *response;
+    gchar *response = NULL;
+    const gchar *static_response;
+    GList *l;
     static const gchar *error_response = "\r\nERROR\r\n";
 
-    /* Find command end */
-    while (i < buffer->len && buffer->data[i] != '\r' && buffer->data[i] != '\n')
+    /* Find command end; SMS data sent after a '>' prompt ends with Ctrl-Z */
+    while (i < buffer->len && buffer->data[i] != '\r' && buffer->data[i] != '\n' && buffer->data[i] != 0x1a)
         i++;
     if (i ==  buffer->len)
         /* no command */
         return NULL;
 
-    while (i < buffer->len && (buffer->data[i] == '\r' || buffer->data[i] == '\n'))
+    while (i < buffer->len && (buffer->data[i] == '\r' || buffer->data[i] == '\n' || buffer->data[i] == 0x1a))
         buffer->data[i++] = '\0';
 
-    /* Setup command and lookup response */
+    /* Setup command and lookup response; fixed responses are preferred over
+     * the ones built by the stateful handlers */
     command = g_strndup ((gchar *)buffer->data, i);
-    response = g_hash_table_lookup (ctx->commands, command);
+    static_response = ctx->commands ? g_hash_table_lookup (ctx->commands, command) : NULL;
+    if (static_response)
+        response = g_strdup (static_response);
+    else {
+        for (l = ctx->handlers; l; l = g_list_next (l)) {
+            CommandHandler *handler = l->data;
+
+            if (g_str_has_prefix (command, handler->prefix)) {
+                response = handler->callback (ctx, command, handler->user_data);
+                break;
+            }
+        }
+    }
+
+    *behavior = (ctx->behaviors ? g_hash_table_lookup (ctx->behaviors, command) : NULL);
+    if (!*behavior)
+        *behavior = &ctx->default_behavior;
     g_free (command);
 
     /* Remove command from buffer */
     g_byte_array_remove_range (buffer, 0, i);
 
-    return response ? response : error_response;
+    return response ? response : g_strdup (error_response);
 }
 
 /*****************************************************************************/
@@ -129,13 +373,36 @@ typedef struct {
     GSocketConnection *connection;
     GSource *connection_readable_source;
     GByteArray *buffer;
+    GQueue *output;
+    GSource *output_source;
 } Client;
 
+/* Chunk of data to write once the given delay has elapsed since the
+ * previous one was written */
+typedef struct {
+    GBytes *data;
+    guint   delay_ms;
+    /* Set in the last chunk of a reply, when the command was received */
+    gint64  command_time;
+} OutputItem;
+
+static void
+output_item_free (OutputItem *item)
+{
+    g_bytes_unref (item->data);
+    g_slice_free (OutputItem, item);
+}
+
 static void
 client_free (Client *client)
 {
     g_source_destroy (client->connection_readable_source);
     g_source_unref (client->connection_readable_source);
+    if (client->output_source) {
+        g_source_destroy (client->output_source);
+        g_source_unref (client->output_source);
+    }
+    g_queue_free_full (client->output, (GDestroyNotify)output_item_free);
     g_output_stream_close (g_io_stream_get_output_stream (G_IO_STREAM (client->connection)), NULL, NULL);
     if (client->buffer)
         g_byte_array_unref (client->buffer);
@@ -150,28 +417,122 @@ connection_close (Client *client)
     client_free (client);
 }
 
+static void client_schedule_output (Client *client);
+
+static gboolean
+client_output_cb (Client *client)
+{
+    OutputItem *item;
+    GError     *error = NULL;
+    gsize       len;
+    const gchar *data;
+
+    g_source_unref (client->output_source);
+    client->output_source = NULL;
+
+    item = g_queue_pop_head (client->output);
+    g_assert (item);
+
+    data = g_bytes_get_data (item->data, &len);
+    if (!g_output_stream_write_all (g_io_stream_get_output_stream (G_IO_STREAM (client->connection)),
+                                    data,
+                                    len,
+                                    NULL, /* bytes_written */
+                                    NULL, /* cancellable */
+                                    &error)) {
+        g_warning ("Cannot send response to client: %s", error->message);
+        g_error_free (error);
+    }
+
+    if (item->command_time) {
+        g_mutex_lock (&client->ctx->stats_mutex);
+        client->ctx->n_replies++;
+        client->ctx->reply_time_us += g_get_monotonic_time () - item->command_time;
+        g_mutex_unlock (&client->ctx->stats_mutex);
+    }
+
+    output_item_free (item);
+
+    client_schedule_output (client);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+client_schedule_output (Client *client)
+{
+    OutputItem *item;
+
+    if (client->output_source)
+        return;
+
+    item = g_queue_peek_head (client->output);
+    if (!item)
+        return;
+
+    client->output_source = g_timeout_source_new (item->delay_ms);
+    g_source_set_callback (client->output_source, (GSourceFunc)client_output_cb, client, NULL);
+    g_source_attach (client->output_source, client->ctx->context);
+}
+
+/* Queues the data to be written after the given delay, in chunks if
+ * requested. Everything is written in order, so a response is never
+ * interleaved with a URC. */
+static void
+client_queue_output (Client      *client,
+                     const gchar *data,
+                     guint        delay_ms,
+                     gint64       command_time)
+{
+    TestPortContext *ctx = client->ctx;
+    gsize            len;
+    gsize            offset = 0;
+
+    len = strlen (data);
+    while (offset < len) {
+        OutputItem *item;
+        gsize       item_len;
+
+        item_len = (ctx->chunk_size && ctx->chunk_size < (len - offset)) ? ctx->chunk_size : (len - offset);
+
+        item = g_slice_new0 (OutputItem);
+        item->data = g_bytes_new (data + offset, item_len);
+        item->delay_ms = (offset == 0 ? delay_ms : ctx->chunk_delay_ms);
+        g_queue_push_tail (client->output, item);
+
+        offset += item_len;
+        if (offset == len)
+            item->command_time = command_time;
+    }
+
+    client_schedule_output (client);
+}
+
 static void
 client_parse_request (Client *client)
 {
-    const gchar *response;
-
-    do {
-        response = process_next_command (client->ctx, client->buffer);
-        if (response) {
-            GError *error = NULL;
-
-            if (!g_output_stream_write_all (g_io_stream_get_output_stream (G_IO_STREAM (client->connection)),
-                                            response,
-                                            strlen (response),
-                                            NULL, /* bytes_written */
-                                            NULL, /* cancellable */
-                                            &error)) {
-                g_warning ("Cannot send response to client: %s", error->message);
-                g_error_free (error);
-            }
+    TestPortContext *ctx = client->ctx;
+    gchar           *response;
+    CommandBehavior *behavior = NULL;
+    gint64           command_time;
+
+    command_time = g_get_monotonic_time ();
+    while ((response = process_next_command (ctx, client->buffer, &behavior)) != NULL) {
+        guint latency;
+
+        if (behavior->drop_probability > 0.0 &&
+            g_rand_double (ctx->rand) < behavior->drop_probability) {
+            g_debug ("dropping response");
+            g_free (response);
+            continue;
         }
 
-    } while (response);
+        latency = behavior->latency_min_ms;
+        if (behavior->latency_max_ms > behavior->latency_min_ms)
+            latency = g_rand_int_range (ctx->rand, behavior->latency_min_ms, behavior->latency_max_ms + 1);
+
+        client_queue_output (client, response, latency, command_time);
+        g_free (response);
+    }
 }
 
 static gboolean
@@ -230,6 +591,7 @@ client_new (TestPortContext *self,
     client = g_slice_new0 (Client);
     client->ctx = self;
     client->connection = g_object_ref (connection);
+    client->output = g_queue_new ();
     client->connection_readable_source = g_socket_create_source (g_socket_connection_get_socket (client->connection),
                                                                  G_IO_IN | G_IO_PRI | G_IO_ERR | G_IO_HUP,
                                                                  NULL);
@@ -242,7 +604,99 @@ client_new (TestPortContext *self,
     return client;
 }
 
-/* /\*****************************************************************************\/ */
+/*****************************************************************************/
+/* Reply statistics */
+
+void
+test_port_context_get_stats (TestPortContext *self,
+                             guint           *n_replies,
+                             guint64         *reply_time_us)
+{
+    g_mutex_lock (&self->stats_mutex);
+    if (n_replies)
+        *n_replies = self->n_replies;
+    if (reply_time_us)
+        *reply_time_us = self->reply_time_us;
+    g_mutex_unlock (&self->stats_mutex);
+}
+
+/*****************************************************************************/
+/* URC injection */
+
+static void
+broadcast_urc (TestPortContext *self,
+               const gchar     *urc)
+{
+    GList *l;
+
+    for (l = self->clients; l; l = g_list_next (l))
+        client_queue_output ((Client *)l->data, urc, 0, 0);
+}
+
+static gboolean
+urc_stream_cb (UrcStream *stream)
+{
+    /* Only consume the stream once there is someone listening */
+    if (!stream->ctx->clients)
+        return G_SOURCE_CONTINUE;
+
+    broadcast_urc (stream->ctx, stream->urcs[stream->sent % stream->n_urcs]);
+    stream->sent++;
+
+    if (stream->count && stream->sent >= stream->count) {
+        g_source_unref (stream->source);
+        stream->source = NULL;
+        return G_SOURCE_REMOVE;
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+start_urc_streams (TestPortContext *self)
+{
+    GList *l;
+
+    for (l = self->urc_streams; l; l = g_list_next (l)) {
+        UrcStream *stream = l->data;
+
+        g_assert (!stream->source);
+        stream->source = g_timeout_source_new (stream->interval_ms);
+        g_source_set_callback (stream->source, (GSourceFunc)urc_stream_cb, stream, NULL);
+        g_source_attach (stream->source, self->context);
+    }
+}
+
+typedef struct {
+    TestPortContext *self;
+    gchar           *urc;
+} SendUrcContext;
+
+static gboolean
+send_urc_cb (SendUrcContext *ctx)
+{
+    broadcast_urc (ctx->self, ctx->urc);
+    g_free (ctx->urc);
+    g_slice_free (SendUrcContext, ctx);
+    return G_SOURCE_REMOVE;
+}
+
+void
+test_port_context_send_urc (TestPortContext *self,
+                            const gchar     *urc)
+{
+    SendUrcContext *ctx;
+
+    g_assert (self->context != NULL);
+
+    /* May be called from any thread, the URC is sent from the port
+     * context thread */
+    ctx = g_slice_new0 (SendUrcContext);
+    ctx->self = self;
+    ctx->urc = g_strcompress (urc);
+    g_main_context_invoke (self->context, (GSourceFunc)send_urc_cb, ctx);
+}
+
+/*****************************************************************************/
 
 static void
 incoming_cb (GSocketService *service,
@@ -351,6 +805,7 @@ port_context_thread_func (TestPortContext *self)
 
     /* Once the thread default context is setup, launch service */
     create_socket_service (self);
+    start_urc_streams (self);
 
     g_main_loop_run (self->loop);
 
@@ -387,10 +842,16 @@ test_port_context_free (TestPortContext *self)
 
     g_cond_clear (&self->ready_cond);
     g_mutex_clear (&self->ready_mutex);
+    g_mutex_clear (&self->stats_mutex);
 
     if (self->commands)
         g_hash_table_unref (self->commands);
+    if (self->behaviors)
+        g_hash_table_unref (self->behaviors);
+    g_list_free_full (self->handlers, (GDestroyNotify)command_handler_free);
+    g_list_free_full (self->urc_streams, (GDestroyNotify)urc_stream_free);
     g_list_free_full (self->clients, (GDestroyNotify)client_free);
+    g_rand_free (self->rand);
     if (self->socket) {
         GError *error = NULL;
 
@@ -416,7 +877,10 @@ test_port_context_new (const gchar *name)
 
     self = g_slice_new0 (TestPortContext);
     self->name = g_strdup (name);
+    /* Fixed seed by default, so that runs are reproducible */
+    self->rand = g_rand_new_with_seed (0);
     g_cond_init (&self->ready_cond);
     g_mutex_init (&self->ready_mutex);
+    g_mutex_init (&self->stats_mutex);
     return self;
 }
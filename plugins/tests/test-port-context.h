@@ -32,4 +32,46 @@ void             test_port_context_set_command   (TestPortContext *self,
 void             test_port_context_load_commands (TestPortContext *self,
                                                   const gchar *commands_file);
 
+/* Stateful replies: the callback is run in the port context thread for every
+ * command starting with the given prefix which doesn't have a fixed response,
+ * and must return a newly allocated response (or NULL to reply ERROR). */
+typedef gchar * (* TestPortContextCommandFn) (TestPortContext *self,
+                                              const gchar     *command,
+                                              gpointer         user_data);
+void             test_port_context_set_command_handler (TestPortContext          *self,
+                                                        const gchar              *prefix,
+                                                        TestPortContextCommandFn  callback,
+                                                        gpointer                  user_data,
+                                                        GDestroyNotify            user_data_free);
+
+/* Timing and fault injection; a NULL command updates the defaults used by
+ * commands without explicit setup. Must be configured before start(). */
+void             test_port_context_set_latency          (TestPortContext *self,
+                                                         const gchar     *command,
+                                                         guint            min_ms,
+                                                         guint            max_ms);
+void             test_port_context_set_drop_probability (TestPortContext *self,
+                                                         const gchar     *command,
+                                                         gdouble          probability);
+void             test_port_context_set_chunking         (TestPortContext *self,
+                                                         guint            chunk_size,
+                                                         guint            chunk_delay_ms);
+void             test_port_context_set_seed             (TestPortContext *self,
+                                                         guint32          seed);
+
+/* URC injection; streams cycle over the given URCs every interval until
+ * count URCs are sent (0 for no limit). send_urc() is thread-safe. */
+void             test_port_context_add_urc_stream (TestPortContext    *self,
+                                                   const gchar *const *urcs,
+                                                   guint               interval_ms,
+                                                   guint               count);
+void             test_port_context_send_urc       (TestPortContext    *self,
+                                                   const gchar        *urc);
+
+/* Number of replies sent and accumulated time between receiving each command
+ * and writing the last byte of its reply. Thread-safe. */
+void             test_port_context_get_stats (TestPortContext *self,
+                                              guint           *n_replies,
+                                              guint64         *reply_time_us);
+
 #endif /* TEST_PORT_CONTEXT_H */
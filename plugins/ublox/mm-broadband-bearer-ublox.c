@@ -27,6 +27,7 @@
 #include <libmm-glib.h>
 
 #include "mm-broadband-bearer-ublox.h"
+#include "mm-broadband-modem-ublox.h"
 #include "mm-base-modem-at.h"
 #include "mm-log.h"
 #include "mm-ublox-enums-types.h"
@@ -50,6 +51,10 @@ struct _MMBroadbandBearerUbloxPrivate {
     MMUbloxBearerAllowedAuth allowed_auths;
     FeatureSupport           statistics;
     FeatureSupport           cedata;
+    /* Last loaded session counters, to compute rates */
+    guint64                  stats_tx_bytes;
+    guint64                  stats_rx_bytes;
+    gint64                   stats_time;
 };
 
 /*****************************************************************************/
@@ -700,6 +705,9 @@ disconnect_3gpp  (MMBroadbandBearer   *self,
                                           user_data)))
         return;
 
+    /* Next connection starts counting from scratch */
+    MM_BROADBAND_BEARER_UBLOX (self)->priv->stats_time = 0;
+
     cmd = g_strdup_printf ("+CGACT=0,%u", cid);
     mm_dbg ("deactivating PDP context #%u...", cid);
     mm_base_modem_at_command (MM_BASE_MODEM (modem),
@@ -741,40 +749,62 @@ reload_stats_finish (MMBaseBearer  *self,
 }
 
 static void
-ugcntrd_ready (MMBaseModem  *modem,
-               GAsyncResult *res,
-               GTask        *task)
+pdp_context_counters_ready (MMBroadbandModemUblox *modem,
+                            GAsyncResult          *res,
+                            GTask                 *task)
 {
-    MMBroadbandBearerUblox *self;
-    const gchar            *response;
-    GError                 *error = NULL;
-    guint64                 tx_bytes = 0;
-    guint64                 rx_bytes = 0;
-    guint                   cid;
+    MMBroadbandBearerUblox          *self;
+    GArray                          *counters;
+    const MMUbloxPdpContextCounters *item;
+    GError                          *error = NULL;
+    StatsResult                     *result;
+    gint64                           sample_time = 0;
+    guint                            cid;
 
     self = MM_BROADBAND_BEARER_UBLOX (g_task_get_source_object (task));
 
     cid = mm_broadband_bearer_get_3gpp_cid (MM_BROADBAND_BEARER (self));
 
-    response = mm_base_modem_at_command_finish (modem, res, &error);
-    if (response)
-        mm_ublox_parse_ugcntrd_response_for_cid (response,
-                                                 cid,
-                                                 &tx_bytes, &rx_bytes,
-                                                 NULL, NULL,
-                                                 &error);
-
-    if (error) {
+    counters = mm_broadband_modem_ublox_load_pdp_context_counters_finish (modem, res, &sample_time, &error);
+    if (!counters) {
         g_prefix_error (&error, "Couldn't load PDP context %u statistics: ", cid);
         g_task_return_error (task, error);
-    } else {
-        StatsResult *result;
+        g_object_unref (task);
+        return;
+    }
 
-        result = g_new (StatsResult, 1);
-        result->bytes_rx = rx_bytes;
-        result->bytes_tx = tx_bytes;
-        g_task_return_pointer (task, result, g_free);
+    item = mm_ublox_pdp_context_counters_lookup (counters, cid);
+    if (!item) {
+        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                                 "Couldn't load PDP context %u statistics: no statistics found", cid);
+        g_array_unref (counters);
+        g_object_unref (task);
+        return;
     }
+
+    /* Rates are computed using the time in which the counters were read, as
+     * these may have been reused from a recent query by another bearer; an
+     * already seen sample doesn't give any new information */
+    if (self->priv->stats_time && sample_time > self->priv->stats_time) {
+        gdouble elapsed;
+        guint64 tx_delta;
+        guint64 rx_delta;
+
+        elapsed  = (gdouble) (sample_time - self->priv->stats_time) / G_USEC_PER_SEC;
+        tx_delta = mm_ublox_counter_delta (self->priv->stats_tx_bytes, item->session_tx_bytes);
+        rx_delta = mm_ublox_counter_delta (self->priv->stats_rx_bytes, item->session_rx_bytes);
+        mm_dbg ("PDP context %u: %" G_GUINT64_FORMAT " bytes sent (%.0lf B/s), %" G_GUINT64_FORMAT " bytes received (%.0lf B/s) in the last %.1lfs",
+                cid, tx_delta, tx_delta / elapsed, rx_delta, rx_delta / elapsed, elapsed);
+    }
+    self->priv->stats_tx_bytes = item->session_tx_bytes;
+    self->priv->stats_rx_bytes = item->session_rx_bytes;
+    self->priv->stats_time     = sample_time;
+
+    result = g_new (StatsResult, 1);
+    result->bytes_rx = item->session_rx_bytes;
+    result->bytes_tx = item->session_tx_bytes;
+    g_task_return_pointer (task, result, g_free);
+    g_array_unref (counters);
     g_object_unref (task);
 }
 
@@ -797,12 +827,9 @@ run_reload_stats (MMBroadbandBearerUblox *self,
         g_object_get (MM_BASE_BEARER (self),
                       MM_BASE_BEARER_MODEM, &modem,
                       NULL);
-        mm_base_modem_at_command (MM_BASE_MODEM (modem),
-                                  "+UGCNTRD",
-                                  3,
-                                  FALSE,
-                                  (GAsyncReadyCallback) ugcntrd_ready,
-                                  task);
+        mm_broadband_modem_ublox_load_pdp_context_counters (MM_BROADBAND_MODEM_UBLOX (modem),
+                                                            (GAsyncReadyCallback) pdp_context_counters_ready,
+                                                            task);
         g_object_unref (modem);
         return;
     }
@@ -69,6 +69,11 @@ struct _MMBroadbandModemUbloxPrivate {
 
     /* Regex to ignore */
     GRegex *pbready_regex;
+
+    /* Last +UGCNTRD counters, shared by all bearers */
+    GArray *pdp_counters;
+    gint64  pdp_counters_time;
+    GList  *pdp_counters_pending;
 };
 
 /*****************************************************************************/
@@ -1364,6 +1369,113 @@ setup_ports (MMBroadbandModem *_self)
     }
 }
 
+/*****************************************************************************/
+/* PDP context counters (shared by all bearers) */
+
+/* Counters younger than this are reused instead of running a new query, so
+ * that bearers reloading stats at about the same time share one +UGCNTRD */
+#define PDP_COUNTERS_MAX_AGE_MS 1000
+
+GArray *
+mm_broadband_modem_ublox_load_pdp_context_counters_finish (MMBroadbandModemUblox  *self,
+                                                           GAsyncResult           *res,
+                                                           gint64                 *sample_time,
+                                                           GError                **error)
+{
+    GArray *counters;
+
+    counters = g_task_propagate_pointer (G_TASK (res), error);
+    if (counters && sample_time)
+        *sample_time = *((gint64 *) g_task_get_task_data (G_TASK (res)));
+    return counters;
+}
+
+static void
+pdp_context_counters_task_return (MMBroadbandModemUblox *self,
+                                  GTask                 *task)
+{
+    gint64 *sample_time;
+
+    /* The counters may be reused, so give the time they were read as well */
+    sample_time = g_new (gint64, 1);
+    *sample_time = self->priv->pdp_counters_time;
+    g_task_set_task_data (task, sample_time, g_free);
+    g_task_return_pointer (task, g_array_ref (self->priv->pdp_counters), (GDestroyNotify) g_array_unref);
+    g_object_unref (task);
+}
+
+static void
+ugcntrd_ready (MMBaseModem  *_self,
+               GAsyncResult *res)
+{
+    MMBroadbandModemUblox *self = MM_BROADBAND_MODEM_UBLOX (_self);
+    const gchar           *response;
+    GError                *error = NULL;
+    GArray                *counters = NULL;
+    GList                 *pending;
+    GList                 *l;
+
+    response = mm_base_modem_at_command_finish (_self, res, &error);
+    if (response)
+        counters = mm_ublox_parse_ugcntrd_response (response, &error);
+
+    if (counters) {
+        if (self->priv->pdp_counters)
+            g_array_unref (self->priv->pdp_counters);
+        self->priv->pdp_counters = g_array_ref (counters);
+        self->priv->pdp_counters_time = g_get_monotonic_time ();
+    }
+
+    /* Complete everyone waiting for this query */
+    pending = self->priv->pdp_counters_pending;
+    self->priv->pdp_counters_pending = NULL;
+    for (l = pending; l; l = g_list_next (l)) {
+        GTask *task = G_TASK (l->data);
+
+        if (counters)
+            pdp_context_counters_task_return (self, task);
+        else {
+            g_task_return_error (task, g_error_copy (error));
+            g_object_unref (task);
+        }
+    }
+    g_list_free (pending);
+
+    if (counters)
+        g_array_unref (counters);
+    g_clear_error (&error);
+}
+
+void
+mm_broadband_modem_ublox_load_pdp_context_counters (MMBroadbandModemUblox *self,
+                                                    GAsyncReadyCallback    callback,
+                                                    gpointer               user_data)
+{
+    GTask    *task;
+    gboolean  running;
+
+    task = g_task_new (self, NULL, callback, user_data);
+
+    if (self->priv->pdp_counters &&
+        (g_get_monotonic_time () - self->priv->pdp_counters_time) < (PDP_COUNTERS_MAX_AGE_MS * 1000)) {
+        pdp_context_counters_task_return (self, task);
+        return;
+    }
+
+    /* If a query is already running, just wait for its reply */
+    running = !!self->priv->pdp_counters_pending;
+    self->priv->pdp_counters_pending = g_list_append (self->priv->pdp_counters_pending, task);
+    if (running)
+        return;
+
+    mm_base_modem_at_command (MM_BASE_MODEM (self),
+                              "+UGCNTRD",
+                              3,
+                              FALSE,
+                              (GAsyncReadyCallback) ugcntrd_ready,
+                              NULL);
+}
+
 /*****************************************************************************/
 
 MMBroadbandModemUblox *
@@ -1459,6 +1571,9 @@ finalize (GObject *object)
     MMBroadbandModemUblox *self = MM_BROADBAND_MODEM_UBLOX (object);
 
     g_regex_unref (self->priv->pbready_regex);
+    g_assert (!self->priv->pdp_counters_pending);
+    if (self->priv->pdp_counters)
+        g_array_unref (self->priv->pdp_counters);
 
     g_free (self->priv->operator_id);
 
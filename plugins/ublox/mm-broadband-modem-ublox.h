@@ -46,4 +46,16 @@ MMBroadbandModemUblox *mm_broadband_modem_ublox_new (const gchar *device,
                                                      guint16 vendor_id,
                                                      guint16 product_id);
 
+/* +UGCNTRD counters for all active PDP contexts, as an array of
+ * MMUbloxPdpContextCounters; one query is shared by all callers, and recent
+ * counters may be reused, so the monotonic time in which they were read is
+ * also given */
+void    mm_broadband_modem_ublox_load_pdp_context_counters        (MMBroadbandModemUblox  *self,
+                                                                   GAsyncReadyCallback     callback,
+                                                                   gpointer                user_data);
+GArray *mm_broadband_modem_ublox_load_pdp_context_counters_finish (MMBroadbandModemUblox  *self,
+                                                                   GAsyncResult           *res,
+                                                                   gint64                 *sample_time,
+                                                                   GError                **error);
+
 #endif /* MM_BROADBAND_MODEM_UBLOX_H */
@@ -1955,94 +1955,133 @@ out:
 /*****************************************************************************/
 /* +UGCNTRD response parser */
 
-gboolean
-mm_ublox_parse_ugcntrd_response_for_cid (const gchar  *response,
-                                         guint         in_cid,
-                                         guint64      *out_session_tx_bytes,
-                                         guint64      *out_session_rx_bytes,
-                                         guint64      *out_total_tx_bytes,
-                                         guint64      *out_total_rx_bytes,
-                                         GError      **error)
+/* The regex is built only once and reused in every stats reload */
+static GRegex *
+ugcntrd_regex_get (void)
+{
+    static gsize regex = 0;
+
+    if (g_once_init_enter (&regex)) {
+        GRegex *r;
+
+        r = g_regex_new ("\\+UGCNTRD:\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+)",
+                         G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+        g_assert (r != NULL);
+        g_once_init_leave (&regex, (gsize) r);
+    }
+
+    return (GRegex *) regex;
+}
+
+GArray *
+mm_ublox_parse_ugcntrd_response (const gchar  *response,
+                                 GError      **error)
 {
-    GRegex     *r;
     GMatchInfo *match_info = NULL;
     GError     *inner_error = NULL;
-    guint64     session_tx_bytes = 0;
-    guint64     session_rx_bytes = 0;
-    guint64     total_tx_bytes   = 0;
-    guint64     total_rx_bytes   = 0;
-    gboolean    matched = FALSE;
+    GArray     *counters;
 
     /* Response may be e.g.:
+     *  +UGCNTRD: 1, 100, 0, 100, 0
      *  +UGCNTRD: 31,2704,1819,2724,1839
-     * We assume only ONE line is returned.
+     * One line per active PDP context.
      */
-    r = g_regex_new ("\\+UGCNTRD:\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+)",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, NULL);
-    g_assert (r != NULL);
+    counters = g_array_new (FALSE, FALSE, sizeof (MMUbloxPdpContextCounters));
 
-    /* Report invalid CID given */
-    if (!in_cid) {
-        inner_error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_FAILED, "Invalid CID given");
-        goto out;
-    }
-
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+    g_regex_match_full (ugcntrd_regex_get (), response, strlen (response), 0, 0, &match_info, &inner_error);
     while (!inner_error && g_match_info_matches (match_info)) {
-        guint cid = 0;
-
-        /* Matched CID? */
-        if (!mm_get_uint_from_match_info (match_info, 1, &cid) || cid != in_cid) {
-            g_match_info_next (match_info, &inner_error);
-            continue;
-        }
+        MMUbloxPdpContextCounters item;
 
-        if (out_session_tx_bytes && !mm_get_u64_from_match_info (match_info, 2, &session_tx_bytes)) {
-            inner_error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_FAILED, "Error parsing session TX bytes");
-            goto out;
+        if (!mm_get_uint_from_match_info (match_info, 1, &item.cid)) {
+            inner_error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_FAILED, "Error parsing CID");
+            break;
         }
 
-        if (out_session_rx_bytes && !mm_get_u64_from_match_info (match_info, 3, &session_rx_bytes)) {
-            inner_error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_FAILED, "Error parsing session RX bytes");
-            goto out;
+        if (!mm_get_u64_from_match_info (match_info, 2, &item.session_tx_bytes) ||
+            !mm_get_u64_from_match_info (match_info, 3, &item.session_rx_bytes) ||
+            !mm_get_u64_from_match_info (match_info, 4, &item.total_tx_bytes) ||
+            !mm_get_u64_from_match_info (match_info, 5, &item.total_rx_bytes)) {
+            inner_error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                                       "Error parsing CID %u statistics", item.cid);
+            break;
         }
 
-        if (out_total_tx_bytes && !mm_get_u64_from_match_info (match_info, 4, &total_tx_bytes)) {
-            inner_error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_FAILED, "Error parsing total TX bytes");
-            goto out;
-        }
+        g_array_append_val (counters, item);
+        g_match_info_next (match_info, &inner_error);
+    }
 
-        if (out_total_rx_bytes && !mm_get_u64_from_match_info (match_info, 5, &total_rx_bytes)) {
-            inner_error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_FAILED, "Error parsing total RX bytes");
-            goto out;
-        }
+    g_match_info_free (match_info);
 
-        matched = TRUE;
-        break;
+    if (inner_error) {
+        g_propagate_error (error, inner_error);
+        g_array_unref (counters);
+        return NULL;
     }
 
-    if (!matched) {
-        inner_error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_FAILED, "No statistics found for CID %u", in_cid);
-        goto out;
+    return counters;
+}
+
+const MMUbloxPdpContextCounters *
+mm_ublox_pdp_context_counters_lookup (GArray *counters,
+                                      guint   cid)
+{
+    guint i;
+
+    for (i = 0; i < counters->len; i++) {
+        const MMUbloxPdpContextCounters *item;
+
+        item = &g_array_index (counters, MMUbloxPdpContextCounters, i);
+        if (item->cid == cid)
+            return item;
     }
+    return NULL;
+}
 
-out:
+guint64
+mm_ublox_counter_delta (guint64 previous,
+                        guint64 current)
+{
+    /* Session counters restart from zero on a new connection */
+    return (current >= previous ? current - previous : current);
+}
 
-    g_match_info_free (match_info);
-    g_regex_unref (r);
+gboolean
+mm_ublox_parse_ugcntrd_response_for_cid (const gchar  *response,
+                                         guint         in_cid,
+                                         guint64      *out_session_tx_bytes,
+                                         guint64      *out_session_rx_bytes,
+                                         guint64      *out_total_tx_bytes,
+                                         guint64      *out_total_rx_bytes,
+                                         GError      **error)
+{
+    GArray                          *counters;
+    const MMUbloxPdpContextCounters *item;
 
-    if (inner_error) {
-        g_propagate_error (error, inner_error);
+    /* Report invalid CID given */
+    if (!in_cid) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED, "Invalid CID given");
+        return FALSE;
+    }
+
+    counters = mm_ublox_parse_ugcntrd_response (response, error);
+    if (!counters)
+        return FALSE;
+
+    item = mm_ublox_pdp_context_counters_lookup (counters, in_cid);
+    if (!item) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED, "No statistics found for CID %u", in_cid);
+        g_array_unref (counters);
         return FALSE;
     }
 
     if (out_session_tx_bytes)
-        *out_session_tx_bytes = session_tx_bytes;
+        *out_session_tx_bytes = item->session_tx_bytes;
     if (out_session_rx_bytes)
-        *out_session_rx_bytes = session_rx_bytes;
+        *out_session_rx_bytes = item->session_rx_bytes;
     if (out_total_tx_bytes)
-        *out_total_tx_bytes = total_tx_bytes;
+        *out_total_tx_bytes = item->total_tx_bytes;
     if (out_total_rx_bytes)
-        *out_total_rx_bytes = total_rx_bytes;
+        *out_total_rx_bytes = item->total_rx_bytes;
+    g_array_unref (counters);
     return TRUE;
 }
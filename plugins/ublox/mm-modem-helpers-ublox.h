@@ -195,6 +195,24 @@ MMUbloxBearerAllowedAuth mm_ublox_parse_uauthreq_test (const char  *response,
 /*****************************************************************************/
 /* +UGCNTRD response parser */
 
+typedef struct {
+    guint   cid;
+    guint64 session_tx_bytes;
+    guint64 session_rx_bytes;
+    guint64 total_tx_bytes;
+    guint64 total_rx_bytes;
+} MMUbloxPdpContextCounters;
+
+/* Returns an array of MMUbloxPdpContextCounters, one per reported context */
+GArray *mm_ublox_parse_ugcntrd_response (const gchar  *response,
+                                         GError      **error);
+
+const MMUbloxPdpContextCounters *mm_ublox_pdp_context_counters_lookup (GArray *counters,
+                                                                       guint   cid);
+
+guint64 mm_ublox_counter_delta (guint64 previous,
+                                guint64 current);
+
 gboolean mm_ublox_parse_ugcntrd_response_for_cid (const gchar  *response,
                                                   guint         in_cid,
                                                   guint64      *session_tx_bytes,
@@ -989,6 +989,49 @@ test_ugcntrd_response (void)
     }
 }
 
+static void
+test_ugcntrd_response_all (void)
+{
+    GError                          *error = NULL;
+    GArray                          *counters;
+    const MMUbloxPdpContextCounters *item;
+
+    counters = mm_ublox_parse_ugcntrd_response ("+UGCNTRD: 1, 100, 0, 100, 0\r\n"
+                                                "+UGCNTRD: 31,2704,1819,2724,1839\r\n",
+                                                &error);
+    g_assert_no_error (error);
+    g_assert (counters);
+    g_assert_cmpuint (counters->len, ==, 2);
+
+    item = mm_ublox_pdp_context_counters_lookup (counters, 31);
+    g_assert (item);
+    g_assert_cmpuint (item->session_tx_bytes, ==, 2704);
+    g_assert_cmpuint (item->session_rx_bytes, ==, 1819);
+
+    item = mm_ublox_pdp_context_counters_lookup (counters, 1);
+    g_assert (item);
+    g_assert_cmpuint (item->total_tx_bytes, ==, 100);
+
+    g_assert (!mm_ublox_pdp_context_counters_lookup (counters, 2));
+    g_array_unref (counters);
+
+    /* No active contexts */
+    counters = mm_ublox_parse_ugcntrd_response ("", &error);
+    g_assert_no_error (error);
+    g_assert (counters);
+    g_assert_cmpuint (counters->len, ==, 0);
+    g_array_unref (counters);
+}
+
+static void
+test_counter_delta (void)
+{
+    g_assert_cmpuint (mm_ublox_counter_delta (100, 150), ==, 50);
+    g_assert_cmpuint (mm_ublox_counter_delta (150, 150), ==, 0);
+    /* Counters reset */
+    g_assert_cmpuint (mm_ublox_counter_delta (150, 20), ==, 20);
+}
+
 /*****************************************************************************/
 
 void
@@ -1053,6 +1096,8 @@ int main (int argc, char **argv)
     g_test_add_func ("/MM/ublox/uauthreq/test/with-auto", test_uauthreq_with_auto);
     g_test_add_func ("/MM/ublox/uauthreq/test/less-fields", test_uauthreq_less_fields);
     g_test_add_func ("/MM/ublox/ugcntrd/response", test_ugcntrd_response);
+    g_test_add_func ("/MM/ublox/ugcntrd/response/all", test_ugcntrd_response_all);
+    g_test_add_func ("/MM/ublox/ugcntrd/counter-delta", test_counter_delta);
 
     return g_test_run ();
 }
@@ -1007,3 +1007,45 @@ out:
 
     return TRUE;
 }
+
+/*****************************************************************************/
+/* NMEA fix detection */
+
+static const gchar *
+nmea_trace_field (const gchar *trace,
+                  guint        index)
+{
+    const gchar *p = trace;
+
+    while (index--) {
+        p = strchr (p, ',');
+        if (!p)
+            return NULL;
+        p++;
+    }
+    return p;
+}
+
+gboolean
+mm_xmm_nmea_trace_has_fix (const gchar *trace)
+{
+    const gchar *field;
+
+    /* Talker ID may be GP, GL, GN... */
+    if (!trace || trace[0] != '$' || strlen (trace) < 6)
+        return FALSE;
+
+    /* $xxGGA,<time>,<lat>,<N/S>,<lon>,<E/W>,<quality>,... */
+    if (g_str_has_prefix (trace + 3, "GGA,")) {
+        field = nmea_trace_field (trace, 6);
+        return (field && g_ascii_isdigit (field[0]) && field[0] != '0');
+    }
+
+    /* $xxRMC,<time>,<status>,... */
+    if (g_str_has_prefix (trace + 3, "RMC,")) {
+        field = nmea_trace_field (trace, 2);
+        return (field && field[0] == 'A');
+    }
+
+    return FALSE;
+}
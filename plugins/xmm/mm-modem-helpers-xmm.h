@@ -70,4 +70,7 @@ gboolean mm_xmm_parse_xlcsslp_query_response (const gchar  *response,
                                               gchar       **supl_address,
                                               GError      **error);
 
+/* Whether the GGA or RMC trace reports a valid position fix */
+gboolean mm_xmm_nmea_trace_has_fix (const gchar *trace);
+
 #endif  /* MM_MODEM_HELPERS_XMM_H */
@@ -58,6 +58,7 @@ typedef struct {
     MMModemLocationSource  supported_sources;
     MMModemLocationSource  enabled_sources;
     GpsEngineState         gps_engine_state;
+    gint64                 gps_engine_start_time;
     MMPortSerialAt        *gps_port;
     GRegex                *xlsrstop_regex;
     GRegex                *nmea_regex;
@@ -942,13 +943,28 @@ mm_shared_xmm_location_load_capabilities (MMIfaceModemLocation *self,
 /*****************************************************************************/
 /* GPS engine state selection */
 
+static const gchar *gps_engine_state_str[] = {
+    [GPS_ENGINE_STATE_OFF]        = "off",
+    [GPS_ENGINE_STATE_STANDALONE] = "standalone",
+    [GPS_ENGINE_STATE_AGPS_MSA]   = "a-gps msa",
+    [GPS_ENGINE_STATE_AGPS_MSB]   = "a-gps msb",
+};
+
+static gdouble
+gps_engine_elapsed (Private *priv)
+{
+    return (gdouble) (g_get_monotonic_time () - priv->gps_engine_start_time) / G_USEC_PER_SEC;
+}
+
 static void
 nmea_received (MMPortSerialAt *port,
                GMatchInfo     *info,
                MMSharedXmm    *self)
 {
-    gchar *trace;
+    Private *priv;
+    gchar   *trace;
 
+    priv = get_private (self);
     trace = g_match_info_fetch (info, 1);
 
     /* Helper to debug GPS location related issues. Don't depend on a real GPS
@@ -991,6 +1007,13 @@ nmea_received (MMPortSerialAt *port,
     }
 #endif
 
+    /* Time to first fix since the engine was started */
+    if (G_UNLIKELY (priv->gps_engine_start_time) && mm_xmm_nmea_trace_has_fix (trace)) {
+        mm_dbg ("GPS fix acquired %.1lfs after engine start (%s)",
+                gps_engine_elapsed (priv), gps_engine_state_str[priv->gps_engine_state]);
+        priv->gps_engine_start_time = 0;
+    }
+
     mm_iface_modem_location_gps_update (MM_IFACE_MODEM_LOCATION (self), trace);
     g_free (trace);
 }
@@ -1032,6 +1055,7 @@ xlcslsr_ready (MMBaseModem  *self,
                                                    self,
                                                    NULL);
     priv->gps_engine_state = state;
+    priv->gps_engine_start_time = g_get_monotonic_time ();
 
     g_task_return_boolean (task, TRUE);
     g_object_unref (task);
@@ -1129,6 +1153,11 @@ xlsrstop_ready (MMBaseModem  *self,
     g_assert (priv->gps_port);
     mm_port_serial_at_add_unsolicited_msg_handler (priv->gps_port, priv->nmea_regex, NULL, NULL, NULL);
     g_clear_object (&priv->gps_port);
+    if (priv->gps_engine_start_time) {
+        mm_dbg ("GPS engine stopped without fix %.1lfs after start (%s)",
+                gps_engine_elapsed (priv), gps_engine_state_str[priv->gps_engine_state]);
+        priv->gps_engine_start_time = 0;
+    }
     priv->gps_engine_state = GPS_ENGINE_STATE_OFF;
 
     /* If already reached requested state, we're done */
@@ -753,6 +753,33 @@ test_xlcsslp_queries (void)
 
 /*****************************************************************************/
 
+typedef struct {
+    const gchar *trace;
+    gboolean     has_fix;
+} NmeaFixTest;
+
+static const NmeaFixTest nmea_fix_tests[] = {
+    { "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47", TRUE  },
+    { "$GNGGA,123519,4807.038,N,01131.000,E,2,08,0.9,545.4,M,46.9,M,,*47", TRUE  },
+    { "$GPGGA,123519,,,,,0,00,,,M,,M,,*66",                                 FALSE },
+    { "$GPGGA,,,,,,,,,,,,,,*66",                                            FALSE },
+    { "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A", TRUE  },
+    { "$GNRMC,123519,V,,,,,,,230394,,,N*53",                                FALSE },
+    { "$GPGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,13,06,292,00*74", FALSE },
+    { "$GPGGA",                                                             FALSE },
+};
+
+static void
+test_nmea_trace_has_fix (void)
+{
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS (nmea_fix_tests); i++)
+        g_assert_cmpint (mm_xmm_nmea_trace_has_fix (nmea_fix_tests[i].trace), ==, nmea_fix_tests[i].has_fix);
+}
+
+/*****************************************************************************/
+
 void
 _mm_log (const char *loc,
          const char *func,
@@ -795,5 +822,7 @@ int main (int argc, char **argv)
 
     g_test_add_func ("/MM/xmm/xlcsslp/query", test_xlcsslp_queries);
 
+    g_test_add_func ("/MM/xmm/nmea/has-fix", test_nmea_trace_has_fix);
+
     return g_test_run ();
 }
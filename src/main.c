@@ -29,6 +29,7 @@
 #include "mm-base-manager.h"
 #include "mm-log.h"
 #include "mm-context.h"
+#include "mm-clock.h"
 
 #if defined WITH_SYSTEMD_SUSPEND_RESUME
 # include "mm-sleep-monitor.h"
@@ -151,6 +152,12 @@ main (int argc, char *argv[])
         exit (1);
     }
 
+    /* Timeouts must all be on the same clock, so setup before anything */
+    if (mm_context_get_test_virtual_clock ()) {
+        mm_info ("Running on a virtual clock");
+        mm_clock_enable_virtual ();
+    }
+
     g_unix_signal_add (SIGTERM, quit_cb, NULL);
     g_unix_signal_add (SIGINT, quit_cb, NULL);
 
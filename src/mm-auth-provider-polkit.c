@@ -26,8 +26,27 @@
 
 G_DEFINE_TYPE (MMAuthProviderPolkit, mm_auth_provider_polkit, MM_TYPE_AUTH_PROVIDER)
 
+/* Positive authorization results are cached for a short while, so that
+ * clients performing lots of privileged calls in a row (e.g. location or
+ * signal quality queries) don't require a PolicyKit round-trip every time. */
+#define AUTHORIZATION_CACHE_TIMEOUT_SECS 5
+
 struct _MMAuthProviderPolkitPrivate {
     PolkitAuthority *authority;
+    gulong authority_changed_id;
+
+    /* Cache of authorized (sender, action) pairs, with their expiration
+     * time in monotonic clock microseconds */
+    GHashTable *cache;
+    /* Bumped every time the cache is flushed, so that checks launched
+     * before the flush don't end up storing stale results */
+    guint cache_generation;
+    guint cache_hits;
+    guint cache_misses;
+
+    /* Bus connection where we listen for senders going away */
+    GDBusConnection *connection;
+    guint name_owner_changed_id;
 };
 
 /*****************************************************************************/
@@ -38,12 +57,145 @@ mm_auth_provider_polkit_new (void)
     return g_object_new (MM_TYPE_AUTH_PROVIDER_POLKIT, NULL);
 }
 
+/*****************************************************************************/
+/* Authorization cache */
+
+static gchar *
+cache_key_new (const gchar *sender,
+               const gchar *authorization)
+{
+    return g_strdup_printf ("%s|%s", sender, authorization);
+}
+
+static gboolean
+cache_lookup (MMAuthProviderPolkit *self,
+              const gchar          *sender,
+              const gchar          *authorization)
+{
+    gchar    *key;
+    gint64   *expiration;
+    gboolean  found = FALSE;
+
+    key = cache_key_new (sender, authorization);
+    expiration = g_hash_table_lookup (self->priv->cache, key);
+    if (expiration) {
+        if (*expiration > g_get_monotonic_time ())
+            found = TRUE;
+        else
+            g_hash_table_remove (self->priv->cache, key);
+    }
+    g_free (key);
+
+    if (found)
+        self->priv->cache_hits++;
+    else
+        self->priv->cache_misses++;
+
+    return found;
+}
+
+static void
+cache_add (MMAuthProviderPolkit *self,
+           const gchar          *sender,
+           const gchar          *authorization)
+{
+    gint64 *expiration;
+
+    expiration = g_new (gint64, 1);
+    *expiration = g_get_monotonic_time () + (AUTHORIZATION_CACHE_TIMEOUT_SECS * G_USEC_PER_SEC);
+    g_hash_table_replace (self->priv->cache, cache_key_new (sender, authorization), expiration);
+}
+
+static void
+cache_flush (MMAuthProviderPolkit *self)
+{
+    self->priv->cache_generation++;
+    if (g_hash_table_size (self->priv->cache) > 0) {
+        mm_dbg ("flushing PolicyKit authorization cache (%u hits, %u misses so far)",
+                self->priv->cache_hits, self->priv->cache_misses);
+        g_hash_table_remove_all (self->priv->cache);
+    }
+}
+
+static gboolean
+cache_remove_sender_cb (const gchar *key,
+                        gint64      *expiration,
+                        const gchar *prefix)
+{
+    return g_str_has_prefix (key, prefix);
+}
+
+static void
+cache_remove_sender (MMAuthProviderPolkit *self,
+                     const gchar          *sender)
+{
+    gchar *prefix;
+
+    /* Checks in flight for this sender must not be cached either */
+    self->priv->cache_generation++;
+
+    prefix = g_strdup_printf ("%s|", sender);
+    g_hash_table_foreach_remove (self->priv->cache, (GHRFunc)cache_remove_sender_cb, prefix);
+    g_free (prefix);
+}
+
+static void
+name_owner_changed (GDBusConnection      *connection,
+                    const gchar          *sender_name,
+                    const gchar          *object_path,
+                    const gchar          *interface_name,
+                    const gchar          *signal_name,
+                    GVariant             *parameters,
+                    MMAuthProviderPolkit *self)
+{
+    const gchar *name;
+    const gchar *old_owner;
+    const gchar *new_owner;
+
+    g_variant_get (parameters, "(&s&s&s)", &name, &old_owner, &new_owner);
+
+    /* We only care about unique names that just went away */
+    if (old_owner[0] != '\0' && new_owner[0] == '\0')
+        cache_remove_sender (self, old_owner);
+}
+
+static void
+authority_changed (PolkitAuthority      *authority,
+                   MMAuthProviderPolkit *self)
+{
+    /* Authorization rules may have changed, forget everything */
+    cache_flush (self);
+}
+
+static void
+setup_name_owner_changed (MMAuthProviderPolkit  *self,
+                          GDBusMethodInvocation *invocation)
+{
+    if (self->priv->connection)
+        return;
+
+    self->priv->connection = g_object_ref (g_dbus_method_invocation_get_connection (invocation));
+    self->priv->name_owner_changed_id =
+        g_dbus_connection_signal_subscribe (self->priv->connection,
+                                            "org.freedesktop.DBus",
+                                            "org.freedesktop.DBus",
+                                            "NameOwnerChanged",
+                                            "/org/freedesktop/DBus",
+                                            NULL,
+                                            G_DBUS_SIGNAL_FLAGS_NONE,
+                                            (GDBusSignalCallback)name_owner_changed,
+                                            self,
+                                            NULL);
+}
+
 /*****************************************************************************/
 
 typedef struct {
     PolkitSubject *subject;
+    gchar *sender;
     gchar *authorization;
     GDBusMethodInvocation *invocation;
+    guint cache_generation;
 } AuthorizeContext;
 
 static void
@@ -51,6 +203,7 @@ authorize_context_free (AuthorizeContext *ctx)
 {
     g_object_unref (ctx->invocation);
     g_object_unref (ctx->subject);
+    g_free (ctx->sender);
     g_free (ctx->authorization);
     g_free (ctx);
 }
@@ -68,6 +221,7 @@ check_authorization_ready (PolkitAuthority *authority,
                            GAsyncResult *res,
                            GTask *task)
 {
+    MMAuthProviderPolkit *self;
     PolkitAuthorizationResult *pk_result;
     GError *error = NULL;
     AuthorizeContext *ctx;
@@ -77,6 +231,7 @@ check_authorization_ready (PolkitAuthority *authority,
         return;
     }
 
+    self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
     pk_result = polkit_authority_check_authorization_finish (authority, res, &error);
     if (!pk_result) {
@@ -87,10 +242,12 @@ check_authorization_ready (PolkitAuthority *authority,
                                  error->message);
         g_error_free (error);
     } else {
-        if (polkit_authorization_result_get_is_authorized (pk_result))
-            /* Good! */
+        if (polkit_authorization_result_get_is_authorized (pk_result)) {
+            /* Good! Only cache the result if nothing was flushed meanwhile */
+            if (ctx->cache_generation == self->priv->cache_generation)
+                cache_add (self, ctx->sender, ctx->authorization);
             g_task_return_boolean (task, TRUE);
-        else if (polkit_authorization_result_get_is_challenge (pk_result))
+        } else if (polkit_authorization_result_get_is_challenge (pk_result))
             g_task_return_new_error (task,
                                      MM_CORE_ERROR,
                                      MM_CORE_ERROR_UNAUTHORIZED,
@@ -118,6 +275,7 @@ authorize (MMAuthProvider *self,
 {
     MMAuthProviderPolkit *polkit = MM_AUTH_PROVIDER_POLKIT (self);
     AuthorizeContext *ctx;
+    const gchar *sender;
     GTask *task;
 
     /* When creating the object, we actually allowed errors when looking for the
@@ -135,12 +293,26 @@ authorize (MMAuthProvider *self,
         return;
     }
 
+    sender = g_dbus_method_invocation_get_sender (invocation);
+
+    task = g_task_new (self, cancellable, callback, user_data);
+
+    if (cache_lookup (polkit, sender, authorization)) {
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    /* Make sure we get notified when the sender goes away */
+    setup_name_owner_changed (polkit, invocation);
+
     ctx = g_new (AuthorizeContext, 1);
     ctx->invocation = g_object_ref (invocation);
+    ctx->sender = g_strdup (sender);
     ctx->authorization = g_strdup (authorization);
-    ctx->subject = polkit_system_bus_name_new (g_dbus_method_invocation_get_sender (ctx->invocation));
+    ctx->subject = polkit_system_bus_name_new (sender);
+    ctx->cache_generation = polkit->priv->cache_generation;
 
-    task = g_task_new (self, cancellable, callback, user_data);
     g_task_set_task_data (task, ctx, (GDestroyNotify)authorize_context_free);
 
     polkit_authority_check_authorization (polkit->priv->authority,
@@ -164,6 +336,8 @@ mm_auth_provider_polkit_init (MMAuthProviderPolkit *self)
                                               MM_TYPE_AUTH_PROVIDER_POLKIT,
                                               MMAuthProviderPolkitPrivate);
 
+    self->priv->cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
     self->priv->authority = polkit_authority_get_sync (NULL, &error);
     if (!self->priv->authority) {
         /* NOTE: we failed to create the polkit authority, but we still create
@@ -171,17 +345,45 @@ mm_auth_provider_polkit_init (MMAuthProviderPolkit *self)
         mm_warn ("failed to create PolicyKit authority: '%s'",
                  error ? error->message : "unknown");
         g_clear_error (&error);
+        return;
     }
+
+    self->priv->authority_changed_id = g_signal_connect (self->priv->authority,
+                                                         "changed",
+                                                         G_CALLBACK (authority_changed),
+                                                         self);
 }
 
 static void
 dispose (GObject *object)
 {
-    g_clear_object (&(MM_AUTH_PROVIDER_POLKIT (object)->priv->authority));
+    MMAuthProviderPolkit *self = MM_AUTH_PROVIDER_POLKIT (object);
+
+    if (self->priv->name_owner_changed_id) {
+        g_dbus_connection_signal_unsubscribe (self->priv->connection, self->priv->name_owner_changed_id);
+        self->priv->name_owner_changed_id = 0;
+    }
+    g_clear_object (&self->priv->connection);
+
+    if (self->priv->authority_changed_id) {
+        g_signal_handler_disconnect (self->priv->authority, self->priv->authority_changed_id);
+        self->priv->authority_changed_id = 0;
+    }
+    g_clear_object (&self->priv->authority);
 
     G_OBJECT_CLASS (mm_auth_provider_polkit_parent_class)->dispose (object);
 }
 
+static void
+finalize (GObject *object)
+{
+    MMAuthProviderPolkit *self = MM_AUTH_PROVIDER_POLKIT (object);
+
+    g_hash_table_unref (self->priv->cache);
+
+    G_OBJECT_CLASS (mm_auth_provider_polkit_parent_class)->finalize (object);
+}
+
 static void
 mm_auth_provider_polkit_class_init (MMAuthProviderPolkitClass *class)
 {
@@ -192,6 +394,7 @@ mm_auth_provider_polkit_class_init (MMAuthProviderPolkitClass *class)
 
     /* Virtual methods */
     object_class->dispose = dispose;
+    object_class->finalize = finalize;
     auth_provider_class->authorize = authorize;
     auth_provider_class->authorize_finish = authorize_finish;
 }
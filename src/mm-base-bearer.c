@@ -36,6 +36,7 @@
 #include "mm-base-modem-at.h"
 #include "mm-base-modem.h"
 #include "mm-log.h"
+#include "mm-clock.h"
 #include "mm-modem-helpers.h"
 #include "mm-bearer-stats.h"
 
@@ -116,8 +117,8 @@ struct _MMBaseBearerPrivate {
     MMBearerStats *stats;
     /* Handler id for the stats update timeout */
     guint stats_update_id;
-    /* Timer to measure the duration of the connection */
-    GTimer *duration_timer;
+    /* Monotonic time when the connection stats were started */
+    gint64 duration_start;
     /* Flag to specify whether reloading stats is supported or not */
     gboolean reload_stats_unsupported;
 };
@@ -208,9 +209,9 @@ initial_connection_monitor_cb (MMBaseBearer *self)
         NULL);
 
     /* Add new monitor timeout at a higher rate */
-    self->priv->connection_monitor_id = g_timeout_add_seconds (BEARER_CONNECTION_MONITOR_TIMEOUT,
-                                                               (GSourceFunc) connection_monitor_cb,
-                                                               self);
+    self->priv->connection_monitor_id = mm_clock_timeout_add_seconds (BEARER_CONNECTION_MONITOR_TIMEOUT,
+                                                                      (GSourceFunc) connection_monitor_cb,
+                                                                      self);
 
     /* Remove the initial connection monitor timeout as we added a new one */
     return G_SOURCE_REMOVE;
@@ -229,9 +230,9 @@ connection_monitor_start (MMBaseBearer *self)
 
     /* Schedule initial check */
     g_assert (!self->priv->connection_monitor_id);
-    self->priv->connection_monitor_id = g_timeout_add_seconds (BEARER_CONNECTION_MONITOR_INITIAL_TIMEOUT,
-                                                               (GSourceFunc) initial_connection_monitor_cb,
-                                                               self);
+    self->priv->connection_monitor_id = mm_clock_timeout_add_seconds (BEARER_CONNECTION_MONITOR_INITIAL_TIMEOUT,
+                                                                      (GSourceFunc) initial_connection_monitor_cb,
+                                                                      self);
 }
 
 /*****************************************************************************/
@@ -251,17 +252,20 @@ bearer_reset_interface_stats (MMBaseBearer *self)
     mm_gdbus_bearer_set_stats (MM_GDBUS_BEARER (self), NULL);
 }
 
+/* Seconds since the stats were started */
+static guint32
+bearer_stats_get_duration (MMBaseBearer *self)
+{
+    return (guint32) ((mm_clock_get_monotonic_time () - self->priv->duration_start) / G_USEC_PER_SEC);
+}
+
 static void
 bearer_stats_stop (MMBaseBearer *self)
 {
-    if (self->priv->duration_timer) {
-        if (self->priv->stats)
-            mm_bearer_stats_set_duration (self->priv->stats, (guint64) g_timer_elapsed (self->priv->duration_timer, NULL));
-        g_timer_destroy (self->priv->duration_timer);
-        self->priv->duration_timer = NULL;
-    }
-
+    /* The update timeout is scheduled while the stats are running */
     if (self->priv->stats_update_id) {
+        if (self->priv->stats)
+            mm_bearer_stats_set_duration (self->priv->stats, bearer_stats_get_duration (self));
         g_source_remove (self->priv->stats_update_id);
         self->priv->stats_update_id = 0;
     }
@@ -293,7 +297,7 @@ reload_stats_ready (MMBaseBearer *self,
     }
 
     /* We only update stats if they were retrieved properly */
-    mm_bearer_stats_set_duration (self->priv->stats, (guint32) g_timer_elapsed (self->priv->duration_timer, NULL));
+    mm_bearer_stats_set_duration (self->priv->stats, bearer_stats_get_duration (self));
     mm_bearer_stats_set_tx_bytes (self->priv->stats, tx_bytes);
     mm_bearer_stats_set_rx_bytes (self->priv->stats, rx_bytes);
     bearer_update_interface_stats (self);
@@ -314,7 +318,7 @@ stats_update_cb (MMBaseBearer *self)
     }
 
     /* Otherwise, just update duration and we're done */
-    mm_bearer_stats_set_duration (self->priv->stats, (guint32) g_timer_elapsed (self->priv->duration_timer, NULL));
+    mm_bearer_stats_set_duration (self->priv->stats, bearer_stats_get_duration (self));
     mm_bearer_stats_set_tx_bytes (self->priv->stats, 0);
     mm_bearer_stats_set_rx_bytes (self->priv->stats, 0);
     bearer_update_interface_stats (self);
@@ -330,14 +334,13 @@ bearer_stats_start (MMBaseBearer *self)
     self->priv->stats = mm_bearer_stats_new ();
 
     /* Start duration timer */
-    g_assert (!self->priv->duration_timer);
-    self->priv->duration_timer = g_timer_new ();
+    self->priv->duration_start = mm_clock_get_monotonic_time ();
 
     /* Schedule */
     g_assert (!self->priv->stats_update_id);
-    self->priv->stats_update_id = g_timeout_add_seconds (BEARER_STATS_UPDATE_TIMEOUT,
-                                                         (GSourceFunc) stats_update_cb,
-                                                         self);
+    self->priv->stats_update_id = mm_clock_timeout_add_seconds (BEARER_STATS_UPDATE_TIMEOUT,
+                                                                (GSourceFunc) stats_update_cb,
+                                                                self);
     /* Load initial values */
     stats_update_cb (self);
 }
@@ -42,6 +42,7 @@ enum {
     PROP_MODEM,
     PROP_SUPPORTS_DIALING_TO_RINGING,
     PROP_SUPPORTS_RINGING_TO_ACTIVE,
+    PROP_INDEX,
     PROP_LAST
 };
 
@@ -57,6 +58,8 @@ struct _MMBaseCallPrivate {
     /* Features */
     gboolean supports_dialing_to_ringing;
     gboolean supports_ringing_to_active;
+    /* Index of the call in the modem, 0 if unknown */
+    guint index;
 
     guint incoming_timeout;
     GRegex *in_call_events;
@@ -219,6 +222,11 @@ call_started (HandleStartContext *ctx)
             /* Otherwise, active right away */
             mm_base_call_change_state (ctx->self, MM_CALL_STATE_ACTIVE, MM_CALL_STATE_REASON_OUTGOING_STARTED);
     }
+
+    /* If the modem reports full call lists, sync right away to learn the
+     * call index */
+    mm_iface_modem_voice_reload_all_calls (MM_IFACE_MODEM_VOICE (ctx->modem));
+
     mm_gdbus_call_complete_start (MM_GDBUS_CALL (ctx->self), ctx->invocation);
     handle_start_context_free (ctx);
 }
@@ -380,6 +388,7 @@ call_accepted (HandleAcceptContext *ctx)
         ctx->self->priv->incoming_timeout = 0;
     }
     mm_base_call_change_state (ctx->self, MM_CALL_STATE_ACTIVE, MM_CALL_STATE_REASON_ACCEPTED);
+    mm_iface_modem_voice_reload_all_calls (MM_IFACE_MODEM_VOICE (ctx->modem));
     mm_gdbus_call_complete_accept (MM_GDBUS_CALL (ctx->self), ctx->invocation);
     handle_accept_context_free (ctx);
 }
@@ -531,6 +540,9 @@ handle_hangup_ready (MMBaseCall *self,
     /* we set it as terminated even if we got an error reported */
     mm_base_call_change_state (self, MM_CALL_STATE_TERMINATED, MM_CALL_STATE_REASON_TERMINATED);
 
+    /* Hanging up may have affected other calls as well */
+    mm_iface_modem_voice_reload_all_calls (MM_IFACE_MODEM_VOICE (ctx->modem));
+
     if (!MM_BASE_CALL_GET_CLASS (self)->hangup_finish (self, res, &error))
         g_dbus_method_invocation_take_error (ctx->invocation, error);
     else {
@@ -786,6 +798,19 @@ mm_base_call_get_path (MMBaseCall *self)
     return self->priv->path;
 }
 
+guint
+mm_base_call_get_index (MMBaseCall *self)
+{
+    return self->priv->index;
+}
+
+void
+mm_base_call_set_index (MMBaseCall *self,
+                        guint       index)
+{
+    g_object_set (self, MM_BASE_CALL_INDEX, index, NULL);
+}
+
 /* Define the states in which we want to handle in-call events */
 #define MM_CALL_STATE_IS_IN_CALL(state)         \
     (state == MM_CALL_STATE_DIALING ||          \
@@ -823,6 +848,12 @@ mm_base_call_change_state (MMBaseCall        *self,
              mm_call_state_get_string (new_state),
              mm_call_state_reason_get_string (reason));
 
+    /* The validity timeout only applies while ringing */
+    if (old_state == MM_CALL_STATE_RINGING_IN && self->priv->incoming_timeout) {
+        g_source_remove (self->priv->incoming_timeout);
+        self->priv->incoming_timeout = 0;
+    }
+
     /* Setup/cleanup unsolicited events  based on state transitions to/from ACTIVE */
     if (!MM_CALL_STATE_IS_IN_CALL (old_state) && MM_CALL_STATE_IS_IN_CALL (new_state)) {
         mm_dbg ("Setting up in-call unsolicited events...");
@@ -1118,6 +1149,9 @@ set_property (GObject *object,
     case PROP_SUPPORTS_RINGING_TO_ACTIVE:
         self->priv->supports_ringing_to_active = g_value_get_boolean (value);
         break;
+    case PROP_INDEX:
+        self->priv->index = g_value_get_uint (value);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
         break;
@@ -1148,6 +1182,9 @@ get_property (GObject *object,
     case PROP_SUPPORTS_RINGING_TO_ACTIVE:
         g_value_set_boolean (value, self->priv->supports_ringing_to_active);
         break;
+    case PROP_INDEX:
+        g_value_set_uint (value, self->priv->index);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
         break;
@@ -1261,4 +1298,12 @@ mm_base_call_class_init (MMBaseCallClass *klass)
                               FALSE,
                               G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
     g_object_class_install_property (object_class, PROP_SUPPORTS_RINGING_TO_ACTIVE, properties[PROP_SUPPORTS_RINGING_TO_ACTIVE]);
+
+    properties[PROP_INDEX] =
+        g_param_spec_uint (MM_BASE_CALL_INDEX,
+                           "Index",
+                           "Index of the call in the modem, 0 if unknown",
+                           0, G_MAXUINT, 0,
+                           G_PARAM_READWRITE);
+    g_object_class_install_property (object_class, PROP_INDEX, properties[PROP_INDEX]);
 }
@@ -41,6 +41,7 @@ typedef struct _MMBaseCallPrivate MMBaseCallPrivate;
 #define MM_BASE_CALL_MODEM                       "call-modem"
 #define MM_BASE_CALL_SUPPORTS_DIALING_TO_RINGING "call-supports-dialing-to-ringing"
 #define MM_BASE_CALL_SUPPORTS_RINGING_TO_ACTIVE  "call-supports-ringing-to-active"
+#define MM_BASE_CALL_INDEX                       "call-index"
 
 struct _MMBaseCall {
     MmGdbusCallSkeleton parent;
@@ -117,6 +118,11 @@ void         mm_base_call_export   (MMBaseCall *self);
 void         mm_base_call_unexport (MMBaseCall *self);
 const gchar *mm_base_call_get_path (MMBaseCall *self);
 
+/* Index of the call in the modem (e.g. as given in +CLCC), 0 if unknown */
+guint        mm_base_call_get_index (MMBaseCall *self);
+void         mm_base_call_set_index (MMBaseCall *self,
+                                     guint       index);
+
 void         mm_base_call_change_state (MMBaseCall *self,
                                         MMCallState new_state,
                                         MMCallStateReason reason);
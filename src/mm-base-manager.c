@@ -45,6 +45,7 @@
 #include "mm-plugin.h"
 #include "mm-filter.h"
 #include "mm-log.h"
+#include "mm-clock.h"
 
 static void initable_iface_init (GInitableIface *iface);
 
@@ -1315,6 +1316,79 @@ out:
     return TRUE;
 }
 
+/*****************************************************************************/
+/* Test memory report */
+
+static gboolean
+handle_get_memory_report (MmGdbusTest *skeleton,
+                          GDBusMethodInvocation *invocation,
+                          MMBaseManager *self)
+{
+    GVariantBuilder builder;
+    GHashTableIter iter;
+    gpointer value;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sa{st}}"));
+
+    g_hash_table_iter_init (&iter, self->priv->devices);
+    while (g_hash_table_iter_next (&iter, NULL, &value)) {
+        MMBaseModem *modem;
+        const gchar *path;
+
+        modem = mm_device_peek_modem (MM_DEVICE (value));
+        if (!modem)
+            continue;
+
+        /* Modems not yet exported are reported by device */
+        path = g_dbus_object_get_object_path (G_DBUS_OBJECT (modem));
+        g_variant_builder_add (&builder, "{s@a{st}}",
+                               path ? path : mm_base_modem_get_device (modem),
+                               mm_base_modem_build_memory_report (modem));
+    }
+
+    mm_gdbus_test_complete_get_memory_report (skeleton, invocation, g_variant_builder_end (&builder));
+    return TRUE;
+}
+
+/*****************************************************************************/
+/* Test virtual clock */
+
+typedef struct {
+    MmGdbusTest           *skeleton;
+    GDBusMethodInvocation *invocation;
+} AdvanceClockContext;
+
+static void
+advance_clock_ready (GObject             *source,
+                     GAsyncResult        *res,
+                     AdvanceClockContext *ctx)
+{
+    GError *error = NULL;
+
+    if (!mm_clock_advance_finish (res, &error))
+        g_dbus_method_invocation_take_error (ctx->invocation, error);
+    else
+        mm_gdbus_test_complete_advance_clock (ctx->skeleton, ctx->invocation);
+
+    g_object_unref (ctx->skeleton);
+    g_slice_free (AdvanceClockContext, ctx);
+}
+
+static gboolean
+handle_advance_clock (MmGdbusTest *skeleton,
+                      GDBusMethodInvocation *invocation,
+                      guint64 ms,
+                      MMBaseManager *self)
+{
+    AdvanceClockContext *ctx;
+
+    ctx = g_slice_new0 (AdvanceClockContext);
+    ctx->skeleton = g_object_ref (skeleton);
+    ctx->invocation = invocation;
+    mm_clock_advance (ms, (GAsyncReadyCallback)advance_clock_ready, ctx);
+    return TRUE;
+}
+
 /*****************************************************************************/
 
 MMBaseManager *
@@ -1516,6 +1590,14 @@ initable_init (GInitable *initable,
                           "handle-set-profile",
                           G_CALLBACK (handle_set_profile),
                           initable);
+        g_signal_connect (priv->test_skeleton,
+                          "handle-get-memory-report",
+                          G_CALLBACK (handle_get_memory_report),
+                          initable);
+        g_signal_connect (priv->test_skeleton,
+                          "handle-advance-clock",
+                          G_CALLBACK (handle_advance_clock),
+                          initable);
         if (!g_dbus_interface_skeleton_export (G_DBUS_INTERFACE_SKELETON (priv->test_skeleton),
                                                priv->connection,
                                                MM_DBUS_PATH,
@@ -1295,6 +1295,46 @@ mm_base_modem_organize_ports (MMBaseModem *self,
     return TRUE;
 }
 
+/*****************************************************************************/
+/* Memory usage report */
+
+GVariant *
+mm_base_modem_build_memory_report (MMBaseModem *self)
+{
+    GVariantBuilder builder;
+    GHashTableIter  iter;
+    MMPort         *port;
+    GList          *interfaces;
+    guint64         port_buffers = 0;
+    guint64         reply_cache = 0;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{st}"));
+
+    g_hash_table_iter_init (&iter, self->priv->ports);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer)&port)) {
+        gsize port_buffers_size = 0;
+        gsize port_reply_cache_size = 0;
+
+        if (!MM_IS_PORT_SERIAL (port))
+            continue;
+        mm_port_serial_get_memory_usage (MM_PORT_SERIAL (port), &port_buffers_size, &port_reply_cache_size);
+        port_buffers += port_buffers_size;
+        reply_cache += port_reply_cache_size;
+    }
+    g_variant_builder_add (&builder, "{st}", "ports", (guint64) g_hash_table_size (self->priv->ports));
+    g_variant_builder_add (&builder, "{st}", "port-buffers-bytes", port_buffers);
+    g_variant_builder_add (&builder, "{st}", "reply-cache-bytes", reply_cache);
+
+    interfaces = g_dbus_object_get_interfaces (G_DBUS_OBJECT (self));
+    g_variant_builder_add (&builder, "{st}", "dbus-interfaces", (guint64) g_list_length (interfaces));
+    g_list_free_full (interfaces, g_object_unref);
+
+    if (MM_BASE_MODEM_GET_CLASS (self)->build_memory_report)
+        MM_BASE_MODEM_GET_CLASS (self)->build_memory_report (self, &builder);
+
+    return g_variant_builder_end (&builder);
+}
+
 /*****************************************************************************/
 /* Authorization */
 
@@ -1306,14 +1346,38 @@ mm_base_modem_authorize_finish (MMBaseModem *self,
     return g_task_propagate_boolean (G_TASK (res), error);
 }
 
+typedef struct {
+    gchar  *authorization;
+    GTimer *timer;
+} AuthorizeContext;
+
+static void
+authorize_context_free (AuthorizeContext *ctx)
+{
+    g_timer_destroy (ctx->timer);
+    g_free (ctx->authorization);
+    g_slice_free (AuthorizeContext, ctx);
+}
+
 static void
 authorize_ready (MMAuthProvider *authp,
                  GAsyncResult *res,
                  GTask *task)
 {
+    AuthorizeContext *ctx;
     GError *error = NULL;
+    gboolean authorized;
+
+    ctx = g_task_get_task_data (task);
+    authorized = mm_auth_provider_authorize_finish (authp, res, &error);
 
-    if (!mm_auth_provider_authorize_finish (authp, res, &error))
+    mm_dbg ("(%s) authorization for '%s' %s in %.3lf ms",
+            mm_base_modem_get_device (MM_BASE_MODEM (g_task_get_source_object (task))),
+            ctx->authorization,
+            authorized ? "granted" : "denied",
+            g_timer_elapsed (ctx->timer, NULL) * 1000.0);
+
+    if (!authorized)
         g_task_return_error (task, error);
     else
         g_task_return_boolean (task, TRUE);
@@ -1328,6 +1392,7 @@ mm_base_modem_authorize (MMBaseModem *self,
                          GAsyncReadyCallback callback,
                          gpointer user_data)
 {
+    AuthorizeContext *ctx;
     GTask *task;
 
     task = g_task_new (self, self->priv->authp_cancellable, callback, user_data);
@@ -1339,6 +1404,11 @@ mm_base_modem_authorize (MMBaseModem *self,
         return;
     }
 
+    ctx = g_slice_new (AuthorizeContext);
+    ctx->authorization = g_strdup (authorization);
+    ctx->timer = g_timer_new ();
+    g_task_set_task_data (task, ctx, (GDestroyNotify)authorize_context_free);
+
     mm_auth_provider_authorize (self->priv->authp,
                                 invocation,
                                 authorization,
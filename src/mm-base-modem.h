@@ -101,6 +101,11 @@ struct _MMBaseModemClass {
     gboolean (*disable_finish) (MMBaseModem *self,
                                 GAsyncResult *res,
                                 GError **error);
+
+    /* Memory usage report.
+     * Subclasses add their own "a{st}" entries to the given builder */
+    void (* build_memory_report) (MMBaseModem *self,
+                                  GVariantBuilder *builder);
 };
 
 GType mm_base_modem_get_type (void);
@@ -180,6 +185,8 @@ guint mm_base_modem_get_product_id (MMBaseModem *self);
 GCancellable *mm_base_modem_peek_cancellable (MMBaseModem *self);
 GCancellable *mm_base_modem_get_cancellable  (MMBaseModem *self);
 
+GVariant *mm_base_modem_build_memory_report (MMBaseModem *self);
+
 void     mm_base_modem_authorize        (MMBaseModem *self,
                                          GDBusMethodInvocation *invocation,
                                          const gchar *authorization,
@@ -47,7 +47,9 @@
 #include "mm-sms-part-3gpp.h"
 #include "mm-call-list.h"
 #include "mm-base-sim.h"
+#include "mm-context.h"
 #include "mm-log.h"
+#include "mm-clock.h"
 #include "mm-modem-helpers.h"
 #include "mm-error-helpers.h"
 #include "mm-port-serial-qcdm.h"
@@ -111,6 +113,7 @@ enum {
     PROP_MODEM_CDMA_EVDO_REGISTRATION_STATE,
     PROP_MODEM_CDMA_CDMA1X_NETWORK_SUPPORTED,
     PROP_MODEM_CDMA_EVDO_NETWORK_SUPPORTED,
+    PROP_MODEM_CDMA_REGISTRATION_MONITORED,
     PROP_MODEM_MESSAGING_SMS_LIST,
     PROP_MODEM_MESSAGING_SMS_PDU_MODE,
     PROP_MODEM_MESSAGING_SMS_DEFAULT_STORAGE,
@@ -163,6 +166,7 @@ struct _MMBroadbandModemPrivate {
     MM3gppCmerInd modem_cmer_ind;
     gboolean modem_cgerep_support_checked;
     gboolean modem_cgerep_supported;
+    gboolean modem_cgerep_enabled;
     MMFlowControl flow_control;
 
     /*<--- Modem 3GPP interface --->*/
@@ -183,6 +187,7 @@ struct _MMBroadbandModemPrivate {
     /* Implementation helpers */
     gboolean use_unencoded_ussd;
     GTask *pending_ussd_action;
+    guint pending_ussd_timeout_id;
 
     /*<--- Modem CDMA interface --->*/
     /* Properties */
@@ -191,12 +196,15 @@ struct _MMBroadbandModemPrivate {
     MMModemCdmaRegistrationState modem_cdma_evdo_registration_state;
     gboolean modem_cdma_cdma1x_network_supported;
     gboolean modem_cdma_evdo_network_supported;
+    gboolean modem_cdma_registration_monitored;
     GCancellable *modem_cdma_pending_registration_cancellable;
     /* Implementation helpers */
     gboolean checked_sprint_support;
     gboolean has_spservice;
     gboolean has_speri;
     gint evdo_pilot_rssi;
+    gboolean evdo_pilot_active;
+    guint evdo_registration_check_id;
 
     /*<--- Modem Simple interface --->*/
     /* Properties */
@@ -241,6 +249,11 @@ struct _MMBroadbandModemPrivate {
     /*<--- Modem Firmware interface --->*/
     /* Properties */
     GObject *modem_firmware_dbus_skeleton;
+
+    /*<--- QCDM log capture --->*/
+    MMPortSerialQcdm *qcdm_log_capture_port;
+    guint64 qcdm_log_capture_frames;
+    guint64 qcdm_log_capture_bytes;
 };
 
 /*****************************************************************************/
@@ -1824,6 +1837,30 @@ modem_load_supported_ip_families (MMIfaceModem *self,
 /*****************************************************************************/
 /* Signal quality loading (Modem interface) */
 
+static guint signal_quality_evdo_pilot_sets (MMBroadbandModem *self);
+
+static void
+evdo_registration_check_ready (MMIfaceModemCdma *self,
+                               GAsyncResult *res)
+{
+    GError *error = NULL;
+
+    if (!mm_iface_modem_cdma_run_registration_checks_finish (self, res, &error)) {
+        mm_dbg ("Couldn't refresh CDMA registration status: '%s'", error->message);
+        g_error_free (error);
+    }
+}
+
+static gboolean
+evdo_registration_check_cb (MMBroadbandModem *self)
+{
+    self->priv->evdo_registration_check_id = 0;
+    mm_iface_modem_cdma_run_registration_checks (MM_IFACE_MODEM_CDMA (self),
+                                                 (GAsyncReadyCallback)evdo_registration_check_ready,
+                                                 NULL);
+    return G_SOURCE_REMOVE;
+}
+
 static void
 qcdm_evdo_pilot_sets_log_handle (MMPortSerialQcdm *port,
                                  GByteArray *log_buffer,
@@ -1835,6 +1872,7 @@ qcdm_evdo_pilot_sets_log_handle (MMPortSerialQcdm *port,
     uint32_t pilot_pn = 0;
     uint32_t pilot_energy = 0;
     int32_t rssi_dbm = 0;
+    guint quality;
 
     result = qcdm_log_item_evdo_pilot_sets_v2_new ((const char *) log_buffer->data,
                                                    log_buffer->len,
@@ -1858,9 +1896,24 @@ qcdm_evdo_pilot_sets_log_handle (MMPortSerialQcdm *port,
                                                     &rssi_dbm)) {
         mm_dbg ("EVDO active pilot RSSI: %ddBm", rssi_dbm);
         self->priv->evdo_pilot_rssi = rssi_dbm;
+
+        /* Report the new quality right away instead of on the next poll */
+        quality = signal_quality_evdo_pilot_sets (self);
+        if (quality > 0)
+            mm_iface_modem_update_signal_quality (MM_IFACE_MODEM (self), quality);
     }
 
     qcdm_result_unref (result);
+
+    /* Acquiring or losing the active set usually comes with a registration
+     * change; refresh the registration state once the log bursts settle. */
+    if ((num_active > 0) != self->priv->evdo_pilot_active) {
+        self->priv->evdo_pilot_active = (num_active > 0);
+        mm_dbg ("EVDO active pilot set %s", num_active > 0 ? "acquired" : "lost");
+        if (!self->priv->evdo_registration_check_id)
+            self->priv->evdo_registration_check_id =
+                mm_clock_timeout_add_seconds (1, (GSourceFunc)evdo_registration_check_cb, self);
+    }
 }
 
 typedef struct {
@@ -2153,7 +2206,6 @@ signal_quality_qcdm (GTask *task)
 {
     MMBroadbandModem *self;
     SignalQualityContext *ctx;
-    GByteArray *pilot_sets;
     guint quality;
 
     self = g_task_get_source_object (task);
@@ -2168,17 +2220,12 @@ signal_quality_qcdm (GTask *task)
     }
 
     /* Use CDMA1x pilot EC/IO if we can */
-    pilot_sets = g_byte_array_sized_new (25);
-    pilot_sets->len = qcdm_cmd_pilot_sets_new ((char *) pilot_sets->data, 25);
-    g_assert (pilot_sets->len);
-
-    mm_port_serial_qcdm_command (MM_PORT_SERIAL_QCDM (ctx->qcdm_port),
-                                 pilot_sets,
-                                 3,
-                                 NULL,
-                                 (GAsyncReadyCallback)signal_quality_qcdm_ready,
-                                 task);
-    g_byte_array_unref (pilot_sets);
+    mm_port_serial_qcdm_poll (MM_PORT_SERIAL_QCDM (ctx->qcdm_port),
+                              MM_PORT_SERIAL_QCDM_POLL_PILOT_SETS,
+                              3,
+                              NULL,
+                              (GAsyncReadyCallback)signal_quality_qcdm_ready,
+                              task);
 }
 
 static void
@@ -2394,7 +2441,6 @@ access_tech_qcdm_gsm_ready (MMPortSerialQcdm *port,
                             GTask *task)
 {
     AccessTechContext *ctx;
-    GByteArray *cmd;
     QcdmResult *result;
     gint err = QCDM_SUCCESS;
     guint8 opmode = 0;
@@ -2434,17 +2480,12 @@ access_tech_qcdm_gsm_ready (MMPortSerialQcdm *port,
     ctx->sysmode = sysmode;
 
     /* WCDMA subsystem state */
-    cmd = g_byte_array_sized_new (50);
-    cmd->len = qcdm_cmd_wcdma_subsys_state_info_new ((char *) cmd->data, 50);
-    g_assert (cmd->len);
-
-    mm_port_serial_qcdm_command (port,
-                                 cmd,
-                                 3,
-                                 NULL,
-                                 (GAsyncReadyCallback)access_tech_qcdm_wcdma_ready,
-                                 task);
-    g_byte_array_unref (cmd);
+    mm_port_serial_qcdm_poll (port,
+                              MM_PORT_SERIAL_QCDM_POLL_WCDMA_SUBSYS_STATE_INFO,
+                              3,
+                              NULL,
+                              (GAsyncReadyCallback)access_tech_qcdm_wcdma_ready,
+                              task);
 }
 
 static void
@@ -2495,7 +2536,6 @@ access_tech_qcdm_cdma_ready (MMPortSerialQcdm *port,
                              GTask *task)
 {
     AccessTechContext *ctx;
-    GByteArray *cmd;
     QcdmResult *result;
     gint err = QCDM_SUCCESS;
     guint32 hybrid;
@@ -2534,17 +2574,12 @@ access_tech_qcdm_cdma_ready (MMPortSerialQcdm *port,
     ctx->hybrid = !!hybrid;
 
     /* HDR subsystem state */
-    cmd = g_byte_array_sized_new (50);
-    cmd->len = qcdm_cmd_hdr_subsys_state_info_new ((char *) cmd->data, 50);
-    g_assert (cmd->len);
-
-    mm_port_serial_qcdm_command (port,
-                                 cmd,
-                                 3,
-                                 NULL,
-                                 (GAsyncReadyCallback)access_tech_qcdm_hdr_ready,
-                                 task);
-    g_byte_array_unref (cmd);
+    mm_port_serial_qcdm_poll (port,
+                              MM_PORT_SERIAL_QCDM_POLL_HDR_SUBSYS_STATE_INFO,
+                              3,
+                              NULL,
+                              (GAsyncReadyCallback)access_tech_qcdm_hdr_ready,
+                              task);
 }
 
 static void
@@ -2580,7 +2615,6 @@ modem_load_access_technologies (MMIfaceModem *self,
 {
     AccessTechContext *ctx;
     GTask *task;
-    GByteArray *cmd;
     GError *error = NULL;
 
     /* For modems where only QCDM provides detailed information, try to
@@ -2606,32 +2640,22 @@ modem_load_access_technologies (MMIfaceModem *self,
              */
 
             if (mm_iface_modem_is_3gpp (self)) {
-                cmd = g_byte_array_sized_new (50);
-                cmd->len = qcdm_cmd_gsm_subsys_state_info_new ((char *) cmd->data, 50);
-                g_assert (cmd->len);
-
-                mm_port_serial_qcdm_command (ctx->port,
-                                             cmd,
-                                             3,
-                                             NULL,
-                                             (GAsyncReadyCallback)access_tech_qcdm_gsm_ready,
-                                             task);
-                g_byte_array_unref (cmd);
+                mm_port_serial_qcdm_poll (ctx->port,
+                                          MM_PORT_SERIAL_QCDM_POLL_GSM_SUBSYS_STATE_INFO,
+                                          3,
+                                          NULL,
+                                          (GAsyncReadyCallback)access_tech_qcdm_gsm_ready,
+                                          task);
                 return;
             }
 
             if (mm_iface_modem_is_cdma (self)) {
-                cmd = g_byte_array_sized_new (50);
-                cmd->len = qcdm_cmd_cm_subsys_state_info_new ((char *) cmd->data, 50);
-                g_assert (cmd->len);
-
-                mm_port_serial_qcdm_command (ctx->port,
-                                             cmd,
-                                             3,
-                                             NULL,
-                                             (GAsyncReadyCallback)access_tech_qcdm_cdma_ready,
-                                             task);
-                g_byte_array_unref (cmd);
+                mm_port_serial_qcdm_poll (ctx->port,
+                                          MM_PORT_SERIAL_QCDM_POLL_CM_SUBSYS_STATE_INFO,
+                                          3,
+                                          NULL,
+                                          (GAsyncReadyCallback)access_tech_qcdm_cdma_ready,
+                                          task);
                 return;
             }
 
@@ -3254,6 +3278,7 @@ typedef struct {
     gchar          *cgerep_command;
     gboolean        cgerep_primary_done;
     gboolean        cgerep_secondary_done;
+    gboolean        cgerep_running;
 } UnsolicitedEventsContext;
 
 static void
@@ -3293,7 +3318,8 @@ unsolicited_events_setup_ready (MMBroadbandModem *self,
                 ctx->enable ? "enable" : "disable",
                 error->message);
         g_error_free (error);
-    }
+    } else if (ctx->cgerep_running && ctx->enable)
+        self->priv->modem_cgerep_enabled = TRUE;
 
     /* Continue on next port/command */
     run_unsolicited_events_setup (task);
@@ -3310,6 +3336,8 @@ run_unsolicited_events_setup (GTask *task)
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
 
+    ctx->cgerep_running = FALSE;
+
     /* CMER on primary port */
     if (!ctx->cmer_primary_done && ctx->cmer_command && ctx->primary) {
         mm_dbg ("Enabling +CIND event reporting in primary port...");
@@ -3328,6 +3356,7 @@ run_unsolicited_events_setup (GTask *task)
     else if (!ctx->cgerep_primary_done && ctx->cgerep_command && ctx->primary) {
         mm_dbg ("Enabling +CGEV event reporting in primary port...");
         ctx->cgerep_primary_done = TRUE;
+        ctx->cgerep_running = TRUE;
         command = ctx->cgerep_command;
         port = ctx->primary;
     }
@@ -3335,6 +3364,7 @@ run_unsolicited_events_setup (GTask *task)
     else if (!ctx->cgerep_secondary_done && ctx->cgerep_command && ctx->secondary) {
         mm_dbg ("Enabling +CGEV event reporting in secondary port...");
         ctx->cgerep_secondary_done = TRUE;
+        ctx->cgerep_running = TRUE;
         port = ctx->secondary;
         command = ctx->cgerep_command;
     }
@@ -3406,6 +3436,9 @@ modem_3gpp_disable_unsolicited_events (MMIfaceModem3gpp *_self,
     if (self->priv->modem_cgerep_support_checked && self->priv->modem_cgerep_supported)
         ctx->cgerep_command = g_strdup ("+CGEREP=0");
 
+    /* Consider events disabled right away, even if the command fails */
+    self->priv->modem_cgerep_enabled = FALSE;
+
     run_unsolicited_events_setup (task);
 }
 
@@ -5262,6 +5295,50 @@ modem_3gpp_enable_unsolicited_registration_events (MMIfaceModem3gpp *self,
                                                   user_data));
 }
 
+/*****************************************************************************/
+/* Pending USSD action (3GPP/USSD interface) */
+
+/* Time to wait for the +CUSD URC with the reply to our request; the network
+ * itself should report a time out (+CUSD: 5) well before this */
+#define USSD_RESPONSE_TIMEOUT_SECS 60
+
+static GTask *
+ussd_pending_action_take (MMBroadbandModem *self)
+{
+    GTask *task;
+
+    if (self->priv->pending_ussd_timeout_id) {
+        g_source_remove (self->priv->pending_ussd_timeout_id);
+        self->priv->pending_ussd_timeout_id = 0;
+    }
+
+    task = self->priv->pending_ussd_action;
+    self->priv->pending_ussd_action = NULL;
+    return task;
+}
+
+static gboolean
+ussd_response_timeout_cb (MMBroadbandModem *self)
+{
+    GTask *task;
+
+    self->priv->pending_ussd_timeout_id = 0;
+    task = ussd_pending_action_take (self);
+    g_assert (task);
+
+    /* Terminate the session in the modem, so that a new one can be started */
+    mm_dbg ("No USSD response received, terminating session");
+    mm_base_modem_at_command (MM_BASE_MODEM (self), "+CUSD=2", 10, TRUE, NULL, NULL);
+
+    mm_iface_modem_3gpp_ussd_update_state (MM_IFACE_MODEM_3GPP_USSD (self),
+                                           MM_MODEM_3GPP_USSD_SESSION_STATE_IDLE);
+
+    g_task_return_new_error (task, MM_SERIAL_ERROR, MM_SERIAL_ERROR_RESPONSE_TIMEOUT,
+                             "No USSD response received");
+    g_object_unref (task);
+    return G_SOURCE_REMOVE;
+}
+
 /*****************************************************************************/
 /* Cancel USSD (3GPP/USSD interface) */
 
@@ -5286,9 +5363,7 @@ cancel_command_ready (MMBroadbandModem *self,
     if (self->priv->pending_ussd_action) {
         GTask *task;
 
-        task = self->priv->pending_ussd_action;
-        self->priv->pending_ussd_action = NULL;
-
+        task = ussd_pending_action_take (self);
         g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_CANCELLED,
                                  "USSD session was cancelled");
         g_object_unref (task);
@@ -5392,7 +5467,15 @@ ussd_send_command_ready (MMBaseModem  *_self,
     if (response && response[0]) {
         response = mm_strip_tag (response, "+CUSD:");
         cusd_process_string (self, response);
+        return;
     }
+
+    /* The reply will come in a +CUSD URC, which is when the action gets
+     * completed; but don't wait forever for it */
+    if (!self->priv->pending_ussd_timeout_id)
+        self->priv->pending_ussd_timeout_id = mm_clock_timeout_add_seconds (USSD_RESPONSE_TIMEOUT_SECS,
+                                                                            (GSourceFunc)ussd_response_timeout_cb,
+                                                                            self);
 }
 
 static void
@@ -5412,8 +5495,7 @@ modem_3gpp_ussd_context_send_encoded (MMBroadbandModem *self)
     if (!encoded) {
         GTask *task;
 
-        task = self->priv->pending_ussd_action;
-        self->priv->pending_ussd_action = NULL;
+        task = ussd_pending_action_take (self);
 
         mm_iface_modem_3gpp_ussd_update_state (MM_IFACE_MODEM_3GPP_USSD (self), MM_MODEM_3GPP_USSD_SESSION_STATE_IDLE);
 
@@ -5473,8 +5555,7 @@ modem_3gpp_ussd_context_step (MMBroadbandModem *self)
     if (ctx->encoded_used && ctx->unencoded_used) {
         GTask *task;
 
-        task = self->priv->pending_ussd_action;
-        self->priv->pending_ussd_action = NULL;
+        task = ussd_pending_action_take (self);
 
         mm_iface_modem_3gpp_ussd_update_state (MM_IFACE_MODEM_3GPP_USSD (self),
                                                MM_MODEM_3GPP_USSD_SESSION_STATE_IDLE);
@@ -5650,8 +5731,7 @@ cusd_process_string (MMBroadbandModem *self,
     gchar                       *converted = NULL;
 
     /* If there is a pending action, it is ALWAYS completed here */
-    task = self->priv->pending_ussd_action;
-    self->priv->pending_ussd_action = NULL;
+    task = ussd_pending_action_take (self);
 
     if (!str || !isdigit (*str)) {
         error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
@@ -5699,12 +5779,24 @@ cusd_process_string (MMBroadbandModem *self,
             error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_CANCELLED, "USSD terminated by network");
         break;
 
+    case 3:
+        /* Response to the user's request? */
+        if (task)
+            error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_CANCELLED, "Other local client has responded");
+        break;
+
     case 4:
         /* Response to the user's request? */
         if (task)
             error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_CANCELLED, "Operation not supported");
         break;
 
+    case 5:
+        /* Response to the user's request? */
+        if (task)
+            error = g_error_new (MM_MOBILE_EQUIPMENT_ERROR, MM_MOBILE_EQUIPMENT_ERROR_NETWORK_TIMEOUT, "Network time out");
+        break;
+
     default:
         /* Response to the user's request? */
         if (task)
@@ -7255,6 +7347,11 @@ ring_received (MMPortSerialAt *port,
                MMBroadbandModem *self)
 {
     mm_dbg ("Ringing");
+
+    /* Full call list available? Then just reload it */
+    if (mm_iface_modem_voice_reload_all_calls (MM_IFACE_MODEM_VOICE (self)))
+        return;
+
     mm_iface_modem_voice_report_incoming_call (MM_IFACE_MODEM_VOICE (self), NULL);
 }
 
@@ -7271,6 +7368,10 @@ cring_received (MMPortSerialAt *port,
     mm_dbg ("Ringing (%s)", str);
     g_free (str);
 
+    /* Full call list available? Then just reload it */
+    if (mm_iface_modem_voice_reload_all_calls (MM_IFACE_MODEM_VOICE (self)))
+        return;
+
     mm_iface_modem_voice_report_incoming_call (MM_IFACE_MODEM_VOICE (self), NULL);
 }
 
@@ -7281,6 +7382,10 @@ clip_received (MMPortSerialAt *port,
 {
     gchar *str;
 
+    /* Full call list available? Then just reload it, it includes numbers */
+    if (mm_iface_modem_voice_reload_all_calls (MM_IFACE_MODEM_VOICE (self)))
+        return;
+
     str = mm_get_string_unquoted_from_match_info (info, 1);
     mm_iface_modem_voice_report_incoming_call (MM_IFACE_MODEM_VOICE (self), str);
     g_free (str);
@@ -7424,6 +7529,37 @@ modem_voice_enable_unsolicited_events (MMIfaceModemVoice *self,
         user_data);
 }
 
+/*****************************************************************************/
+/* Load full list of calls (Voice interface) */
+
+static gboolean
+modem_voice_load_call_list_finish (MMIfaceModemVoice  *self,
+                                   GAsyncResult       *res,
+                                   GList             **call_info_list,
+                                   GError            **error)
+{
+    const gchar *response;
+
+    response = mm_base_modem_at_command_finish (MM_BASE_MODEM (self), res, error);
+    if (!response)
+        return FALSE;
+
+    return mm_voice_parse_clcc_response (response, call_info_list, error);
+}
+
+static void
+modem_voice_load_call_list (MMIfaceModemVoice   *self,
+                            GAsyncReadyCallback  callback,
+                            gpointer             user_data)
+{
+    mm_base_modem_at_command (MM_BASE_MODEM (self),
+                              "+CLCC",
+                              5,
+                              FALSE,
+                              callback,
+                              user_data);
+}
+
 /*****************************************************************************/
 /* Create CALL (Voice interface) */
 
@@ -7572,6 +7708,20 @@ logcmd_qcdm_ready (MMPortSerialQcdm *port,
 
     qcdm_result_unref (result);
 
+    /* While the log is enabled, EVDO signal and registration changes are
+     * reported by the modem. Nothing reports 1x changes, so periodic
+     * registration checks can only be relaxed in EVDO-only modems. */
+    self->priv->evdo_pilot_active = FALSE;
+    if (!ctx->setup && self->priv->evdo_registration_check_id) {
+        g_source_remove (self->priv->evdo_registration_check_id);
+        self->priv->evdo_registration_check_id = 0;
+    }
+    g_object_set (self,
+                  MM_IFACE_MODEM_CDMA_REGISTRATION_MONITORED, (ctx->setup &&
+                                                               self->priv->modem_cdma_evdo_network_supported &&
+                                                               !self->priv->modem_cdma_cdma1x_network_supported),
+                  NULL);
+
     /* Balance the mm_port_seral_open() from modem_cdma_setup_cleanup_unsolicited_events().
      * We want to close it in either case:
      *  (a) we're cleaning up and setup opened the port
@@ -7598,7 +7748,7 @@ modem_cdma_setup_cleanup_unsolicited_events (MMBroadbandModem *self,
     GError *error = NULL;
 
     ctx = g_new0 (CdmaUnsolicitedEventsContext, 1);
-    ctx->setup = TRUE;
+    ctx->setup = setup;
 
     task = g_task_new (self, NULL, callback, user_data);
     g_task_set_task_data (task, ctx, (GDestroyNotify)cdma_unsolicited_events_context_free);
@@ -7759,7 +7909,6 @@ modem_cdma_get_hdr_state (MMIfaceModemCdma *self,
 {
     MMPortSerialQcdm *qcdm;
     GTask *task;
-    GByteArray *hdrstate;
     GError *error = NULL;
 
     task = g_task_new (self, NULL, callback, user_data);
@@ -7785,17 +7934,12 @@ modem_cdma_get_hdr_state (MMIfaceModemCdma *self,
                           (GDestroyNotify) hdr_state_cleanup_port);
 
     /* Setup command */
-    hdrstate = g_byte_array_sized_new (25);
-    hdrstate->len = qcdm_cmd_hdr_subsys_state_info_new ((gchar *) hdrstate->data, 25);
-    g_assert (hdrstate->len);
-
-    mm_port_serial_qcdm_command (qcdm,
-                                 hdrstate,
-                                 3,
-                                 NULL,
-                                 (GAsyncReadyCallback)hdr_subsys_state_info_ready,
-                                 task);
-    g_byte_array_unref (hdrstate);
+    mm_port_serial_qcdm_poll (qcdm,
+                              MM_PORT_SERIAL_QCDM_POLL_HDR_SUBSYS_STATE_INFO,
+                              3,
+                              NULL,
+                              (GAsyncReadyCallback)hdr_subsys_state_info_ready,
+                              task);
 }
 
 /*****************************************************************************/
@@ -7883,7 +8027,6 @@ modem_cdma_get_call_manager_state (MMIfaceModemCdma *self,
 {
     MMPortSerialQcdm *qcdm;
     GTask *task;
-    GByteArray *cmstate;
     GError *error = NULL;
 
     task = g_task_new (self, NULL, callback, user_data);
@@ -7909,17 +8052,12 @@ modem_cdma_get_call_manager_state (MMIfaceModemCdma *self,
                           (GDestroyNotify) cm_state_cleanup_port);
 
     /* Setup command */
-    cmstate = g_byte_array_sized_new (25);
-    cmstate->len = qcdm_cmd_cm_subsys_state_info_new ((gchar *) cmstate->data, 25);
-    g_assert (cmstate->len);
-
-    mm_port_serial_qcdm_command (qcdm,
-                                 cmstate,
-                                 3,
-                                 NULL,
-                                 (GAsyncReadyCallback)cm_subsys_state_info_ready,
-                                 task);
-    g_byte_array_unref (cmstate);
+    mm_port_serial_qcdm_poll (qcdm,
+                              MM_PORT_SERIAL_QCDM_POLL_CM_SUBSYS_STATE_INFO,
+                              3,
+                              NULL,
+                              (GAsyncReadyCallback)cm_subsys_state_info_ready,
+                              task);
 }
 
 /*****************************************************************************/
@@ -8178,7 +8316,6 @@ modem_cdma_get_cdma1x_serving_system (MMIfaceModemCdma *self,
                                       gpointer user_data)
 {
     GError *error = NULL;
-    GByteArray *cdma_status;
     GTask *task;
     MMPortSerialQcdm *qcdm;
 
@@ -8205,16 +8342,12 @@ modem_cdma_get_cdma1x_serving_system (MMIfaceModemCdma *self,
                           (GDestroyNotify) cdma1x_serving_system_state_cleanup_port);
 
     /* Setup command */
-    cdma_status = g_byte_array_sized_new (25);
-    cdma_status->len = qcdm_cmd_cdma_status_new ((char *) cdma_status->data, 25);
-    g_assert (cdma_status->len);
-    mm_port_serial_qcdm_command (qcdm,
-                                 cdma_status,
-                                 3,
-                                 NULL,
-                                 (GAsyncReadyCallback) qcdm_cdma_status_ready,
-                                 task);
-    g_byte_array_unref (cdma_status);
+    mm_port_serial_qcdm_poll (qcdm,
+                              MM_PORT_SERIAL_QCDM_POLL_CDMA_STATUS,
+                              3,
+                              NULL,
+                              (GAsyncReadyCallback) qcdm_cdma_status_ready,
+                              task);
 }
 
 /*****************************************************************************/
@@ -8679,7 +8812,7 @@ modem_cdma_setup_registration_checks (MMIfaceModemCdma *_self,
 typedef struct {
     MMBroadbandModem *self;
     GCancellable *cancellable;
-    GTimer *timer;
+    gint64 start_time;
     guint max_registration_time;
 } RegisterInCdmaNetworkContext;
 
@@ -8692,9 +8825,6 @@ register_in_cdma_network_context_free (RegisterInCdmaNetworkContext *ctx)
         g_clear_object (&ctx->self->priv->modem_cdma_pending_registration_cancellable);
     }
 
-    if (ctx->timer)
-        g_timer_destroy (ctx->timer);
-
     g_object_unref (ctx->cancellable);
     g_object_unref (ctx->self);
     g_free (ctx);
@@ -8777,7 +8907,7 @@ run_cdma_registration_checks_ready (MMBroadbandModem *self,
     }
 
     /* Don't spend too much time waiting to get registered */
-    if (g_timer_elapsed (ctx->timer, NULL) > ctx->max_registration_time) {
+    if ((mm_clock_get_monotonic_time () - ctx->start_time) > ((gint64) ctx->max_registration_time * G_USEC_PER_SEC)) {
         mm_dbg ("CDMA registration check timed out");
         mm_iface_modem_cdma_update_cdma1x_registration_state (
             MM_IFACE_MODEM_CDMA (self),
@@ -8798,9 +8928,9 @@ run_cdma_registration_checks_ready (MMBroadbandModem *self,
 
     /* Check again in a few seconds. */
     mm_dbg ("Modem not yet registered in a CDMA network... will recheck soon");
-    g_timeout_add_seconds (3,
-                           (GSourceFunc)run_cdma_registration_checks_again,
-                           task);
+    mm_clock_timeout_add_seconds (3,
+                                  (GSourceFunc)run_cdma_registration_checks_again,
+                                  task);
 }
 
 static void
@@ -8830,7 +8960,7 @@ modem_cdma_register_in_network (MMIfaceModemCdma *self,
         g_object_ref (ctx->cancellable);
 
     /* Get fresh registration state */
-    ctx->timer = g_timer_new ();
+    ctx->start_time = mm_clock_get_monotonic_time ();
 
     task = g_task_new (self, NULL, callback, user_data);
     g_task_set_task_data (task, ctx, (GDestroyNotify)register_in_cdma_network_context_free);
@@ -9621,12 +9751,269 @@ schedule_initial_registration_checks (MMBroadbandModem *self)
     g_idle_add ((GSourceFunc) schedule_initial_registration_checks_cb, g_object_ref (self));
 }
 
+/*****************************************************************************/
+/* QCDM log capture (enabling/disabling) */
+
+/* Log items captured for each equipment ID. Setting the mask of an equipment
+ * ID replaces the previous one, so the CDMA items include the EVDO pilot sets
+ * that the CDMA interface listens to. */
+static const guint16 qcdm_log_capture_cdma_items[] = {
+    DM_LOG_ITEM_CDMA_ACCESS_CHANNEL_MSG,
+    DM_LOG_ITEM_CDMA_REV_CHANNEL_TRAFFIC_MSG,
+    DM_LOG_ITEM_CDMA_SYNC_CHANNEL_MSG,
+    DM_LOG_ITEM_CDMA_PAGING_CHANNEL_MSG,
+    DM_LOG_ITEM_CDMA_FWD_CHANNEL_TRAFFIC_MSG,
+    DM_LOG_ITEM_CDMA_MARKOV_STATS,
+    DM_LOG_ITEM_CDMA_REVERSE_POWER_CONTROL,
+    DM_LOG_ITEM_CDMA_SERVICE_CONFIG,
+    DM_LOG_ITEM_EVDO_HANDOFF_STATE,
+    DM_LOG_ITEM_EVDO_ACTIVE_PILOT_SET,
+    DM_LOG_ITEM_EVDO_REV_LINK_PACKET_SUMMARY,
+    DM_LOG_ITEM_EVDO_REV_TRAFFIC_RATE_COUNT,
+    DM_LOG_ITEM_EVDO_REV_POWER_CONTROL,
+    DM_LOG_ITEM_EVDO_ARQ_EFFECTIVE_RECEIVE_RATE,
+    DM_LOG_ITEM_EVDO_AIR_LINK_SUMMARY,
+    DM_LOG_ITEM_EVDO_POWER,
+    DM_LOG_ITEM_EVDO_FWD_LINK_PACKET_SNAPSHOT,
+    DM_LOG_ITEM_EVDO_ACCESS_ATTEMPT,
+    DM_LOG_ITEM_EVDO_REV_ACTIVITY_BITS_BUFFER,
+    DM_LOG_ITEM_EVDO_PILOT_SETS,
+    DM_LOG_ITEM_EVDO_STATE_INFO,
+    DM_LOG_ITEM_EVDO_SECTOR_INFO,
+    DM_LOG_ITEM_EVDO_PILOT_SETS_V2,
+    0
+};
+
+static const guint16 qcdm_log_capture_wcdma_items[] = {
+    DM_LOG_ITEM_WCDMA_TA_FINGER_INFO,
+    DM_LOG_ITEM_WCDMA_AGC_INFO,
+    DM_LOG_ITEM_WCDMA_RRC_STATE,
+    DM_LOG_ITEM_WCDMA_CELL_ID,
+    0
+};
+
+static const guint16 qcdm_log_capture_gsm_items[] = {
+    DM_LOG_ITEM_GSM_BURST_METRICS,
+    DM_LOG_ITEM_GSM_BCCH_MESSAGE,
+    0
+};
+
+static const struct {
+    guint32        equip_id;
+    const guint16 *items;
+} qcdm_log_capture_masks[] = {
+    { 0x01, qcdm_log_capture_cdma_items  },
+    { 0x04, qcdm_log_capture_wcdma_items },
+    { 0x05, qcdm_log_capture_gsm_items   },
+};
+
+typedef struct {
+    MMPortSerialQcdm *port;
+    gboolean setup;
+    guint i;
+} QcdmLogCaptureContext;
+
+static void
+qcdm_log_capture_context_free (QcdmLogCaptureContext *ctx)
+{
+    /* Cleanup balances the port open done during setup, unless the port was
+     * forced closed in between */
+    if (!ctx->setup && mm_port_serial_is_open (MM_PORT_SERIAL (ctx->port)))
+        mm_port_serial_close (MM_PORT_SERIAL (ctx->port));
+    g_object_unref (ctx->port);
+    g_slice_free (QcdmLogCaptureContext, ctx);
+}
+
+static gboolean
+qcdm_log_capture_setup_cleanup_finish (MMBroadbandModem *self,
+                                       GAsyncResult *res,
+                                       GError **error)
+{
+    return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+static void qcdm_log_capture_set_next_mask (GTask *task);
+
+static void
+qcdm_log_capture_set_mask_ready (MMPortSerialQcdm *port,
+                                 GAsyncResult *res,
+                                 GTask *task)
+{
+    QcdmLogCaptureContext *ctx;
+    QcdmResult *result;
+    GByteArray *response;
+    GError *error = NULL;
+    gint err = QCDM_SUCCESS;
+
+    ctx = g_task_get_task_data (task);
+
+    /* Not all modems support all equipment IDs, so just go on */
+    response = mm_port_serial_qcdm_command_finish (port, res, &error);
+    if (error) {
+        mm_dbg ("Couldn't set QCDM log mask for equipment ID %u: %s",
+                qcdm_log_capture_masks[ctx->i].equip_id, error->message);
+        g_error_free (error);
+    } else {
+        result = qcdm_cmd_log_config_set_mask_result ((const gchar *) response->data,
+                                                      response->len,
+                                                      &err);
+        if (!result)
+            mm_dbg ("Couldn't set QCDM log mask for equipment ID %u: %d",
+                    qcdm_log_capture_masks[ctx->i].equip_id, err);
+        else
+            qcdm_result_unref (result);
+        g_byte_array_unref (response);
+    }
+
+    ctx->i++;
+    qcdm_log_capture_set_next_mask (task);
+}
+
+static void
+qcdm_log_capture_set_next_mask (GTask *task)
+{
+    QcdmLogCaptureContext *ctx;
+    GByteArray *logcmd;
+
+    ctx = g_task_get_task_data (task);
+
+    if (ctx->i == G_N_ELEMENTS (qcdm_log_capture_masks)) {
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    logcmd = g_byte_array_sized_new (512);
+    logcmd->len = qcdm_cmd_log_config_set_mask_new ((char *) logcmd->data,
+                                                    512,
+                                                    qcdm_log_capture_masks[ctx->i].equip_id,
+                                                    ctx->setup ? (uint16_t *) qcdm_log_capture_masks[ctx->i].items : NULL);
+    g_assert (logcmd->len);
+
+    mm_port_serial_qcdm_command (ctx->port,
+                                 logcmd,
+                                 5,
+                                 NULL,
+                                 (GAsyncReadyCallback)qcdm_log_capture_set_mask_ready,
+                                 task);
+    g_byte_array_unref (logcmd);
+}
+
+static void
+qcdm_log_capture_batch (MMPortSerialQcdm *port,
+                        GByteArray **frames,
+                        guint n_frames,
+                        MMBroadbandModem *self)
+{
+    guint i;
+
+    self->priv->qcdm_log_capture_frames += n_frames;
+    for (i = 0; i < n_frames; i++)
+        self->priv->qcdm_log_capture_bytes += frames[i]->len;
+}
+
+static void
+qcdm_log_capture_setup (MMBroadbandModem *self,
+                        GAsyncReadyCallback callback,
+                        gpointer user_data)
+{
+    QcdmLogCaptureContext *ctx;
+    MMPortSerialQcdm *port;
+    GTask *task;
+    GError *error = NULL;
+    const gchar *dir;
+    gchar *filename;
+    gchar *path;
+
+    task = g_task_new (self, NULL, callback, user_data);
+
+    /* Capture is a debugging aid, so it never makes enabling fail */
+    dir = mm_context_get_log_qcdm_dir ();
+    port = mm_base_modem_peek_port_qcdm (MM_BASE_MODEM (self));
+    if (!dir || !port || self->priv->qcdm_log_capture_port) {
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    /* Keep the port open while capturing, so that log frames are read */
+    if (!mm_port_serial_open (MM_PORT_SERIAL (port), &error)) {
+        mm_warn ("Couldn't open QCDM port for log capture: %s", error->message);
+        g_error_free (error);
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    filename = g_strdup_printf ("%s.qcdm", mm_port_get_device (MM_PORT (port)));
+    path = g_build_filename (dir, filename, NULL);
+    g_free (filename);
+    if (!mm_port_serial_qcdm_set_log_file (port, path, &error)) {
+        mm_warn ("Couldn't start QCDM log capture: %s", error->message);
+        g_error_free (error);
+        g_free (path);
+        mm_port_serial_close (MM_PORT_SERIAL (port));
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+    mm_info ("Capturing QCDM logs in '%s'", path);
+    g_free (path);
+
+    self->priv->qcdm_log_capture_port = g_object_ref (port);
+    self->priv->qcdm_log_capture_frames = 0;
+    self->priv->qcdm_log_capture_bytes = 0;
+    mm_port_serial_qcdm_set_log_batch_handler (port,
+                                               (MMPortSerialQcdmLogBatchFn)qcdm_log_capture_batch,
+                                               self,
+                                               NULL);
+
+    ctx = g_slice_new0 (QcdmLogCaptureContext);
+    ctx->port = g_object_ref (port);
+    ctx->setup = TRUE;
+    g_task_set_task_data (task, ctx, (GDestroyNotify)qcdm_log_capture_context_free);
+
+    qcdm_log_capture_set_next_mask (task);
+}
+
+static void
+qcdm_log_capture_cleanup (MMBroadbandModem *self,
+                          GAsyncReadyCallback callback,
+                          gpointer user_data)
+{
+    QcdmLogCaptureContext *ctx;
+    GTask *task;
+
+    task = g_task_new (self, NULL, callback, user_data);
+
+    if (!self->priv->qcdm_log_capture_port) {
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    ctx = g_slice_new0 (QcdmLogCaptureContext);
+    ctx->port = self->priv->qcdm_log_capture_port;
+    ctx->setup = FALSE;
+    self->priv->qcdm_log_capture_port = NULL;
+    g_task_set_task_data (task, ctx, (GDestroyNotify)qcdm_log_capture_context_free);
+
+    mm_port_serial_qcdm_set_log_batch_handler (ctx->port, NULL, NULL, NULL);
+    mm_port_serial_qcdm_set_log_file (ctx->port, NULL, NULL);
+    mm_info ("QCDM log capture stopped: %" G_GUINT64_FORMAT " frames, %" G_GUINT64_FORMAT " bytes",
+             self->priv->qcdm_log_capture_frames, self->priv->qcdm_log_capture_bytes);
+
+    /* Stop the modem from sending the captured log items */
+    qcdm_log_capture_set_next_mask (task);
+}
+
 /*****************************************************************************/
 
 typedef enum {
     DISABLING_STEP_FIRST,
     DISABLING_STEP_WAIT_FOR_FINAL_STATE,
     DISABLING_STEP_DISCONNECT_BEARERS,
+    DISABLING_STEP_QCDM_LOG_CAPTURE,
     DISABLING_STEP_IFACE_SIMPLE,
     DISABLING_STEP_IFACE_FIRMWARE,
     DISABLING_STEP_IFACE_SIGNAL,
@@ -9748,6 +10135,22 @@ bearer_list_disconnect_all_bearers_ready (MMBearerList *list,
     disabling_step (task);
 }
 
+static void
+disabling_qcdm_log_capture_ready (MMBroadbandModem *self,
+                                  GAsyncResult *res,
+                                  GTask *task)
+{
+    DisablingContext *ctx;
+
+    /* Never fails */
+    qcdm_log_capture_setup_cleanup_finish (self, res, NULL);
+
+    /* Go on to next step */
+    ctx = g_task_get_task_data (task);
+    ctx->step++;
+    disabling_step (task);
+}
+
 static void
 disabling_wait_for_final_state_ready (MMIfaceModem *self,
                                       GAsyncResult *res,
@@ -9826,6 +10229,16 @@ disabling_step (GTask *task)
         /* Fall down to next step */
         ctx->step++;
 
+    case DISABLING_STEP_QCDM_LOG_CAPTURE:
+        if (ctx->self->priv->qcdm_log_capture_port) {
+            qcdm_log_capture_cleanup (ctx->self,
+                                      (GAsyncReadyCallback)disabling_qcdm_log_capture_ready,
+                                      task);
+            return;
+        }
+        /* Fall down to next step */
+        ctx->step++;
+
     case DISABLING_STEP_IFACE_SIMPLE:
         /* Fall down to next step */
         ctx->step++;
@@ -10008,6 +10421,7 @@ typedef enum {
     ENABLING_STEP_IFACE_OMA,
     ENABLING_STEP_IFACE_FIRMWARE,
     ENABLING_STEP_IFACE_SIMPLE,
+    ENABLING_STEP_QCDM_LOG_CAPTURE,
     ENABLING_STEP_LAST,
 } EnablingStep;
 
@@ -10107,6 +10521,22 @@ enabling_started_ready (MMBroadbandModem *self,
     enabling_step (task);
 }
 
+static void
+enabling_qcdm_log_capture_ready (MMBroadbandModem *self,
+                                 GAsyncResult *res,
+                                 GTask *task)
+{
+    EnablingContext *ctx;
+
+    /* Never fails */
+    qcdm_log_capture_setup_cleanup_finish (self, res, NULL);
+
+    /* Go on to next step */
+    ctx = g_task_get_task_data (task);
+    ctx->step++;
+    enabling_step (task);
+}
+
 static void
 enabling_wait_for_final_state_ready (MMIfaceModem *self,
                                      GAsyncResult *res,
@@ -10313,6 +10743,18 @@ enabling_step (GTask *task)
         /* Fall down to next step */
         ctx->step++;
 
+    case ENABLING_STEP_QCDM_LOG_CAPTURE:
+        /* Run after all interfaces so that the log masks set here override
+         * the ones set when enabling them */
+        if (mm_context_get_log_qcdm_dir ()) {
+            qcdm_log_capture_setup (ctx->self,
+                                    (GAsyncReadyCallback)enabling_qcdm_log_capture_ready,
+                                    task);
+            return;
+        }
+        /* Fall down to next step */
+        ctx->step++;
+
     case ENABLING_STEP_LAST:
         ctx->enabled = TRUE;
 
@@ -10669,7 +11111,8 @@ initialize_step (GTask *task)
         ctx->step++;
 
     case INITIALIZE_STEP_IFACE_3GPP_USSD:
-        if (mm_iface_modem_is_3gpp (MM_IFACE_MODEM (ctx->self))) {
+        if (mm_iface_modem_is_3gpp (MM_IFACE_MODEM (ctx->self)) &&
+            !mm_context_get_interface_disabled (MM_CONTEXT_INTERFACE_3GPP_USSD)) {
             /* Initialize the 3GPP/USSD interface */
             mm_iface_modem_3gpp_ussd_initialize (MM_IFACE_MODEM_3GPP_USSD (ctx->self),
                                                  (GAsyncReadyCallback)iface_modem_3gpp_ussd_initialize_ready,
@@ -10696,60 +11139,88 @@ initialize_step (GTask *task)
         ctx->step++;
 
     case INITIALIZE_STEP_IFACE_LOCATION:
-        /* Initialize the Location interface */
-        mm_iface_modem_location_initialize (MM_IFACE_MODEM_LOCATION (ctx->self),
-                                            g_task_get_cancellable (task),
-                                            (GAsyncReadyCallback)iface_modem_location_initialize_ready,
-                                            task);
-        return;
+        if (!mm_context_get_interface_disabled (MM_CONTEXT_INTERFACE_LOCATION)) {
+            /* Initialize the Location interface */
+            mm_iface_modem_location_initialize (MM_IFACE_MODEM_LOCATION (ctx->self),
+                                                g_task_get_cancellable (task),
+                                                (GAsyncReadyCallback)iface_modem_location_initialize_ready,
+                                                task);
+            return;
+        }
+        /* Fall down to next step */
+        ctx->step++;
 
     case INITIALIZE_STEP_IFACE_MESSAGING:
-        /* Initialize the Messaging interface */
-        mm_iface_modem_messaging_initialize (MM_IFACE_MODEM_MESSAGING (ctx->self),
-                                             g_task_get_cancellable (task),
-                                             (GAsyncReadyCallback)iface_modem_messaging_initialize_ready,
-                                             task);
-        return;
+        if (!mm_context_get_interface_disabled (MM_CONTEXT_INTERFACE_MESSAGING)) {
+            /* Initialize the Messaging interface */
+            mm_iface_modem_messaging_initialize (MM_IFACE_MODEM_MESSAGING (ctx->self),
+                                                 g_task_get_cancellable (task),
+                                                 (GAsyncReadyCallback)iface_modem_messaging_initialize_ready,
+                                                 task);
+            return;
+        }
+        /* Fall down to next step */
+        ctx->step++;
 
     case INITIALIZE_STEP_IFACE_VOICE:
-        /* Initialize the Voice interface */
-        mm_iface_modem_voice_initialize (MM_IFACE_MODEM_VOICE (ctx->self),
-                                         g_task_get_cancellable (task),
-                                         (GAsyncReadyCallback)iface_modem_voice_initialize_ready,
-                                         task);
-        return;
+        if (!mm_context_get_interface_disabled (MM_CONTEXT_INTERFACE_VOICE)) {
+            /* Initialize the Voice interface */
+            mm_iface_modem_voice_initialize (MM_IFACE_MODEM_VOICE (ctx->self),
+                                             g_task_get_cancellable (task),
+                                             (GAsyncReadyCallback)iface_modem_voice_initialize_ready,
+                                             task);
+            return;
+        }
+        /* Fall down to next step */
+        ctx->step++;
 
     case INITIALIZE_STEP_IFACE_TIME:
-        /* Initialize the Time interface */
-        mm_iface_modem_time_initialize (MM_IFACE_MODEM_TIME (ctx->self),
-                                        g_task_get_cancellable (task),
-                                        (GAsyncReadyCallback)iface_modem_time_initialize_ready,
-                                        task);
-        return;
+        if (!mm_context_get_interface_disabled (MM_CONTEXT_INTERFACE_TIME)) {
+            /* Initialize the Time interface */
+            mm_iface_modem_time_initialize (MM_IFACE_MODEM_TIME (ctx->self),
+                                            g_task_get_cancellable (task),
+                                            (GAsyncReadyCallback)iface_modem_time_initialize_ready,
+                                            task);
+            return;
+        }
+        /* Fall down to next step */
+        ctx->step++;
 
     case INITIALIZE_STEP_IFACE_SIGNAL:
-        /* Initialize the Signal interface */
-        mm_iface_modem_signal_initialize (MM_IFACE_MODEM_SIGNAL (ctx->self),
-                                          g_task_get_cancellable (task),
-                                          (GAsyncReadyCallback)iface_modem_signal_initialize_ready,
-                                          task);
-        return;
+        if (!mm_context_get_interface_disabled (MM_CONTEXT_INTERFACE_SIGNAL)) {
+            /* Initialize the Signal interface */
+            mm_iface_modem_signal_initialize (MM_IFACE_MODEM_SIGNAL (ctx->self),
+                                              g_task_get_cancellable (task),
+                                              (GAsyncReadyCallback)iface_modem_signal_initialize_ready,
+                                              task);
+            return;
+        }
+        /* Fall down to next step */
+        ctx->step++;
 
     case INITIALIZE_STEP_IFACE_OMA:
-        /* Initialize the Oma interface */
-        mm_iface_modem_oma_initialize (MM_IFACE_MODEM_OMA (ctx->self),
-                                       g_task_get_cancellable (task),
-                                       (GAsyncReadyCallback)iface_modem_oma_initialize_ready,
-                                       task);
-        return;
+        if (!mm_context_get_interface_disabled (MM_CONTEXT_INTERFACE_OMA)) {
+            /* Initialize the Oma interface */
+            mm_iface_modem_oma_initialize (MM_IFACE_MODEM_OMA (ctx->self),
+                                           g_task_get_cancellable (task),
+                                           (GAsyncReadyCallback)iface_modem_oma_initialize_ready,
+                                           task);
+            return;
+        }
+        /* Fall down to next step */
+        ctx->step++;
 
     case INITIALIZE_STEP_IFACE_FIRMWARE:
-        /* Initialize the Firmware interface */
-        mm_iface_modem_firmware_initialize (MM_IFACE_MODEM_FIRMWARE (ctx->self),
-                                            g_task_get_cancellable (task),
-                                            (GAsyncReadyCallback)iface_modem_firmware_initialize_ready,
-                                            task);
-        return;
+        if (!mm_context_get_interface_disabled (MM_CONTEXT_INTERFACE_FIRMWARE)) {
+            /* Initialize the Firmware interface */
+            mm_iface_modem_firmware_initialize (MM_IFACE_MODEM_FIRMWARE (ctx->self),
+                                                g_task_get_cancellable (task),
+                                                (GAsyncReadyCallback)iface_modem_firmware_initialize_ready,
+                                                task);
+            return;
+        }
+        /* Fall down to next step */
+        ctx->step++;
 
     case INITIALIZE_STEP_SIM_HOT_SWAP:
         /* Create the SIM hot swap ports context only if not already done before
@@ -10986,6 +11457,12 @@ mm_broadband_modem_get_current_charset (MMBroadbandModem *self)
     return self->priv->modem_current_charset;
 }
 
+gboolean
+mm_broadband_modem_get_packet_domain_events_enabled (MMBroadbandModem *self)
+{
+    return self->priv->modem_cgerep_enabled;
+}
+
 gchar *
 mm_broadband_modem_create_device_identifier (MMBroadbandModem *self,
                                              const gchar *ati,
@@ -11155,6 +11632,9 @@ set_property (GObject *object,
     case PROP_MODEM_CDMA_EVDO_NETWORK_SUPPORTED:
         self->priv->modem_cdma_evdo_network_supported = g_value_get_boolean (value);
         break;
+    case PROP_MODEM_CDMA_REGISTRATION_MONITORED:
+        self->priv->modem_cdma_registration_monitored = g_value_get_boolean (value);
+        break;
     case PROP_MODEM_MESSAGING_SMS_LIST:
         g_clear_object (&self->priv->modem_messaging_sms_list);
         self->priv->modem_messaging_sms_list = g_value_dup_object (value);
@@ -11281,6 +11761,9 @@ get_property (GObject *object,
     case PROP_MODEM_CDMA_EVDO_NETWORK_SUPPORTED:
         g_value_set_boolean (value, self->priv->modem_cdma_evdo_network_supported);
         break;
+    case PROP_MODEM_CDMA_REGISTRATION_MONITORED:
+        g_value_set_boolean (value, self->priv->modem_cdma_registration_monitored);
+        break;
     case PROP_MODEM_MESSAGING_SMS_LIST:
         g_value_set_object (value, self->priv->modem_messaging_sms_list);
         break;
@@ -11320,6 +11803,37 @@ get_property (GObject *object,
     }
 }
 
+/*****************************************************************************/
+/* Memory usage report */
+
+static void
+build_memory_report (MMBaseModem     *_self,
+                     GVariantBuilder *builder)
+{
+    MMBroadbandModem *self = MM_BROADBAND_MODEM (_self);
+
+    if (self->priv->modem_bearer_list)
+        g_variant_builder_add (builder, "{st}", "bearers",
+                               (guint64) mm_bearer_list_get_count (self->priv->modem_bearer_list));
+
+    if (self->priv->modem_messaging_sms_list) {
+        g_variant_builder_add (builder, "{st}", "sms",
+                               (guint64) mm_sms_list_get_count (self->priv->modem_messaging_sms_list));
+        g_variant_builder_add (builder, "{st}", "sms-bytes",
+                               (guint64) mm_sms_list_get_memory_usage (self->priv->modem_messaging_sms_list));
+    }
+
+    if (self->priv->modem_voice_call_list)
+        g_variant_builder_add (builder, "{st}", "calls",
+                               (guint64) mm_call_list_get_count (self->priv->modem_voice_call_list));
+
+    if (self->priv->modem_location_dbus_skeleton)
+        g_variant_builder_add (builder, "{st}", "location-nmea-bytes",
+                               (guint64) mm_iface_modem_location_get_gps_nmea_size (MM_IFACE_MODEM_LOCATION (self)));
+}
+
+/*****************************************************************************/
+
 static void
 mm_broadband_modem_init (MMBroadbandModem *self)
 {
@@ -11389,6 +11903,19 @@ dispose (GObject *object)
         g_clear_object (&self->priv->modem_3gpp_ussd_dbus_skeleton);
     }
 
+    if (self->priv->evdo_registration_check_id) {
+        g_source_remove (self->priv->evdo_registration_check_id);
+        self->priv->evdo_registration_check_id = 0;
+    }
+
+    if (self->priv->qcdm_log_capture_port) {
+        mm_port_serial_qcdm_set_log_batch_handler (self->priv->qcdm_log_capture_port, NULL, NULL, NULL);
+        mm_port_serial_qcdm_set_log_file (self->priv->qcdm_log_capture_port, NULL, NULL);
+        if (mm_port_serial_is_open (MM_PORT_SERIAL (self->priv->qcdm_log_capture_port)))
+            mm_port_serial_close (MM_PORT_SERIAL (self->priv->qcdm_log_capture_port));
+        g_clear_object (&self->priv->qcdm_log_capture_port);
+    }
+
     if (self->priv->modem_cdma_dbus_skeleton) {
         mm_iface_modem_cdma_shutdown (MM_IFACE_MODEM_CDMA (object));
         g_clear_object (&self->priv->modem_cdma_dbus_skeleton);
@@ -11645,6 +12172,8 @@ iface_modem_voice_init (MMIfaceModemVoice *iface)
     iface->enable_unsolicited_events_finish = modem_voice_enable_unsolicited_events_finish;
     iface->cleanup_unsolicited_events = modem_voice_cleanup_unsolicited_events;
     iface->cleanup_unsolicited_events_finish = modem_voice_setup_cleanup_unsolicited_events_finish;
+    iface->load_call_list = modem_voice_load_call_list;
+    iface->load_call_list_finish = modem_voice_load_call_list_finish;
     iface->create_call = modem_voice_create_call;
 }
 
@@ -11698,6 +12227,7 @@ mm_broadband_modem_class_init (MMBroadbandModemClass *klass)
     base_modem_class->enable_finish = enable_finish;
     base_modem_class->disable = disable;
     base_modem_class->disable_finish = disable_finish;
+    base_modem_class->build_memory_report = build_memory_report;
 
     klass->setup_ports = setup_ports;
     klass->initialization_started = initialization_started;
@@ -11809,6 +12339,10 @@ mm_broadband_modem_class_init (MMBroadbandModemClass *klass)
                                       PROP_MODEM_CDMA_EVDO_NETWORK_SUPPORTED,
                                       MM_IFACE_MODEM_CDMA_EVDO_NETWORK_SUPPORTED);
 
+    g_object_class_override_property (object_class,
+                                      PROP_MODEM_CDMA_REGISTRATION_MONITORED,
+                                      MM_IFACE_MODEM_CDMA_REGISTRATION_MONITORED);
+
     g_object_class_override_property (object_class,
                                       PROP_MODEM_MESSAGING_SMS_LIST,
                                       MM_IFACE_MODEM_MESSAGING_SMS_LIST);
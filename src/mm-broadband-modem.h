@@ -112,6 +112,9 @@ gchar *mm_broadband_modem_take_and_convert_to_current_charset (MMBroadbandModem
 
 MMModemCharset mm_broadband_modem_get_current_charset (MMBroadbandModem *self);
 
+/* Whether +CGEV packet domain events were successfully enabled with +CGEREP */
+gboolean mm_broadband_modem_get_packet_domain_events_enabled (MMBroadbandModem *self);
+
 /* Create a unique device identifier string using the ATI and ATI1 replies and some
  * additional internal info */
 gchar *mm_broadband_modem_create_device_identifier (MMBroadbandModem *self,
@@ -50,6 +50,13 @@ struct _MMCallListPrivate {
     MMBaseModem *modem;
     /* List of call objects */
     GList *list;
+    /* Lookup tables of the list links, by path and by call index */
+    GHashTable *by_path;
+    GHashTable *by_index;
+    /* Index each call is registered with in by_index, 0 if none */
+    GHashTable *indices;
+    /* Calls without index, most recently added first */
+    GList *unindexed;
 };
 
 /*****************************************************************************/
@@ -109,13 +116,79 @@ mm_call_list_get_first_ringing_in_call (MMCallList *self)
     return NULL;
 }
 
+MMBaseCall *
+mm_call_list_get_call_by_index (MMCallList *self,
+                                guint       index)
+{
+    GList *l;
+
+    l = g_hash_table_lookup (self->priv->by_index, GUINT_TO_POINTER (index));
+    return (l ? MM_BASE_CALL (l->data) : NULL);
+}
+
+void
+mm_call_list_foreach (MMCallList            *self,
+                      MMCallListForeachFunc  func,
+                      gpointer               user_data)
+{
+    g_list_foreach (self->priv->list, (GFunc)func, user_data);
+}
+
+void
+mm_call_list_foreach_unindexed (MMCallList            *self,
+                                MMCallListForeachFunc  func,
+                                gpointer               user_data)
+{
+    g_list_foreach (self->priv->unindexed, (GFunc)func, user_data);
+}
+
 /*****************************************************************************/
 
-static guint
-cmp_call_by_path (MMBaseCall *call,
-                 const gchar *path)
+static void
+call_index_untrack (MMCallList *self,
+                    MMBaseCall *call,
+                    GList      *l)
+{
+    guint index;
+
+    index = GPOINTER_TO_UINT (g_hash_table_lookup (self->priv->indices, call));
+    if (!index) {
+        self->priv->unindexed = g_list_remove (self->priv->unindexed, call);
+        return;
+    }
+
+    /* The index may have been taken over by a different call already */
+    if (g_hash_table_lookup (self->priv->by_index, GUINT_TO_POINTER (index)) == l)
+        g_hash_table_remove (self->priv->by_index, GUINT_TO_POINTER (index));
+}
+
+static void
+call_index_track (MMCallList *self,
+                  MMBaseCall *call,
+                  GList      *l)
+{
+    guint index;
+
+    index = mm_base_call_get_index (call);
+    if (index)
+        g_hash_table_replace (self->priv->by_index, GUINT_TO_POINTER (index), l);
+    else
+        self->priv->unindexed = g_list_prepend (self->priv->unindexed, call);
+    g_hash_table_replace (self->priv->indices, call, GUINT_TO_POINTER (index));
+}
+
+static void
+call_index_updated (MMBaseCall *call,
+                    GParamSpec *pspec,
+                    MMCallList *self)
 {
-    return g_strcmp0 (mm_base_call_get_path (call), path);
+    GList *l;
+
+    l = g_hash_table_lookup (self->priv->by_path, mm_base_call_get_path (call));
+    g_assert (l);
+
+    call_index_untrack (self, call, l);
+    call_index_track (self, call, l);
 }
 
 gboolean
@@ -126,9 +199,7 @@ mm_call_list_delete_call (MMCallList   *self,
     GList      *l;
     MMBaseCall *call;
 
-    l = g_list_find_custom (self->priv->list,
-                            (gpointer)call_path,
-                            (GCompareFunc)cmp_call_by_path);
+    l = g_hash_table_lookup (self->priv->by_path, call_path);
     if (!l) {
         g_set_error (error,
                      MM_CORE_ERROR,
@@ -139,6 +210,11 @@ mm_call_list_delete_call (MMCallList   *self,
     }
 
     call = MM_BASE_CALL (l->data);
+    g_signal_handlers_disconnect_by_func (call, call_index_updated, self);
+    call_index_untrack (self, call, l);
+    g_hash_table_remove (self->priv->indices, call);
+    g_hash_table_remove (self->priv->by_path, call_path);
+
     mm_base_call_unexport (call);
     g_signal_emit (self, signals[SIGNAL_CALL_DELETED], 0, call_path);
 
@@ -154,7 +230,21 @@ void
 mm_call_list_add_call (MMCallList *self,
                      MMBaseCall *call)
 {
+    const gchar *path;
+
     self->priv->list = g_list_prepend (self->priv->list, g_object_ref (call));
+
+    /* Calls are only added once exported */
+    path = mm_base_call_get_path (call);
+    g_assert (path);
+    g_hash_table_insert (self->priv->by_path, g_strdup (path), self->priv->list);
+
+    call_index_track (self, call, self->priv->list);
+    g_signal_connect (call,
+                      "notify::" MM_BASE_CALL_INDEX,
+                      G_CALLBACK (call_index_updated),
+                      self);
+
     g_signal_emit (self, signals[SIGNAL_CALL_ADDED], 0,
                    mm_base_call_get_path (call),
                    FALSE);
@@ -215,6 +305,16 @@ mm_call_list_init (MMCallList *self)
     self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self,
                                               MM_TYPE_CALL_LIST,
                                               MMCallListPrivate);
+    self->priv->by_path = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    self->priv->by_index = g_hash_table_new (g_direct_hash, g_direct_equal);
+    self->priv->indices = g_hash_table_new (g_direct_hash, g_direct_equal);
+}
+
+static void
+call_disconnect (MMBaseCall *call,
+                 MMCallList *self)
+{
+    g_signal_handlers_disconnect_by_func (call, call_index_updated, self);
 }
 
 static void
@@ -223,8 +323,13 @@ dispose (GObject *object)
     MMCallList *self = MM_CALL_LIST (object);
 
     g_clear_object (&self->priv->modem);
+    g_list_foreach (self->priv->list, (GFunc)call_disconnect, self);
     g_list_free_full (self->priv->list, g_object_unref);
     self->priv->list = NULL;
+    g_clear_pointer (&self->priv->by_path, g_hash_table_unref);
+    g_clear_pointer (&self->priv->by_index, g_hash_table_unref);
+    g_clear_pointer (&self->priv->indices, g_hash_table_unref);
+    g_clear_pointer (&self->priv->unindexed, g_list_free);
 
     G_OBJECT_CLASS (mm_call_list_parent_class)->dispose (object);
 }
@@ -69,5 +69,16 @@ gboolean mm_call_list_delete_call (MMCallList   *self,
                                    GError      **error);
 
 MMBaseCall *mm_call_list_get_first_ringing_in_call (MMCallList *self);
+MMBaseCall *mm_call_list_get_call_by_index         (MMCallList *self,
+                                                    guint       index);
+
+typedef void (*MMCallListForeachFunc) (MMBaseCall *call,
+                                       gpointer    user_data);
+void mm_call_list_foreach (MMCallList            *self,
+                           MMCallListForeachFunc  func,
+                           gpointer               user_data);
+void mm_call_list_foreach_unindexed (MMCallList            *self,
+                                     MMCallListForeachFunc  func,
+                                     gpointer               user_data);
 
 #endif /* MM_CALL_LIST_H */
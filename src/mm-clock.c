@@ -0,0 +1,249 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <ModemManager.h>
+#include <libmm-glib.h>
+
+#include "mm-clock.h"
+
+static gboolean  virtual_clock;
+static gint64    virtual_now;     /* us */
+static GList    *virtual_sources; /* VirtualTimeoutSource, not owned */
+static GTask    *advance_task;
+
+G_LOCK_DEFINE_STATIC (virtual_clock);
+
+/*****************************************************************************/
+/* Virtual timeout source */
+
+typedef struct {
+    GSource source;
+    gint64  interval;   /* us */
+    gint64  expiration; /* us, in the virtual clock */
+} VirtualTimeoutSource;
+
+static gboolean
+virtual_timeout_check (GSource *source)
+{
+    gboolean ready;
+
+    G_LOCK (virtual_clock);
+    ready = (virtual_now >= ((VirtualTimeoutSource *)source)->expiration);
+    G_UNLOCK (virtual_clock);
+    return ready;
+}
+
+static gboolean
+virtual_timeout_prepare (GSource *source,
+                         gint    *timeout)
+{
+    /* Never wake up by real time, only when the clock is advanced */
+    *timeout = -1;
+    return virtual_timeout_check (source);
+}
+
+static gboolean
+virtual_timeout_dispatch (GSource     *source,
+                          GSourceFunc  callback,
+                          gpointer     user_data)
+{
+    VirtualTimeoutSource *self = (VirtualTimeoutSource *)source;
+
+    if (!callback) {
+        g_warning ("Virtual timeout source dispatched without callback");
+        return G_SOURCE_REMOVE;
+    }
+
+    if (!callback (user_data))
+        return G_SOURCE_REMOVE;
+
+    G_LOCK (virtual_clock);
+    self->expiration = virtual_now + self->interval;
+    G_UNLOCK (virtual_clock);
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+virtual_timeout_finalize (GSource *source)
+{
+    G_LOCK (virtual_clock);
+    virtual_sources = g_list_remove (virtual_sources, source);
+    G_UNLOCK (virtual_clock);
+}
+
+static GSourceFuncs virtual_timeout_funcs = {
+    virtual_timeout_prepare,
+    virtual_timeout_check,
+    virtual_timeout_dispatch,
+    virtual_timeout_finalize,
+};
+
+static guint
+virtual_timeout_add (gint64      interval_us,
+                     GSourceFunc function,
+                     gpointer    data)
+{
+    VirtualTimeoutSource *self;
+    guint                 id;
+
+    self = (VirtualTimeoutSource *) g_source_new (&virtual_timeout_funcs, sizeof (VirtualTimeoutSource));
+    self->interval = interval_us;
+
+    G_LOCK (virtual_clock);
+    self->expiration = virtual_now + interval_us;
+    virtual_sources = g_list_prepend (virtual_sources, self);
+    G_UNLOCK (virtual_clock);
+
+    g_source_set_callback ((GSource *)self, function, data, NULL);
+    id = g_source_attach ((GSource *)self, NULL);
+    g_source_unref ((GSource *)self);
+    return id;
+}
+
+/*****************************************************************************/
+
+guint
+mm_clock_timeout_add (guint       interval_ms,
+                      GSourceFunc function,
+                      gpointer    data)
+{
+    if (!virtual_clock)
+        return g_timeout_add (interval_ms, function, data);
+    return virtual_timeout_add ((gint64) interval_ms * 1000, function, data);
+}
+
+guint
+mm_clock_timeout_add_seconds (guint       interval_secs,
+                              GSourceFunc function,
+                              gpointer    data)
+{
+    if (!virtual_clock)
+        return g_timeout_add_seconds (interval_secs, function, data);
+    return virtual_timeout_add ((gint64) interval_secs * G_USEC_PER_SEC, function, data);
+}
+
+gint64
+mm_clock_get_monotonic_time (void)
+{
+    gint64 now;
+
+    if (!virtual_clock)
+        return g_get_monotonic_time ();
+
+    G_LOCK (virtual_clock);
+    now = virtual_now;
+    G_UNLOCK (virtual_clock);
+    return now;
+}
+
+/*****************************************************************************/
+
+void
+mm_clock_enable_virtual (void)
+{
+    g_return_if_fail (!virtual_clock);
+
+    /* Start at the real time, so that timestamps look sane */
+    virtual_now = g_get_monotonic_time ();
+    virtual_clock = TRUE;
+}
+
+gboolean
+mm_clock_is_virtual (void)
+{
+    return virtual_clock;
+}
+
+/*****************************************************************************/
+
+gboolean
+mm_clock_advance_finish (GAsyncResult  *res,
+                         GError       **error)
+{
+    return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+/* Run in low priority, so that all the timeouts ready at the current time
+ * are dispatched before moving on to the next expiration; which also means
+ * that once the target time is reached, the advance is only completed in
+ * the next step, when the timeouts expiring at the target have run. */
+static gboolean
+advance_step (GTask *task)
+{
+    gint64   target;
+    gint64   next;
+    gboolean done;
+    GList   *l;
+
+    target = *((gint64 *) g_task_get_task_data (task));
+
+    G_LOCK (virtual_clock);
+    done = (virtual_now >= target);
+    if (!done) {
+        next = target;
+        for (l = virtual_sources; l; l = g_list_next (l)) {
+            VirtualTimeoutSource *source = l->data;
+
+            if (g_source_is_destroyed ((GSource *)source))
+                continue;
+            if (source->expiration > virtual_now && source->expiration < next)
+                next = source->expiration;
+        }
+        virtual_now = next;
+    }
+    G_UNLOCK (virtual_clock);
+
+    if (!done)
+        return G_SOURCE_CONTINUE;
+
+    advance_task = NULL;
+    g_task_return_boolean (task, TRUE);
+    g_object_unref (task);
+    return G_SOURCE_REMOVE;
+}
+
+void
+mm_clock_advance (guint64             ms,
+                  GAsyncReadyCallback callback,
+                  gpointer            user_data)
+{
+    GTask  *task;
+    gint64 *target;
+
+    task = g_task_new (NULL, NULL, callback, user_data);
+
+    if (!virtual_clock) {
+        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_UNSUPPORTED,
+                                 "Virtual clock not enabled");
+        g_object_unref (task);
+        return;
+    }
+
+    if (advance_task) {
+        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_IN_PROGRESS,
+                                 "Virtual clock already being advanced");
+        g_object_unref (task);
+        return;
+    }
+
+    target = g_new (gint64, 1);
+    G_LOCK (virtual_clock);
+    *target = virtual_now + (gint64) ms * 1000;
+    G_UNLOCK (virtual_clock);
+    g_task_set_task_data (task, target, g_free);
+
+    advance_task = task;
+    g_idle_add_full (G_PRIORITY_LOW, (GSourceFunc) advance_step, task, NULL);
+}
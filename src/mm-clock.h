@@ -0,0 +1,53 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#ifndef MM_CLOCK_H
+#define MM_CLOCK_H
+
+#include <glib.h>
+#include <gio/gio.h>
+
+/* Time source for the timeouts in the daemon.
+ *
+ * By default these are just the GLib timeouts. When the virtual clock is
+ * enabled, timeouts only expire when the clock is explicitly advanced, which
+ * allows running hours of timeout-driven logic (polling, probing, command
+ * timeouts...) in a few seconds and in a deterministic way.
+ *
+ * The returned ids are standard GSource ids in the default main context, so
+ * they are removed with g_source_remove() as usual. */
+
+guint    mm_clock_timeout_add         (guint       interval_ms,
+                                       GSourceFunc function,
+                                       gpointer    data);
+guint    mm_clock_timeout_add_seconds (guint       interval_secs,
+                                       GSourceFunc function,
+                                       gpointer    data);
+gint64   mm_clock_get_monotonic_time  (void);
+
+/* Virtual clock; must be enabled before any timeout is added. Advancing runs
+ * all timeouts expiring up to the new time, in order, and must be done by the
+ * owner of the default main context. I/O is not simulated, so while waiting
+ * for real I/O (e.g. a modem reply) the clock should be advanced in small
+ * steps to avoid spurious timeouts. */
+void     mm_clock_enable_virtual      (void);
+gboolean mm_clock_is_virtual          (void);
+void     mm_clock_advance             (guint64              ms,
+                                       GAsyncReadyCallback  callback,
+                                       gpointer             user_data);
+gboolean mm_clock_advance_finish      (GAsyncResult        *res,
+                                       GError             **error);
+
+#endif /* MM_CLOCK_H */
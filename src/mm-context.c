@@ -41,6 +41,7 @@ static gboolean      debug;
 static MMFilterRule  filter_policy = MM_FILTER_POLICY_DEFAULT;
 static gboolean      no_auto_scan = NO_AUTO_SCAN_DEFAULT;
 static const gchar  *initial_kernel_events;
+static MMContextInterface disabled_interfaces = MM_CONTEXT_INTERFACE_NONE;
 
 static gboolean
 filter_policy_option_arg (const gchar  *option_name,
@@ -74,6 +75,56 @@ filter_policy_option_arg (const gchar  *option_name,
     return FALSE;
 }
 
+static const struct {
+    const gchar        *name;
+    MMContextInterface  iface;
+} interface_names[] = {
+    { "3gpp-ussd", MM_CONTEXT_INTERFACE_3GPP_USSD },
+    { "location",  MM_CONTEXT_INTERFACE_LOCATION  },
+    { "messaging", MM_CONTEXT_INTERFACE_MESSAGING },
+    { "voice",     MM_CONTEXT_INTERFACE_VOICE     },
+    { "time",      MM_CONTEXT_INTERFACE_TIME      },
+    { "signal",    MM_CONTEXT_INTERFACE_SIGNAL    },
+    { "oma",       MM_CONTEXT_INTERFACE_OMA       },
+    { "firmware",  MM_CONTEXT_INTERFACE_FIRMWARE  },
+};
+
+static gboolean
+disable_interfaces_option_arg (const gchar  *option_name,
+                               const gchar  *value,
+                               gpointer      data,
+                               GError      **error)
+{
+    gchar **split;
+    guint   i;
+
+    split = g_strsplit (value, ",", -1);
+    for (i = 0; split[i]; i++) {
+        guint j;
+
+        g_strstrip (split[i]);
+        if (!split[i][0])
+            continue;
+
+        for (j = 0; j < G_N_ELEMENTS (interface_names); j++) {
+            if (!g_ascii_strcasecmp (split[i], interface_names[j].name)) {
+                disabled_interfaces |= interface_names[j].iface;
+                break;
+            }
+        }
+
+        if (j == G_N_ELEMENTS (interface_names)) {
+            g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                         "Invalid interface name given: %s",
+                         split[i]);
+            g_strfreev (split);
+            return FALSE;
+        }
+    }
+    g_strfreev (split);
+    return TRUE;
+}
+
 static const GOptionEntry entries[] = {
     {
         "filter-policy", 0, 0, G_OPTION_ARG_CALLBACK, filter_policy_option_arg,
@@ -90,6 +141,12 @@ static const GOptionEntry entries[] = {
         "Path to initial kernel events file",
         "[PATH]"
     },
+    {
+        "disable-interfaces", 0, 0, G_OPTION_ARG_CALLBACK, disable_interfaces_option_arg,
+        "Comma-separated list of modem interfaces never to be initialized: "
+        "3GPP-USSD, LOCATION, MESSAGING, VOICE, TIME, SIGNAL, OMA, FIRMWARE",
+        "[LIST]"
+    },
     {
         "debug", 0, 0, G_OPTION_ARG_NONE, &debug,
         "Run with extended debugging capabilities",
@@ -132,6 +189,12 @@ mm_context_get_filter_policy (void)
     return filter_policy;
 }
 
+gboolean
+mm_context_get_interface_disabled (MMContextInterface iface)
+{
+    return !!(disabled_interfaces & iface);
+}
+
 /*****************************************************************************/
 /* Log context */
 
@@ -140,6 +203,7 @@ static const gchar *log_file;
 static gboolean     log_journal;
 static gboolean     log_show_ts;
 static gboolean     log_rel_ts;
+static gchar       *log_qcdm_dir;
 
 static const GOptionEntry log_entries[] = {
     {
@@ -169,6 +233,11 @@ static const GOptionEntry log_entries[] = {
         "Use relative timestamps (from MM start)",
         NULL
     },
+    {
+        "log-qcdm-dir", 0, 0, G_OPTION_ARG_FILENAME, &log_qcdm_dir,
+        "Path to directory where to store QCDM diag logs of enabled modems",
+        "[PATH]"
+    },
     { NULL }
 };
 
@@ -216,12 +285,19 @@ mm_context_get_log_relative_timestamps (void)
     return log_rel_ts;
 }
 
+const gchar *
+mm_context_get_log_qcdm_dir (void)
+{
+    return log_qcdm_dir;
+}
+
 /*****************************************************************************/
 /* Test context */
 
 static gboolean  test_session;
 static gboolean  test_enable;
 static gchar    *test_plugin_dir;
+static gboolean  test_virtual_clock;
 
 static const GOptionEntry test_entries[] = {
     {
@@ -239,6 +315,11 @@ static const GOptionEntry test_entries[] = {
         "Path to look for plugins",
         "[PATH]"
     },
+    {
+        "test-virtual-clock", 0, 0, G_OPTION_ARG_NONE, &test_virtual_clock,
+        "Run timeouts on a virtual clock, advanced through the Test interface",
+        NULL
+    },
     { NULL }
 };
 
@@ -274,6 +355,12 @@ mm_context_get_test_plugin_dir (void)
     return test_plugin_dir ? test_plugin_dir : PLUGINDIR;
 }
 
+gboolean
+mm_context_get_test_virtual_clock (void)
+{
+    return test_virtual_clock;
+}
+
 /*****************************************************************************/
 
 static void
@@ -35,16 +35,33 @@ gboolean     mm_context_get_no_auto_scan          (void);
 /* Filter support */
 MMFilterRule mm_context_get_filter_policy (void);
 
+/* Optional modem interfaces that may be disabled */
+typedef enum {
+    MM_CONTEXT_INTERFACE_NONE      = 0,
+    MM_CONTEXT_INTERFACE_3GPP_USSD = 1 << 0,
+    MM_CONTEXT_INTERFACE_LOCATION  = 1 << 1,
+    MM_CONTEXT_INTERFACE_MESSAGING = 1 << 2,
+    MM_CONTEXT_INTERFACE_VOICE     = 1 << 3,
+    MM_CONTEXT_INTERFACE_TIME      = 1 << 4,
+    MM_CONTEXT_INTERFACE_SIGNAL    = 1 << 5,
+    MM_CONTEXT_INTERFACE_OMA       = 1 << 6,
+    MM_CONTEXT_INTERFACE_FIRMWARE  = 1 << 7,
+} MMContextInterface;
+
+gboolean mm_context_get_interface_disabled (MMContextInterface iface);
+
 /* Logging support */
 const gchar *mm_context_get_log_level               (void);
 const gchar *mm_context_get_log_file                (void);
 gboolean     mm_context_get_log_journal             (void);
 gboolean     mm_context_get_log_timestamps          (void);
 gboolean     mm_context_get_log_relative_timestamps (void);
+const gchar *mm_context_get_log_qcdm_dir            (void);
 
 /* Testing support */
-gboolean     mm_context_get_test_session    (void);
-gboolean     mm_context_get_test_enable     (void);
-const gchar *mm_context_get_test_plugin_dir (void);
+gboolean     mm_context_get_test_session       (void);
+gboolean     mm_context_get_test_enable        (void);
+const gchar *mm_context_get_test_plugin_dir    (void);
+gboolean     mm_context_get_test_virtual_clock (void);
 
 #endif /* MM_CONTEXT_H */
@@ -26,14 +26,65 @@
 #include "mm-iface-modem-3gpp-ussd.h"
 #include "mm-base-modem.h"
 #include "mm-modem-helpers.h"
+#include "mm-clock.h"
 #include "mm-log.h"
 
 #define SUPPORT_CHECKED_TAG "3gpp-ussd-support-checked-tag"
 #define SUPPORTED_TAG       "3gpp-ussd-supported-tag"
 
+/* Maximum number of Initiate() requests waiting for the ongoing session */
+#define MAX_QUEUED_INITIATE_REQUESTS 16
+
+/* Maximum time an Initiate() request may wait for the ongoing session, e.g.
+ * if it's waiting for a user response that never comes. Longer than the time
+ * an active session may wait for the network reply, so that requests queued
+ * behind an unresponsive network still get their turn. */
+#define QUEUED_INITIATE_REQUEST_TIMEOUT 120
+
 static GQuark support_checked_quark;
 static GQuark supported_quark;
 
+/*****************************************************************************/
+/* Private data context */
+
+#define PRIVATE_TAG "3gpp-ussd-private-tag"
+static GQuark private_quark;
+
+typedef struct {
+    /* Initiate() requests waiting for the ongoing session to finish */
+    GQueue *initiate_queue;
+    guint   initiate_queue_id;
+} Private;
+
+static void
+private_free (Private *priv)
+{
+    if (priv->initiate_queue_id)
+        g_source_remove (priv->initiate_queue_id);
+    /* Queued requests hold a full reference to the modem */
+    g_assert (g_queue_is_empty (priv->initiate_queue));
+    g_queue_free (priv->initiate_queue);
+    g_slice_free (Private, priv);
+}
+
+static Private *
+get_private (MMIfaceModem3gppUssd *self)
+{
+    Private *priv;
+
+    if (G_UNLIKELY (!private_quark))
+        private_quark = g_quark_from_static_string (PRIVATE_TAG);
+
+    priv = g_object_get_qdata (G_OBJECT (self), private_quark);
+    if (!priv) {
+        priv = g_slice_new0 (Private);
+        priv->initiate_queue = g_queue_new ();
+        g_object_set_qdata_full (G_OBJECT (self), private_quark, priv, (GDestroyNotify)private_free);
+    }
+
+    return priv;
+}
+
 /*****************************************************************************/
 
 void
@@ -176,6 +227,7 @@ typedef struct {
     GDBusMethodInvocation *invocation;
     MMIfaceModem3gppUssd *self;
     gchar *command;
+    gint64 request_time;
 } HandleRespondContext;
 
 static void
@@ -197,6 +249,9 @@ handle_respond_ready (MMIfaceModem3gppUssd *self,
     gchar *reply;
 
     reply = MM_IFACE_MODEM_3GPP_USSD_GET_INTERFACE (self)->send_finish (self, res, &error);
+    mm_dbg ("USSD respond request %s in %.3lfs",
+            reply ? "completed" : "failed",
+            (mm_clock_get_monotonic_time () - ctx->request_time) / (gdouble) G_USEC_PER_SEC);
     if (!reply)
         g_dbus_method_invocation_take_error (ctx->invocation, error);
     else {
@@ -266,6 +321,7 @@ handle_respond (MmGdbusModem3gppUssd *skeleton,
     ctx->invocation = g_object_ref (invocation);
     ctx->self = g_object_ref (self);
     ctx->command = g_strdup (command);
+    ctx->request_time = mm_clock_get_monotonic_time ();
 
     mm_base_modem_authorize (MM_BASE_MODEM (self),
                              invocation,
@@ -282,11 +338,16 @@ typedef struct {
     GDBusMethodInvocation *invocation;
     MMIfaceModem3gppUssd *self;
     gchar *command;
+    gint64 request_time;
+    gint64 send_time;
+    guint queue_timeout_id;
 } HandleInitiateContext;
 
 static void
 handle_initiate_context_free (HandleInitiateContext *ctx)
 {
+    if (ctx->queue_timeout_id)
+        g_source_remove (ctx->queue_timeout_id);
     g_object_unref (ctx->skeleton);
     g_object_unref (ctx->invocation);
     g_object_unref (ctx->self);
@@ -294,6 +355,8 @@ handle_initiate_context_free (HandleInitiateContext *ctx)
     g_free (ctx);
 }
 
+static void initiate_queue_schedule (MMIfaceModem3gppUssd *self);
+
 static void
 handle_initiate_ready (MMIfaceModem3gppUssd *self,
                        GAsyncResult *res,
@@ -303,6 +366,10 @@ handle_initiate_ready (MMIfaceModem3gppUssd *self,
     gchar *reply;
 
     reply = MM_IFACE_MODEM_3GPP_USSD_GET_INTERFACE (self)->send_finish (self, res, &error);
+    mm_dbg ("USSD initiate request %s in %.3lfs (%.3lfs queued)",
+            reply ? "completed" : "failed",
+            (mm_clock_get_monotonic_time () - ctx->request_time) / (gdouble) G_USEC_PER_SEC,
+            (ctx->send_time - ctx->request_time) / (gdouble) G_USEC_PER_SEC);
     if (!reply)
         g_dbus_method_invocation_take_error (ctx->invocation, error);
     else {
@@ -311,7 +378,102 @@ handle_initiate_ready (MMIfaceModem3gppUssd *self,
                                                    reply);
         g_free (reply);
     }
+
+    /* If the session is over, let the next queued request go */
+    initiate_queue_schedule (self);
+    handle_initiate_context_free (ctx);
+}
+
+static void
+handle_initiate_send (HandleInitiateContext *ctx)
+{
+    ctx->send_time = mm_clock_get_monotonic_time ();
+    MM_IFACE_MODEM_3GPP_USSD_GET_INTERFACE (ctx->self)->send (
+        ctx->self,
+        ctx->command,
+        (GAsyncReadyCallback)handle_initiate_ready,
+        ctx);
+}
+
+static gboolean
+initiate_queue_process (MMIfaceModem3gppUssd *self)
+{
+    Private *priv;
+    HandleInitiateContext *ctx;
+
+    priv = get_private (self);
+    priv->initiate_queue_id = 0;
+
+    /* Only one session at a time; if there is still one ongoing, we'll be
+     * scheduled again once it's back to idle */
+    if (mm_iface_modem_3gpp_ussd_get_state (self) != MM_MODEM_3GPP_USSD_SESSION_STATE_IDLE)
+        return G_SOURCE_REMOVE;
+
+    ctx = g_queue_pop_head (priv->initiate_queue);
+    if (ctx) {
+        g_source_remove (ctx->queue_timeout_id);
+        ctx->queue_timeout_id = 0;
+        mm_dbg ("Running queued USSD initiate request (%u still queued)",
+                g_queue_get_length (priv->initiate_queue));
+        handle_initiate_send (ctx);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static void
+initiate_queue_schedule (MMIfaceModem3gppUssd *self)
+{
+    Private *priv;
+
+    priv = get_private (self);
+    if (priv->initiate_queue_id || g_queue_is_empty (priv->initiate_queue))
+        return;
+
+    /* Always from an idle, so that whoever reported the state change is done
+     * before a new session is started */
+    priv->initiate_queue_id = g_idle_add ((GSourceFunc)initiate_queue_process, self);
+}
+
+static gboolean
+initiate_queue_timeout (HandleInitiateContext *ctx)
+{
+    Private *priv;
+
+    priv = get_private (ctx->self);
+    ctx->queue_timeout_id = 0;
+
+    g_queue_remove (priv->initiate_queue, ctx);
+    mm_dbg ("Queued USSD initiate request timed out (%u still queued)",
+            g_queue_get_length (priv->initiate_queue));
+    g_dbus_method_invocation_return_error (ctx->invocation,
+                                           MM_CORE_ERROR,
+                                           MM_CORE_ERROR_RETRY,
+                                           "Cannot initiate USSD: "
+                                           "timed out waiting for the ongoing session");
     handle_initiate_context_free (ctx);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+initiate_queue_flush (MMIfaceModem3gppUssd *self)
+{
+    Private *priv;
+    HandleInitiateContext *ctx;
+
+    priv = get_private (self);
+    if (priv->initiate_queue_id) {
+        g_source_remove (priv->initiate_queue_id);
+        priv->initiate_queue_id = 0;
+    }
+
+    while ((ctx = g_queue_pop_head (priv->initiate_queue)) != NULL) {
+        g_dbus_method_invocation_return_error (ctx->invocation,
+                                               MM_CORE_ERROR,
+                                               MM_CORE_ERROR_ABORTED,
+                                               "Cannot initiate USSD: "
+                                               "interface no longer available");
+        handle_initiate_context_free (ctx);
+    }
 }
 
 static void
@@ -320,6 +482,7 @@ handle_initiate_auth_ready (MMBaseModem *self,
                             HandleInitiateContext *ctx)
 {
     GError *error = NULL;
+    Private *priv;
 
     if (!mm_base_modem_authorize_finish (self, res, &error) ||
         !ensure_enabled (self, &error)) {
@@ -331,22 +494,33 @@ handle_initiate_auth_ready (MMBaseModem *self,
     g_assert (MM_IFACE_MODEM_3GPP_USSD_GET_INTERFACE (self)->send != NULL);
     g_assert (MM_IFACE_MODEM_3GPP_USSD_GET_INTERFACE (self)->send_finish != NULL);
 
+    priv = get_private (MM_IFACE_MODEM_3GPP_USSD (self));
+
     switch (mm_gdbus_modem3gpp_ussd_get_state (ctx->skeleton)) {
+    case MM_MODEM_3GPP_USSD_SESSION_STATE_IDLE:
+        if (g_queue_is_empty (priv->initiate_queue)) {
+            handle_initiate_send (ctx);
+            return;
+        }
+        /* Fall through, and wait for the requests queued before this one */
+
     case MM_MODEM_3GPP_USSD_SESSION_STATE_ACTIVE:
     case MM_MODEM_3GPP_USSD_SESSION_STATE_USER_RESPONSE:
-        g_dbus_method_invocation_return_error (ctx->invocation,
-                                               MM_CORE_ERROR,
-                                               MM_CORE_ERROR_WRONG_STATE,
-                                               "Cannot initiate USSD: "
-                                               "a session is already active");
-        break;
-
-    case MM_MODEM_3GPP_USSD_SESSION_STATE_IDLE:
-        MM_IFACE_MODEM_3GPP_USSD_GET_INTERFACE (self)->send (
-            MM_IFACE_MODEM_3GPP_USSD (self),
-            ctx->command,
-            (GAsyncReadyCallback)handle_initiate_ready,
-            ctx);
+        if (g_queue_get_length (priv->initiate_queue) >= MAX_QUEUED_INITIATE_REQUESTS) {
+            g_dbus_method_invocation_return_error (ctx->invocation,
+                                                   MM_CORE_ERROR,
+                                                   MM_CORE_ERROR_RETRY,
+                                                   "Cannot initiate USSD: "
+                                                   "too many requests queued");
+            break;
+        }
+        ctx->queue_timeout_id = mm_clock_timeout_add_seconds (QUEUED_INITIATE_REQUEST_TIMEOUT,
+                                                              (GSourceFunc)initiate_queue_timeout,
+                                                              ctx);
+        g_queue_push_tail (priv->initiate_queue, ctx);
+        mm_dbg ("Queued USSD initiate request (%u queued)",
+                g_queue_get_length (priv->initiate_queue));
+        initiate_queue_schedule (MM_IFACE_MODEM_3GPP_USSD (self));
         return;
 
     case MM_MODEM_3GPP_USSD_SESSION_STATE_UNKNOWN:
@@ -367,11 +541,12 @@ handle_initiate (MmGdbusModem3gppUssd *skeleton,
 {
     HandleInitiateContext *ctx;
 
-    ctx = g_new (HandleInitiateContext, 1);
+    ctx = g_new0 (HandleInitiateContext, 1);
     ctx->skeleton = g_object_ref (skeleton);
     ctx->invocation = g_object_ref (invocation);
     ctx->self = g_object_ref (self);
     ctx->command = g_strdup (command);
+    ctx->request_time = mm_clock_get_monotonic_time ();
 
     mm_base_modem_authorize (MM_BASE_MODEM (self),
                              invocation,
@@ -440,6 +615,13 @@ mm_iface_modem_3gpp_ussd_update_state (MMIfaceModem3gppUssd *self,
         mm_gdbus_modem3gpp_ussd_set_state (skeleton, new_state);
 
     g_object_unref (skeleton);
+
+    /* Queued Initiate() requests go once the session is over, and are
+     * discarded if the interface is no longer usable */
+    if (new_state == MM_MODEM_3GPP_USSD_SESSION_STATE_IDLE)
+        initiate_queue_schedule (self);
+    else if (new_state == MM_MODEM_3GPP_USSD_SESSION_STATE_UNKNOWN)
+        initiate_queue_flush (self);
 }
 
 void
@@ -961,6 +1143,8 @@ mm_iface_modem_3gpp_ussd_initialize (MMIfaceModem3gppUssd *self,
 void
 mm_iface_modem_3gpp_ussd_shutdown (MMIfaceModem3gppUssd *self)
 {
+    initiate_queue_flush (self);
+
     /* Unexport DBus interface and remove the skeleton */
     mm_gdbus_object_skeleton_set_modem3gpp_ussd (MM_GDBUS_OBJECT_SKELETON (self), NULL);
     g_object_set (self,
@@ -27,6 +27,7 @@
 #include "mm-modem-helpers.h"
 #include "mm-error-helpers.h"
 #include "mm-log.h"
+#include "mm-clock.h"
 
 #define REGISTRATION_CHECK_TIMEOUT_SEC 30
 
@@ -208,16 +209,13 @@ typedef struct {
     MmGdbusModem3gpp *skeleton;
     GCancellable *cancellable;
     gchar *operator_id;
-    GTimer *timer;
+    gint64 start_time;
     guint max_registration_time;
 } RegisterInNetworkContext;
 
 static void
 register_in_network_context_free (RegisterInNetworkContext *ctx)
 {
-    if (ctx->timer)
-        g_timer_destroy (ctx->timer);
-
     if (ctx->cancellable) {
         RegistrationStateContext *registration_state_context;
 
@@ -327,7 +325,7 @@ run_registration_checks_ready (MMIfaceModem3gpp *self,
     }
 
     /* Don't spend too much time waiting to get registered */
-    if (g_timer_elapsed (ctx->timer, NULL) > ctx->max_registration_time) {
+    if ((mm_clock_get_monotonic_time () - ctx->start_time) > ((gint64) ctx->max_registration_time * G_USEC_PER_SEC)) {
         mm_dbg ("3GPP registration check timed out");
         register_in_network_context_complete_failed (
             task,
@@ -342,7 +340,7 @@ run_registration_checks_ready (MMIfaceModem3gpp *self,
      * well.
      */
     mm_dbg ("Modem not yet registered in a 3GPP network... will recheck soon");
-    g_timeout_add_seconds (3, (GSourceFunc)run_registration_checks_again, task);
+    mm_clock_timeout_add_seconds (3, (GSourceFunc)run_registration_checks_again, task);
 }
 
 static void
@@ -464,7 +462,7 @@ mm_iface_modem_3gpp_register_in_network (MMIfaceModem3gpp *self,
     registration_state_context->pending_registration_cancellable =
         g_object_ref (ctx->cancellable);
 
-    ctx->timer = g_timer_new ();
+    ctx->start_time = mm_clock_get_monotonic_time ();
     MM_IFACE_MODEM_3GPP_GET_INTERFACE (self)->register_in_network (
         self,
         ctx->operator_id,
@@ -1606,9 +1604,9 @@ periodic_registration_check_enable (MMIfaceModem3gpp *self)
     /* Create context and keep it as object data */
     mm_dbg ("Periodic 3GPP registration checks enabled");
     ctx = g_new0 (RegistrationCheckContext, 1);
-    ctx->timeout_source = g_timeout_add_seconds (REGISTRATION_CHECK_TIMEOUT_SEC,
-                                                 (GSourceFunc)periodic_registration_check,
-                                                 self);
+    ctx->timeout_source = mm_clock_timeout_add_seconds (REGISTRATION_CHECK_TIMEOUT_SEC,
+                                                        (GSourceFunc)periodic_registration_check,
+                                                        self);
     g_object_set_qdata_full (G_OBJECT (self),
                              registration_check_context_quark,
                              ctx,
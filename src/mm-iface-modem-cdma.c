@@ -24,8 +24,12 @@
 #include "mm-base-modem.h"
 #include "mm-modem-helpers.h"
 #include "mm-log.h"
+#include "mm-clock.h"
 
 #define REGISTRATION_CHECK_TIMEOUT_SEC 30
+/* Fallback polling when all registration changes (1x and EV-DO) are also
+ * reported by the modem */
+#define REGISTRATION_CHECK_MONITORED_TIMEOUT_SEC 180
 
 #define SUBSYSTEM_CDMA1X "cdma1x"
 #define SUBSYSTEM_EVDO "evdo"
@@ -1196,6 +1200,8 @@ static void
 periodic_registration_check_enable (MMIfaceModemCdma *self)
 {
     RegistrationCheckContext *ctx;
+    gboolean monitored = FALSE;
+    guint interval;
 
     if (G_UNLIKELY (!registration_check_context_quark))
         registration_check_context_quark = (g_quark_from_static_string (
@@ -1207,12 +1213,19 @@ periodic_registration_check_enable (MMIfaceModemCdma *self)
     if (ctx)
         return;
 
+    /* When the modem reports all changes on its own, polling is only needed
+     * as a safety net */
+    g_object_get (self,
+                  MM_IFACE_MODEM_CDMA_REGISTRATION_MONITORED, &monitored,
+                  NULL);
+    interval = monitored ? REGISTRATION_CHECK_MONITORED_TIMEOUT_SEC : REGISTRATION_CHECK_TIMEOUT_SEC;
+
     /* Create context and keep it as object data */
-    mm_dbg ("Periodic CDMA registration checks enabled");
+    mm_dbg ("Periodic CDMA registration checks enabled (every %u seconds)", interval);
     ctx = g_new0 (RegistrationCheckContext, 1);
-    ctx->timeout_source = g_timeout_add_seconds (REGISTRATION_CHECK_TIMEOUT_SEC,
-                                                 (GSourceFunc)periodic_registration_check,
-                                                 self);
+    ctx->timeout_source = mm_clock_timeout_add_seconds (interval,
+                                                        (GSourceFunc)periodic_registration_check,
+                                                        self);
     g_object_set_qdata_full (G_OBJECT (self),
                              registration_check_context_quark,
                              ctx,
@@ -1890,6 +1903,14 @@ iface_modem_cdma_init (gpointer g_iface)
                                "Whether the modem works in the EV-DO network",
                                TRUE,
                                G_PARAM_READWRITE));
+
+    g_object_interface_install_property
+        (g_iface,
+         g_param_spec_boolean (MM_IFACE_MODEM_CDMA_REGISTRATION_MONITORED,
+                               "Registration monitored",
+                               "Whether all registration changes are reported by the modem without polling",
+                               FALSE,
+                               G_PARAM_READWRITE));
     initialized = TRUE;
 }
 
@@ -103,6 +103,26 @@ get_location_context (MMIfaceModemLocation *self)
     return ctx;
 }
 
+gsize
+mm_iface_modem_location_get_gps_nmea_size (MMIfaceModemLocation *self)
+{
+    LocationContext *ctx;
+    gchar           *full;
+    gsize            size;
+
+    /* Don't create the context if not already there */
+    if (!location_context_quark)
+        return 0;
+    ctx = g_object_get_qdata (G_OBJECT (self), location_context_quark);
+    if (!ctx || !ctx->location_gps_nmea)
+        return 0;
+
+    full = mm_location_gps_nmea_build_full (ctx->location_gps_nmea);
+    size = full ? strlen (full) : 0;
+    g_free (full);
+    return size;
+}
+
 /*****************************************************************************/
 
 static GVariant *
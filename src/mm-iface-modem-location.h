@@ -156,6 +156,9 @@ void mm_iface_modem_location_cdma_bs_update (MMIfaceModemLocation *self,
                                              gdouble latitude);
 void mm_iface_modem_location_cdma_bs_clear (MMIfaceModemLocation *self);
 
+/* Size of the GPS NMEA traces currently kept */
+gsize mm_iface_modem_location_get_gps_nmea_size (MMIfaceModemLocation *self);
+
 /* Bind properties for simple GetStatus() */
 void mm_iface_modem_location_bind_simple_status (MMIfaceModemLocation *self,
                                                  MMSimpleStatus *status);
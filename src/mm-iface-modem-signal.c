@@ -20,6 +20,7 @@
 #include "mm-iface-modem.h"
 #include "mm-iface-modem-signal.h"
 #include "mm-log.h"
+#include "mm-clock.h"
 
 #define SUPPORT_CHECKED_TAG "signal-support-checked-tag"
 #define SUPPORTED_TAG       "signal-supported-tag"
@@ -240,7 +241,7 @@ setup_refresh_context (MMIfaceModemSignal *self,
     ctx->rate = new_rate;
     if (ctx->timeout_source)
         g_source_remove (ctx->timeout_source);
-    ctx->timeout_source = g_timeout_add_seconds (ctx->rate, (GSourceFunc) refresh_context_cb, self);
+    ctx->timeout_source = mm_clock_timeout_add_seconds (ctx->rate, (GSourceFunc) refresh_context_cb, self);
 
     /* Also launch right away */
     refresh_context_cb (self);
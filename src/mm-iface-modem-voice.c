@@ -20,14 +20,67 @@
 #include "mm-iface-modem.h"
 #include "mm-iface-modem-voice.h"
 #include "mm-call-list.h"
+#include "mm-modem-helpers.h"
 #include "mm-log.h"
+#include "mm-clock.h"
 
 #define SUPPORT_CHECKED_TAG "voice-support-checked-tag"
 #define SUPPORTED_TAG       "voice-supported-tag"
 
+/* While there are calls in progress, the call list is also reloaded
+ * periodically, so that no state change is missed */
+#define CALL_LIST_POLLING_TIMEOUT_SECS 5
+
 static GQuark support_checked_quark;
 static GQuark supported_quark;
 
+/*****************************************************************************/
+/* Private data context */
+
+#define PRIVATE_TAG "voice-private-tag"
+static GQuark private_quark;
+
+typedef enum {
+    FEATURE_UNKNOWN,
+    FEATURE_UNSUPPORTED,
+    FEATURE_SUPPORTED,
+} Feature;
+
+typedef struct {
+    /* Call list reloading; requests received while one is ongoing are
+     * coalesced into a single new one */
+    Feature  call_list_reload;
+    gboolean call_list_reload_ongoing;
+    gboolean call_list_reload_pending;
+    guint    call_list_polling_id;
+} Private;
+
+static void
+private_free (Private *priv)
+{
+    if (priv->call_list_polling_id)
+        g_source_remove (priv->call_list_polling_id);
+    g_slice_free (Private, priv);
+}
+
+static Private *
+get_private (MMIfaceModemVoice *self)
+{
+    Private *priv;
+
+    if (G_UNLIKELY (!private_quark))
+        private_quark = g_quark_from_static_string (PRIVATE_TAG);
+
+    priv = g_object_get_qdata (G_OBJECT (self), private_quark);
+    if (!priv) {
+        priv = g_slice_new0 (Private);
+        priv->call_list_reload = FEATURE_UNKNOWN;
+        g_object_set_qdata_full (G_OBJECT (self), private_quark, priv, (GDestroyNotify)private_free);
+    }
+
+    return priv;
+}
+
 /*****************************************************************************/
 
 void
@@ -114,6 +167,276 @@ mm_iface_modem_voice_report_incoming_call (MMIfaceModemVoice *self,
     g_object_unref (list);
 }
 
+/*****************************************************************************/
+/* Full call list reconciliation */
+
+typedef struct {
+    MMCallDirection  direction;
+    MMBaseCall      *found;
+} FindUnindexedContext;
+
+static void
+find_unindexed_call (MMBaseCall           *call,
+                     FindUnindexedContext *ctx)
+{
+    MMCallState state;
+
+    if (ctx->found ||
+        mm_gdbus_call_get_direction (MM_GDBUS_CALL (call)) != ctx->direction)
+        return;
+
+    /* Incoming calls reported via RING/CLIP, or outgoing calls that we
+     * started ourselves */
+    state = mm_gdbus_call_get_state (MM_GDBUS_CALL (call));
+    if ((ctx->direction == MM_CALL_DIRECTION_INCOMING &&
+         (state == MM_CALL_STATE_RINGING_IN || state == MM_CALL_STATE_WAITING)) ||
+        (ctx->direction == MM_CALL_DIRECTION_OUTGOING &&
+         (state == MM_CALL_STATE_DIALING || state == MM_CALL_STATE_RINGING_OUT || state == MM_CALL_STATE_ACTIVE)))
+        ctx->found = call;
+}
+
+static MMCallStateReason
+call_state_reason (MMCallState old_state,
+                   MMCallState new_state)
+{
+    if (new_state == MM_CALL_STATE_ACTIVE &&
+        (old_state == MM_CALL_STATE_RINGING_IN ||
+         old_state == MM_CALL_STATE_WAITING ||
+         old_state == MM_CALL_STATE_DIALING ||
+         old_state == MM_CALL_STATE_RINGING_OUT))
+        return MM_CALL_STATE_REASON_ACCEPTED;
+    if (new_state == MM_CALL_STATE_TERMINATED)
+        return MM_CALL_STATE_REASON_TERMINATED;
+    return MM_CALL_STATE_REASON_UNKNOWN;
+}
+
+static void
+terminate_unmatched_call (MMBaseCall *call,
+                          GHashTable *matched)
+{
+    MMCallState state;
+
+    if (g_hash_table_contains (matched, call))
+        return;
+
+    state = mm_gdbus_call_get_state (MM_GDBUS_CALL (call));
+    if (state != MM_CALL_STATE_UNKNOWN && state != MM_CALL_STATE_TERMINATED) {
+        /* Outgoing calls we're still starting may not be listed yet */
+        if (mm_base_call_get_index (call) == 0 &&
+            mm_gdbus_call_get_direction (MM_GDBUS_CALL (call)) == MM_CALL_DIRECTION_OUTGOING)
+            return;
+        mm_base_call_change_state (call, MM_CALL_STATE_TERMINATED, MM_CALL_STATE_REASON_TERMINATED);
+    }
+
+    /* The index may be reused by a new call */
+    if (mm_base_call_get_index (call) != 0)
+        mm_base_call_set_index (call, 0);
+}
+
+void
+mm_iface_modem_voice_report_all_calls (MMIfaceModemVoice *self,
+                                       GList             *call_info_list)
+{
+    MMCallList *list = NULL;
+    GHashTable *matched;
+    GList      *l;
+
+    g_object_get (MM_BASE_MODEM (self),
+                  MM_IFACE_MODEM_VOICE_CALL_LIST, &list,
+                  NULL);
+    if (!list) {
+        /* e.g. if disabled while reloading */
+        mm_dbg ("Cannot report all calls: missing call list");
+        return;
+    }
+
+    mm_dbg ("Reconciling call list: %u calls reported", g_list_length (call_info_list));
+
+    /* Update the state of all reported calls, creating new ones as needed */
+    matched = g_hash_table_new (g_direct_hash, g_direct_equal);
+    for (l = call_info_list; l; l = g_list_next (l)) {
+        MMCallInfo  *info = l->data;
+        MMBaseCall  *call;
+        MMCallState  state;
+
+        /* A known index being used by a different call means the one we
+         * had tracked is gone */
+        call = mm_call_list_get_call_by_index (list, info->index);
+        if (call &&
+            (mm_gdbus_call_get_direction (MM_GDBUS_CALL (call)) != info->direction ||
+             mm_gdbus_call_get_state (MM_GDBUS_CALL (call)) == MM_CALL_STATE_TERMINATED)) {
+            terminate_unmatched_call (call, matched);
+            call = NULL;
+        }
+
+        if (!call) {
+            FindUnindexedContext ctx = { info->direction, NULL };
+
+            mm_call_list_foreach_unindexed (list, (MMCallListForeachFunc)find_unindexed_call, &ctx);
+            call = ctx.found;
+            if (call)
+                mm_base_call_set_index (call, info->index);
+        }
+
+        if (!call) {
+            mm_dbg ("Creating new %s call (index %u)...",
+                    mm_call_direction_get_string (info->direction), info->index);
+            g_assert (MM_IFACE_MODEM_VOICE_GET_INTERFACE (self)->create_call != NULL);
+            call = MM_IFACE_MODEM_VOICE_GET_INTERFACE (self)->create_call (self, info->direction, info->number);
+            mm_base_call_set_index (call, info->index);
+            mm_base_call_change_state (call, info->state,
+                                       (info->direction == MM_CALL_DIRECTION_INCOMING ?
+                                        MM_CALL_STATE_REASON_INCOMING_NEW :
+                                        MM_CALL_STATE_REASON_OUTGOING_STARTED));
+            mm_base_call_export (call);
+            mm_call_list_add_call (list, call);
+            g_object_unref (call);
+        }
+
+        g_hash_table_add (matched, call);
+
+        if (info->number && !mm_gdbus_call_get_number (MM_GDBUS_CALL (call)))
+            mm_gdbus_call_set_number (MM_GDBUS_CALL (call), info->number);
+
+        state = mm_gdbus_call_get_state (MM_GDBUS_CALL (call));
+        if (state != info->state)
+            mm_base_call_change_state (call, info->state, call_state_reason (state, info->state));
+
+        /* Keep the validity timeout of ringing calls alive while listed */
+        if (info->state == MM_CALL_STATE_RINGING_IN)
+            mm_base_call_incoming_refresh (call);
+    }
+
+    /* And terminate all the ones not reported */
+    mm_call_list_foreach (list, (MMCallListForeachFunc)terminate_unmatched_call, matched);
+
+    g_hash_table_unref (matched);
+    g_object_unref (list);
+}
+
+static void
+count_calls_in_progress (MMBaseCall *call,
+                         guint      *n_calls)
+{
+    MMCallState state;
+
+    state = mm_gdbus_call_get_state (MM_GDBUS_CALL (call));
+    if (state != MM_CALL_STATE_UNKNOWN && state != MM_CALL_STATE_TERMINATED)
+        (*n_calls)++;
+}
+
+static void reload_all_calls (MMIfaceModemVoice *self);
+
+static gboolean
+call_list_polling_cb (MMIfaceModemVoice *self)
+{
+    Private *priv;
+
+    priv = get_private (self);
+    priv->call_list_polling_id = 0;
+    reload_all_calls (self);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+stop_call_list_polling (MMIfaceModemVoice *self)
+{
+    Private *priv;
+
+    priv = get_private (self);
+    if (priv->call_list_polling_id) {
+        g_source_remove (priv->call_list_polling_id);
+        priv->call_list_polling_id = 0;
+    }
+}
+
+static void
+update_call_list_polling (MMIfaceModemVoice *self)
+{
+    Private    *priv;
+    MMCallList *list = NULL;
+    guint       n_calls = 0;
+
+    priv = get_private (self);
+
+    g_object_get (MM_BASE_MODEM (self),
+                  MM_IFACE_MODEM_VOICE_CALL_LIST, &list,
+                  NULL);
+    if (list) {
+        mm_call_list_foreach (list, (MMCallListForeachFunc)count_calls_in_progress, &n_calls);
+        g_object_unref (list);
+    }
+
+    if (!n_calls) {
+        stop_call_list_polling (self);
+        return;
+    }
+
+    if (!priv->call_list_polling_id)
+        priv->call_list_polling_id = mm_clock_timeout_add_seconds (CALL_LIST_POLLING_TIMEOUT_SECS,
+                                                                   (GSourceFunc)call_list_polling_cb,
+                                                                   self);
+}
+
+static void
+load_call_list_ready (MMIfaceModemVoice *self,
+                      GAsyncResult      *res)
+{
+    Private *priv;
+    GList   *call_info_list = NULL;
+    GError  *error = NULL;
+
+    priv = get_private (self);
+    priv->call_list_reload_ongoing = FALSE;
+
+    if (!MM_IFACE_MODEM_VOICE_GET_INTERFACE (self)->load_call_list_finish (self, res, &call_info_list, &error)) {
+        mm_dbg ("Couldn't reload call list: %s", error->message);
+        g_error_free (error);
+    } else {
+        mm_iface_modem_voice_report_all_calls (self, call_info_list);
+        mm_voice_call_info_list_free (call_info_list);
+    }
+
+    /* Another event happened while we were reloading, go again */
+    if (priv->call_list_reload_pending) {
+        priv->call_list_reload_pending = FALSE;
+        reload_all_calls (self);
+    } else
+        update_call_list_polling (self);
+
+    g_object_unref (self);
+}
+
+static void
+reload_all_calls (MMIfaceModemVoice *self)
+{
+    Private *priv;
+
+    priv = get_private (self);
+    if (priv->call_list_reload_ongoing) {
+        priv->call_list_reload_pending = TRUE;
+        return;
+    }
+
+    priv->call_list_reload_ongoing = TRUE;
+    MM_IFACE_MODEM_VOICE_GET_INTERFACE (self)->load_call_list (
+        self,
+        (GAsyncReadyCallback)load_call_list_ready,
+        g_object_ref (self));
+}
+
+gboolean
+mm_iface_modem_voice_reload_all_calls (MMIfaceModemVoice *self)
+{
+    if (!MM_IFACE_MODEM_VOICE_GET_INTERFACE (self)->load_call_list ||
+        !MM_IFACE_MODEM_VOICE_GET_INTERFACE (self)->load_call_list_finish ||
+        get_private (self)->call_list_reload != FEATURE_SUPPORTED)
+        return FALSE;
+
+    reload_all_calls (self);
+    return TRUE;
+}
+
 /*****************************************************************************/
 
 typedef struct {
@@ -517,6 +840,9 @@ interface_disabling_step (GTask *task)
         ctx->step++;
 
     case DISABLING_STEP_LAST:
+        /* Stop call list polling */
+        stop_call_list_polling (self);
+
         /* Clear CALL list */
         g_object_set (self,
                       MM_IFACE_MODEM_VOICE_CALL_LIST, NULL,
@@ -569,6 +895,7 @@ typedef enum {
     ENABLING_STEP_FIRST,
     ENABLING_STEP_SETUP_UNSOLICITED_EVENTS,
     ENABLING_STEP_ENABLE_UNSOLICITED_EVENTS,
+    ENABLING_STEP_LOAD_CALL_LIST,
     ENABLING_STEP_LAST
 } EnablingStep;
 
@@ -635,6 +962,37 @@ enable_unsolicited_events_ready (MMIfaceModemVoice *self,
     interface_enabling_step (task);
 }
 
+static void
+enabling_load_call_list_ready (MMIfaceModemVoice *self,
+                               GAsyncResult      *res,
+                               GTask             *task)
+{
+    EnablingContext *ctx;
+    Private         *priv;
+    GList           *call_info_list = NULL;
+    GError          *error = NULL;
+
+    priv = get_private (self);
+
+    /* Not fatal; calls will be tracked from the individual events */
+    if (!MM_IFACE_MODEM_VOICE_GET_INTERFACE (self)->load_call_list_finish (self, res, &call_info_list, &error)) {
+        mm_dbg ("Call list loading unsupported: %s", error->message);
+        priv->call_list_reload = FEATURE_UNSUPPORTED;
+        g_error_free (error);
+    } else {
+        mm_dbg ("Call list loading supported: calls will be reconciled");
+        priv->call_list_reload = FEATURE_SUPPORTED;
+        mm_iface_modem_voice_report_all_calls (self, call_info_list);
+        mm_voice_call_info_list_free (call_info_list);
+        update_call_list_polling (self);
+    }
+
+    /* Go on with next step */
+    ctx = g_task_get_task_data (task);
+    ctx->step++;
+    interface_enabling_step (task);
+}
+
 static void
 interface_enabling_step (GTask *task)
 {
@@ -701,6 +1059,20 @@ interface_enabling_step (GTask *task)
         /* Fall down to next step */
         ctx->step++;
 
+    case ENABLING_STEP_LOAD_CALL_LIST:
+        /* Sync with the calls already in the modem, and find out whether
+         * the full call list can be used to track call states */
+        if (MM_IFACE_MODEM_VOICE_GET_INTERFACE (self)->load_call_list &&
+            MM_IFACE_MODEM_VOICE_GET_INTERFACE (self)->load_call_list_finish) {
+            MM_IFACE_MODEM_VOICE_GET_INTERFACE (self)->load_call_list (
+                self,
+                (GAsyncReadyCallback)enabling_load_call_list_ready,
+                task);
+            return;
+        }
+        /* Fall down to next step */
+        ctx->step++;
+
     case ENABLING_STEP_LAST:
         /* We are done without errors! */
         g_task_return_boolean (task, TRUE);
@@ -936,6 +1308,8 @@ mm_iface_modem_voice_initialize (MMIfaceModemVoice *self,
 void
 mm_iface_modem_voice_shutdown (MMIfaceModemVoice *self)
 {
+    stop_call_list_polling (self);
+
     /* Unexport DBus interface and remove the skeleton */
     mm_gdbus_object_skeleton_set_modem_voice (MM_GDBUS_OBJECT_SKELETON (self), NULL);
     g_object_set (self,
@@ -81,6 +81,15 @@ struct _MMIfaceModemVoice {
     MMBaseCall * (* create_call) (MMIfaceModemVoice *self,
                                   MMCallDirection    direction,
                                   const gchar       *number);
+
+    /* Load full list of calls (async); list of MMCallInfo */
+    void     (* load_call_list)        (MMIfaceModemVoice    *self,
+                                        GAsyncReadyCallback   callback,
+                                        gpointer              user_data);
+    gboolean (* load_call_list_finish) (MMIfaceModemVoice    *self,
+                                        GAsyncResult         *res,
+                                        GList               **call_info_list,
+                                        GError              **error);
 };
 
 GType mm_iface_modem_voice_get_type (void);
@@ -122,4 +131,13 @@ void mm_iface_modem_voice_bind_simple_status (MMIfaceModemVoice *self,
 void mm_iface_modem_voice_report_incoming_call (MMIfaceModemVoice *self,
                                                 const gchar       *number);
 
+/* Full call list reconciliation; the list of MMCallInfo given is compared
+ * against the tracked calls, and all call states updated in one go. If the
+ * call list can be reloaded, events affecting any call should just request
+ * a reload; FALSE is returned otherwise, and the event should be processed
+ * by the caller. */
+void     mm_iface_modem_voice_report_all_calls (MMIfaceModemVoice *self,
+                                                GList             *call_info_list);
+gboolean mm_iface_modem_voice_reload_all_calls (MMIfaceModemVoice *self);
+
 #endif /* MM_IFACE_MODEM_VOICE_H */
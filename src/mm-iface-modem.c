@@ -27,6 +27,7 @@
 #include "mm-base-sim.h"
 #include "mm-bearer-list.h"
 #include "mm-log.h"
+#include "mm-clock.h"
 #include "mm-context.h"
 
 #define SIGNAL_QUALITY_RECENT_TIMEOUT_SEC 60
@@ -1113,7 +1114,7 @@ update_signal_quality (MMIfaceModem *self,
 
     /* If we got a new expirable value, setup new timeout */
     if (expire)
-        ctx->recent_timeout_source = (g_timeout_add_seconds (
+        ctx->recent_timeout_source = (mm_clock_timeout_add_seconds (
                                           SIGNAL_QUALITY_RECENT_TIMEOUT_SEC,
                                           (GSourceFunc)expire_signal_quality,
                                           self));
@@ -1354,7 +1355,7 @@ peridic_signal_check_step (MMIfaceModem *self)
 
         mm_dbg ("Periodic signal quality checks scheduled in %ds", ctx->interval);
         g_assert (!ctx->timeout_source);
-        ctx->timeout_source = g_timeout_add_seconds (ctx->interval, (GSourceFunc) periodic_signal_check_cb, self);
+        ctx->timeout_source = mm_clock_timeout_add_seconds (ctx->interval, (GSourceFunc) periodic_signal_check_cb, self);
         return;
     }
 }
@@ -554,6 +554,122 @@ mm_voice_clip_regex_get (void)
                         NULL);
 }
 
+static void
+call_info_free (MMCallInfo *info)
+{
+    g_free (info->number);
+    g_slice_free (MMCallInfo, info);
+}
+
+void
+mm_voice_call_info_list_free (GList *call_info_list)
+{
+    g_list_free_full (call_info_list, (GDestroyNotify) call_info_free);
+}
+
+static gint
+call_info_cmp (MMCallInfo *a,
+               MMCallInfo *b)
+{
+    return (a->index - b->index);
+}
+
+gboolean
+mm_voice_parse_clcc_response (const gchar  *str,
+                              GList       **out_list,
+                              GError      **error)
+{
+    GRegex     *r;
+    GMatchInfo *match_info = NULL;
+    GError     *inner_error = NULL;
+    GList      *list = NULL;
+
+    /* Example:
+     * +CLCC: 1,1,4,0,0,"+393351391306",145
+     * +CLCC: 2,0,0,0,0,"112",129
+     *        \_ Index
+     *          \_ Direction (0: MO, 1: MT)
+     *            \_ State
+     *              \_ Mode (0: voice)
+     *                \_ Multiparty
+     *
+     * An empty response means there are no calls.
+     */
+    static const MMCallState call_state[] = {
+        [0] = MM_CALL_STATE_ACTIVE,
+        [1] = MM_CALL_STATE_HELD,
+        [2] = MM_CALL_STATE_DIALING,
+        [3] = MM_CALL_STATE_RINGING_OUT,
+        [4] = MM_CALL_STATE_RINGING_IN,
+        [5] = MM_CALL_STATE_WAITING,
+    };
+
+    g_assert (out_list);
+
+    r = g_regex_new ("\\+CLCC:\\s*(\\d+)\\s*,\\s*(\\d+)\\s*,\\s*(\\d+)\\s*,\\s*(\\d+)\\s*,\\s*(\\d+)"
+                     "(?:\\s*,\\s*([^,\\r\\n]*))?",
+                     G_REGEX_RAW,
+                     0,
+                     NULL);
+    g_assert (r);
+
+    g_regex_match_full (r, str ? str : "", -1, 0, 0, &match_info, &inner_error);
+    while (!inner_error && g_match_info_matches (match_info)) {
+        MMCallInfo *info;
+        guint       direction;
+        guint       state;
+        guint       mode;
+
+        info = g_slice_new0 (MMCallInfo);
+
+        if (!mm_get_uint_from_match_info (match_info, 1, &info->index) || !info->index) {
+            inner_error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_FAILED, "Couldn't parse call index from +CLCC line");
+            call_info_free (info);
+            break;
+        }
+
+        if (!mm_get_uint_from_match_info (match_info, 2, &direction) || direction > 1) {
+            inner_error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_FAILED, "Couldn't parse call direction from +CLCC line");
+            call_info_free (info);
+            break;
+        }
+        info->direction = (direction == 0 ? MM_CALL_DIRECTION_OUTGOING : MM_CALL_DIRECTION_INCOMING);
+
+        if (!mm_get_uint_from_match_info (match_info, 3, &state) || state >= G_N_ELEMENTS (call_state)) {
+            inner_error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_FAILED, "Couldn't parse call state from +CLCC line");
+            call_info_free (info);
+            break;
+        }
+        info->state = call_state[state];
+
+        /* Skip data and fax calls */
+        if (!mm_get_uint_from_match_info (match_info, 4, &mode) || mode != 0) {
+            call_info_free (info);
+            g_match_info_next (match_info, &inner_error);
+            continue;
+        }
+
+        info->number = mm_get_string_unquoted_from_match_info (match_info, 6);
+        if (info->number && !info->number[0])
+            g_clear_pointer (&info->number, g_free);
+
+        list = g_list_prepend (list, info);
+        g_match_info_next (match_info, &inner_error);
+    }
+
+    g_match_info_free (match_info);
+    g_regex_unref (r);
+
+    if (inner_error) {
+        mm_voice_call_info_list_free (list);
+        g_propagate_error (error, inner_error);
+        return FALSE;
+    }
+
+    *out_list = g_list_sort (list, (GCompareFunc) call_info_cmp);
+    return TRUE;
+}
+
 /*************************************************************************/
 
 static MMFlowControl
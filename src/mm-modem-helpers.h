@@ -97,6 +97,18 @@ GRegex *mm_voice_ring_regex_get  (void);
 GRegex *mm_voice_cring_regex_get (void);
 GRegex *mm_voice_clip_regex_get  (void);
 
+/* AT+CLCC response parser */
+typedef struct {
+    guint            index;
+    MMCallDirection  direction;
+    MMCallState      state;
+    gchar           *number; /* optional */
+} MMCallInfo;
+void     mm_voice_call_info_list_free (GList        *call_info_list);
+gboolean mm_voice_parse_clcc_response (const gchar  *str,
+                                       GList       **out_list,
+                                       GError      **error);
+
 /*****************************************************************************/
 /* SERIAL specific helpers and utilities */
 
@@ -28,6 +28,7 @@
 #include "mm-plugin-manager.h"
 #include "mm-plugin.h"
 #include "mm-log.h"
+#include "mm-clock.h"
 
 static void initable_iface_init (GInitableIface *iface);
 
@@ -421,9 +422,9 @@ port_context_defer (PortContext *port_context)
      *
      * In this case we don't pass a port context reference because we're able
      * to fully cancel the timeout ourselves. */
-    port_context->defer_id = g_timeout_add_seconds (DEFER_TIMEOUT_SECS,
-                                                    (GSourceFunc) port_context_defer_ready,
-                                                    port_context);
+    port_context->defer_id = mm_clock_timeout_add_seconds (DEFER_TIMEOUT_SECS,
+                                                           (GSourceFunc) port_context_defer_ready,
+                                                           port_context);
 }
 
 static void
@@ -1289,9 +1290,9 @@ device_context_run (MMPluginManager     *self,
      * as possible. If we don't do this, some plugin filters won't work properly,
      * like the 'forbidden-drivers' one.
      */
-    device_context->min_wait_time_id = g_timeout_add (MIN_WAIT_TIME_MSECS,
-                                                      (GSourceFunc) device_context_min_wait_time_elapsed,
-                                                      device_context);
+    device_context->min_wait_time_id = mm_clock_timeout_add (MIN_WAIT_TIME_MSECS,
+                                                             (GSourceFunc) device_context_min_wait_time_elapsed,
+                                                             device_context);
 
     /* Set the initial probing timeout. We force the probing time of the device to
      * be at least this amount of time, so that the kernel has enough time to
@@ -1299,9 +1300,9 @@ device_context_run (MMPluginManager     *self,
      * device has been exposed in udev, this timeout effectively means that we
      * leave up to 2s to the remaining ports to appear.
      */
-    device_context->min_probing_time_id = g_timeout_add (MIN_PROBING_TIME_MSECS,
-                                                         (GSourceFunc) device_context_min_probing_time_elapsed,
-                                                         device_context);
+    device_context->min_probing_time_id = mm_clock_timeout_add (MIN_PROBING_TIME_MSECS,
+                                                                (GSourceFunc) device_context_min_probing_time_elapsed,
+                                                                device_context);
 
     /* The full device context is now cancellable. We pass this cancellable also
      * to the inner GTask, so that if we're cancelled we always return a
@@ -18,12 +18,14 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
+#include <errno.h>
 
 #include <ModemManager.h>
 #include <mm-errors-types.h>
 
 #include "mm-port-serial-qcdm.h"
 #include "libqcdm/src/com.h"
+#include "libqcdm/src/commands.h"
 #include "libqcdm/src/utils.h"
 #include "libqcdm/src/errors.h"
 #include "libqcdm/src/dm-commands.h"
@@ -31,14 +33,39 @@
 
 G_DEFINE_TYPE (MMPortSerialQcdm, mm_port_serial_qcdm, MM_TYPE_PORT_SERIAL)
 
+/* Largest DIAG packet we may receive, once unescaped */
+#define QCDM_MAX_FRAME_SIZE 8192
+
+/* Stdio buffer used for the log file sink, flushed once per batch */
+#define LOG_FILE_BUFFER_SIZE 65536
+
 struct _MMPortSerialQcdmPrivate {
     GSList *unsolicited_msg_handlers;
+
+    /* Decapsulation buffer, reused for every frame */
+    guint8 *frame_buffer;
+
+    /* Log frames found while processing the receive buffer. The byte
+     * arrays are reused across batches, so that no allocation is needed
+     * once they've grown enough. */
+    GPtrArray *log_batch;
+    guint log_batch_len;
+
+    /* Log batch handler */
+    MMPortSerialQcdmLogBatchFn log_batch_callback;
+    gpointer log_batch_user_data;
+    GDestroyNotify log_batch_notify;
+
+    /* Raw log frames file sink */
+    FILE *log_file;
 };
 
 /*****************************************************************************/
 
 static gboolean
-find_qcdm_start (GByteArray *response, gsize *start)
+find_qcdm_start (const guint8 *data,
+                 gsize len,
+                 gsize *start)
 {
     int i, last = -1;
 
@@ -48,8 +75,8 @@ find_qcdm_start (GByteArray *response, gsize *start)
      * with 0x7E and ending with 0x7E, and (3) a non-QCDM frame that still
      * uses HDLC framing (like Sierra CnS) that starts and ends with 0x7E.
      */
-    for (i = 0; i < response->len; i++) {
-        if (response->data[i] == 0x7E) {
+    for (i = 0; i < len; i++) {
+        if (data[i] == 0x7E) {
             if (i > last + 3) {
                 /* Got a full QCDM frame; 3 non-0x7E bytes and a terminator */
                 if (start)
@@ -64,37 +91,50 @@ find_qcdm_start (GByteArray *response, gsize *start)
     return FALSE;
 }
 
+/* Parses the QCDM frame found at the given offset of the response buffer.
+ * On success the decapsulated frame is left in the port frame buffer. The
+ * offset is updated with the amount of data the caller must discard from
+ * the response buffer, so that several frames may be processed with a
+ * single buffer update. */
 static MMPortSerialResponseType
-parse_qcdm (GByteArray *response,
+parse_qcdm (MMPortSerialQcdm *self,
+            GByteArray *response,
+            gsize *offset,
             gboolean want_log,
-            GByteArray **parsed_response,
+            gsize *frame_len,
             GError **error)
 {
+    const guint8 *data;
+    gsize len;
     gsize start = 0;
     gsize used = 0;
     gsize unescaped_len = 0;
-    guint8 *unescaped_buffer;
     qcdmbool more = FALSE;
 
+    g_assert (*offset <= response->len);
+    data = response->data + *offset;
+    len = response->len - *offset;
+
     /* Get the offset into the buffer of where the QCDM frame starts */
-    if (!find_qcdm_start (response, &start)) {
+    if (!find_qcdm_start (data, len, &start)) {
         /* Discard the unparsable data right away, we do need a QCDM
          * start, and anything that comes before it is unknown data
          * that we'll never use. */
         return MM_PORT_SERIAL_RESPONSE_NONE;
     }
 
-    /* If there is anything before the start marker, remove it */
-    g_byte_array_remove_range (response, 0, start);
-    if (response->len == 0)
+    /* If there is anything before the start marker, skip it */
+    *offset += start;
+    data += start;
+    len -= start;
+    if (len == 0)
         return MM_PORT_SERIAL_RESPONSE_NONE;
 
-    /* Try to decapsulate the response into a buffer */
-    unescaped_buffer = g_malloc (1024);
-    if (!dm_decapsulate_buffer ((const char *)(response->data),
-                                response->len,
-                                (char *)unescaped_buffer,
-                                1024,
+    /* Try to decapsulate the response into the frame buffer */
+    if (!dm_decapsulate_buffer ((const char *)data,
+                                len,
+                                (char *)self->priv->frame_buffer,
+                                QCDM_MAX_FRAME_SIZE,
                                 &unescaped_len,
                                 &used,
                                 &more)) {
@@ -105,35 +145,28 @@ parse_qcdm (GByteArray *response,
                      MM_SERIAL_ERROR,
                      MM_SERIAL_ERROR_PARSE_FAILED,
                      "Failed to unescape QCDM packet");
-        g_free (unescaped_buffer);
         return MM_PORT_SERIAL_RESPONSE_ERROR;
     }
 
     if (more) {
-        /* Need more data, we leave the original byte array untouched so that
-         * we can retry later when more data arrives. */
-        g_free (unescaped_buffer);
+        /* Need more data, we leave the frame untouched so that we can retry
+         * later when more data arrives. */
         return MM_PORT_SERIAL_RESPONSE_NONE;
     }
 
-    if (want_log && unescaped_buffer[0] != DIAG_CMD_LOG) {
+    if (want_log && (unescaped_len == 0 || self->priv->frame_buffer[0] != DIAG_CMD_LOG)) {
         /* If we only want log items and this isn't one, don't remove this
          * DM packet from the buffer.
          */
-        g_free (unescaped_buffer);
         return MM_PORT_SERIAL_RESPONSE_NONE;
     }
 
-    /* Successfully decapsulated the DM command. We'll build a new byte array
-     * with the response, and leave the input buffer cleaned up. */
-    g_assert (unescaped_len <= 1024);
-    unescaped_buffer = g_realloc (unescaped_buffer, unescaped_len);
-    *parsed_response = g_byte_array_new_take (unescaped_buffer, unescaped_len);
-
-    /* Remove the data we used from the input buffer, leaving out any
-     * additional data that may already been received (e.g. from the following
-     * message). */
-    g_byte_array_remove_range (response, 0, used);
+    /* Successfully decapsulated the DM command. Skip the data we used,
+     * leaving any additional data that may already been received (e.g.
+     * from the following message). */
+    g_assert (unescaped_len <= QCDM_MAX_FRAME_SIZE);
+    *frame_len = unescaped_len;
+    *offset += used;
     return MM_PORT_SERIAL_RESPONSE_BUFFER;
 }
 
@@ -143,7 +176,21 @@ parse_response (MMPortSerial *port,
                 GByteArray **parsed_response,
                 GError **error)
 {
-    return parse_qcdm (response, FALSE, parsed_response, error);
+    MMPortSerialQcdm *self = MM_PORT_SERIAL_QCDM (port);
+    MMPortSerialResponseType type;
+    gsize offset = 0;
+    gsize frame_len = 0;
+
+    type = parse_qcdm (self, response, &offset, FALSE, &frame_len, error);
+    if (type == MM_PORT_SERIAL_RESPONSE_BUFFER) {
+        /* Build a new byte array with the response */
+        *parsed_response = g_byte_array_sized_new (frame_len);
+        g_byte_array_append (*parsed_response, self->priv->frame_buffer, frame_len);
+    }
+
+    if (offset > 0)
+        g_byte_array_remove_range (response, 0, offset);
+    return type;
 }
 
 /*****************************************************************************/
@@ -153,24 +200,7 @@ mm_port_serial_qcdm_command_finish (MMPortSerialQcdm *self,
                                     GAsyncResult *res,
                                     GError **error)
 {
-    return g_task_propagate_pointer (G_TASK (res), error);
-}
-
-static void
-serial_command_ready (MMPortSerial *port,
-                      GAsyncResult *res,
-                      GTask *task)
-{
-    GByteArray *response;
-    GError *error = NULL;
-
-    response = mm_port_serial_command_finish (port, res, &error);
-    if (!response)
-        g_task_return_error (task, error);
-    else
-        g_task_return_pointer (task, response, (GDestroyNotify)g_byte_array_unref);
-
-    g_object_unref (task);
+    return mm_port_serial_command_finish (MM_PORT_SERIAL (self), res, error);
 }
 
 void
@@ -181,22 +211,72 @@ mm_port_serial_qcdm_command (MMPortSerialQcdm *self,
                              GAsyncReadyCallback callback,
                              gpointer user_data)
 {
-    GTask *task;
-
     g_return_if_fail (MM_IS_PORT_SERIAL_QCDM (self));
     g_return_if_fail (command != NULL);
 
-    task = g_task_new (self, cancellable, callback, user_data);
-
-    /* 'command' is expected to be already CRC-ed and escaped */
+    /* 'command' is expected to be already CRC-ed and escaped. The result of
+     * the serial port command is given as is to the caller, there is no
+     * need to wrap it in a task of our own. */
     mm_port_serial_command (MM_PORT_SERIAL (self),
                             command,
                             timeout_seconds,
                             FALSE, /* never cached */
                             FALSE, /* always queued last */
                             cancellable,
-                            (GAsyncReadyCallback)serial_command_ready,
-                            task);
+                            callback,
+                            user_data);
+}
+
+/*****************************************************************************/
+
+typedef size_t (* PollCommandBuilder) (char *buf, size_t len);
+
+static const PollCommandBuilder poll_command_builders[MM_PORT_SERIAL_QCDM_POLL_LAST] = {
+    [MM_PORT_SERIAL_QCDM_POLL_CDMA_STATUS]             = qcdm_cmd_cdma_status_new,
+    [MM_PORT_SERIAL_QCDM_POLL_PILOT_SETS]              = qcdm_cmd_pilot_sets_new,
+    [MM_PORT_SERIAL_QCDM_POLL_CM_SUBSYS_STATE_INFO]    = qcdm_cmd_cm_subsys_state_info_new,
+    [MM_PORT_SERIAL_QCDM_POLL_HDR_SUBSYS_STATE_INFO]   = qcdm_cmd_hdr_subsys_state_info_new,
+    [MM_PORT_SERIAL_QCDM_POLL_GSM_SUBSYS_STATE_INFO]   = qcdm_cmd_gsm_subsys_state_info_new,
+    [MM_PORT_SERIAL_QCDM_POLL_WCDMA_SUBSYS_STATE_INFO] = qcdm_cmd_wcdma_subsys_state_info_new,
+};
+
+/* Encapsulated frames of the polling commands. They don't depend on the
+ * port, so they're built once when the class is initialized and shared by
+ * all ports; the serial port never modifies the commands it sends. */
+static GByteArray *poll_frames[MM_PORT_SERIAL_QCDM_POLL_LAST];
+
+static void
+build_poll_frames (void)
+{
+    guint i;
+
+    for (i = 0; i < MM_PORT_SERIAL_QCDM_POLL_LAST; i++) {
+        GByteArray *frame;
+
+        frame = g_byte_array_sized_new (25);
+        frame->len = poll_command_builders[i] ((char *) frame->data, 25);
+        g_assert (frame->len);
+        poll_frames[i] = frame;
+    }
+}
+
+void
+mm_port_serial_qcdm_poll (MMPortSerialQcdm *self,
+                          MMPortSerialQcdmPoll poll,
+                          guint32 timeout_seconds,
+                          GCancellable *cancellable,
+                          GAsyncReadyCallback callback,
+                          gpointer user_data)
+{
+    g_return_if_fail (MM_IS_PORT_SERIAL_QCDM (self));
+    g_return_if_fail (poll < MM_PORT_SERIAL_QCDM_POLL_LAST);
+
+    mm_port_serial_qcdm_command (self,
+                                 poll_frames[poll],
+                                 timeout_seconds,
+                                 cancellable,
+                                 callback,
+                                 user_data);
 }
 
 static void
@@ -287,31 +367,98 @@ mm_port_serial_qcdm_enable_unsolicited_msg_handler (MMPortSerialQcdm *self,
     }
 }
 
+void
+mm_port_serial_qcdm_set_log_batch_handler (MMPortSerialQcdm *self,
+                                           MMPortSerialQcdmLogBatchFn callback,
+                                           gpointer user_data,
+                                           GDestroyNotify notify)
+{
+    g_return_if_fail (MM_IS_PORT_SERIAL_QCDM (self));
+
+    /* We OVERWRITE any existing one, so if any context data existing, free it */
+    if (self->priv->log_batch_notify)
+        self->priv->log_batch_notify (self->priv->log_batch_user_data);
+
+    self->priv->log_batch_callback = callback;
+    self->priv->log_batch_user_data = user_data;
+    self->priv->log_batch_notify = notify;
+}
+
+gboolean
+mm_port_serial_qcdm_set_log_file (MMPortSerialQcdm *self,
+                                  const gchar *path,
+                                  GError **error)
+{
+    FILE *file = NULL;
+
+    g_return_val_if_fail (MM_IS_PORT_SERIAL_QCDM (self), FALSE);
+
+    if (path) {
+        file = fopen (path, "ab");
+        if (!file) {
+            g_set_error (error,
+                         MM_CORE_ERROR,
+                         MM_CORE_ERROR_FAILED,
+                         "Couldn't open QCDM log file '%s': %s",
+                         path, g_strerror (errno));
+            return FALSE;
+        }
+        setvbuf (file, NULL, _IOFBF, LOG_FILE_BUFFER_SIZE);
+    }
+
+    if (self->priv->log_file)
+        fclose (self->priv->log_file);
+    self->priv->log_file = file;
+    return TRUE;
+}
+
 static void
-parse_unsolicited (MMPortSerial *port, GByteArray *response)
+log_file_write_frame (MMPortSerialQcdm *self,
+                      const GByteArray *frame)
 {
-    MMPortSerialQcdm *self = MM_PORT_SERIAL_QCDM (port);
-    GByteArray *log_buffer = NULL;
+    guint64 timestamp;
+    guint32 frame_len;
+
+    /* Each record is the 64-bit realtime timestamp in microseconds, the
+     * 32-bit frame length, and the decapsulated frame itself, all integers
+     * in little endian */
+    timestamp = GUINT64_TO_LE ((guint64) g_get_real_time ());
+    frame_len = GUINT32_TO_LE ((guint32) frame->len);
+
+    if (fwrite (&timestamp, sizeof (timestamp), 1, self->priv->log_file) != 1 ||
+        fwrite (&frame_len, sizeof (frame_len), 1, self->priv->log_file) != 1 ||
+        fwrite (frame->data, 1, frame->len, self->priv->log_file) != frame->len) {
+        mm_warn ("(%s): couldn't write QCDM log frame, closing log file: %s",
+                 mm_port_get_device (MM_PORT (self)), g_strerror (errno));
+        fclose (self->priv->log_file);
+        self->priv->log_file = NULL;
+    }
+}
+
+static void
+process_log_frame (MMPortSerialQcdm *self,
+                   gsize frame_len)
+{
+    GByteArray *log_buffer;
+    DMCmdLog *log_cmd;
     GSList *iter;
 
-    if (parse_qcdm (response,
-                    TRUE,
-                    &log_buffer,
-                    NULL) != MM_PORT_SERIAL_RESPONSE_BUFFER) {
-        return;
-    }
+    /* Copy the frame into the next pooled byte array of the batch */
+    if (self->priv->log_batch_len == self->priv->log_batch->len)
+        g_ptr_array_add (self->priv->log_batch, g_byte_array_new ());
+    log_buffer = g_ptr_array_index (self->priv->log_batch, self->priv->log_batch_len++);
+    g_byte_array_set_size (log_buffer, 0);
+    g_byte_array_append (log_buffer, self->priv->frame_buffer, frame_len);
 
-    /* These should be guaranteed by parse_qcdm() */
-    g_return_if_fail (log_buffer);
-    g_return_if_fail (log_buffer->len > 0);
-    g_return_if_fail (log_buffer->data[0] == DIAG_CMD_LOG);
+    if (self->priv->log_file)
+        log_file_write_frame (self, log_buffer);
 
     if (log_buffer->len < sizeof (DMCmdLog))
         return;
 
+    log_cmd = (DMCmdLog *) log_buffer->data;
     for (iter = self->priv->unsolicited_msg_handlers; iter; iter = iter->next) {
         MMQcdmUnsolicitedMsgHandler *handler = (MMQcdmUnsolicitedMsgHandler *) iter->data;
-        DMCmdLog *log_cmd = (DMCmdLog *) log_buffer->data;
 
         if (!handler->enable)
             continue;
@@ -322,6 +469,40 @@ parse_unsolicited (MMPortSerial *port, GByteArray *response)
     }
 }
 
+static void
+parse_unsolicited (MMPortSerial *port, GByteArray *response)
+{
+    MMPortSerialQcdm *self = MM_PORT_SERIAL_QCDM (port);
+    gsize offset = 0;
+    gsize frame_len = 0;
+
+    /* Process all the log frames available at the head of the buffer in one
+     * go, and only then update the buffer */
+    self->priv->log_batch_len = 0;
+    while (parse_qcdm (self,
+                       response,
+                       &offset,
+                       TRUE,
+                       &frame_len,
+                       NULL) == MM_PORT_SERIAL_RESPONSE_BUFFER)
+        process_log_frame (self, frame_len);
+
+    if (offset > 0)
+        g_byte_array_remove_range (response, 0, offset);
+
+    if (!self->priv->log_batch_len)
+        return;
+
+    if (self->priv->log_batch_callback)
+        self->priv->log_batch_callback (self,
+                                        (GByteArray **) self->priv->log_batch->pdata,
+                                        self->priv->log_batch_len,
+                                        self->priv->log_batch_user_data);
+
+    if (self->priv->log_file)
+        fflush (self->priv->log_file);
+}
+
 /*****************************************************************************/
 
 static gboolean
@@ -373,6 +554,9 @@ static void
 mm_port_serial_qcdm_init (MMPortSerialQcdm *self)
 {
     self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self, MM_TYPE_PORT_SERIAL_QCDM, MMPortSerialQcdmPrivate);
+
+    self->priv->frame_buffer = g_malloc (QCDM_MAX_FRAME_SIZE);
+    self->priv->log_batch = g_ptr_array_new_with_free_func ((GDestroyNotify) g_byte_array_unref);
 }
 
 static void
@@ -391,6 +575,15 @@ finalize (GObject *object)
                                                                     self->priv->unsolicited_msg_handlers);
     }
 
+    if (self->priv->log_batch_notify)
+        self->priv->log_batch_notify (self->priv->log_batch_user_data);
+
+    if (self->priv->log_file)
+        fclose (self->priv->log_file);
+
+    g_ptr_array_unref (self->priv->log_batch);
+    g_free (self->priv->frame_buffer);
+
     G_OBJECT_CLASS (mm_port_serial_qcdm_parent_class)->finalize (object);
 }
 
@@ -408,4 +601,6 @@ mm_port_serial_qcdm_class_init (MMPortSerialQcdmClass *klass)
     port_class->parse_response = parse_response;
     port_class->config_fd = config_fd;
     port_class->debug_log = debug_log;
+
+    build_poll_frames ();
 }
@@ -57,6 +57,26 @@ GByteArray *mm_port_serial_qcdm_command_finish (MMPortSerialQcdm *self,
                                                 GAsyncResult *res,
                                                 GError **error);
 
+/* Parameterless commands which are sent periodically to query the modem
+ * state. Their frames are built once and reused for every request. */
+typedef enum {
+    MM_PORT_SERIAL_QCDM_POLL_CDMA_STATUS,
+    MM_PORT_SERIAL_QCDM_POLL_PILOT_SETS,
+    MM_PORT_SERIAL_QCDM_POLL_CM_SUBSYS_STATE_INFO,
+    MM_PORT_SERIAL_QCDM_POLL_HDR_SUBSYS_STATE_INFO,
+    MM_PORT_SERIAL_QCDM_POLL_GSM_SUBSYS_STATE_INFO,
+    MM_PORT_SERIAL_QCDM_POLL_WCDMA_SUBSYS_STATE_INFO,
+    MM_PORT_SERIAL_QCDM_POLL_LAST
+} MMPortSerialQcdmPoll;
+
+/* Completed with mm_port_serial_qcdm_command_finish() */
+void        mm_port_serial_qcdm_poll           (MMPortSerialQcdm *self,
+                                                MMPortSerialQcdmPoll poll,
+                                                guint32 timeout_seconds,
+                                                GCancellable *cancellable,
+                                                GAsyncReadyCallback callback,
+                                                gpointer user_data);
+
 typedef void (*MMPortSerialQcdmUnsolicitedMsgFn) (MMPortSerialQcdm *port,
                                                   GByteArray *log_buffer,
                                                   gpointer user_data);
@@ -71,4 +91,21 @@ void     mm_port_serial_qcdm_enable_unsolicited_msg_handler (MMPortSerialQcdm *s
                                                              guint log_code,
                                                              gboolean enable);
 
+/* Called once per receive buffer update with all the log frames found in it.
+ * Frames are owned by the port and only valid during the callback. */
+typedef void (*MMPortSerialQcdmLogBatchFn) (MMPortSerialQcdm *port,
+                                            GByteArray **frames,
+                                            guint n_frames,
+                                            gpointer user_data);
+
+void     mm_port_serial_qcdm_set_log_batch_handler (MMPortSerialQcdm *self,
+                                                    MMPortSerialQcdmLogBatchFn callback,
+                                                    gpointer user_data,
+                                                    GDestroyNotify notify);
+
+/* Store all received log frames in the given file, or stop if NULL */
+gboolean mm_port_serial_qcdm_set_log_file (MMPortSerialQcdm *self,
+                                           const gchar *path,
+                                           GError **error);
+
 #endif /* MM_PORT_SERIAL_QCDM_H */
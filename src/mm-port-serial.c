@@ -35,6 +35,7 @@
 
 #include "mm-port-serial.h"
 #include "mm-log.h"
+#include "mm-clock.h"
 #include "mm-helper-enums-types.h"
 
 static gboolean port_serial_queue_process          (gpointer data);
@@ -696,6 +697,39 @@ port_serial_get_cached_reply (MMPortSerial *self,
     return (const GByteArray *)g_hash_table_lookup (self->priv->reply_cache, command);
 }
 
+static void
+reply_cache_add_size (GByteArray *command,
+                      GByteArray *response,
+                      gsize      *size)
+{
+    *size += command->len + response->len;
+}
+
+/* Only the payload bytes are accounted, container overhead is ignored */
+void
+mm_port_serial_get_memory_usage (MMPortSerial *self,
+                                 gsize        *buffers,
+                                 gsize        *reply_cache)
+{
+    g_return_if_fail (MM_IS_PORT_SERIAL (self));
+
+    if (buffers) {
+        GList *l;
+
+        *buffers = self->priv->response->len;
+        for (l = self->priv->queue->head; l; l = g_list_next (l)) {
+            CommandContext *ctx = l->data;
+
+            *buffers += ctx->command->len;
+        }
+    }
+
+    if (reply_cache) {
+        *reply_cache = 0;
+        g_hash_table_foreach (self->priv->reply_cache, (GHFunc)reply_cache_add_size, reply_cache);
+    }
+}
+
 static void
 port_serial_schedule_queue_process (MMPortSerial *self, guint timeout_ms)
 {
@@ -895,9 +929,9 @@ port_serial_queue_process (gpointer data)
     }
 
     /* If the command is finished being sent, schedule the timeout */
-    self->priv->timeout_id = g_timeout_add_seconds (ctx->timeout,
-                                                    port_serial_timed_out,
-                                                    self);
+    self->priv->timeout_id = mm_clock_timeout_add_seconds (ctx->timeout,
+                                                           port_serial_timed_out,
+                                                           self);
     return G_SOURCE_REMOVE;
 }
 
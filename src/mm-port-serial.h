@@ -157,4 +157,9 @@ gboolean mm_port_serial_set_flow_control (MMPortSerial   *self,
                                           GError        **error);
 
 MMFlowControl mm_port_serial_get_flow_control (MMPortSerial *self);
+
+void mm_port_serial_get_memory_usage (MMPortSerial *self,
+                                      gsize        *buffers,
+                                      gsize        *reply_cache);
+
 #endif /* MM_PORT_SERIAL_H */
@@ -26,6 +26,8 @@
 #include <libqmi-glib.h>
 
 #include "mm-log.h"
+#include "mm-clock.h"
+#include "mm-base-modem.h"
 #include "mm-iface-modem.h"
 #include "mm-iface-modem-3gpp.h"
 #include "mm-iface-modem-location.h"
@@ -91,6 +93,8 @@ typedef struct {
     gboolean  config_active_default;
     GArray   *config_list;
     gint      config_active_i;
+    gint64    config_setup_time;
+    gulong    config_registration_state_id;
 } Private;
 
 static void
@@ -1948,6 +1952,146 @@ mm_shared_qmi_factory_reset (MMIfaceModem        *self,
 #define SETUP_CARRIER_CONFIG_STEP_TIMEOUT_SECS 10
 #define GENERIC_CONFIG_FALLBACK "generic"
 
+/* Mapping files are parsed only once, and kept indexed by path */
+typedef struct {
+    gchar      *group;
+    gchar      *fallback;
+    GHashTable *configs; /* MCCMNC (5 or 6 digits) -> config description */
+} CarrierConfigMapping;
+
+static GHashTable *carrier_config_mappings;
+
+static void
+carrier_config_mapping_free (CarrierConfigMapping *mapping)
+{
+    g_hash_table_unref (mapping->configs);
+    g_free (mapping->fallback);
+    g_free (mapping->group);
+    g_slice_free (CarrierConfigMapping, mapping);
+}
+
+static const CarrierConfigMapping *
+carrier_config_mapping_get (const gchar  *path,
+                            GError      **error)
+{
+    CarrierConfigMapping  *mapping;
+    GKeyFile              *keyfile;
+    gchar                **keys;
+    guint                  i;
+
+    if (G_UNLIKELY (!carrier_config_mappings))
+        carrier_config_mappings = g_hash_table_new_full (g_str_hash,
+                                                         g_str_equal,
+                                                         g_free,
+                                                         (GDestroyNotify) carrier_config_mapping_free);
+
+    mapping = g_hash_table_lookup (carrier_config_mappings, path);
+    if (mapping)
+        return mapping;
+
+    keyfile = g_key_file_new ();
+    if (!g_key_file_load_from_file (keyfile, path, G_KEY_FILE_NONE, error)) {
+        g_key_file_unref (keyfile);
+        return NULL;
+    }
+
+    mapping = g_slice_new0 (CarrierConfigMapping);
+    mapping->configs = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+    /* Only one group expected per file, so get the start one */
+    mapping->group = g_key_file_get_start_group (keyfile);
+    keys = (mapping->group ? g_key_file_get_keys (keyfile, mapping->group, NULL, NULL) : NULL);
+    for (i = 0; keys && keys[i]; i++) {
+        gchar *value;
+
+        value = g_key_file_get_string (keyfile, mapping->group, keys[i], NULL);
+        if (!value)
+            continue;
+        if (g_str_equal (keys[i], GENERIC_CONFIG_FALLBACK)) {
+            g_free (mapping->fallback);
+            mapping->fallback = value;
+        } else
+            g_hash_table_insert (mapping->configs, g_strdup (keys[i]), value);
+    }
+    g_strfreev (keys);
+    g_key_file_unref (keyfile);
+
+    mm_dbg ("Loaded carrier config mapping '%s': %u entries in group '%s'",
+            path, g_hash_table_size (mapping->configs), mapping->group ? mapping->group : "n/a");
+    g_hash_table_insert (carrier_config_mappings, g_strdup (path), mapping);
+    return mapping;
+}
+
+/* Time to registered after the carrier config setup, which runs as soon as
+ * the SIM is available. If a config switch is needed, the modem object is
+ * re-created after the reset, so the setup start time is kept by device
+ * until the new one runs its own setup. */
+static GHashTable *carrier_config_switch_times;
+
+static void
+carrier_config_registration_state_changed (MMSharedQmi *self,
+                                           GParamSpec  *pspec)
+{
+    MMModem3gppRegistrationState  state = MM_MODEM_3GPP_REGISTRATION_STATE_UNKNOWN;
+    Private                      *priv;
+
+    g_object_get (self,
+                  MM_IFACE_MODEM_3GPP_REGISTRATION_STATE, &state,
+                  NULL);
+    if (state != MM_MODEM_3GPP_REGISTRATION_STATE_HOME &&
+        state != MM_MODEM_3GPP_REGISTRATION_STATE_ROAMING)
+        return;
+
+    priv = get_private (self);
+    mm_info ("Registered %.3lfs after the carrier config setup",
+             (gdouble) (mm_clock_get_monotonic_time () - priv->config_setup_time) / G_USEC_PER_SEC);
+
+    g_signal_handler_disconnect (self, priv->config_registration_state_id);
+    priv->config_registration_state_id = 0;
+}
+
+static void
+carrier_config_registration_timing_start (MMSharedQmi *self)
+{
+    Private     *priv;
+    const gchar *device;
+    gint64      *switch_time;
+
+    priv = get_private (self);
+    device = mm_base_modem_get_device (MM_BASE_MODEM (self));
+
+    switch_time = (carrier_config_switch_times ? g_hash_table_lookup (carrier_config_switch_times, device) : NULL);
+    if (switch_time) {
+        priv->config_setup_time = *switch_time;
+        g_hash_table_remove (carrier_config_switch_times, device);
+    } else
+        priv->config_setup_time = mm_clock_get_monotonic_time ();
+
+    if (!priv->config_registration_state_id)
+        priv->config_registration_state_id = g_signal_connect (self,
+                                                               "notify::" MM_IFACE_MODEM_3GPP_REGISTRATION_STATE,
+                                                               G_CALLBACK (carrier_config_registration_state_changed),
+                                                               NULL);
+}
+
+static void
+carrier_config_registration_timing_switched (MMSharedQmi *self)
+{
+    Private *priv;
+    gint64  *switch_time;
+
+    priv = get_private (self);
+
+    if (G_UNLIKELY (!carrier_config_switch_times))
+        carrier_config_switch_times = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+    switch_time = g_new (gint64, 1);
+    *switch_time = priv->config_setup_time;
+    g_hash_table_replace (carrier_config_switch_times,
+                          g_strdup (mm_base_modem_get_device (MM_BASE_MODEM (self))),
+                          switch_time);
+}
+
 typedef enum {
     SETUP_CARRIER_CONFIG_STEP_FIRST,
     SETUP_CARRIER_CONFIG_STEP_FIND_REQUESTED,
@@ -1959,18 +2103,18 @@ typedef enum {
 
 
 typedef struct {
-    SetupCarrierConfigStep  step;
-    QmiClientPdc           *client;
-    GKeyFile               *keyfile;
-    gchar                  *imsi;
-
-    gint                    config_requested_i;
-    gchar                  *config_requested;
-
-    guint                   token;
-    guint                   timeout_id;
-    gulong                  set_selected_config_indication_id;
-    gulong                  activate_config_indication_id;
+    SetupCarrierConfigStep      step;
+    QmiClientPdc               *client;
+    const CarrierConfigMapping *mapping;
+    gchar                      *imsi;
+
+    gint                        config_requested_i;
+    gchar                      *config_requested;
+
+    guint                       token;
+    guint                       timeout_id;
+    gulong                      set_selected_config_indication_id;
+    gulong                      activate_config_indication_id;
 } SetupCarrierConfigContext;
 
 /* Allow to cleanup action setup right away, without being tied
@@ -1999,7 +2143,6 @@ setup_carrier_config_context_free (SetupCarrierConfigContext *ctx)
 
     g_free (ctx->config_requested);
     g_free (ctx->imsi);
-    g_key_file_unref (ctx->keyfile);
     g_clear_object (&ctx->client);
     g_slice_free (SetupCarrierConfigContext, ctx);
 }
@@ -2208,7 +2351,7 @@ find_requested_carrier_config (GTask *task)
     MMSharedQmi               *self;
     Private                   *priv;
     gchar                      mccmnc[7];
-    gchar                     *group;
+    const gchar               *group;
     gint                       config_fallback_i = -1;
     gchar                     *config_fallback = NULL;
 
@@ -2216,21 +2359,20 @@ find_requested_carrier_config (GTask *task)
     self = MM_SHARED_QMI (g_task_get_source_object (task));
     priv = get_private (self);
 
-    /* Only one group expected per file, so get the start one */
-    group = g_key_file_get_start_group (ctx->keyfile);
+    group = ctx->mapping->group;
 
     /* Match generic configuration */
-    config_fallback = g_key_file_get_string (ctx->keyfile, group, GENERIC_CONFIG_FALLBACK, NULL);
+    config_fallback = g_strdup (ctx->mapping->fallback);
     mm_dbg ("Fallback carrier configuration %sfound in group '%s'", config_fallback ? "" : "not ", group);
 
     /* First, try to match 6 MCCMNC digits (3-digit MNCs) */
     strncpy (mccmnc, ctx->imsi, 6);
     mccmnc[6] = '\0';
-    ctx->config_requested = g_key_file_get_string (ctx->keyfile, group, mccmnc, NULL);
+    ctx->config_requested = g_strdup (g_hash_table_lookup (ctx->mapping->configs, mccmnc));
     if (!ctx->config_requested) {
         /* If not found, try to match 5 MCCMNC digits (2-digit MNCs) */
         mccmnc[5] = '\0';
-        ctx->config_requested = g_key_file_get_string (ctx->keyfile, group, mccmnc, NULL);
+        ctx->config_requested = g_strdup (g_hash_table_lookup (ctx->mapping->configs, mccmnc));
     }
     mm_dbg ("Requested carrier configuration %sfound for '%s' in group '%s': %s",
             ctx->config_requested ? "" : "not ", mccmnc, group, ctx->config_requested ? ctx->config_requested : "n/a");
@@ -2304,7 +2446,6 @@ find_requested_carrier_config (GTask *task)
 
 out:
     g_free (config_fallback);
-    g_free (group);
 }
 
 static void
@@ -2385,6 +2526,9 @@ setup_carrier_config_step (GTask *task)
     }
 
     case SETUP_CARRIER_CONFIG_STEP_LAST:
+        /* The modem resets after a switch */
+        if (ctx->config_requested_i != priv->config_active_i)
+            carrier_config_registration_timing_switched (g_task_get_source_object (task));
         g_task_return_boolean (task, TRUE);
         g_object_unref (task);
         break;
@@ -2410,15 +2554,12 @@ mm_shared_qmi_setup_carrier_config (MMIfaceModem        *self,
     ctx = g_slice_new0 (SetupCarrierConfigContext);
     ctx->step = SETUP_CARRIER_CONFIG_STEP_FIRST;
     ctx->imsi = g_strdup (imsi);
-    ctx->keyfile = g_key_file_new ();
     ctx->config_requested_i = -1;
     g_task_set_task_data (task, ctx, (GDestroyNotify)setup_carrier_config_context_free);
 
-    /* Load mapping keyfile */
-    if (!g_key_file_load_from_file (ctx->keyfile,
-                                    carrier_config_mapping,
-                                    G_KEY_FILE_NONE,
-                                    &error)) {
+    /* Load mapping keyfile, or reuse the one already loaded */
+    ctx->mapping = carrier_config_mapping_get (carrier_config_mapping, &error);
+    if (!ctx->mapping) {
         g_task_return_error (task, error);
         g_object_unref (task);
         return;
@@ -2437,6 +2578,7 @@ mm_shared_qmi_setup_carrier_config (MMIfaceModem        *self,
     }
     ctx->client = g_object_ref (client);
 
+    carrier_config_registration_timing_start (MM_SHARED_QMI (self));
     setup_carrier_config_step (task);
 }
 
@@ -2445,6 +2587,11 @@ mm_shared_qmi_setup_carrier_config (MMIfaceModem        *self,
 
 #define LOAD_CARRIER_CONFIG_STEP_TIMEOUT_SECS 5
 
+/* Config lists already loaded, indexed by device and firmware revision, so
+ * that they aren't listed again when the modem object is re-created (e.g.
+ * after the reset done to switch configs) */
+static GHashTable *carrier_config_lists;
+
 typedef enum {
     LOAD_CARRIER_CONFIG_STEP_FIRST,
     LOAD_CARRIER_CONFIG_STEP_LIST_CONFIGS,
@@ -2457,6 +2604,8 @@ typedef struct {
 
     QmiClientPdc *client;
 
+    gchar        *cache_key;
+    gboolean      config_list_cached;
     GArray       *config_list;
     guint         configs_loaded;
     gboolean      config_active_default;
@@ -2499,6 +2648,7 @@ load_carrier_config_context_free (LoadCarrierConfigContext *ctx)
 
     if (ctx->config_list)
         g_array_unref (ctx->config_list);
+    g_free (ctx->cache_key);
     g_clear_object (&ctx->client);
     g_slice_free (LoadCarrierConfigContext, ctx);
 }
@@ -2610,6 +2760,20 @@ get_selected_config_indication (QmiClientPdc                            *client,
     }
 
     if (i == ctx->config_list->len) {
+        /* The configs installed may have changed since the list was cached
+         * (e.g. a new one installed and selected at runtime), so list them
+         * again before giving up */
+        if (ctx->config_list_cached) {
+            mm_dbg ("currently selected config not found in the cached list: listing configs again");
+            g_hash_table_remove (carrier_config_lists, ctx->cache_key);
+            g_clear_pointer (&ctx->config_list, g_array_unref);
+            ctx->config_list_cached = FALSE;
+            load_carrier_config_context_cleanup_action (ctx);
+            ctx->step = LOAD_CARRIER_CONFIG_STEP_LIST_CONFIGS;
+            load_carrier_config_step (task);
+            return;
+        }
+
         load_carrier_config_abort (task, g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
                                                       "couldn't find currently selected config"));
         return;
@@ -2838,6 +3002,17 @@ load_carrier_config_step (GTask *task)
 
     case LOAD_CARRIER_CONFIG_STEP_LIST_CONFIGS: {
         QmiMessagePdcListConfigsInput *input;
+        GArray                        *cached;
+
+        cached = (carrier_config_lists ? g_hash_table_lookup (carrier_config_lists, ctx->cache_key) : NULL);
+        if (cached) {
+            mm_dbg ("reusing %u carrier configurations already loaded", cached->len);
+            ctx->config_list = g_array_ref (cached);
+            ctx->config_list_cached = TRUE;
+            ctx->step++;
+            load_carrier_config_step (task);
+            return;
+        }
 
         input = qmi_message_pdc_list_configs_input_new ();
         qmi_message_pdc_list_configs_input_set_config_type (input, QMI_PDC_CONFIGURATION_TYPE_SOFTWARE, NULL);
@@ -2874,6 +3049,15 @@ load_carrier_config_step (GTask *task)
         g_assert (priv->config_active_i < 0 && !priv->config_active_default);
         g_assert (ctx->config_active_i >= 0 || ctx->config_active_default);
         priv->config_list = ctx->config_list ? g_array_ref (ctx->config_list) : NULL;
+
+        if (ctx->config_list) {
+            if (G_UNLIKELY (!carrier_config_lists))
+                carrier_config_lists = g_hash_table_new_full (g_str_hash,
+                                                              g_str_equal,
+                                                              g_free,
+                                                              (GDestroyNotify) g_array_unref);
+            g_hash_table_replace (carrier_config_lists, g_strdup (ctx->cache_key), g_array_ref (ctx->config_list));
+        }
         priv->config_active_i = ctx->config_active_i;
         priv->config_active_default = ctx->config_active_default;
 
@@ -2897,6 +3081,9 @@ mm_shared_qmi_load_carrier_config (MMIfaceModem        *self,
     ctx = g_slice_new0 (LoadCarrierConfigContext);
     ctx->step = LOAD_CARRIER_CONFIG_STEP_FIRST;
     ctx->config_active_i = -1;
+    ctx->cache_key = g_strdup_printf ("%s:%s",
+                                      mm_base_modem_get_device (MM_BASE_MODEM (self)),
+                                      mm_iface_modem_get_revision (self) ? mm_iface_modem_get_revision (self) : "");
     g_task_set_task_data (task, ctx, (GDestroyNotify)load_carrier_config_context_free);
 
     /* Load PDC client */
@@ -89,6 +89,37 @@ mm_sms_list_get_count (MMSmsList *self)
     return g_list_length (self->priv->list);
 }
 
+#define STRLEN0(str) ((str) ? strlen (str) + 1 : 0)
+
+gsize
+mm_sms_list_get_memory_usage (MMSmsList *self)
+{
+    GList *l;
+    gsize  size = 0;
+
+    for (l = self->priv->list; l; l = g_list_next (l)) {
+        GList *parts;
+
+        for (parts = mm_base_sms_get_parts (MM_BASE_SMS (l->data)); parts; parts = g_list_next (parts)) {
+            MMSmsPart        *part = (MMSmsPart *)parts->data;
+            const GByteArray *data;
+
+            size += STRLEN0 (mm_sms_part_get_smsc (part));
+            size += STRLEN0 (mm_sms_part_get_number (part));
+            size += STRLEN0 (mm_sms_part_get_timestamp (part));
+            size += STRLEN0 (mm_sms_part_get_discharge_timestamp (part));
+            size += STRLEN0 (mm_sms_part_get_text (part));
+            data = mm_sms_part_get_data (part);
+            if (data)
+                size += data->len;
+        }
+    }
+
+    return size;
+}
+
+#undef STRLEN0
+
 GStrv
 mm_sms_list_get_paths (MMSmsList *self)
 {
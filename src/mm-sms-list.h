@@ -60,6 +60,7 @@ MMSmsList *mm_sms_list_new (MMBaseModem *modem);
 
 GStrv mm_sms_list_get_paths (MMSmsList *self);
 guint mm_sms_list_get_count (MMSmsList *self);
+gsize mm_sms_list_get_memory_usage (MMSmsList *self);
 
 gboolean mm_sms_list_has_part (MMSmsList *self,
                                MMSmsStorage storage,
@@ -0,0 +1,442 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <config.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <glib.h>
+#include <gio/gio.h>
+#include <gio/gunixsocketaddress.h>
+
+#include "mm-port-serial-at.h"
+#include "mm-serial-parsers.h"
+#include "mm-modem-helpers.h"
+#include "mm-log.h"
+
+/* Throughput of the AT serial port and response parsers, using an abstract
+ * UNIX socket instead of a TTY. A server thread plays the modem side while
+ * the main thread runs the MMPortSerialAt; CPU usage is measured for the
+ * main thread only, so it doesn't include the fake modem. Small sizes are
+ * used by default, the real benchmark sizes are used in perf mode. */
+
+#define BENCH_TIMEOUT_SECS 120
+
+/*****************************************************************************/
+/* Fake modem side */
+
+typedef struct {
+    GSocket     *socket;
+    /* Reply mode: each received command gets the same reply */
+    const gchar *reply;
+    /* Stream mode: the stream is written right away, commands are ignored */
+    GBytes      *stream;
+} Server;
+
+static gboolean
+server_write_all (Server      *server,
+                  const gchar *data,
+                  gsize        len)
+{
+    gsize written = 0;
+
+    while (written < len) {
+        gssize n;
+
+        n = g_socket_send (server->socket, data + written, len - written, NULL, NULL);
+        if (n <= 0)
+            return FALSE;
+        written += n;
+    }
+    return TRUE;
+}
+
+static gpointer
+server_thread_func (Server *server)
+{
+    gchar buffer[1024];
+
+    if (server->stream) {
+        gconstpointer data;
+        gsize         len;
+
+        data = g_bytes_get_data (server->stream, &len);
+        server_write_all (server, data, len);
+    }
+
+    /* Reply to commands until the port is closed */
+    while (TRUE) {
+        gssize n;
+        gssize i;
+
+        n = g_socket_receive (server->socket, buffer, sizeof (buffer), NULL, NULL);
+        if (n <= 0)
+            break;
+
+        for (i = 0; i < n; i++) {
+            if (buffer[i] == '\r' && server->reply &&
+                !server_write_all (server, server->reply, strlen (server->reply)))
+                return NULL;
+        }
+    }
+    return NULL;
+}
+
+/*****************************************************************************/
+/* Benchmark context */
+
+typedef struct {
+    MMPortSerialAt *port;
+    GSocket        *listener;
+    Server          server;
+    GThread        *server_thread;
+    GMainLoop      *loop;
+    guint           timeout_id;
+
+    /* Workload */
+    const gchar    *command;
+    guint           n_expected;
+    guint           n_done;
+    guint64         n_bytes;
+    gsize           reply_len;
+
+    /* Measurements */
+    gint64          start_time;
+    gint64          start_cpu;
+} BenchContext;
+
+static gint64
+thread_cpu_time_ns (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ((gint64) ts.tv_sec * G_GINT64_CONSTANT (1000000000)) + ts.tv_nsec;
+}
+
+static gboolean
+bench_timeout_cb (BenchContext *ctx)
+{
+    g_error ("Benchmark timed out: %u/%u done", ctx->n_done, ctx->n_expected);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+bench_setup (BenchContext *ctx,
+             const gchar  *reply,
+             GBytes       *stream)
+{
+    GError         *error = NULL;
+    GSocketAddress *address;
+    gchar          *name;
+
+    name = g_strdup_printf ("abstract:mm-test-at-serial-port-throughput:%ld", (glong) getpid ());
+
+    /* Listen in the abstract socket the port will connect to */
+    ctx->listener = g_socket_new (G_SOCKET_FAMILY_UNIX, G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_DEFAULT, &error);
+    g_assert_no_error (error);
+    address = g_unix_socket_address_new_with_type (name, -1, G_UNIX_SOCKET_ADDRESS_ABSTRACT);
+    g_socket_bind (ctx->listener, address, TRUE, &error);
+    g_assert_no_error (error);
+    g_socket_listen (ctx->listener, &error);
+    g_assert_no_error (error);
+    g_object_unref (address);
+
+    ctx->port = mm_port_serial_at_new (name, MM_PORT_SUBSYS_UNIX);
+    mm_port_serial_at_set_response_parser (ctx->port,
+                                           mm_serial_parser_v1_parse,
+                                           mm_serial_parser_v1_new (),
+                                           mm_serial_parser_v1_destroy);
+    g_object_set (ctx->port, MM_PORT_SERIAL_AT_INIT_SEQUENCE_ENABLED, FALSE, NULL);
+    mm_port_serial_open (MM_PORT_SERIAL (ctx->port), &error);
+    g_assert_no_error (error);
+
+    ctx->server.socket = g_socket_accept (ctx->listener, NULL, &error);
+    g_assert_no_error (error);
+    ctx->server.reply = reply;
+    ctx->server.stream = stream ? g_bytes_ref (stream) : NULL;
+    ctx->server_thread = g_thread_new ("server", (GThreadFunc)server_thread_func, &ctx->server);
+
+    ctx->loop = g_main_loop_new (NULL, FALSE);
+    ctx->timeout_id = g_timeout_add_seconds (BENCH_TIMEOUT_SECS, (GSourceFunc)bench_timeout_cb, ctx);
+
+    g_free (name);
+}
+
+static void
+bench_teardown (BenchContext *ctx)
+{
+    g_source_remove (ctx->timeout_id);
+    g_main_loop_unref (ctx->loop);
+
+    /* Closing the port makes the server thread exit */
+    mm_port_serial_close (MM_PORT_SERIAL (ctx->port));
+    g_object_unref (ctx->port);
+    g_socket_shutdown (ctx->server.socket, TRUE, TRUE, NULL);
+    g_thread_join (ctx->server_thread);
+    g_object_unref (ctx->server.socket);
+    if (ctx->server.stream)
+        g_bytes_unref (ctx->server.stream);
+    g_object_unref (ctx->listener);
+}
+
+static void
+bench_start (BenchContext *ctx)
+{
+    ctx->start_time = g_get_monotonic_time ();
+    ctx->start_cpu = thread_cpu_time_ns ();
+}
+
+static void
+bench_report (BenchContext *ctx,
+              const gchar  *name,
+              const gchar  *unit)
+{
+    gdouble elapsed;
+    gdouble cpu;
+
+    elapsed = (g_get_monotonic_time () - ctx->start_time) / (gdouble) G_USEC_PER_SEC;
+    cpu = (thread_cpu_time_ns () - ctx->start_cpu) / 1e9;
+
+    g_test_message ("%s: %u %s in %.3fs: %.1f %s/s, %.1f kB/s parsed, %.2f ns CPU per byte",
+                    name,
+                    ctx->n_done, unit, elapsed,
+                    ctx->n_done / elapsed, unit,
+                    ctx->n_bytes / elapsed / 1024.0,
+                    ctx->n_bytes ? (cpu * 1e9) / ctx->n_bytes : 0.0);
+    g_test_maximized_result (ctx->n_done / elapsed, "%s: %.1f %s/s", name, ctx->n_done / elapsed, unit);
+}
+
+/*****************************************************************************/
+/* Command/reply profiles */
+
+static void command_next (BenchContext *ctx);
+
+static void
+command_ready (MMPortSerialAt *port,
+               GAsyncResult   *res,
+               BenchContext   *ctx)
+{
+    GError      *error = NULL;
+    const gchar *response;
+
+    response = mm_port_serial_at_command_finish (port, res, &error);
+    g_assert_no_error (error);
+    g_assert (response);
+
+    ctx->n_done++;
+    ctx->n_bytes += ctx->reply_len;
+    if (ctx->n_done == ctx->n_expected)
+        g_main_loop_quit (ctx->loop);
+    else
+        command_next (ctx);
+}
+
+static void
+command_next (BenchContext *ctx)
+{
+    mm_port_serial_at_command (ctx->port,
+                               ctx->command,
+                               10,
+                               FALSE, /* raw */
+                               FALSE, /* allow cached */
+                               NULL,
+                               (GAsyncReadyCallback)command_ready,
+                               ctx);
+}
+
+static void
+run_command_profile (const gchar *name,
+                     const gchar *command,
+                     const gchar *reply,
+                     guint        n_commands)
+{
+    BenchContext ctx = { 0 };
+
+    bench_setup (&ctx, reply, NULL);
+    ctx.command = command;
+    ctx.n_expected = n_commands;
+    ctx.reply_len = strlen (reply);
+
+    bench_start (&ctx);
+    command_next (&ctx);
+    g_main_loop_run (ctx.loop);
+    bench_report (&ctx, name, "commands");
+
+    bench_teardown (&ctx);
+}
+
+static void
+test_short_replies (void)
+{
+    run_command_profile ("short replies",
+                         "+CSQ",
+                         "\r\n+CSQ: 17,99\r\n\r\nOK\r\n",
+                         g_test_perf () ? 20000 : 100);
+}
+
+static void
+test_huge_cmgl (void)
+{
+    GString *reply;
+    guint    i;
+
+    /* Full SIM storage of long SMS PDUs */
+    reply = g_string_new ("\r\n");
+    for (i = 0; i < 250; i++)
+        g_string_append_printf (reply,
+                                "+CMGL: %u,1,,159\r\n"
+                                "07914306073011F0040B914316709807F2000061101261020440A0"
+                                "C8329BFD06DDDF723619C47ECBE92074B86D06A5DD7410BD3C07A5DD7410BD3C07A5DD7410BD3C07A5DD7410BD3C07"
+                                "A5DD7410BD3C07A5DD7410BD3C07A5DD7410BD3C07A5DD7410BD3C07A5DD7410BD3C07A5DD7410BD3C07A5DD7410BD3C07"
+                                "A5DD7410BD3C07A5DD7410BD3C07A5DD7410BD3C07A5DD7410BD3C07A5DD74\r\n",
+                                i);
+    g_string_append (reply, "\r\nOK\r\n");
+
+    run_command_profile ("huge CMGL", "+CMGL=4", reply->str, g_test_perf () ? 200 : 2);
+    g_string_free (reply, TRUE);
+}
+
+/*****************************************************************************/
+/* Unsolicited message profiles */
+
+static void
+unsolicited_cb (MMPortSerialAt *port,
+                GMatchInfo     *match_info,
+                BenchContext   *ctx)
+{
+    gchar *match;
+
+    match = g_match_info_fetch (match_info, 0);
+    ctx->n_bytes += strlen (match);
+    g_free (match);
+
+    if (++ctx->n_done == ctx->n_expected)
+        g_main_loop_quit (ctx->loop);
+}
+
+static void
+run_unsolicited_profile (const gchar        *name,
+                         const gchar *const *messages,
+                         guint               n_messages)
+{
+    BenchContext  ctx = { 0 };
+    GString      *stream;
+    GBytes       *bytes;
+    GPtrArray    *creg;
+    GRegex       *regex;
+    guint         i;
+
+    stream = g_string_new (NULL);
+    for (i = 0; i < n_messages; i++)
+        g_string_append (stream, messages[i % g_strv_length ((gchar **)messages)]);
+    bytes = g_string_free_to_bytes (stream);
+
+    bench_setup (&ctx, NULL, bytes);
+    ctx.n_expected = n_messages;
+
+    /* Same handlers a 3GPP modem has, so that every message goes through a
+     * realistic number of regex matches */
+    creg = mm_3gpp_creg_regex_get (FALSE);
+    for (i = 0; i < creg->len; i++)
+        mm_port_serial_at_add_unsolicited_msg_handler (ctx.port,
+                                                       g_ptr_array_index (creg, i),
+                                                       (MMPortSerialAtUnsolicitedMsgFn)unsolicited_cb,
+                                                       &ctx,
+                                                       NULL);
+    mm_3gpp_creg_regex_destroy (creg);
+
+    regex = mm_3gpp_cmti_regex_get ();
+    mm_port_serial_at_add_unsolicited_msg_handler (ctx.port, regex, (MMPortSerialAtUnsolicitedMsgFn)unsolicited_cb, &ctx, NULL);
+    g_regex_unref (regex);
+
+    regex = mm_3gpp_cusd_regex_get ();
+    mm_port_serial_at_add_unsolicited_msg_handler (ctx.port, regex, (MMPortSerialAtUnsolicitedMsgFn)unsolicited_cb, &ctx, NULL);
+    g_regex_unref (regex);
+
+    /* NMEA traces reported in the AT port, as some modems do */
+    regex = g_regex_new ("\\r\\n(\\$G[A-Z]{4},[^\\r\\n]*)\\r\\n", G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    mm_port_serial_at_add_unsolicited_msg_handler (ctx.port, regex, (MMPortSerialAtUnsolicitedMsgFn)unsolicited_cb, &ctx, NULL);
+    g_regex_unref (regex);
+
+    bench_start (&ctx);
+    g_main_loop_run (ctx.loop);
+    bench_report (&ctx, name, "messages");
+
+    bench_teardown (&ctx);
+    g_bytes_unref (bytes);
+}
+
+static void
+test_dense_urcs (void)
+{
+    static const gchar *urcs[] = {
+        "\r\n+CREG: 1,\"1234\",\"0001ABCD\"\r\n",
+        "\r\n+CMTI: \"ME\",3\r\n",
+        "\r\n+CREG: 5,\"1234\",\"0001ABCE\",7\r\n",
+        NULL
+    };
+
+    run_unsolicited_profile ("dense URCs", urcs, g_test_perf () ? 100000 : 300);
+}
+
+static void
+test_nmea_flood (void)
+{
+    static const gchar *nmea[] = {
+        "\r\n$GPGGA,092750.000,5321.6802,N,00630.3372,W,1,8,1.03,61.7,M,55.2,M,,*76\r\n",
+        "\r\n$GPGSA,A,3,10,07,05,02,29,04,08,13,,,,,1.72,1.03,1.38*0A\r\n",
+        "\r\n$GPGSV,3,1,11,10,63,137,17,07,61,098,15,05,59,290,20,08,54,157,30*70\r\n",
+        "\r\n$GPRMC,092750.000,A,5321.6802,N,00630.3372,W,0.02,31.66,280511,,,A*43\r\n",
+        NULL
+    };
+
+    run_unsolicited_profile ("NMEA flood", nmea, g_test_perf () ? 100000 : 400);
+}
+
+/*****************************************************************************/
+
+void
+_mm_log (const char *loc,
+         const char *func,
+         guint32 level,
+         const char *fmt,
+         ...)
+{
+#if defined ENABLE_TEST_MESSAGE_TRACES
+    /* Dummy log function */
+    va_list args;
+    gchar *msg;
+
+    va_start (args, fmt);
+    msg = g_strdup_vprintf (fmt, args);
+    va_end (args);
+    g_print ("%s\n", msg);
+    g_free (msg);
+#endif
+}
+
+int main (int argc, char **argv)
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/ModemManager/AT-serial/throughput/short-replies", test_short_replies);
+    g_test_add_func ("/ModemManager/AT-serial/throughput/huge-cmgl",     test_huge_cmgl);
+    g_test_add_func ("/ModemManager/AT-serial/throughput/dense-urcs",    test_dense_urcs);
+    g_test_add_func ("/ModemManager/AT-serial/throughput/nmea-flood",    test_nmea_flood);
+
+    return g_test_run ();
+}
@@ -0,0 +1,178 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <glib.h>
+#include <string.h>
+
+#include "mm-clock.h"
+#include "mm-log.h"
+
+/*****************************************************************************/
+
+static void
+advance_ready (GObject      *source,
+               GAsyncResult *res,
+               GMainLoop    *loop)
+{
+    GError *error = NULL;
+
+    g_assert (mm_clock_advance_finish (res, &error));
+    g_assert_no_error (error);
+    g_main_loop_quit (loop);
+}
+
+static void
+advance_sync (guint64 ms)
+{
+    GMainLoop *loop;
+
+    loop = g_main_loop_new (NULL, FALSE);
+    mm_clock_advance (ms, (GAsyncReadyCallback)advance_ready, loop);
+    g_main_loop_run (loop);
+    g_main_loop_unref (loop);
+}
+
+/*****************************************************************************/
+
+static gboolean
+count_cb (guint *count)
+{
+    (*count)++;
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+test_periodic (void)
+{
+    guint  count = 0;
+    guint  id;
+    gint64 start;
+
+    start = mm_clock_get_monotonic_time ();
+
+    /* One hour of 30s polling */
+    id = mm_clock_timeout_add_seconds (30, (GSourceFunc)count_cb, &count);
+    advance_sync (60 * 60 * 1000);
+    g_assert_cmpuint (count, ==, 120);
+    g_assert_cmpint (mm_clock_get_monotonic_time () - start, ==, (gint64) 60 * 60 * G_USEC_PER_SEC);
+
+    /* Not yet expired again */
+    advance_sync (29 * 1000);
+    g_assert_cmpuint (count, ==, 120);
+    advance_sync (1000);
+    g_assert_cmpuint (count, ==, 121);
+
+    g_source_remove (id);
+    advance_sync (60 * 1000);
+    g_assert_cmpuint (count, ==, 121);
+}
+
+/*****************************************************************************/
+
+typedef struct {
+    GString *order;
+    gchar    tag;
+} OrderContext;
+
+static gboolean
+order_cb (OrderContext *ctx)
+{
+    g_string_append_c (ctx->order, ctx->tag);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+test_order (void)
+{
+    GString      *order;
+    OrderContext  a, b, c, d;
+
+    order = g_string_new (NULL);
+    a.order = b.order = c.order = d.order = order;
+    a.tag = 'a';
+    b.tag = 'b';
+    c.tag = 'c';
+    d.tag = 'd';
+
+    mm_clock_timeout_add_seconds (5, (GSourceFunc)order_cb, &a);
+    mm_clock_timeout_add (1500, (GSourceFunc)order_cb, &b);
+    mm_clock_timeout_add_seconds (3, (GSourceFunc)order_cb, &c);
+    mm_clock_timeout_add_seconds (10, (GSourceFunc)order_cb, &d);
+
+    advance_sync (6000);
+    g_assert_cmpstr (order->str, ==, "bca");
+    advance_sync (6000);
+    g_assert_cmpstr (order->str, ==, "bcad");
+
+    g_string_free (order, TRUE);
+}
+
+/*****************************************************************************/
+
+static gboolean
+rearm_cb (guint *count)
+{
+    /* Timeouts added while advancing run within the same advance */
+    if (++(*count) < 5)
+        mm_clock_timeout_add_seconds (2, (GSourceFunc)rearm_cb, count);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+test_rearm (void)
+{
+    guint count = 0;
+
+    mm_clock_timeout_add_seconds (2, (GSourceFunc)rearm_cb, &count);
+    advance_sync (9 * 1000);
+    g_assert_cmpuint (count, ==, 4);
+    advance_sync (1000);
+    g_assert_cmpuint (count, ==, 5);
+}
+
+/*****************************************************************************/
+
+void
+_mm_log (const char *loc,
+         const char *func,
+         guint32 level,
+         const char *fmt,
+         ...)
+{
+#if defined ENABLE_TEST_MESSAGE_TRACES
+    /* Dummy log function */
+    va_list args;
+    gchar *msg;
+
+    va_start (args, fmt);
+    msg = g_strdup_vprintf (fmt, args);
+    va_end (args);
+    g_print ("%s\n", msg);
+    g_free (msg);
+#endif
+}
+
+int main (int argc, char **argv)
+{
+    g_test_init (&argc, &argv, NULL);
+
+    mm_clock_enable_virtual ();
+
+    g_test_add_func ("/MM/clock/virtual/periodic", test_periodic);
+    g_test_add_func ("/MM/clock/virtual/order",    test_order);
+    g_test_add_func ("/MM/clock/virtual/rearm",    test_rearm);
+
+    return g_test_run ();
+}
@@ -4004,6 +4004,95 @@ test_bcd_to_string (void *f, gpointer d)
     }
 }
 
+/*****************************************************************************/
+/* Test +CLCC responses */
+
+typedef struct {
+    const gchar      *str;
+    const MMCallInfo  info[4];
+} ClccResponseTest;
+
+static const ClccResponseTest clcc_response_tests[] = {
+    {
+        "", { { 0 } }
+    },
+    {
+        "+CLCC: 1,1,4,0,0,\"+393351391306\",145\r\n",
+        {
+            { 1, MM_CALL_DIRECTION_INCOMING, MM_CALL_STATE_RINGING_IN, "+393351391306" },
+            { 0 }
+        }
+    },
+    {
+        /* Unsorted, without numbers, and with a data call that is ignored */
+        "+CLCC: 3,0,2,0,0\r\n"
+        "+CLCC: 2,1,1,0,1,\"\",129\r\n"
+        "+CLCC: 4,1,0,1,0,\"12345\",129\r\n"
+        "+CLCC: 1,1,0,0,1,\"12345\",129,\"Someone\"\r\n",
+        {
+            { 1, MM_CALL_DIRECTION_INCOMING, MM_CALL_STATE_ACTIVE,  "12345" },
+            { 2, MM_CALL_DIRECTION_INCOMING, MM_CALL_STATE_HELD,    NULL    },
+            { 3, MM_CALL_DIRECTION_OUTGOING, MM_CALL_STATE_DIALING, NULL    },
+            { 0 }
+        }
+    },
+    {
+        "+CLCC: 1,0,3,0,0,\"112\",129\r\n"
+        "+CLCC: 2,1,5,0,0,\"5551234\",129\r\n",
+        {
+            { 1, MM_CALL_DIRECTION_OUTGOING, MM_CALL_STATE_RINGING_OUT, "112"     },
+            { 2, MM_CALL_DIRECTION_INCOMING, MM_CALL_STATE_WAITING,     "5551234" },
+            { 0 }
+        }
+    },
+};
+
+static void
+test_clcc_response (void)
+{
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS (clcc_response_tests); i++) {
+        GError   *error = NULL;
+        gboolean  success;
+        GList    *list = NULL;
+        GList    *l;
+        guint     j;
+
+        success = mm_voice_parse_clcc_response (clcc_response_tests[i].str, &list, &error);
+        g_assert_no_error (error);
+        g_assert (success);
+
+        for (j = 0, l = list; l; l = g_list_next (l), j++) {
+            MMCallInfo *info = l->data;
+
+            g_assert_cmpuint (clcc_response_tests[i].info[j].index, !=, 0);
+            g_assert_cmpuint (info->index, ==, clcc_response_tests[i].info[j].index);
+            g_assert_cmpuint (info->direction, ==, clcc_response_tests[i].info[j].direction);
+            g_assert_cmpuint (info->state, ==, clcc_response_tests[i].info[j].state);
+            g_assert_cmpstr (info->number, ==, clcc_response_tests[i].info[j].number);
+        }
+        g_assert_cmpuint (clcc_response_tests[i].info[j].index, ==, 0);
+
+        mm_voice_call_info_list_free (list);
+    }
+}
+
+static void
+test_clcc_response_invalid (void)
+{
+    GError   *error = NULL;
+    gboolean  success;
+    GList    *list = NULL;
+
+    /* Unknown call state */
+    success = mm_voice_parse_clcc_response ("+CLCC: 1,1,9,0,0\r\n", &list, &error);
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED);
+    g_assert (!success);
+    g_assert (!list);
+    g_clear_error (&error);
+}
+
 /*****************************************************************************/
 
 void
@@ -4240,6 +4329,9 @@ int main (int argc, char **argv)
 
     g_test_suite_add (suite, TESTCASE (test_bcd_to_string, NULL));
 
+    g_test_suite_add (suite, TESTCASE (test_clcc_response, NULL));
+    g_test_suite_add (suite, TESTCASE (test_clcc_response_invalid, NULL));
+
     result = g_test_run ();
 
     reg_test_data_free (reg_data);
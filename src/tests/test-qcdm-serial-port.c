@@ -25,6 +25,7 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <signal.h>
+#include <endian.h>
 
 #include <ModemManager.h>
 #include <mm-errors-types.h>
@@ -34,6 +35,8 @@
 #include "libqcdm/src/utils.h"
 #include "libqcdm/src/com.h"
 #include "libqcdm/src/errors.h"
+#include "libqcdm/src/dm-commands.h"
+#include "libqcdm/src/log-items.h"
 #include "mm-log.h"
 
 typedef struct {
@@ -397,6 +400,303 @@ test_leading_frame_markers (TestData *d)
     g_assert (wait_for_child (d, 3));
 }
 
+/* Log stream: lots of log frames sent in bulk, which must all be delivered
+ * in batches and stored in the log file sink */
+
+#define LOG_STREAM_FRAMES      4000
+#define LOG_STREAM_PAYLOAD_LEN 500
+#define LOG_STREAM_FRAME_LEN   (sizeof (DMCmdLog) + LOG_STREAM_PAYLOAD_LEN)
+#define LOG_STREAM_RECORD_LEN  (8 + 4 + LOG_STREAM_FRAME_LEN)
+
+typedef struct {
+    GMainLoop *loop;
+    guint n_frames;
+    guint n_batches;
+    gsize n_bytes;
+} LogStreamContext;
+
+static void
+log_stream_batch_cb (MMPortSerialQcdm *port,
+                     GByteArray **frames,
+                     guint n_frames,
+                     LogStreamContext *ctx)
+{
+    guint i;
+
+    for (i = 0; i < n_frames; i++) {
+        DMCmdLog *log_cmd = (DMCmdLog *) frames[i]->data;
+
+        g_assert_cmpuint (frames[i]->len, ==, LOG_STREAM_FRAME_LEN);
+        g_assert_cmpuint (log_cmd->code, ==, DIAG_CMD_LOG);
+        /* Frames must arrive in order */
+        g_assert_cmpuint (le64toh (log_cmd->timestamp), ==, ctx->n_frames + i);
+        ctx->n_bytes += frames[i]->len;
+    }
+
+    ctx->n_frames += n_frames;
+    ctx->n_batches++;
+    if (ctx->n_frames == LOG_STREAM_FRAMES)
+        g_main_loop_quit (ctx->loop);
+}
+
+static gboolean
+log_stream_timeout_cb (LogStreamContext *ctx)
+{
+    g_main_loop_quit (ctx->loop);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+log_stream_child (int fd, const gchar *log_path)
+{
+    MMPortSerialQcdm *port;
+    LogStreamContext ctx = { 0 };
+    GError *error = NULL;
+    GTimer *timer;
+    guint timeout_id;
+
+    ctx.loop = g_main_loop_new (NULL, FALSE);
+
+    port = mm_port_serial_qcdm_new_fd (fd);
+    g_assert (port);
+
+    g_assert (mm_port_serial_qcdm_set_log_file (port, log_path, &error));
+    g_assert_no_error (error);
+    mm_port_serial_qcdm_set_log_batch_handler (port,
+                                               (MMPortSerialQcdmLogBatchFn)log_stream_batch_cb,
+                                               &ctx,
+                                               NULL);
+
+    g_assert (mm_port_serial_open (MM_PORT_SERIAL (port), &error));
+    g_assert_no_error (error);
+
+    timer = g_timer_new ();
+    timeout_id = g_timeout_add_seconds (10, (GSourceFunc)log_stream_timeout_cb, &ctx);
+    g_main_loop_run (ctx.loop);
+    g_source_remove (timeout_id);
+
+    g_assert_cmpuint (ctx.n_frames, ==, LOG_STREAM_FRAMES);
+    if (g_test_verbose ())
+        g_print ("received %u log frames (%" G_GSIZE_FORMAT " bytes) in %u batches: %.2lf MB/min\n",
+                 ctx.n_frames, ctx.n_bytes, ctx.n_batches,
+                 (ctx.n_bytes / (1024.0 * 1024.0)) * 60.0 / g_timer_elapsed (timer, NULL));
+    g_timer_destroy (timer);
+
+    /* Flush and close the log file */
+    g_assert (mm_port_serial_qcdm_set_log_file (port, NULL, NULL));
+
+    mm_port_serial_close (MM_PORT_SERIAL (port));
+    g_object_unref (port);
+    g_main_loop_unref (ctx.loop);
+}
+
+static gsize
+log_stream_build_frame (guint i, char *buf, gsize len)
+{
+    char frame[LOG_STREAM_FRAME_LEN + 2];
+    DMCmdLog *log_cmd = (DMCmdLog *) frame;
+    guint j;
+
+    log_cmd->code = DIAG_CMD_LOG;
+    log_cmd->more = 0;
+    log_cmd->len = htole16 (LOG_STREAM_FRAME_LEN - 4);
+    log_cmd->_unknown2 = log_cmd->len;
+    log_cmd->log_code = htole16 (DM_LOG_ITEM_EVDO_PILOT_SETS_V2);
+    log_cmd->timestamp = htole64 (i);
+    /* Payload covering all byte values, so that escaping is exercised */
+    for (j = 0; j < LOG_STREAM_PAYLOAD_LEN; j++)
+        log_cmd->data[j] = (i + j) & 0xFF;
+
+    return dm_encapsulate_buffer (frame, LOG_STREAM_FRAME_LEN, sizeof (frame), buf, len);
+}
+
+static void
+test_log_stream (TestData *d)
+{
+    GByteArray *stream;
+    gchar *log_path;
+    gchar *contents = NULL;
+    gsize contents_len = 0;
+    gsize written = 0;
+    guint retries = 0;
+    pid_t cpid;
+    guint i;
+    int fd;
+
+    fd = g_file_open_tmp ("test-qcdm-log-XXXXXX", &log_path, NULL);
+    g_assert (fd >= 0);
+    close (fd);
+
+    stream = g_byte_array_new ();
+    for (i = 0; i < LOG_STREAM_FRAMES; i++) {
+        char buf[(LOG_STREAM_FRAME_LEN + 2) * 2 + 1];
+        gsize len;
+
+        len = log_stream_build_frame (i, buf, sizeof (buf));
+        g_assert (len > 0);
+        g_byte_array_append (stream, (const guint8 *) buf, len);
+    }
+
+    signal (SIGCHLD, SIG_DFL);
+    cpid = fork ();
+    g_assert (cpid >= 0);
+
+    if (cpid == 0) {
+        /* In the child */
+        log_stream_child (d->slave, log_path);
+        exit (0);
+    }
+    /* Parent */
+    d->child = cpid;
+
+    /* Send the whole stream as fast as the child reads it */
+    while (written < stream->len) {
+        ssize_t status;
+
+        status = write (d->master, &stream->data[written], MIN (4096, stream->len - written));
+        if (status < 0) {
+            g_assert_cmpint (errno, ==, EAGAIN);
+            g_assert_cmpuint (retries++, <, 10000);
+            usleep (1000);
+            continue;
+        }
+        written += status;
+    }
+
+    g_assert (wait_for_child (d, 15));
+
+    /* Every frame must have been stored, each one with its own header */
+    g_assert (g_file_get_contents (log_path, &contents, &contents_len, NULL));
+    g_assert_cmpuint (contents_len, ==, LOG_STREAM_FRAMES * LOG_STREAM_RECORD_LEN);
+    for (i = 0; i < LOG_STREAM_FRAMES; i += 997) {
+        const gchar *record = &contents[i * LOG_STREAM_RECORD_LEN];
+        guint32 frame_len;
+
+        memcpy (&frame_len, &record[8], sizeof (frame_len));
+        g_assert_cmpuint (GUINT32_FROM_LE (frame_len), ==, LOG_STREAM_FRAME_LEN);
+        g_assert_cmpuint ((guint8) record[12], ==, DIAG_CMD_LOG);
+    }
+
+    unlink (log_path);
+    g_free (contents);
+    g_free (log_path);
+    g_byte_array_unref (stream);
+}
+
+#define POLL_ROUNDS 10
+
+typedef struct {
+    MMPortSerialQcdm *port;
+    GMainLoop *loop;
+    guint n_polls;
+} PollContext;
+
+static void
+poll_cdma_status_ready_cb (MMPortSerialQcdm *port,
+                           GAsyncResult *res,
+                           PollContext *ctx)
+{
+    GError *error = NULL;
+    GByteArray *response;
+    QcdmResult *result;
+    guint32 sid = 0;
+
+    response = mm_port_serial_qcdm_command_finish (port, res, &error);
+    g_assert_no_error (error);
+
+    result = qcdm_cmd_cdma_status_result ((const char *) response->data, response->len, NULL);
+    g_assert (result);
+    g_assert_cmpint (qcdm_result_get_u32 (result, QCDM_CMD_CDMA_STATUS_ITEM_SID, &sid), ==, 0);
+    /* The server reports the round number as SID */
+    g_assert_cmpuint (sid, ==, ctx->n_polls);
+    qcdm_result_unref (result);
+    g_byte_array_unref (response);
+
+    if (++ctx->n_polls == POLL_ROUNDS) {
+        g_main_loop_quit (ctx->loop);
+        return;
+    }
+
+    mm_port_serial_qcdm_poll (port,
+                              MM_PORT_SERIAL_QCDM_POLL_CDMA_STATUS,
+                              3,
+                              NULL,
+                              (GAsyncReadyCallback)poll_cdma_status_ready_cb,
+                              ctx);
+}
+
+static void
+poll_child (int fd)
+{
+    PollContext ctx = { 0 };
+    GError *error = NULL;
+
+    ctx.loop = g_main_loop_new (NULL, FALSE);
+
+    ctx.port = mm_port_serial_qcdm_new_fd (fd);
+    g_assert (ctx.port);
+
+    g_assert (mm_port_serial_open (MM_PORT_SERIAL (ctx.port), &error));
+    g_assert_no_error (error);
+
+    mm_port_serial_qcdm_poll (ctx.port,
+                              MM_PORT_SERIAL_QCDM_POLL_CDMA_STATUS,
+                              3,
+                              NULL,
+                              (GAsyncReadyCallback)poll_cdma_status_ready_cb,
+                              &ctx);
+    g_main_loop_run (ctx.loop);
+    g_assert_cmpuint (ctx.n_polls, ==, POLL_ROUNDS);
+
+    mm_port_serial_close (MM_PORT_SERIAL (ctx.port));
+    g_object_unref (ctx.port);
+    g_main_loop_unref (ctx.loop);
+}
+
+/* Test that the prebuilt polling frames can be sent over and over, each
+ * request getting its own response.
+ */
+static void
+test_poll (TestData *d)
+{
+    pid_t cpid;
+    guint i;
+
+    signal (SIGCHLD, SIG_DFL);
+    cpid = fork ();
+    g_assert (cpid >= 0);
+
+    if (cpid == 0) {
+        /* In the child */
+        poll_child (d->slave);
+        exit (0);
+    }
+    /* Parent */
+    d->child = cpid;
+
+    for (i = 0; i < POLL_ROUNDS; i++) {
+        char req[512];
+        char rsp_buf[sizeof (DMCmdStatusRsp) + 2];
+        DMCmdStatusRsp *rsp = (DMCmdStatusRsp *) rsp_buf;
+        char encapsulated[(sizeof (rsp_buf) * 2) + 1];
+        gsize req_len, len;
+
+        req_len = server_wait_request (d->master, req, sizeof (req));
+        g_assert_cmpuint (req_len, ==, 1);
+        g_assert_cmpint (req[0], ==, DIAG_CMD_STATUS);
+
+        memset (rsp_buf, 0, sizeof (rsp_buf));
+        rsp->code = DIAG_CMD_STATUS;
+        rsp->sid = htole16 (i);
+        len = dm_encapsulate_buffer (rsp_buf, sizeof (DMCmdStatusRsp), sizeof (rsp_buf),
+                                     encapsulated, sizeof (encapsulated));
+        g_assert (len > 0);
+        server_send_response (d->master, encapsulated, len);
+    }
+
+    g_assert (wait_for_child (d, 3));
+}
+
 static void
 test_pty_create (TestData *d)
 {
@@ -468,6 +768,8 @@ int main (int argc, char **argv)
     TESTCASE_PTY ("/MM/QCDM/Sierra-Cns-Rejected", test_sierra_cns_rejected);
     TESTCASE_PTY ("/MM/QCDM/Random-Data-Rejected", test_random_data_rejected);
     TESTCASE_PTY ("/MM/QCDM/Leading-Frame-Markers", test_leading_frame_markers);
+    TESTCASE_PTY ("/MM/QCDM/Log-Stream", test_log_stream);
+    TESTCASE_PTY ("/MM/QCDM/Poll", test_poll);
 
     return g_test_run ();
 }